@@ -5,23 +5,29 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../Src/FinalProjectSTMToArduino.c 
+../Src/FinalProjectSTMToArduino.c \
+../Src/syscalls.c \
+../Src/sysmem.c 
 
 OBJS += \
-./Src/FinalProjectSTMToArduino.o 
+./Src/FinalProjectSTMToArduino.o \
+./Src/syscalls.o \
+./Src/sysmem.o 
 
 C_DEPS += \
-./Src/FinalProjectSTMToArduino.d 
+./Src/FinalProjectSTMToArduino.d \
+./Src/syscalls.d \
+./Src/sysmem.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 Src/%.o Src/%.su Src/%.cyclo: ../Src/%.c Src/subdir.mk
-	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DSTM32 -DSTM32F407G_DISC1 -DSTM32F4 -DSTM32F407VGTx -c -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/drivers/Inc" -I../Inc -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/bsp/Inc" -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=soft -mthumb -o "$@"
+	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DSTM32 -DSTM32F407G_DISC1 -DSTM32F4 -DSTM32F407VGTx -c -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/drivers/Inc" -I../Inc -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/bsp/Inc" -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=hard -mthumb -o "$@"
 
 clean: clean-Src
 
 clean-Src:
-	-$(RM) ./Src/FinalProjectSTMToArduino.cyclo ./Src/FinalProjectSTMToArduino.d ./Src/FinalProjectSTMToArduino.o ./Src/FinalProjectSTMToArduino.su
+	-$(RM) ./Src/FinalProjectSTMToArduino.cyclo ./Src/FinalProjectSTMToArduino.d ./Src/FinalProjectSTMToArduino.o ./Src/FinalProjectSTMToArduino.su ./Src/syscalls.cyclo ./Src/syscalls.d ./Src/syscalls.o ./Src/syscalls.su ./Src/sysmem.cyclo ./Src/sysmem.d ./Src/sysmem.o ./Src/sysmem.su
 
 .PHONY: clean-Src
 
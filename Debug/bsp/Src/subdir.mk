@@ -5,23 +5,26 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../bsp/Src/ds18b20_temp_sensor.c 
+../bsp/Src/ds18b20_temp_sensor.c \
+../bsp/Src/water_quality_sensors.c 
 
 OBJS += \
-./bsp/Src/ds18b20_temp_sensor.o 
+./bsp/Src/ds18b20_temp_sensor.o \
+./bsp/Src/water_quality_sensors.o 
 
 C_DEPS += \
-./bsp/Src/ds18b20_temp_sensor.d 
+./bsp/Src/ds18b20_temp_sensor.d \
+./bsp/Src/water_quality_sensors.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 bsp/Src/%.o bsp/Src/%.su bsp/Src/%.cyclo: ../bsp/Src/%.c bsp/Src/subdir.mk
-	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DSTM32 -DSTM32F407G_DISC1 -DSTM32F4 -DSTM32F407VGTx -c -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/drivers/Inc" -I../Inc -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/bsp/Inc" -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=soft -mthumb -o "$@"
+	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DSTM32 -DSTM32F407G_DISC1 -DSTM32F4 -DSTM32F407VGTx -c -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/drivers/Inc" -I../Inc -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/bsp/Inc" -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=hard -mthumb -o "$@"
 
 clean: clean-bsp-2f-Src
 
 clean-bsp-2f-Src:
-	-$(RM) ./bsp/Src/ds18b20_temp_sensor.cyclo ./bsp/Src/ds18b20_temp_sensor.d ./bsp/Src/ds18b20_temp_sensor.o ./bsp/Src/ds18b20_temp_sensor.su
+	-$(RM) ./bsp/Src/ds18b20_temp_sensor.cyclo ./bsp/Src/ds18b20_temp_sensor.d ./bsp/Src/ds18b20_temp_sensor.o ./bsp/Src/ds18b20_temp_sensor.su ./bsp/Src/water_quality_sensors.cyclo ./bsp/Src/water_quality_sensors.d ./bsp/Src/water_quality_sensors.o ./bsp/Src/water_quality_sensors.su
 
 .PHONY: clean-bsp-2f-Src
 
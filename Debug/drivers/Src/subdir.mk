@@ -6,40 +6,67 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../drivers/Src/stm32f407vg_adc_driver.c \
+../drivers/Src/stm32f407vg_adc_oversampling.c \
+../drivers/Src/stm32f407vg_dma_driver.c \
 ../drivers/Src/stm32f407vg_gpio_driver.c \
 ../drivers/Src/stm32f407vg_i2c_driver.c \
+../drivers/Src/stm32f407vg_i2c_txqueue.c \
+../drivers/Src/stm32f407vg_profiler.c \
+../drivers/Src/stm32f407vg_pwr_driver.c \
 ../drivers/Src/stm32f407vg_rcc_driver.c \
 ../drivers/Src/stm32f407vg_spi_driver.c \
+../drivers/Src/stm32f407vg_spsc_ring.c \
+../drivers/Src/stm32f407vg_sw_timer.c \
+../drivers/Src/stm32f407vg_telemetry.c \
 ../drivers/Src/stm32f407vg_tim_driver.c \
-../drivers/Src/stm32f407vg_usart_driver.c 
+../drivers/Src/stm32f407vg_usart_driver.c \
+../drivers/Src/stm32f407vg_usart_log.c 
 
 OBJS += \
 ./drivers/Src/stm32f407vg_adc_driver.o \
+./drivers/Src/stm32f407vg_adc_oversampling.o \
+./drivers/Src/stm32f407vg_dma_driver.o \
 ./drivers/Src/stm32f407vg_gpio_driver.o \
 ./drivers/Src/stm32f407vg_i2c_driver.o \
+./drivers/Src/stm32f407vg_i2c_txqueue.o \
+./drivers/Src/stm32f407vg_profiler.o \
+./drivers/Src/stm32f407vg_pwr_driver.o \
 ./drivers/Src/stm32f407vg_rcc_driver.o \
 ./drivers/Src/stm32f407vg_spi_driver.o \
+./drivers/Src/stm32f407vg_spsc_ring.o \
+./drivers/Src/stm32f407vg_sw_timer.o \
+./drivers/Src/stm32f407vg_telemetry.o \
 ./drivers/Src/stm32f407vg_tim_driver.o \
-./drivers/Src/stm32f407vg_usart_driver.o 
+./drivers/Src/stm32f407vg_usart_driver.o \
+./drivers/Src/stm32f407vg_usart_log.o 
 
 C_DEPS += \
 ./drivers/Src/stm32f407vg_adc_driver.d \
+./drivers/Src/stm32f407vg_adc_oversampling.d \
+./drivers/Src/stm32f407vg_dma_driver.d \
 ./drivers/Src/stm32f407vg_gpio_driver.d \
 ./drivers/Src/stm32f407vg_i2c_driver.d \
+./drivers/Src/stm32f407vg_i2c_txqueue.d \
+./drivers/Src/stm32f407vg_profiler.d \
+./drivers/Src/stm32f407vg_pwr_driver.d \
 ./drivers/Src/stm32f407vg_rcc_driver.d \
 ./drivers/Src/stm32f407vg_spi_driver.d \
+./drivers/Src/stm32f407vg_spsc_ring.d \
+./drivers/Src/stm32f407vg_sw_timer.d \
+./drivers/Src/stm32f407vg_telemetry.d \
 ./drivers/Src/stm32f407vg_tim_driver.d \
-./drivers/Src/stm32f407vg_usart_driver.d 
+./drivers/Src/stm32f407vg_usart_driver.d \
+./drivers/Src/stm32f407vg_usart_log.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 drivers/Src/%.o drivers/Src/%.su drivers/Src/%.cyclo: ../drivers/Src/%.c drivers/Src/subdir.mk
-	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DSTM32 -DSTM32F407G_DISC1 -DSTM32F4 -DSTM32F407VGTx -c -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/drivers/Inc" -I../Inc -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/bsp/Inc" -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=soft -mthumb -o "$@"
+	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DSTM32 -DSTM32F407G_DISC1 -DSTM32F4 -DSTM32F407VGTx -c -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/drivers/Inc" -I../Inc -I"C:/Users/butle/OneDrive/Documents/MCU1-Course/MCU1/stm32f407_drivers/bsp/Inc" -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=hard -mthumb -o "$@"
 
 clean: clean-drivers-2f-Src
 
 clean-drivers-2f-Src:
-	-$(RM) ./drivers/Src/stm32f407vg_adc_driver.cyclo ./drivers/Src/stm32f407vg_adc_driver.d ./drivers/Src/stm32f407vg_adc_driver.o ./drivers/Src/stm32f407vg_adc_driver.su ./drivers/Src/stm32f407vg_gpio_driver.cyclo ./drivers/Src/stm32f407vg_gpio_driver.d ./drivers/Src/stm32f407vg_gpio_driver.o ./drivers/Src/stm32f407vg_gpio_driver.su ./drivers/Src/stm32f407vg_i2c_driver.cyclo ./drivers/Src/stm32f407vg_i2c_driver.d ./drivers/Src/stm32f407vg_i2c_driver.o ./drivers/Src/stm32f407vg_i2c_driver.su ./drivers/Src/stm32f407vg_rcc_driver.cyclo ./drivers/Src/stm32f407vg_rcc_driver.d ./drivers/Src/stm32f407vg_rcc_driver.o ./drivers/Src/stm32f407vg_rcc_driver.su ./drivers/Src/stm32f407vg_spi_driver.cyclo ./drivers/Src/stm32f407vg_spi_driver.d ./drivers/Src/stm32f407vg_spi_driver.o ./drivers/Src/stm32f407vg_spi_driver.su ./drivers/Src/stm32f407vg_tim_driver.cyclo ./drivers/Src/stm32f407vg_tim_driver.d ./drivers/Src/stm32f407vg_tim_driver.o ./drivers/Src/stm32f407vg_tim_driver.su ./drivers/Src/stm32f407vg_usart_driver.cyclo ./drivers/Src/stm32f407vg_usart_driver.d ./drivers/Src/stm32f407vg_usart_driver.o ./drivers/Src/stm32f407vg_usart_driver.su
+	-$(RM) ./drivers/Src/stm32f407vg_adc_driver.cyclo ./drivers/Src/stm32f407vg_adc_driver.d ./drivers/Src/stm32f407vg_adc_driver.o ./drivers/Src/stm32f407vg_adc_driver.su ./drivers/Src/stm32f407vg_adc_oversampling.cyclo ./drivers/Src/stm32f407vg_adc_oversampling.d ./drivers/Src/stm32f407vg_adc_oversampling.o ./drivers/Src/stm32f407vg_adc_oversampling.su ./drivers/Src/stm32f407vg_dma_driver.cyclo ./drivers/Src/stm32f407vg_dma_driver.d ./drivers/Src/stm32f407vg_dma_driver.o ./drivers/Src/stm32f407vg_dma_driver.su ./drivers/Src/stm32f407vg_gpio_driver.cyclo ./drivers/Src/stm32f407vg_gpio_driver.d ./drivers/Src/stm32f407vg_gpio_driver.o ./drivers/Src/stm32f407vg_gpio_driver.su ./drivers/Src/stm32f407vg_i2c_driver.cyclo ./drivers/Src/stm32f407vg_i2c_driver.d ./drivers/Src/stm32f407vg_i2c_driver.o ./drivers/Src/stm32f407vg_i2c_driver.su ./drivers/Src/stm32f407vg_i2c_txqueue.cyclo ./drivers/Src/stm32f407vg_i2c_txqueue.d ./drivers/Src/stm32f407vg_i2c_txqueue.o ./drivers/Src/stm32f407vg_i2c_txqueue.su ./drivers/Src/stm32f407vg_profiler.cyclo ./drivers/Src/stm32f407vg_profiler.d ./drivers/Src/stm32f407vg_profiler.o ./drivers/Src/stm32f407vg_profiler.su ./drivers/Src/stm32f407vg_pwr_driver.cyclo ./drivers/Src/stm32f407vg_pwr_driver.d ./drivers/Src/stm32f407vg_pwr_driver.o ./drivers/Src/stm32f407vg_pwr_driver.su ./drivers/Src/stm32f407vg_rcc_driver.cyclo ./drivers/Src/stm32f407vg_rcc_driver.d ./drivers/Src/stm32f407vg_rcc_driver.o ./drivers/Src/stm32f407vg_rcc_driver.su ./drivers/Src/stm32f407vg_spi_driver.cyclo ./drivers/Src/stm32f407vg_spi_driver.d ./drivers/Src/stm32f407vg_spi_driver.o ./drivers/Src/stm32f407vg_spi_driver.su ./drivers/Src/stm32f407vg_spsc_ring.cyclo ./drivers/Src/stm32f407vg_spsc_ring.d ./drivers/Src/stm32f407vg_spsc_ring.o ./drivers/Src/stm32f407vg_spsc_ring.su ./drivers/Src/stm32f407vg_sw_timer.cyclo ./drivers/Src/stm32f407vg_sw_timer.d ./drivers/Src/stm32f407vg_sw_timer.o ./drivers/Src/stm32f407vg_sw_timer.su ./drivers/Src/stm32f407vg_telemetry.cyclo ./drivers/Src/stm32f407vg_telemetry.d ./drivers/Src/stm32f407vg_telemetry.o ./drivers/Src/stm32f407vg_telemetry.su ./drivers/Src/stm32f407vg_tim_driver.cyclo ./drivers/Src/stm32f407vg_tim_driver.d ./drivers/Src/stm32f407vg_tim_driver.o ./drivers/Src/stm32f407vg_tim_driver.su ./drivers/Src/stm32f407vg_usart_driver.cyclo ./drivers/Src/stm32f407vg_usart_driver.d ./drivers/Src/stm32f407vg_usart_driver.o ./drivers/Src/stm32f407vg_usart_driver.su ./drivers/Src/stm32f407vg_usart_log.cyclo ./drivers/Src/stm32f407vg_usart_log.d ./drivers/Src/stm32f407vg_usart_log.o ./drivers/Src/stm32f407vg_usart_log.su
 
 .PHONY: clean-drivers-2f-Src
 
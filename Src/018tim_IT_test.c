@@ -32,7 +32,7 @@ int main(void)
 
 	//TIM2 counter init
 	//freq = 0.0167 is equivalent to 1 trigger every minute
-	double freq = 0.0167;
+	float freq = 0.0167f;
 
 	TIM2_5_SetIT(TIM2, freq);
 
@@ -14,7 +14,7 @@
  * 3. When TIM2 timer interrupt is generated, read ADC value and store in user variable
  *
  * Can use 0V and 3V pins to test the ADC - this should give you 0 and 4096 digital values if using 12-bit resolution
- * NOTE: DISABLE HARDWARE FPU OR ELSE CRITICAL FAULT OCCURS AND PROGRAM WILL NOT WORK
+ * NOTE: Hardware FPU is enabled in Reset_Handler (startup file) - float math here is single precision, keep literals suffixed with f
  */
 
 
@@ -85,7 +85,7 @@ int main(void)
 	while(1)
 	{
 		//Voltage calculation
-		volts = ( ( UserData / 4095.0 ) * 3.3 );
+		volts = ( ( UserData / 4095.0f ) * 3.3f );
 
 		printf("The ADC DR is currently reading a value of %d, or %fV\n", UserData, volts);
 	}
@@ -118,7 +118,7 @@ void ADC_ApplicationEventCallBack(ADC_Handle_t *pADCHandle, uint8_t AppEvent)
 			printf("Analog watch dog triggered - under voltage condition detected.\n");
 		}
 
-		volts = ( ( UserData / 4095.0 ) * 3.3 );
+		volts = ( ( UserData / 4095.0f ) * 3.3f );
 
 		printf("\nCurrent voltage reading: %f\n\n", volts);
 
@@ -94,7 +94,7 @@ int main(void)
 	while(1)
 	{
 		//Voltage calculation
-		volts = ( ( UserData / 4095.0 ) * 3.3 );
+		volts = ( ( UserData / 4095.0f ) * 3.3f );
 
 		printf("The ADC DR is currently reading a value of %d, or %fV\n", UserData, volts );
 	}
@@ -127,7 +127,7 @@ void ADC_ApplicationEventCallBack(ADC_Handle_t *pADCHandle, uint8_t AppEvent)
 			printf("Analog watch dog triggered - under voltage condition detected.\n");
 		}
 
-		volts = ( ( UserData / 4095.0 ) * 3.3 );
+		volts = ( ( UserData / 4095.0f ) * 3.3f );
 
 		printf("\nCurrent voltage reading: %f\n\n", volts);
 
@@ -15,6 +15,7 @@
 #include "ds18b20_temp_sensor.h"
 
 uint8_t TempBuffer[2];
+uint8_t Scratchpad[DS18B20_SCRATCHPAD_LEN];
 uint8_t TxBuf;
 float Temperature;
 
@@ -29,6 +30,9 @@ int main(void)
 
 	DS18B20_Config();
 
+	//TIM5 is the 1-wire time base once DS18B20_Config is called - use TIM2 for the delay in-between readings
+	TIM2_5_SetDelayInit(TIM2);
+
 	while(1)
 	{
 		//1. Master initiates communication sequence (Master Tx) and waits for presence pulse from DS18B20 (Master Rx)
@@ -47,28 +51,22 @@ int main(void)
 		while( !DS18B20_MasterGenerateReadTimeSlot() )
 			;
 
-		//6. Master initiates another communication sequence (Master Tx) and waits for presence pulse from DS18B20 (Master Rx)
-		DS18B20_MasterSendInitializeSequence();
-
-		//7. Master sends skip ROM command since there is only 1 slave on bus (Master Tx)
-		TxBuf = MASTER_COMMAND_SKIP_ROM;
-		DS18B20_MasterSendData( &TxBuf , 1);
-
-		//8. Master sends read scratch pad command (Master Tx)
-		TxBuf = MASTER_COMMAND_READ_SCRATCHPAD;
-		DS18B20_MasterSendData( &TxBuf , 1);
-
-		//9. Master waits until 2 bytes of data have been sent (Master Rx)
-		DS18B20_MasterReceiveData(TempBuffer, 2);
-
-		//10. Master sends a reset pulse to stop reading scratch pad (the temperature is only the first 2 bytes) is (Master Tx)
-		DS18B20_MasterSendInitializeSequence();
-
-		//11. Program displays temperature onto console
-		Temperature = DS18B20_ConvertTemp(TempBuffer);
-		printf("The temperature in my room is currently %f degrees C\n", Temperature);
-
-		//12. Wait some seconds to do it again ad infinitum
-		TIM2_5_Delay(TIM5, 2000000);
+		//6. Master resets the bus, sends skip ROM + read scratch pad, then reads all 9 bytes and checks them against their CRC-8,
+		//	 reading again on a mismatch (Master Tx / Rx)
+		if( DS18B20_MasterReadScratchpad(Scratchpad) != DS18B20_EVENT_TRANSFER_CMPLT )
+		{
+			printf("Scratch pad failed CRC - reading skipped\n");
+		}
+		else
+		{
+			//7. Program displays temperature onto console - temperature is the first 2 bytes, LSB first
+			TempBuffer[0] = Scratchpad[1];
+			TempBuffer[1] = Scratchpad[0];
+			Temperature = DS18B20_ConvertTemp(TempBuffer);
+			printf("The temperature in my room is currently %f degrees C\n", Temperature);
+		}
+
+		//8. Wait some seconds to do it again ad infinitum
+		TIM2_5_Delay(TIM2, 2000000);
 	}
 }
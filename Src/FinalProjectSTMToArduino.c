@@ -14,6 +14,8 @@
  * 			VCC <-> 3.3V
  * 			GND <-> GND
  * 			DQ <-> PA3 (STM32) (hanging off 4.7kOhm pull up resistor connected to +Vdd)
+ * 			More probes can share the bus (DQ of every probe on PA3) - they are found by a ROM search at start up
+ * 			Built with -DDS18B20_TRANSPORT=DS18B20_TRANSPORT_USART the bus is driven by USART2 instead - DQ <-> PD5
  *
  * 		TDS sensor
  * 			VCC <-> 3.3V
@@ -30,6 +32,9 @@
  *			PA1 <-> Analog output of TDS sensor
  *			PB6 <-> SCLK (i2c to Arduino) ~~~ Use 5V to 3.3V logic level converter to interface between the 2 boards~~~
  *			PB7 <-> SDA (i2c to Arduino) ~~~ Use 5V to 3.3V logic level converter to interface between the 2 boards~~~
+ *			PD8 <-> RX of a 3.3V USB-serial adapter (USART3 TX log, 115200 8N1)
+ *			PC6 <-> RX of a 3.3V USB-serial adapter (USART6 TX binary telemetry, 460800 8N1 - decode with host/tlm_decode)
+ *			PD12 <-> Green LED of the Discovery board (heartbeat, toggled by a software timer)
  *
  *		Arduino
  *			A5 <-> SCLK ~~~ Use 5V to 3.3V logic level converter to interface between the 2 boards~~~
@@ -47,64 +52,209 @@
 
 #include "stm32f407vg.h"
 #include "ds18b20_temp_sensor.h"
+#include "stm32f407vg_adc_oversampling.h"
+#include "water_quality_sensors.h"
+#include "stm32f407vg_i2c_txqueue.h"
+#include "stm32f407vg_profiler.h"
+#include "stm32f407vg_spsc_ring.h"
+#include "stm32f407vg_usart_log.h"
+#include "stm32f407vg_telemetry.h"
+#include "stm32f407vg_sw_timer.h"
+#include "stm32f407vg_pwr_driver.h"
 
 #define NUM_OF_ANALOG_CONVERSIONS				2				//TDS and Turbidity
+#define SAMPLE_PERIOD_USECS						1333333			//TIM2 update (ADC trigger) period - 0.75Hz
+#define ADC_OVERSAMPLING_RATIO					16				//Conversions per channel per TIM2 tick - 16x gives 14 bits in enhance mode
+#define ADC_BURST_BUFFER_LEN					( ADC_OVERSAMPLING_RATIO * NUM_OF_ANALOG_CONVERSIONS )	//One burst of sequences per trigger
+#define ADC_BURST_DMA_WORDS						( ADC_BURST_BUFFER_LEN / 2 )	//Dual mode: DMA2 stream 0 moves one ADC_CDR word (TDS and turbidity) per transfer
+#define TEMPERATURE_MAX_AGE_USECS				3000000			//Oldest temperature reading still trusted for TDS compensation (~2 sample periods)
+#define TEMPERATURE_RESOLUTION					DS18B20_RESOLUTION_12_BIT	//750ms conversion fits the sample period - 9-bit (94ms) for sample periods down to ~100ms
+#define TEMPERATURE_ALARM_HIGH_C				35				//Probes found by an alarm search - water warmer than this
+#define TEMPERATURE_ALARM_LOW_C					2				//or colder than this
+#define ARDUINO_TXQ_POLICY						I2C_TXQ_POLICY_COALESCE		//Arduino only needs the latest readings - a late frame is replaced, not queued behind
+#define PROFILE_REPORT_PERIOD					10				//Readings between two ISR timing reports
+#define SAMPLE_RING_CAPACITY					8				//Readings the main loop can fall behind by (power of two) - ~10s at 0.75Hz
+#define CONSOLE_LOG_POLICY						USART_LOG_POLICY_DROP		//printf never waits on the USART - a line that doesn't fit is dropped (counted)
+#define SOFT_TIMER_CHANNEL						TIM_CHANNEL_2	//Software timer wheel shares the 1-wire time base (TIM5, 1us) on its second compare channel
+#define HEARTBEAT_PERIOD_USECS					500000			//Heartbeat LED toggle period - 1Hz blink
+#define CONSOLE_READINGS						1				//Print every reading as text - set to 0 once a telemetry logger is attached (saves the float printf)
+#define IDLE_MIN_STOP_USECS						10000			//Idle periods shorter than this are spent in Sleep
+#define IDLE_WAKEUP_USECS						3000			//STOP exit, HSE start-up and PLL lock, with margin - STOP ends this early
+
+/*
+ * One processed reading - handed from the DMA2 stream 0 ISR to the main loop through SampleRing
+ */
+typedef struct
+{
+	uint32_t 		Timestamp;									/* 1-wire time base (us) when the reading was processed */
+	uint32_t 		TemperatureAgeUsecs;						/* Age of the temperature used for TDS compensation */
+	WQ_Readings_t 	Readings;									/* Converted readings */
+	uint8_t 		Frame[6];									/* Bytes queued for the Arduino */
+	uint8_t 		TemperatureValid;							/* 1 if Readings were compensated with the measured temperature */
+}WQ_Sample_t;
 
 ADC_Handle_t pADC1Handle;
+ADC_Handle_t pADC2Handle;
+DMA_Handle_t ADC1DMAHandle;
+ADC_OVS_Handle_t ADC1OVSHandle;
 GPIO_Handle_t pGPIOAHandle;
 GPIO_Handle_t GPIOi2cPins;
 I2C_Handle_t i2c1;
+DMA_Handle_t I2C1TxDMAHandle;
+I2C_TXQ_Handle_t ArduinoTxQueue;
+GPIO_Handle_t GPIOLogPin;
+USART_Handle_t usart3;
+DMA_Handle_t USART3TxDMAHandle;
+USART_LOG_Handle_t ConsoleLog;
+GPIO_Handle_t GPIOTelemetryPin;
+USART_Handle_t usart6;
+DMA_Handle_t USART6TxDMAHandle;
+USART_LOG_Handle_t TelemetryLog;
+TLM_Handle_t TelemetryStream;
+GPIO_Handle_t GPIOHeartbeatPin;
+SWT_Handle_t SoftTimers;
+SWT_Timer_t HeartbeatTimer;
+RCC_Config_t RunClockConfig;
+PWR_Handle_t PowerManager;
 
 //1-wire DSB18B20 global variables
 uint8_t BufferOneWireRawTemperature[2];
-uint8_t BufferOneWireCommands;
-float Temperature = 0;
+uint8_t BufferProbeTemperatures[DS18B20_MAX_DEVICES * 2];	//Raw temperature of each probe found by the ROM search (probe 0 first)
+__vo int16_t TemperatureRaw = 0;				//Last good DS18B20 temperature register (°C * 16)
+__vo uint32_t TemperatureTimestamp;				//When the conversion behind TemperatureRaw was started (1-wire time base, us)
+__vo uint32_t TemperatureAgeUsecs;				//Age of TemperatureRaw when it was last used for TDS compensation
+__vo uint8_t TemperatureValid = 0;
+__vo uint32_t OneWireSearchErrors = 0;			//ROM / alarm searches that ended in DS18B20_ERROR_SEARCH
 
-//Common ADC global variables
-uint16_t BufferADCValues[NUM_OF_ANALOG_CONVERSIONS] = {0,0};
-__vo uint8_t ADCSequenceIndex = 1;
+//Common ADC global variables - burst written by DMA2 stream 0 from ADC_CDR, ADC1 then ADC2: | TDS | Turbidity | TDS | Turbidity | ...
+//Word aligned - the stream moves whole ADC_CDR words (DMA mode 2)
+uint16_t BufferADCValues[ADC_BURST_BUFFER_LEN] __attribute__((aligned(4))) = {0};
 
-//TDS ADC global variables
-__vo uint16_t BufferADCTDSValue;
-__vo float VoltsTDS;
-__vo uint16_t TDS = 0;
-__vo float TDSTemperatureCompensationCoefficient;
+//Converted readings - integer units sent to the Arduino (ppm, tenths of %, hundredths of °C). Only the main loop turns them into floats for display
+WQ_RawReadings_t WaterQualityRaw;
+WQ_Readings_t WaterQualityReadings;
 
 //i2c global variables
 uint8_t BufferDataToArduino[6];
 uint8_t SlaveAddr = 0x68;
 uint8_t Len;
 
-//Turbidity global variables
-__vo uint16_t BufferADCTurbidityValue;
-__vo float VoltsTurbidity;
-__vo float Turbidity = 0;
+//Readings waiting to be displayed - DMA2 stream 0 ISR is the only producer, the main loop the only consumer
+WQ_Sample_t SampleRingBuffer[SAMPLE_RING_CAPACITY];
+RING_Handle_t SampleRing;
 
-//New values ready to display flag
-__vo uint8_t NewValuesReady = 0;
+//ISR timing
+PROF_SITE_DEFINE(TIM2_IRQHandler);
+PROF_SITE_DEFINE(TIM5_IRQHandler);
+PROF_SITE_DEFINE(ADC_IRQHandler);
+PROF_SITE_DEFINE(DMA2_Stream0_IRQHandler);
+PROF_SITE_DEFINE(DMA1_Stream7_IRQHandler);
 
-extern void initialise_monitor_handles(void);
 void I2C_MasterSendDataToArduino(void);
-void DS18B20_MasterGetTemperature(uint8_t *BufferCommands, uint8_t *BufferReceiveTemperature);
+void initialize_clocks(void);
+void initialize_log(void);
+void initialize_telemetry(void);
+void SendSampleTelemetry(const WQ_Sample_t *pSample);
 void initialize_i2c(void);
 void initialize_GPIO(void);
 void initialize_ADC(void);
-uint16_t TDS_ConvertVoltageToPPM(__vo float Voltage, __vo float TemperatureCompensation);
-uint16_t TDS_CalibratePPM(uint16_t UncalibratedTDSPPM);
-float Turbidity_ConvertVoltageToPercentage(__vo float Voltage);
-void I2C_ConvertTurbidityPercentageToBytes(float TurbidityPercentage, uint8_t *Bufferi2c);
+void initialize_soft_timers(void);
+void HeartbeatCallback(void *pContext);
+void initialize_power(void);
+void initialize_application(void);
+void ProcessWaterQualityReadings(void);
+void I2C_ConvertTurbidityPercentageToBytes(uint16_t TurbidityTenths, uint8_t *Bufferi2c);
 void I2C_ConvertTDSPPMToBytes(uint16_t TDSPPM, uint8_t *Bufferi2c);
 
 int main(void)
 {
-	/************************ Semi-hosting INIT ***************/
-	initialise_monitor_handles();
+	initialize_application();
+
+	uint32_t Reports = 0;
+	WQ_Sample_t Sample;
+
+	while(1)
+	{
+		//When TIM2 interrupt is triggered, the ISR reads the temperature converted since the last tick and starts the next conversion (pipelined). TIM5 paces the 1-wire bus
+			//The same TIM2 update event starts ADC1 (TDS) and ADC2 (turbidity) together through TRGO (no software in the sampling path)
+			//DMA2 stream 0 copies a burst of 16 simultaneous pairs (TDS, turbidity) into BufferADCValues. Its transfer complete ISR decimates the burst, processes the readings and queues the i2c message to the arduino (sent in the background by I2C1 events and DMA1 stream 7)
+
+		//While not in an ISR every reading is printed from its own copy - the ISR can keep producing while a slow printf runs
+			//Nothing to print - wait in STOP (or Sleep) until the next interrupt. The ring is checked again with interrupts masked, so a reading put in just before can't be slept on
+		while( RING_Get(&SampleRing, &Sample) != RING_OK )
+		{
+			uint32_t primask;
+
+			CRITICAL_SECTION_ENTER(primask);
+
+			if( RING_GetCount(&SampleRing) == 0 )
+			{
+				PWR_Idle(&PowerManager);
+			}
+
+			CRITICAL_SECTION_EXIT(primask);
+		}
+
+		SendSampleTelemetry(&Sample);
+
+#if CONSOLE_READINGS
+		printf("Sent:  | 0x%X | 0x%X | 0x%X | 0x%X | 0x%X | 0x%X |   at %lums\n", Sample.Frame[0], Sample.Frame[1], Sample.Frame[2], Sample.Frame[3], Sample.Frame[4], Sample.Frame[5], (unsigned long)( Sample.Timestamp / 1000 ) );
+		printf("Current water readings: Temp - %.2f°C (%lums old)   TDS - %dppm   Turbidity - %.2f%% \n", Sample.Readings.TemperatureCentiDeg / 100.0f, (unsigned long)( Sample.TemperatureAgeUsecs / 1000 ), Sample.Readings.TDSppm, Sample.Readings.TurbidityTenths / 10.0f);
+		printf("Oversampling cost: TDS - %lu cycles (%d bits)   Turbidity - %lu cycles (%d bits)\n", (unsigned long) ADC1OVSHandle.Cycles[0], ADC1OVSHandle.ResultBits[0], (unsigned long) ADC1OVSHandle.Cycles[1], ADC1OVSHandle.ResultBits[1]);
+		printf("i2c queue: %d pending   %lu sent   %lu coalesced   %lu dropped   %lu errors\n", I2C_TXQ_GetCount(&ArduinoTxQueue), (unsigned long) ArduinoTxQueue.Sent, (unsigned long) ArduinoTxQueue.Coalesced, (unsigned long) ArduinoTxQueue.Dropped, (unsigned long) ArduinoTxQueue.Errors);
+
+		printf("Sample ring: %d waiting   %d high water   %lu overflows\n", RING_GetCount(&SampleRing), SampleRing.HighWater, (unsigned long) SampleRing.Overflows);
+		printf("Log: %d pending   %d high water   %lu dropped   telemetry %lu dropped\n", USART_LOG_GetCount(&ConsoleLog), ConsoleLog.HighWater, (unsigned long) ConsoleLog.Dropped, (unsigned long) TelemetryLog.Dropped);
+		printf("Power: run %lums   sleep %lums   stop %lums (%lu entries, %lu vetoed, %lu late)\n", (unsigned long) ( PWR_GetStateUsecs(&PowerManager, PWR_STATE_RUN) / 1000 ), (unsigned long) ( PWR_GetStateUsecs(&PowerManager, PWR_STATE_SLEEP) / 1000 ), (unsigned long) ( PWR_GetStateUsecs(&PowerManager, PWR_STATE_STOP) / 1000 ), (unsigned long) PowerManager.Entries[PWR_STATE_STOP], (unsigned long) PowerManager.StopVetoes, (unsigned long) PowerManager.LateWakeups);
+#endif
+
+		if( ++Reports >= PROFILE_REPORT_PERIOD )
+		{
+			Reports = 0;
+			PROF_Dump(NULL);
+		}
+	}
+}
+
+
+
+void initialize_application(void)
+{
+	/************************ CLOCK INIT ***************/
+	initialize_clocks();												//First - every driver below reads the bus clocks when it is initialized
+
+	/************************ LOG INIT ***************/
+	initialize_log();
+
+	USART_IRQInterruptConfig(IRQ_NO_USART3, ENABLE);
+	USART_IRQPriorityConfig(IRQ_NO_USART3, NVIC_IRQ_PRIO_3 );			//Text only - below sampling, like the i2c bus
+
+	DMA_IRQInterruptConfig(IRQ_NO_DMA1_STREAM3, ENABLE);
+	DMA_IRQPriorityConfig(IRQ_NO_DMA1_STREAM3, NVIC_IRQ_PRIO_3 );
 
 	printf("Application starting...\n");
 
+	/************************ TELEMETRY INIT ***************/
+	initialize_telemetry();
+
+	USART_IRQInterruptConfig(IRQ_NO_USART6, ENABLE);
+	USART_IRQPriorityConfig(IRQ_NO_USART6, NVIC_IRQ_PRIO_3 );
+
+	DMA_IRQInterruptConfig(IRQ_NO_DMA2_STREAM6, ENABLE);
+	DMA_IRQPriorityConfig(IRQ_NO_DMA2_STREAM6, NVIC_IRQ_PRIO_3 );
+
+	/************************ PROFILER INIT ***************/
+	PROF_Init();
+
+	/************************ SAMPLE RING INIT ***************/
+	RING_Init(&SampleRing, SampleRingBuffer, sizeof(WQ_Sample_t), SAMPLE_RING_CAPACITY);
+
 	/************************ DS18B20 INIT ***************/
 	DS18B20_Config();
 
+	/************************ SOFTWARE TIMER INIT ***************/
+	initialize_soft_timers();											//After DS18B20 - the wheel runs on the 1-wire time base
+
 	/************************ GPIO INIT ***************/
 	initialize_GPIO();
 
@@ -114,32 +264,57 @@ int main(void)
 	/************************ i2c INIT ***************/
 	initialize_i2c();
 
+	I2C_IRQInterruptConfig(IRQ_NO_I2C1_EV, ENABLE);
+	I2C_IRQPriorityConfig(IRQ_NO_I2C1_EV, NVIC_IRQ_PRIO_3 );			//Bus runs in the background, below sampling
+
+	I2C_IRQInterruptConfig(IRQ_NO_I2C1_ER, ENABLE);
+	I2C_IRQPriorityConfig(IRQ_NO_I2C1_ER, NVIC_IRQ_PRIO_3 );
+
+	DMA_IRQInterruptConfig(IRQ_NO_DMA1_STREAM7, ENABLE);
+	DMA_IRQPriorityConfig(IRQ_NO_DMA1_STREAM7, NVIC_IRQ_PRIO_3 );
+
 	/************************ ADC INTERRUPT INIT ***************/
 	ADC_IRQInterruptConfig(IRQ_NO_ADC, ENABLE);
 	ADC_IRQPriorityConfig(IRQ_NO_ADC, NVIC_IRQ_PRIO_1 );
 
+	DMA_IRQInterruptConfig(IRQ_NO_DMA2_STREAM0, ENABLE);
+	DMA_IRQPriorityConfig(IRQ_NO_DMA2_STREAM0, NVIC_IRQ_PRIO_1 );
+
+	/************************ ADC OVERSAMPLING START ***************/
+	ADC_OVS_Init(&ADC1OVSHandle, BufferADCValues, ADC_BURST_BUFFER_LEN);
+
 	/************************ TIM INTERRUPT INIT ***************/
+	TIM2_5_IRQInterruptConfig(IRQ_NO_TIM5, ENABLE );
+	TIM2_5_IRQPriorityConfig(IRQ_NO_TIM5, NVIC_IRQ_PRIO_0 );			//1-wire time slots have the tightest timing requirements
+
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	DMA_IRQInterruptConfig(DS18B20_USART_DMA_RX_IRQ, ENABLE);
+	DMA_IRQPriorityConfig(DS18B20_USART_DMA_RX_IRQ, NVIC_IRQ_PRIO_0 );	//Next run of time slots is set up from here
+#endif
+
+	//Find the probes on the 1-wire bus - done long before the first TIM2 tick reads them
+	DS18B20_MasterSearchROMIT(MASTER_COMMAND_SEARCH_ROM);
+
 	TIM2_5_IRQInterruptConfig(IRQ_NO_TIM2, ENABLE );
 	TIM2_5_IRQPriorityConfig(IRQ_NO_TIM2, NVIC_IRQ_PRIO_2 );
 
 
-	float freq = 0.75;
-	TIM2_5_SetIT(TIM2, freq);
+	//TIM2 update event also drives TRGO, which starts the ADC scan at the exact same instant every period
+	TIM2_5_MasterModeConfig(TIM2, TIM_TRGO_UPDATE);
 
-	while(1)
+	if( TIM2_5_SetPeriodIT(TIM2, SAMPLE_PERIOD_USECS, TIM_UNIT_US) != TIM_OK )
 	{
-		//When TIM2 interrupt is triggered, the ISR handles retrieving temperature reading and enables ADC
-			//When ADC ISR is triggered, it handles retrieving DR value from analog pin (TDS). It also handles i2c communications to arduino
+		printf("TIM2 can't make a %lu us period\n", (unsigned long) SAMPLE_PERIOD_USECS);
+	}
 
-		//While not in an ISR values print to console every so often
-		while( !NewValuesReady )
-				;
+	//Periodic chores that don't need a hardware timer of their own run from the software timer wheel (TIM5 IRQ)
+	SWT_Start(&SoftTimers, &HeartbeatTimer, HEARTBEAT_PERIOD_USECS, HEARTBEAT_PERIOD_USECS, HeartbeatCallback, NULL);
 
-		NewValuesReady = 0;
+	/************************ POWER INIT ***************/
+	initialize_power();													//Last - plans STOP around the TIM2/TIM5 events set up above
 
-		printf("Sent:  | 0x%X | 0x%X | 0x%X | 0x%X | 0x%X | 0x%X |\n", BufferDataToArduino[0], BufferDataToArduino[1], BufferDataToArduino[2], BufferDataToArduino[3], BufferDataToArduino[4], BufferDataToArduino[5] );
-		printf("Current water readings: Temp - %.2f°C   TDS - %dppm   Turbidity - %.2f%% \n", Temperature, TDS, Turbidity);
-	}
+	PWR_IRQInterruptConfig(IRQ_NO_RTC_WKUP, ENABLE);
+	PWR_IRQPriorityConfig(IRQ_NO_RTC_WKUP, NVIC_IRQ_PRIO_3 );
 }
 
 
@@ -147,57 +322,99 @@ int main(void)
 
 void TIM2_IRQHandler(void)
 {
+	PROF_ENTER(TIM2_IRQHandler);
+
 	TIM2_5_IRQHandling(TIM2);
 
-	//1. Get Temperature From DS18B20
-	DS18B20_MasterGetTemperature(&BufferOneWireCommands, BufferOneWireRawTemperature);
+	//1. Read temperature converted since the last tick and start the next conversion - the rest is handled in DS18B20_ApplicationEventCallBack
+	//	 Several probes: one Convert T for all of them, then each one is read by its ROM
+	if( DS18B20_GetNumOfDevices() > 1 )
+	{
+		if( DS18B20_MasterPipelineAllTemperaturesIT(BufferProbeTemperatures) == DS18B20_BUSY )
+		{
+			printf("1-wire bus still busy - sample skipped.\n");
+		}
+	}
+	else if( DS18B20_MasterPipelineTemperatureIT(BufferOneWireRawTemperature) == DS18B20_BUSY )
+	{
+		printf("1-wire bus still busy - sample skipped.\n");
+	}
+
+	PROF_EXIT(TIM2_IRQHandler);
+}
 
-	//2. Update global temperature variable
-	Temperature = DS18B20_ConvertTemp( BufferOneWireRawTemperature);
+void TIM5_IRQHandler(void)
+{
+	//Shared time base - 1-wire engine on channel 1, software timers on SOFT_TIMER_CHANNEL
+	PROF_ENTER(TIM5_IRQHandler);
+	DS18B20_IRQHandling();
+	SWT_IRQHandling(&SoftTimers);
+	PROF_EXIT(TIM5_IRQHandler);
+}
 
-	//3. Enable ADC start up code
-	ADC_EnableIT(&pADC1Handle, BufferADCValues, (pADC1Handle.ADC_Config.ADC_Seq_Len) );
+void RTC_WKUP_IRQHandler(void)
+{
+	//STOP ended by the RTC - PWR_Idle has already restored the clocks and the timers
+	PWR_RTCWakeupIRQHandling();
 }
 
 void ADC_IRQHandler(void)
 {
-	//1. Read value(s) in from TDS sensor first, then turbidity sensor
+	//Only watch dog and overrun are reported here - converted values arrive through DMA2 stream 0. ADC1-ADC3 share this IRQ
+	PROF_ENTER(ADC_IRQHandler);
 	ADC_IRQHandling(&pADC1Handle);
+	ADC_IRQHandling(&pADC2Handle);
+	PROF_EXIT(ADC_IRQHandler);
+}
 
-	//2. At this point in program flow, all data conversions are done.
-	//   Calculate display values based off of voltages and then store all in buffer to be sent to Arduino via i2c
-	if( ADCSequenceIndex > NUM_OF_ANALOG_CONVERSIONS )
-	{
-		//2.1 Reset global sequence index
-		ADCSequenceIndex = 1;
-
-		//2.2 Update global 1-wire variables - Temperature
-		TDSTemperatureCompensationCoefficient = 1.0 + (0.02 * (Temperature - 25.0));
-
-		//2.3 Update global ADC variables - TDS
-		BufferADCTDSValue = BufferADCValues[0];
-		VoltsTDS = BufferADCTDSValue * 3.3 / 4095.0;
-		TDS = TDS_ConvertVoltageToPPM(VoltsTDS, TDSTemperatureCompensationCoefficient);
-		TDS = TDS_CalibratePPM(TDS);
-
-		//2.4 Update global ADC variables - Turbidity
-		BufferADCTurbidityValue = BufferADCValues[1];
-		VoltsTurbidity = BufferADCTurbidityValue * 3.3 / 4095.0;
-		Turbidity = Turbidity_ConvertVoltageToPercentage(VoltsTurbidity);
-
-		//2.5 fit Temperature, TDS, and turbidity data into buffer to be sent over i2c bus
-		//Structure of bytes of message: | 1) Temperature MSB | 2) Temperature LSB | 3) TDS MSB | 4) TDS LSB | 5) Turbidity (%)
-		BufferDataToArduino[0] = BufferOneWireRawTemperature[0];
-		BufferDataToArduino[1] = BufferOneWireRawTemperature[1];
-		I2C_ConvertTDSPPMToBytes(TDS, &BufferDataToArduino[2]);
-		I2C_ConvertTurbidityPercentageToBytes(Turbidity, &BufferDataToArduino[4]);
-
-		//2.6 Update global flag - New values ready to be printed by STM32
-		NewValuesReady = 1;
-
-		//2.7 Send all data to Arduino
-		I2C_MasterSendDataToArduino();
-	}
+void DMA2_Stream0_IRQHandler(void)
+{
+	//Transfer complete - one finished burst of TDS/turbidity pairs (decimation, conversion and i2c queueing included)
+	PROF_ENTER(DMA2_Stream0_IRQHandler);
+	ADC_DMA_IRQHandling(&pADC1Handle);
+	PROF_EXIT(DMA2_Stream0_IRQHandler);
+}
+
+void ProcessWaterQualityReadings(void)
+{
+	//At this point in program flow, all data conversions of one burst are done and decimated.
+	//Convert raw readings (integer pipeline unless built with WQ_USE_FIXED_POINT=0) and then store all in buffer to be sent to Arduino via i2c
+
+	//1. Temperature - only compensate with a reading of known, bounded age, otherwise use 25°C reference
+	TemperatureAgeUsecs = DS18B20_GetTimestamp() - TemperatureTimestamp;
+
+	WaterQualityRaw.TemperatureRaw = TemperatureRaw;
+	WaterQualityRaw.TemperatureValid = ( TemperatureValid && ( TemperatureAgeUsecs <= TEMPERATURE_MAX_AGE_USECS ) );
+
+	//2. TDS and turbidity - decimated ADC results and the values they reach at VDDA
+	WaterQualityRaw.TDSCounts = ADC1OVSHandle.Result[0];
+	WaterQualityRaw.TDSFullScale = ADC1OVSHandle.FullScale[0];
+	WaterQualityRaw.TurbidityCounts = ADC1OVSHandle.Result[1];
+	WaterQualityRaw.TurbidityFullScale = ADC1OVSHandle.FullScale[1];
+
+	//3. Counts to ppm / tenths of % / hundredths of °C
+	WQ_ProcessReadings(&WaterQualityRaw, &WaterQualityReadings);
+
+	//4. fit Temperature, TDS, and turbidity data into buffer to be sent over i2c bus
+	//Structure of bytes of message: | 1) Temperature MSB | 2) Temperature LSB | 3) TDS MSB | 4) TDS LSB | 5) Turbidity (%)
+	BufferDataToArduino[0] = BufferOneWireRawTemperature[0];
+	BufferDataToArduino[1] = BufferOneWireRawTemperature[1];
+	I2C_ConvertTDSPPMToBytes(WaterQualityReadings.TDSppm, &BufferDataToArduino[2]);
+	I2C_ConvertTurbidityPercentageToBytes(WaterQualityReadings.TurbidityTenths, &BufferDataToArduino[4]);
+
+	//5. Hand a copy to the main loop - if it has fallen SAMPLE_RING_CAPACITY readings behind this one is dropped (counted in Overflows)
+	WQ_Sample_t Sample;
+
+	Sample.Timestamp = DS18B20_GetTimestamp();
+	Sample.TemperatureAgeUsecs = TemperatureAgeUsecs;
+	Sample.Readings = WaterQualityReadings;
+	memcpy(Sample.Frame, BufferDataToArduino, sizeof(Sample.Frame));
+	Sample.TemperatureValid = WaterQualityRaw.TemperatureValid;
+
+	RING_Put(&SampleRing, &Sample);
+
+	//6. Queue all data for the Arduino - sent in the background by the I2C1 event interrupt
+	I2C_MasterSendDataToArduino();
 }
 
 
@@ -206,52 +423,78 @@ void ADC_IRQHandler(void)
 
 void I2C_MasterSendDataToArduino(void)
 {
-	//1. enable peripheral hardware
-	I2C_PeripheralControl(i2c1.pI2Cx, ENABLE);
-
-	//2. start comms, send address phase, then send all information. Close comms once finished
+	//1. Copy the message into the transmit queue - returns right away, the bus is never waited on in this ISR
 	Len = ( sizeof(BufferDataToArduino)/sizeof(BufferDataToArduino[0]) );
-	I2C_MasterSendData(&i2c1, BufferDataToArduino, Len, SlaveAddr, 0);
+	I2C_TXQ_Enqueue(&ArduinoTxQueue, SlaveAddr, BufferDataToArduino, Len);
 
-	//3. Disable the I2C peripheral once communication is over
-	I2C_PeripheralControl(i2c1.pI2Cx,DISABLE);
+	//2. Start, address phase and stop are driven by I2C1_EV_IRQHandler, data bytes by DMA1 stream 7. Completion and errors come back through I2C_ApplicationEventCallBack
 }
 
 
-void DS18B20_MasterGetTemperature(uint8_t *BufferCommands, uint8_t *BufferReceiveTemperature)
+void I2C1_EV_IRQHandler(void)
 {
-	//1. Master initiates communication sequence (Master Tx) and waits for presence pulse from DS18B20 (Master Rx)
-	DS18B20_MasterSendInitializeSequence();
+	I2C_EV_IRQHandling(&i2c1);
+}
 
-	//2. Master sends skip ROM command since there is only 1 slave on bus (Master Tx)
-	*BufferCommands = MASTER_COMMAND_SKIP_ROM;
-	DS18B20_MasterSendData( BufferCommands , 1);
+void I2C1_ER_IRQHandler(void)
+{
+	I2C_ER_IRQHandling(&i2c1);
+}
 
-	//3. Master sends convert T command to make DS18B20 start converting (Master Tx)
-	*BufferCommands = MASTER_COMMAND_CONVERT_T;
-	DS18B20_MasterSendData( BufferCommands , 1);
+void DMA1_Stream7_IRQHandler(void)
+{
+	//Last byte of the frame handed to I2C1 - the BTF event closes the frame
+	PROF_ENTER(DMA1_Stream7_IRQHandler);
+	I2C_DMA_TxIRQHandling(&i2c1);
+	PROF_EXIT(DMA1_Stream7_IRQHandler);
+}
 
-	//4. Master continuously sends read time slots to gauge when DS18B20 is finished converting temp (Master Tx)
-	//5. Master waits until it receives 1 '1' on the bus notifying it the temperature is ready (Master Rx)
-	while( !DS18B20_MasterGenerateReadTimeSlot() )
-		;
+void USART3_IRQHandler(void)
+{
+	//Transmission complete - the log retires the bytes just sent and starts the next chunk
+	USART_IRQHandling(&usart3);
+}
 
-	//6. Master initiates another communication sequence (Master Tx) and waits for presence pulse from DS18B20 (Master Rx)
-	DS18B20_MasterSendInitializeSequence();
+void DMA1_Stream5_IRQHandler(void)
+{
+	//USART transport of the 1-wire bus - echo of the reset byte / time slots is in
+	DS18B20_DMAIRQHandling();
+}
 
-	//7. Master sends skip ROM command since there is only 1 slave on bus (Master Tx)
-	*BufferCommands = MASTER_COMMAND_SKIP_ROM;
-	DS18B20_MasterSendData( BufferCommands , 1);
+void DMA1_Stream3_IRQHandler(void)
+{
+	//Last byte of the chunk handed to USART3 - the TC interrupt closes the transmission
+	USART_DMA_TxIRQHandling(&usart3);
+}
 
-	//8. Master sends read scratch pad command (Master Tx)
-	*BufferCommands = MASTER_COMMAND_READ_SCRATCHPAD;
-	DS18B20_MasterSendData( BufferCommands , 1);
+void USART6_IRQHandler(void)
+{
+	USART_IRQHandling(&usart6);
+}
 
-	//9. Master waits until 2 bytes of data have been sent (Master Rx)
-	DS18B20_MasterReceiveData(BufferReceiveTemperature, 2);
+void DMA2_Stream6_IRQHandler(void)
+{
+	USART_DMA_TxIRQHandling(&usart6);
+}
 
-	//10. Master sends a reset pulse to stop reading scratch pad (the temperature is only the first 2 bytes) is (Master Tx)
-	DS18B20_MasterSendInitializeSequence();
+void SendSampleTelemetry(const WQ_Sample_t *pSample)
+{
+	WQ_TLM_Sample_t Record;
+	uint8_t Frame[TLM_MAX_FRAME_LEN];
+	uint16_t FrameLen;
+	uint32_t AgeMs = pSample->TemperatureAgeUsecs / 1000;
+
+	//1. Fixed layout record - integer units only, nothing to format
+	Record.TemperatureCentiDeg = pSample->Readings.TemperatureCentiDeg;
+	Record.TDSppm = pSample->Readings.TDSppm;
+	Record.TurbidityTenths = pSample->Readings.TurbidityTenths;
+	Record.TemperatureAgeMs = ( AgeMs > 0xFFFF ) ? 0xFFFF : (uint16_t) AgeMs;
+	Record.Flags = pSample->TemperatureValid ? WQ_TLM_FLAG_TEMP_VALID : 0;
+
+	//2. One frame (~20 bytes) into the telemetry buffer - sent by DMA2 stream 6, dropped whole (sequence gap) if the buffer is full
+	FrameLen = TLM_EncodeFrame(&TelemetryStream, WQ_TLM_RECORD_SAMPLE, pSample->Timestamp, &Record, sizeof(Record), Frame);
+
+	USART_LOG_Write(&TelemetryLog, Frame, FrameLen);
 }
 
 
@@ -293,6 +536,168 @@ void initialize_GPIO(void)
 	GPIO_Init(&GPIOi2cPins);
 }
 
+void initialize_clocks(void)
+{
+	//Kept - the power manager restores it after every STOP (the core wakes up on the 16MHz HSI)
+	memset(&RunClockConfig,0,sizeof(RunClockConfig));
+
+	RunClockConfig.RCC_ClkSource = RCC_CLK_SRC_PLL;							//SYSCLK = PLL = 168MHz
+	RunClockConfig.RCC_PLLSource = RCC_PLL_SRC_HSE;							//8MHz crystal
+	RunClockConfig.RCC_PLL_M = 8;											//VCO input = 1MHz
+	RunClockConfig.RCC_PLL_N = 336;											//VCO output = 336MHz
+	RunClockConfig.RCC_PLL_P = 2;											//SYSCLK = 168MHz
+	RunClockConfig.RCC_PLL_Q = 7;											//USB/SDIO/RNG = 48MHz
+	RunClockConfig.RCC_AHBPrescaler = RCC_AHB_DIV_1;						//HCLK = 168MHz
+	RunClockConfig.RCC_APB1Prescaler = RCC_APB_DIV_4;						//PCLK1 = 42MHz (TIM2/TIM5 clock = 84MHz)
+	RunClockConfig.RCC_APB2Prescaler = RCC_APB_DIV_2;						//PCLK2 = 84MHz
+	RunClockConfig.RCC_FlashART = ENABLE;									//5 wait states hidden by prefetch and the caches
+
+	RCC_ClockConfig(&RunClockConfig);
+}
+
+void initialize_power(void)
+{
+	//Main loop idles in STOP between samples - RTC (LSI) wakes the core just before the next TIM2 update or TIM5 compare
+	memset(&PowerManager,0,sizeof(PowerManager));
+
+	PowerManager.PWR_Config.PWR_Mode = PWR_MODE_STOP;
+	PowerManager.PWR_Config.pRunClock = &RunClockConfig;
+	PowerManager.PWR_Config.pTIMx[0] = DS18B20_TIM_PERIPHERAL;				//1-wire time base (1us, free running) - also the software timer wheel
+	PowerManager.PWR_Config.pTIMx[1] = TIM2;								//Sample period (update event triggers the ADC)
+	PowerManager.PWR_Config.PWR_MinStopUsecs = IDLE_MIN_STOP_USECS;
+	PowerManager.PWR_Config.PWR_WakeupUsecs = IDLE_WAKEUP_USECS;
+
+	PWR_Init(&PowerManager);
+}
+
+uint8_t PWR_ApplicationStopAllowed(PWR_Handle_t *pPWRHandle)
+{
+	//User implementation of PWR_ApplicationStopAllowed API - no STOP while a log, a frame to the Arduino, a 1-wire transfer or an ADC burst is under way
+	if( USART_LOG_GetCount(&ConsoleLog) || ConsoleLog.InFlight || USART_LOG_GetCount(&TelemetryLog) || TelemetryLog.InFlight )
+	{
+		return 0;
+	}
+
+	if( I2C_TXQ_GetCount(&ArduinoTxQueue) || ArduinoTxQueue.InFlight )
+	{
+		return 0;
+	}
+
+	if( !DS18B20_StopAllowed() )
+	{
+		return 0;
+	}
+
+	return ( DMA_GetCurrDataCounter(&ADC1DMAHandle) == ADC_BURST_DMA_WORDS );
+}
+
+void initialize_soft_timers(void)
+{
+	//Heartbeat LED - PD12 push-pull output
+	memset(&GPIOHeartbeatPin,0,sizeof(GPIOHeartbeatPin));
+
+	GPIOHeartbeatPin.pGPIOx = GPIOD;
+	GPIOHeartbeatPin.GPIO_PinConfig.GPIO_PinNumber = GPIO_PIN_NO_12;
+	GPIOHeartbeatPin.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_OUT;
+	GPIOHeartbeatPin.GPIO_PinConfig.GPIO_PinOPType = GPIO_OP_TYPE_PP;
+	GPIOHeartbeatPin.GPIO_PinConfig.GPIO_PinPuPdControl = GPIO_NO_PUPD;
+	GPIOHeartbeatPin.GPIO_PinConfig.GPIO_PinSpeed = GPIO_OSPEED_LOW;
+
+	GPIO_Init(&GPIOHeartbeatPin);
+
+	//Timer wheel - any number of one-shot/periodic callbacks from one compare channel, set to the next deadline only
+	memset(&SoftTimers,0,sizeof(SoftTimers));
+
+	SoftTimers.SWT_Config.pTIMx = DS18B20_TIM_PERIPHERAL;
+	SoftTimers.SWT_Config.SWT_Channel = SOFT_TIMER_CHANNEL;
+	SoftTimers.SWT_Config.SWT_TickFreq = DS18B20_TIM_TICK_FREQ;
+
+	SWT_Init(&SoftTimers);
+}
+
+void HeartbeatCallback(void *pContext)
+{
+	GPIO_ToggleOutputPin(GPIOD, GPIO_PIN_NO_12);
+}
+
+void initialize_log(void)
+{
+	//USART3 TX on PD8 - printf (_write) feeds ConsoleLog, DMA1 stream 3 channel 4 (USART3_TX) drains it in the background
+	memset(&GPIOLogPin,0,sizeof(GPIOLogPin));
+
+	GPIOLogPin.pGPIOx = GPIOD;
+	GPIOLogPin.GPIO_PinConfig.GPIO_PinNumber = GPIO_PIN_NO_8;
+	GPIOLogPin.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	GPIOLogPin.GPIO_PinConfig.GPIO_PinAltFunMode = GPIO_MODE_AF7;
+	GPIOLogPin.GPIO_PinConfig.GPIO_PinOPType = GPIO_OP_TYPE_PP;
+	GPIOLogPin.GPIO_PinConfig.GPIO_PinPuPdControl = GPIO_PIN_PU;
+	GPIOLogPin.GPIO_PinConfig.GPIO_PinSpeed = GPIO_OSPEED_HIGH;
+
+	GPIO_Init(&GPIOLogPin);
+
+	memset(&USART3TxDMAHandle,0,sizeof(USART3TxDMAHandle));
+
+	USART3TxDMAHandle.pDMAx = DMA1;
+	USART3TxDMAHandle.StreamNumber = 3;
+	USART3TxDMAHandle.DMA_Config.DMA_Channel = DMA_CHANNEL_4;
+	USART3TxDMAHandle.DMA_Config.DMA_Priority = DMA_PRIORITY_LOW;
+
+	memset(&usart3,0,sizeof(usart3));
+
+	usart3.pUSARTx = USART3;
+	usart3.USART_Config.USART_Mode = USART_MODE_ONLY_TX;
+	usart3.USART_Config.USART_Baud = USART_STD_BAUD_115200;
+	usart3.USART_Config.USART_NoOfStopBits = USART_STOPBITS_1;
+	usart3.USART_Config.USART_WordLength = USART_WORDLEN_8BITS;
+	usart3.USART_Config.USART_ParityControl = USART_PARITY_DISABLE;
+	usart3.USART_Config.USART_HWFlowControl = USART_HW_FLOW_CTRL_NONE;
+	usart3.pDMATxHandle = &USART3TxDMAHandle;
+
+	USART_Init(&usart3);
+
+	USART_LOG_Init(&ConsoleLog, &usart3, CONSOLE_LOG_POLICY);
+	USART_LOG_SetStdout(&ConsoleLog);
+}
+
+void initialize_telemetry(void)
+{
+	//USART6 TX on PC6 - binary records (stm32f407vg_telemetry) drained by DMA2 stream 6 channel 5 (USART6_TX)
+	memset(&GPIOTelemetryPin,0,sizeof(GPIOTelemetryPin));
+
+	GPIOTelemetryPin.pGPIOx = GPIOC;
+	GPIOTelemetryPin.GPIO_PinConfig.GPIO_PinNumber = GPIO_PIN_NO_6;
+	GPIOTelemetryPin.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	GPIOTelemetryPin.GPIO_PinConfig.GPIO_PinAltFunMode = GPIO_MODE_AF8;
+	GPIOTelemetryPin.GPIO_PinConfig.GPIO_PinOPType = GPIO_OP_TYPE_PP;
+	GPIOTelemetryPin.GPIO_PinConfig.GPIO_PinPuPdControl = GPIO_PIN_PU;
+	GPIOTelemetryPin.GPIO_PinConfig.GPIO_PinSpeed = GPIO_OSPEED_HIGH;
+
+	GPIO_Init(&GPIOTelemetryPin);
+
+	memset(&USART6TxDMAHandle,0,sizeof(USART6TxDMAHandle));
+
+	USART6TxDMAHandle.pDMAx = DMA2;
+	USART6TxDMAHandle.StreamNumber = 6;
+	USART6TxDMAHandle.DMA_Config.DMA_Channel = DMA_CHANNEL_5;
+	USART6TxDMAHandle.DMA_Config.DMA_Priority = DMA_PRIORITY_LOW;
+
+	memset(&usart6,0,sizeof(usart6));
+
+	usart6.pUSARTx = USART6;
+	usart6.USART_Config.USART_Mode = USART_MODE_ONLY_TX;
+	usart6.USART_Config.USART_Baud = USART_STD_BAUD_460800;
+	usart6.USART_Config.USART_NoOfStopBits = USART_STOPBITS_1;
+	usart6.USART_Config.USART_WordLength = USART_WORDLEN_8BITS;
+	usart6.USART_Config.USART_ParityControl = USART_PARITY_DISABLE;
+	usart6.USART_Config.USART_HWFlowControl = USART_HW_FLOW_CTRL_NONE;
+	usart6.pDMATxHandle = &USART6TxDMAHandle;
+
+	USART_Init(&usart6);
+
+	USART_LOG_Init(&TelemetryLog, &usart6, USART_LOG_POLICY_DROP);
+	TLM_Init(&TelemetryStream);
+}
+
 void initialize_i2c(void)
 {
 	memset(&i2c1,0,sizeof(i2c1)); 		//sets each member element of the structure to zero. Avoids bugs caused by random garbage values in local variables upon first declaration
@@ -303,85 +708,86 @@ void initialize_i2c(void)
 	i2c1.I2C_Config.I2C_DeviceAddress = 0x01;
 	i2c1.I2C_Config.I2C_FMDutyCycle = I2C_FM_DUTY_2;
 
+	//Frame bytes are moved by DMA1 stream 7 channel 1 (I2C1_TX) - a frame costs the same few interrupts whatever its length
+	memset(&I2C1TxDMAHandle,0,sizeof(I2C1TxDMAHandle));
+
+	I2C1TxDMAHandle.pDMAx = DMA1;
+	I2C1TxDMAHandle.StreamNumber = 7;
+	I2C1TxDMAHandle.DMA_Config.DMA_Channel = DMA_CHANNEL_1;
+	I2C1TxDMAHandle.DMA_Config.DMA_Priority = DMA_PRIORITY_MEDIUM;
+
+	i2c1.pDMATxHandle = &I2C1TxDMAHandle;
+
 
 	I2C_Init(&i2c1);
+
+	I2C_TXQ_Init(&ArduinoTxQueue, &i2c1, ARDUINO_TXQ_POLICY);
 }
 
 void initialize_ADC(void)
 {
+	//ADC2 converts turbidity at the same instant ADC1 converts TDS (dual regular simultaneous) - half the acquisition time of a 2 channel scan
+	memset(&pADC2Handle,0,sizeof(pADC2Handle));
+
+	pADC2Handle.ADC_Config.ADC_Resolution = ADC_RES_12BITS;					//DR resolution = 12 bits
+	pADC2Handle.ADC_Config.ADC_DataAlignment = ADC_RIGHT_ALIGNMENT;			//DR alignment = right
+	pADC2Handle.ADC_Config.ADC_Mode = ADC_SCAN_CONVERSION_MODE;				//ADC mode - sequence converted per ADC1 trigger
+	pADC2Handle.ADC_Config.ADC_SamplingTime[ADC_IN2] = ADC_SMP_480_CYCLES;	//Channel 2 sampling time = 480 cycles (same as ADC1)
+	pADC2Handle.ADC_Config.ADC_AWDHT = 0xFFF;								//High voltage threshold: digital 4095 | analog 3.3V
+	pADC2Handle.ADC_Config.ADC_AWDLT = 0x0;									//Low voltage threshold: digital 0 | analog 0V
+	pADC2Handle.ADC_Config.ADC_Seq_Len = 1;									//channel conversion sequence length = 1 channel (same as ADC1)
+	pADC2Handle.ADC_Config.ADC_Seq_Order[0] = ADC_IN2;						//ADC channel sequence order = 1) ADC_IN2 - Turbidity sensor
+	pADC2Handle.ADC_Config.ADC_ExtTrigEdge = ADC_EXT_TRIG_DISABLE;			//Slave - started by the ADC1 trigger
+
+	pADC2Handle.pADCx = ADC2;												//Using ADC2 peripheral
+
 	memset(&pADC1Handle,0,sizeof(pADC1Handle));
 
-	pADC1Handle.ADC_Config.ADC_ClkPrescaler = ADC_CLK_DIV_2; 				//ADC clk = 8MHz
+	pADC1Handle.ADC_Config.ADC_ClkPrescaler = ADC_CLK_DIV_4; 				//ADC clk = 21MHz (PCLK2 = 84MHz, 36MHz max)
 	pADC1Handle.ADC_Config.ADC_Resolution = ADC_RES_12BITS;					//DR resolution = 12 bits
 	pADC1Handle.ADC_Config.ADC_DataAlignment = ADC_RIGHT_ALIGNMENT;			//DR alignment = right
-	pADC1Handle.ADC_Config.ADC_Mode = ADC_SINGLE_CONVERSION_MODE;				//ADC mode
-	pADC1Handle.ADC_Config.ADC_SamplingTime[ADC_IN1] = ADC_SMP_480_CYCLES;	//Channel 1 sampling time = 3 cycles
-	pADC1Handle.ADC_Config.ADC_SamplingTime[ADC_IN2] = ADC_SMP_480_CYCLES;	//Channel 2 sampling time = 3 cycles
+	pADC1Handle.ADC_Config.ADC_Mode = ADC_SCAN_CONVERSION_MODE;				//ADC mode - whole sequence converted per trigger
+	pADC1Handle.ADC_Config.ADC_SamplingTime[ADC_IN1] = ADC_SMP_480_CYCLES;	//Channel 1 sampling time = 480 cycles
 	pADC1Handle.ADC_Config.ADC_AWDHT = 0xFFF;								//High voltage threshold: digital 4095 | analog 3.3V /// digital 2048 | analog 1.65V
 	pADC1Handle.ADC_Config.ADC_AWDLT = 0x0;									//Low voltage threshold: digital 0 | analog 0V /// digital 2048 | analog 1.65V
-	pADC1Handle.ADC_Config.ADC_Seq_Len = NUM_OF_ANALOG_CONVERSIONS;			//channel conversion sequence length = 1 channel
+	pADC1Handle.ADC_Config.ADC_Seq_Len = 1;									//channel conversion sequence length = 1 channel per ADC
 	pADC1Handle.ADC_Config.ADC_Seq_Order[0] = ADC_IN1;						//ADC channel sequence order = 1) ADC_IN1 - TDS sensor
-	pADC1Handle.ADC_Config.ADC_Seq_Order[1] = ADC_IN2;						//ADC channel sequence order = 2) ADC_IN2 - Turbidity sensor
+	pADC1Handle.ADC_Config.ADC_ExtTrigSource = ADC_EXT_TRIG_TIM2_TRGO;		//Conversions started by TIM2 TRGO (update event)
+	pADC1Handle.ADC_Config.ADC_ExtTrigEdge = ADC_EXT_TRIG_RISING;			//Trigger on rising edge of TRGO
+	pADC1Handle.ADC_Config.ADC_MultiMode = ADC_MULTI_DUAL_REG_SIMULT;		//ADC1 and ADC2 sample together - results read packed from ADC_CDR
 
 	pADC1Handle.pADCx = ADC1;												//Using ADC1 peripheral
+	pADC1Handle.pSlaveHandle[0] = &pADC2Handle;
 
 	ADC_Init(&pADC1Handle);
-}
 
-uint16_t TDS_ConvertVoltageToPPM(__vo float Voltage, __vo float TemperatureCompensation)
-{
-	float CompensatedVoltage;
-	uint16_t TDSppm;
+	//ADC1 requests (ADC_CDR in dual mode) are mapped to DMA2 stream 0 channel 0 (RM table 43) - rest of the stream is configured by ADC_StartBurstDMA
+	memset(&ADC1DMAHandle,0,sizeof(ADC1DMAHandle));
 
-	CompensatedVoltage = Voltage / TemperatureCompensation; //Temperature Compensation
+	ADC1DMAHandle.pDMAx = DMA2;
+	ADC1DMAHandle.StreamNumber = 0;
+	ADC1DMAHandle.DMA_Config.DMA_Channel = DMA_CHANNEL_0;
 
-	TDSppm = (133.42*CompensatedVoltage*CompensatedVoltage*CompensatedVoltage - 255.86*CompensatedVoltage*CompensatedVoltage + 857.39*CompensatedVoltage) * 0.5; //convert voltage value to tds value
+	pADC1Handle.pDMAHandle = &ADC1DMAHandle;
 
-	return TDSppm;
-}
+	//Oversampling: TDS resolution enhanced to 14 bits, turbidity averaged (its conversion only needs 12 bits, less noise)
+	memset(&ADC1OVSHandle,0,sizeof(ADC1OVSHandle));
 
-uint16_t TDS_CalibratePPM(uint16_t UncalibratedTDSPPM)
-{
-	//Calibration value based off of real life data measuring known TDS value vs sensor TDS value
-	//Calibration relationship is a linear function based off of 2 real life data points:
-		//(7ppm measured,0ppm known) ; (128ppm measured,707ppm known)
-	//This yields the rough relationship: CorrectedValue = 5.84 * MeasuredValue − 41
-	if( (5.84 * (int16_t)UncalibratedTDSPPM - 41) < 0 )
-	{
-		return 0;
-	}
-	else
-		return (5.84 * UncalibratedTDSPPM - 41);
+	ADC1OVSHandle.pADCHandle = &pADC1Handle;
+	ADC1OVSHandle.ADC_OVS_Config.ADC_OVS_Ratio[ADC_IN1] = ADC_OVS_RATIO_16;
+	ADC1OVSHandle.ADC_OVS_Config.ADC_OVS_Mode[ADC_IN1] = ADC_OVS_MODE_ENHANCE;
+	ADC1OVSHandle.ADC_OVS_Config.ADC_OVS_Ratio[ADC_IN2] = ADC_OVS_RATIO_16;
+	ADC1OVSHandle.ADC_OVS_Config.ADC_OVS_Mode[ADC_IN2] = ADC_OVS_MODE_AVERAGE;
 }
 
-float Turbidity_ConvertVoltageToPercentage(__vo float Voltage)
+void I2C_ConvertTurbidityPercentageToBytes(uint16_t TurbidityTenths, uint8_t *Bufferi2c)
 {
-	//0V = 3.5% turbidity, 1.51V = 0% turbidity
-
-	//Due to error within the measurements, guard band the readings and say anything above the possible error is 100% clear
-	if( Voltage > 1.53 )
-	{
-		return 0;
-	}
-	else
-	{
-		float TurbidityPercentage;
-		float Step = 3.5 / 1.53; //3.5% is the highest reading capable on sensor, 1.51V is the theoretical highest value the ADC can read from this sensor
-
-		TurbidityPercentage = Voltage * Step;
-		TurbidityPercentage = 3.5 - TurbidityPercentage;
-		return TurbidityPercentage;
-	}
-}
-
-void I2C_ConvertTurbidityPercentageToBytes(float TurbidityPercentage, uint8_t *Bufferi2c)
-{
-	//Takes percentage and stores it into an 8-bit buffer of size 2. The first byte is the whole number part, the second byte is the fractional part
-	//i.e.,   2.5%  -->  | 00000010 | 00000101 |
+	//Takes percentage (in tenths) and stores it into an 8-bit buffer of size 2. The first byte is the whole number part, the second byte is the fractional part
+	//i.e.,   2.5% (25)  -->  | 00000010 | 00000101 |
 
 	uint16_t temp;
 
-	temp = TurbidityPercentage*10;
+	temp = TurbidityTenths;
 
 	//Load MSB of buffer
 	*(++Bufferi2c) = temp % 10;
@@ -414,18 +820,19 @@ void ADC_ApplicationEventCallBack(ADC_Handle_t *pADCHandle, uint8_t AppEvent)
 
 	if( AppEvent == ADC_EVENT_AWD )
 	{
-		//Analog watch dog threshold triggered
+		//Analog watch dog threshold triggered - DR still holds the conversion that triggered it (DMA only copies it)
+		uint16_t AWDValue = (uint16_t) ( pADCHandle->pADCx->DR & 0xFFF );
 
-		if( BufferADCValues[(pADCHandle->ADC_SeqLen) - 1] > ( pADCHandle->pADCx->HTR ) )
+		if( AWDValue > ( pADCHandle->pADCx->HTR ) )
 		{
 			printf("Analog watch dog triggered - over voltage condition detected.\n");
 		}
-		else if( BufferADCValues[(pADCHandle->ADC_SeqLen) - 1] < ( pADCHandle->pADCx->LTR ) )
+		else if( AWDValue < ( pADCHandle->pADCx->LTR ) )
 		{
 			printf("Analog watch dog triggered - under voltage condition detected.\n");
 		}
 
-		float VoltsAWD = ( ( BufferADCValues[(pADCHandle->ADC_SeqLen) - 1] / 4095.0 ) * 3.3 );
+		float VoltsAWD = ( ( AWDValue / 4095.0f ) * 3.3f );
 
 		printf("\nCurrent voltage reading: %f\n\n", VoltsAWD);
 
@@ -444,29 +851,103 @@ void ADC_ApplicationEventCallBack(ADC_Handle_t *pADCHandle, uint8_t AppEvent)
 		while(1);
 	}
 
-	if( AppEvent == ADC_EVENT_EOC )
+	if( AppEvent == ADC_ERROR_DMA )
+	{
+		//DMA stream stopped by hardware - buffer can no longer be trusted
+
+		printf("ADC DMA transfer error detected - suspending program...\n");
+
+		while(1);
+	}
+
+	if( AppEvent == ADC_EVENT_DMA_CMPLT )
 	{
-		//For multiple channels, need to be in single conversion mode for this program and will have to manually change channel selects
+		//Burst is done - decimate it before the driver re-arms the buffer for the next trigger
+		ADC_OVS_Decimate(&ADC1OVSHandle);
+		ProcessWaterQualityReadings();
+	}
+
+}
+
+void I2C_ApplicationEventCallBack(I2C_Handle_t *pI2CHandle, uint8_t AppEvent)
+{
+	//User implementation of I2C_ApplicationEventCallBack API
+
+	//Frame done (or abandoned on NACK / bus error) - the queue retires it and starts the next one
+	I2C_TXQ_EventHandling(&ArduinoTxQueue, AppEvent);
+}
+
+void USART_ApplicationEventCallBack(USART_Handle_t *pUSARTHandle, uint8_t AppEvent)
+{
+	//User implementation of USART_ApplicationEventCallBack API
 
-		//1. Stop the ADC after each conversion
-		pADCHandle->pADCx->CR2 &= ~( 1 << ADC_CR2_ADON );
+	//Chunk sent (or abandoned on a DMA error) - the log frees it and sends whatever was written meanwhile
+	if( pUSARTHandle == &usart3 )
+	{
+		USART_LOG_EventHandling(&ConsoleLog, AppEvent);
+	}
+	else if( pUSARTHandle == &usart6 )
+	{
+		USART_LOG_EventHandling(&TelemetryLog, AppEvent);
+	}
+}
 
-		//2. Increment global tracking flag to see where we are in conversion order
-		++ADCSequenceIndex;
+void DS18B20_ApplicationEventCallBack(uint8_t AppEvent)
+{
+	//User implementation of DS18B20_ApplicationEventCallBack API
 
-		//3. If we are done converting all channels, we need to reinitialize the order with user configuration values
-		if( ADCSequenceIndex > NUM_OF_ANALOG_CONVERSIONS )
+	if( AppEvent == DS18B20_EVENT_TEMP_READY )
+	{
+		//1. Update global temperature variable along with when it was measured - probe 0 is the one reported with several probes
+		if( DS18B20_GetNumOfDevices() > 1 )
 		{
-			ADC_SequenceInit(pADCHandle);
+			BufferOneWireRawTemperature[0] = BufferProbeTemperatures[0];
+			BufferOneWireRawTemperature[1] = BufferProbeTemperatures[1];
 		}
-		else
-		{
-			//4. Change the channel selected to be converted in single channel mode to the next channel.
-			pADCHandle->pADCx->SQR3 >>= 5;
 
-			//5. Restart the ADC to keep converting channels
-			ADC_StartADC(pADCHandle);
-		}
+		TemperatureRaw = DS18B20_ConvertTempRaw( BufferOneWireRawTemperature);
+		TemperatureTimestamp = DS18B20_GetTemperatureTimestamp();
+		TemperatureValid = 1;
+	}
+	else if( AppEvent == DS18B20_EVENT_CONV_STARTED )
+	{
+		//First tick - conversion started, result is read on the next tick
+	}
+	else if( AppEvent == DS18B20_ERROR_NO_PRESENCE )
+	{
+		//Keep the last good temperature so TDS and turbidity keep being reported - it stops being used once it is too old
+		printf("DS18B20 did not answer reset pulse - check 1-wire bus.\n");
+	}
+	else if( AppEvent == DS18B20_ERROR_TRANSPORT )
+	{
+		//USART transport DMA error - same as a missing probe, the next tick starts over with a reset
+		printf("1-wire USART transfer failed.\n");
+	}
+	else if( AppEvent == DS18B20_ERROR_CRC )
+	{
+		//Corrupted reads never reach TDS compensation - same as a missing probe, the last good temperature ages out
+		printf("DS18B20 scratch pad failed CRC %u times - check 1-wire cable. %lu CRC errors, %lu retries so far.\n",
+				DS18B20_MAX_CRC_RETRIES + 1, (unsigned long) DS18B20_GetCRCErrors(), (unsigned long) DS18B20_GetCRCRetries());
+	}
+	else if( AppEvent == DS18B20_EVENT_SEARCH_CMPLT )
+	{
+		printf("%u DS18B20 probe(s) found on 1-wire bus.\n", DS18B20_GetNumOfDevices());
+
+		//Same resolution and alarm thresholds on every probe (not saved to EEPROM) - sets the conversion time the reads wait for
+		DS18B20_MasterWriteConfigIT(DS18B20_ALL_DEVICES, TEMPERATURE_ALARM_HIGH_C, TEMPERATURE_ALARM_LOW_C, TEMPERATURE_RESOLUTION, 0);
+	}
+	else if( AppEvent == DS18B20_ERROR_SEARCH )
+	{
+		//Single probe reads (skip ROM) still work - only the multi-probe reads need the table
+		printf("1-wire ROM search failed - check 1-wire bus.\n");
+		OneWireSearchErrors++;
+
+		DS18B20_MasterWriteConfigIT(DS18B20_ALL_DEVICES, TEMPERATURE_ALARM_HIGH_C, TEMPERATURE_ALARM_LOW_C, TEMPERATURE_RESOLUTION, 0);
+	}
+	else if( AppEvent == DS18B20_EVENT_CONFIG_CMPLT )
+	{
+		printf("DS18B20 resolution %u bits - %lu us conversions.\n", 9 + DS18B20_GetResolution(0), (unsigned long) DS18B20_GetConvTimeUsecs());
 	}
 
+	//ADC scans are started by TIM2 TRGO in hardware - nothing to start here
 }
@@ -31,33 +31,58 @@
 #include <sys/times.h>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
-//					Implementation of printf like feature using ARM Cortex M3/M4/M7 ITM functionality
-//					This function will not work for ARM Cortex M0/M0+
-//					If you are using Cortex M0, then you can use semihosting feature of openOCD
+//					Implementation of printf like feature using a USART log channel (stm32f407vg_usart_log)
+//					Bytes are copied into a RAM buffer and sent in the background by USART Tx DMA - works without a
+//					debugger attached and never waits in the default drop-on-full mode
+//					Programs that don't register a stdout log (i.e., the Src/0xx demos) fall back to semihosting while a
+//					debugger is attached - output goes to the debugger console as it did with rdimon
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "stm32f407vg_usart_log.h"
 
-//Debug Exception and Monitor Control Register base address
-#define DEMCR        			*((volatile uint32_t*) 0xE000EDFCU )
+//Debug Halting Control and Status Register - C_DEBUGEN is set while a debugger is connected
+#define DHCSR						*((volatile uint32_t*) 0xE000EDF0U )
+#define DHCSR_C_DEBUGEN				0
 
-/* ITM register addresses */
-#define ITM_STIMULUS_PORT0   	*((volatile uint32_t*) 0xE0000000 )
-#define ITM_TRACE_EN          	*((volatile uint32_t*) 0xE0000E00 )
+/* Semihosting operations (ARM semihosting specification) */
+#define SEMIHOSTING_SYS_OPEN		0x01
+#define SEMIHOSTING_SYS_WRITE		0x05
+#define SEMIHOSTING_OPEN_W			4						/* fopen() mode "w" */
 
-void ITM_SendChar(uint8_t ch)
+static int SemihostingStdout = -1;
+
+static int semihosting_call(int op, void *arg)
 {
+  register int r0 __asm__("r0") = op;
+  register void *r1 __asm__("r1") = arg;
 
-	//Enable TRCENA
-	DEMCR |= ( 1 << 24);
+  /* BKPT 0xAB without a debugger escalates to HardFault - callers check C_DEBUGEN first */
+  __asm__ volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
 
-	//enable stimulus port 0
-	ITM_TRACE_EN |= ( 1 << 0);
+  return r0;
+}
 
-	// read FIFO status in bit [0]:
-	while(!(ITM_STIMULUS_PORT0 & 1));
+static void semihosting_write(const char *ptr, int len)
+{
+  if (!(DHCSR & (1 << DHCSR_C_DEBUGEN)))
+  {
+    return;
+  }
+
+  if (SemihostingStdout < 0)
+  {
+    /* ":tt" is the debugger console */
+    uint32_t OpenArgs[3] = { (uint32_t) ":tt", SEMIHOSTING_OPEN_W, 3 };
+
+    SemihostingStdout = semihosting_call(SEMIHOSTING_SYS_OPEN, OpenArgs);
+  }
 
-	//Write to ITM stimulus port0
-	ITM_STIMULUS_PORT0 = ch;
+  if (SemihostingStdout >= 0)
+  {
+    uint32_t WriteArgs[3] = { (uint32_t) SemihostingStdout, (uint32_t) ptr, (uint32_t) len };
+
+    semihosting_call(SEMIHOSTING_SYS_WRITE, WriteArgs);
+  }
 }
 
 
@@ -73,6 +98,7 @@ char **environ = __env;
 /* Functions */
 void initialise_monitor_handles()
 {
+  /* Kept for the demos - rdimon is not linked, _write opens the semihosting console on first use */
 }
 
 int _getpid(void)
@@ -110,13 +136,18 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
   (void)file;
-  int DataIdx;
+  USART_LOG_Handle_t *pLogHandle = USART_LOG_GetStdout();
 
-  for (DataIdx = 0; DataIdx < len; DataIdx++)
+  /* Bytes that don't fit are counted in the log's Dropped counter - report them written so newlib doesn't retry */
+  if (pLogHandle != NULL)
+  {
+    USART_LOG_Write(pLogHandle, (const uint8_t *) ptr, (uint32_t) len);
+  }
+  else
   {
-    //__io_putchar(*ptr++);
-	  ITM_SendChar(*ptr++);
+    semihosting_write(ptr, len);
   }
+
   return len;
 }
 
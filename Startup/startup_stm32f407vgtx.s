@@ -24,7 +24,7 @@
 
 .syntax unified
 .cpu cortex-m4
-.fpu softvfp
+.fpu fpv4-sp-d16
 .thumb
 
 .global g_pfnVectors
@@ -57,6 +57,21 @@ defined in linker script */
 Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
+
+/* Enable the FPU before any C code runs: full access to CP10 and CP11 (SCB_CPACR bits 20-23) */
+  ldr   r0, =0xE000ED88
+  ldr   r1, [r0]
+  orr   r1, r1, #(0xF << 20)
+  str   r1, [r0]
+/* Automatic + lazy FP context stacking (FPU_FPCCR ASPEN, LSPEN): ISRs using floats get their S0-S15/FPSCR
+   frame reserved on entry, but it is only written if the ISR actually executes an FP instruction */
+  ldr   r0, =0xE000EF34
+  ldr   r1, [r0]
+  orr   r1, r1, #0xC0000000
+  str   r1, [r0]
+  dsb
+  isb
+
 /* Call the clock system initialization function.*/
   bl  SystemInit
 
@@ -10,6 +10,21 @@
 
 #include "stm32f407vg.h"
 
+/*
+ * Build configurable items
+ *
+ * NOTE: DS18B20_TRANSPORT selects how the 1-wire bus is driven (i.e., -DDS18B20_TRANSPORT=DS18B20_TRANSPORT_USART).
+ * 		 GPIO bit-bangs DS18B20_GPIO_PIN from the DS18B20_TIM_PERIPHERAL compare interrupt. USART shifts one byte per
+ * 		 time slot through DS18B20_USART_PERIPHERAL in half-duplex mode, moved by DMA - slot timing comes from the baud
+ * 		 rate generator instead of code and GPIO mode switches. Both sit behind the same APIs
+ */
+#define DS18B20_TRANSPORT_GPIO					0
+#define DS18B20_TRANSPORT_USART					1
+
+#ifndef DS18B20_TRANSPORT
+#define DS18B20_TRANSPORT						DS18B20_TRANSPORT_GPIO
+#endif
+
 /*
  * Application configurable items
  */
@@ -19,6 +34,20 @@
 #define DS18B20_GPIO_PIN_NO_PUPD				GPIO_NO_PUPD			//Fixed value - will be using ~5kOhm external resistor. Should not be changed
 
 #define DS18B20_TIM_PERIPHERAL					TIM5
+#define DS18B20_TIM_CHANNEL						TIM_CHANNEL_1			//Output compare channel that paces the interrupt driven 1-wire engine
+#define DS18B20_TIM_TICK_FREQ					1000000					//1 tick = 1us
+
+#define DS18B20_MAX_DEVICES						8						//Probes the device table (ROM search) holds - one bus, MATCH_ROM addressed
+
+#define DS18B20_USART_PERIPHERAL				USART2					//USART transport only
+#define DS18B20_USART_GPIO_PORT					GPIOD					//PD5 - USART2 TX (half-duplex, open drain with the bus pull up resistor)
+#define DS18B20_USART_GPIO_PIN					GPIO_PIN_NO_5
+#define DS18B20_USART_GPIO_ALTFN				GPIO_MODE_AF7
+#define DS18B20_USART_DMA						DMA1
+#define DS18B20_USART_DMA_CHANNEL				DMA_CHANNEL_4			//USART2_TX: DMA1 stream 6 channel 4, USART2_RX: DMA1 stream 5 channel 4 (RM table 42)
+#define DS18B20_USART_DMA_TX_STREAM				6
+#define DS18B20_USART_DMA_RX_STREAM				5
+#define DS18B20_USART_DMA_RX_IRQ				IRQ_NO_DMA1_STREAM5		//Its handler calls DS18B20_DMAIRQHandling
 
 
 /*
@@ -31,11 +60,59 @@
 #define MASTER_RX_PRESENCE_HOLD_USECS			330
 
 #define MASTER_TX_RX_TIMESLOT_HOLD_USECS		60
-#define MASTER_TX_RX_RECOVERY_HOLD_USECS		(0.1)
+#define MASTER_TX_RX_RECOVERY_HOLD_USECS		(0.1f)
 
 #define MASTER_RX_INITIATE_USECS				1
 #define MASTER_RX_SAMPLE_USECS					10
 
+#define MASTER_TX_WRITE_ONE_LOW_USECS			2						//Write '1' time slot: release bus within 15us, but hold low for at least 1us
+#define MASTER_RX_PRESENCE_SAMPLE_USECS			70						//Sample point after releasing the bus - DS18B20 pulls low 15-60us after release, for 60-240us
+#define MASTER_TX_RX_RECOVERY_USECS				2						//Integer recovery time used by the interrupt driven engine (min. 1us)
+
+/*
+ * USART transport - one byte per reset / time slot. The receiver reads back the wired-AND of what was sent and what the
+ * DS18B20 pulled low
+ */
+#define DS18B20_USART_RESET_BAUD				9600					//0xF0: start bit + 4 zeros = 520us reset pulse, presence pulls some of the 1s low
+#define DS18B20_USART_SLOT_BAUD					115200					//0xFF: 8.7us low (write 1 / read, sampled 13us in), 0x00: 78us low (write 0)
+#define DS18B20_USART_RESET_BYTE				0xF0
+#define DS18B20_USART_RESET_TAIL_USECS			60						//Echo of the reset byte is in mid stop bit - bus idle 480us after the reset pulse before the first slot
+#define DS18B20_USART_MAX_SLOTS					64						//Time slots per DMA transfer (8 bytes on the bus)
+
+#define DS18B20_CONV_TIME_USECS					750000					//Max. temperature conversion time at 12-bit resolution
+#define DS18B20_COPY_TIME_USECS					10000					//Max. time to copy TH, TL and configuration register to EEPROM
+#define DS18B20_RECALL_TIME_USECS				1000					//EEPROM recall - no max. in the data sheet, margin only
+
+/*
+ * @DS18B20_Resolution
+ * Conversion resolution (R1 R0 of the configuration register). Every bit less halves the conversion time
+ */
+#define DS18B20_RESOLUTION_9_BIT				0						//0.5°C LSB, 93.75ms
+#define DS18B20_RESOLUTION_10_BIT				1						//0.25°C LSB, 187.5ms
+#define DS18B20_RESOLUTION_11_BIT				2						//0.125°C LSB, 375ms
+#define DS18B20_RESOLUTION_12_BIT				3						//0.0625°C LSB, 750ms (power-on default)
+
+#define DS18B20_CONFIG_REG(RES)					( ( (RES) << 5 ) | 0x1F )	//Bits 4:0 always read 1, bit 7 always 0
+#define DS18B20_CONFIG_RESOLUTION(REG)			( ( (REG) >> 5 ) & 0x3 )
+#define DS18B20_CONV_TIME_RES_USECS(RES)		( DS18B20_CONV_TIME_USECS >> ( DS18B20_RESOLUTION_12_BIT - (RES) ) )
+#define DS18B20_TEMP_COUNTS_PER_DEGREE			16						//Temperature register is 1/16°C at every resolution - lower ones leave the low bits undefined
+
+#define DS18B20_ALL_DEVICES						0xFF					//Device index of a broadcast (skip ROM) configuration write / recall
+
+/*
+ * 64-bit ROM code: family code, 48-bit serial number, CRC-8 (stored in bus order - family code first)
+ */
+#define DS18B20_ROM_LEN							8
+#define DS18B20_FAMILY_CODE						0x28
+#define DS18B20_SEARCH_SLOTS					( 64 * 3 )				//Read bit, read complement, write direction for every ROM bit
+#define DS18B20_MAX_SEARCH_PASSES				( 4 * DS18B20_MAX_DEVICES )	//Bound on the search tree walk (other families, a shorted bus)
+
+/*
+ * Scratch pad: temperature LSB, MSB, TH, TL, configuration register, 3 reserved bytes, CRC-8 of the 8 bytes before it
+ */
+#define DS18B20_SCRATCHPAD_LEN					9
+#define DS18B20_MAX_CRC_RETRIES					3						//Times a read (scratch pad, ROM, search pass) failing its CRC is repeated
+
 /*
  * Master GPIO pin control
  */
@@ -61,6 +138,47 @@
 #define MASTER_COMMAND_RECALL_E2				0xB8
 #define MASTER_COMMAND_READ_POWER_SUPPLY		0xB4
 
+/*
+ * Interrupt driven 1-wire engine states
+ */
+#define DS18B20_READY							0
+#define DS18B20_BUSY							1
+
+/*
+ * Possible DS18B20 application events
+ */
+#define DS18B20_EVENT_TRANSFER_CMPLT			0
+#define DS18B20_EVENT_TEMP_READY				1
+#define DS18B20_ERROR_NO_PRESENCE				2
+#define DS18B20_EVENT_CONV_STARTED				3
+#define DS18B20_EVENT_SEARCH_CMPLT				4
+#define DS18B20_ERROR_SEARCH					5						//No device answered a ROM bit, ROM CRC mismatch or too many passes
+#define DS18B20_EVENT_CONFIG_CMPLT				6						//Alarm thresholds / resolution written (and copied) or recalled
+#define DS18B20_ERROR_CRC						7						//A read still failed its CRC-8 after DS18B20_MAX_CRC_RETRIES retries
+#define DS18B20_ERROR_TRANSPORT					8						//USART transport: DMA transfer error - the job was abandoned
+
+/*
+ * Max. number of transactions the interrupt driven engine can chain together in a single job (Convert T or Recall E2, one
+ * scratch pad read per device)
+ */
+#define DS18B20_MAX_TRANSACTIONS				( DS18B20_MAX_DEVICES + 1 )
+
+
+/*
+ * One 1-wire transaction: reset + presence, TxLen bytes written, RxLen bytes read (stored in bus order), 64 ROM search
+ * triplets if pSearchROM is set, then an optional idle time before the next transaction of the job begins
+ */
+typedef struct
+{
+	uint8_t 	*pTxBuffer;
+	uint8_t 	TxLen;
+	uint8_t 	*pRxBuffer;
+	uint8_t 	RxLen;
+	uint8_t 	*pSearchROM;				//SEARCH_ROM / ALARM_SEARCH: ROM of the previous pass in, branch taken out (NULL if not a search)
+	uint8_t 	CheckCRC;					//1: last byte read is the CRC-8 of the ones before it - repeated on mismatch (DS18B20_MAX_CRC_RETRIES)
+	uint32_t 	PostDelayUsecs;
+}DS18B20_Transaction_t;
+
 
 /******************************************************************************************
  *								APIs supported by this driver
@@ -80,14 +198,75 @@ void DS18B20_Config(void);
 void DS18B20_MasterSendInitializeSequence(void);
 void DS18B20_MasterSendData(uint8_t *TxBuffer, uint8_t len);
 void DS18B20_MasterReceiveData(uint8_t *RxBuffer, uint8_t len);
+uint8_t DS18B20_MasterReadScratchpad(uint8_t *Scratchpad);
+uint8_t DS18B20_MasterReadROM(uint8_t *ROM);
 
 void DS18B20_MasterGenerateWriteTimeSlot(uint8_t WriteValue);
 uint8_t DS18B20_MasterGenerateReadTimeSlot(void);
 
+/*
+ * Interrupt driven (non-blocking) communication
+ */
+uint8_t DS18B20_MasterTransferIT(DS18B20_Transaction_t *pTransactions, uint8_t NumTransactions);
+uint8_t DS18B20_MasterGetTemperatureIT(uint8_t *TempBuffer);
+uint8_t DS18B20_MasterPipelineTemperatureIT(uint8_t *TempBuffer);
+uint8_t DS18B20_GetState(void);
+
+/*
+ * Multi-probe bus - ROM search into the device table, one broadcast Convert T, MATCH_ROM scratch pad reads
+ */
+uint8_t DS18B20_MasterSearchROMIT(uint8_t SearchCommand);
+uint8_t DS18B20_MasterGetAllTemperaturesIT(uint8_t *TempBuffers);
+uint8_t DS18B20_MasterPipelineAllTemperaturesIT(uint8_t *TempBuffers);
+uint8_t DS18B20_GetNumOfDevices(void);
+const uint8_t *DS18B20_GetDeviceROM(uint8_t Device);
+uint32_t DS18B20_GetAlarmDevices(void);
+
+/*
+ * Resolution and alarm thresholds (scratch pad TH, TL, configuration register) - per device or broadcast
+ */
+uint8_t DS18B20_MasterWriteConfigIT(uint8_t Device, int8_t AlarmHigh, int8_t AlarmLow, uint8_t Resolution, uint8_t Save);
+uint8_t DS18B20_MasterRecallConfigIT(uint8_t Device);
+uint8_t DS18B20_GetResolution(uint8_t Device);
+void DS18B20_GetAlarmThresholds(uint8_t Device, int8_t *pAlarmHigh, int8_t *pAlarmLow);
+float DS18B20_GetLSBWeight(uint8_t Device);
+uint32_t DS18B20_GetConvTimeUsecs(void);
+
+/*
+ * CRC-8 (ROM code, scratch pad) and read error statistics
+ */
+uint8_t DS18B20_CRC8(const uint8_t *pData, uint8_t Len);
+uint32_t DS18B20_GetCRCErrors(void);
+uint32_t DS18B20_GetCRCRetries(void);
+
+/*
+ * Time base / measurement age
+ */
+uint32_t DS18B20_GetTimestamp(void);
+uint32_t DS18B20_GetTemperatureTimestamp(void);
+
+/*
+ * ISR handling - call from the DS18B20_TIM_PERIPHERAL IRQ handler, and from the DS18B20_USART_DMA_RX_IRQ handler with
+ * the USART transport
+ */
+void DS18B20_IRQHandling(void);
+void DS18B20_DMAIRQHandling(void);
+
+/*
+ * Low power - STOP freezes the USART transport mid transfer
+ */
+uint8_t DS18B20_StopAllowed(void);
+
 /*
  * Temperature conversion
  */
 float DS18B20_ConvertTemp(uint8_t *TempBuffer);
+int16_t DS18B20_ConvertTempRaw(uint8_t *TempBuffer);
+
+/*
+ * Application callback
+ */
+void DS18B20_ApplicationEventCallBack(uint8_t AppEvent);
 
 
 
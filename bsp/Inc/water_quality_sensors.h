@@ -0,0 +1,123 @@
+/*
+ * water_quality_sensors.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_WATER_QUALITY_SENSORS_H_
+#define INC_WATER_QUALITY_SENSORS_H_
+
+#include <stdint.h>
+
+/*
+ * Build configurable items
+ *
+ * NOTE: WQ_USE_FIXED_POINT selects the integer (Q16) conversion pipeline. Set it to 0 (i.e., -DWQ_USE_FIXED_POINT=0)
+ * 		 to go back to the float pipeline. Both give the same values on the i2c wire within 1 LSB
+ */
+#ifndef WQ_USE_FIXED_POINT
+#define WQ_USE_FIXED_POINT						1
+#endif
+
+/*
+ * Sensor constants
+ */
+#define WQ_VREF_VOLTS							3.3f					//ADC reference (VDDA)
+#define WQ_TDS_TEMP_COEF_PER_DEG				0.02f					//TDS compensation coefficient slope per °C
+#define WQ_TDS_REF_TEMP_DEG						25.0f					//TDS compensation reference temperature
+#define WQ_TDS_MIN_TEMP_COEF					0.1f					//Lowest compensation coefficient used (reached at -20°C) - avoids dividing by ~0
+#define WQ_TDS_MAX_PPM							0xFFFF					//Largest value that fits the 2 byte i2c field
+
+#define WQ_TURBIDITY_MAX_PERCENT				3.5f					//Highest reading capable on sensor, at 0V
+#define WQ_TURBIDITY_CLEAR_VOLTS				1.53f					//Anything above this voltage (plus error guard band) is 100% clear
+
+/*
+ * Q16 versions of the sensor constants (value * 65536) used by the fixed point pipeline
+ */
+#define WQ_Q16_ONE								65536
+#define WQ_Q16_VREF								216269					//3.3
+#define WQ_Q16_TDS_MIN_TEMP_COEF				6554					//0.1
+#define WQ_Q16_TDS_CUBIC_A3						4371907					//133.42 * 0.5
+#define WQ_Q16_TDS_CUBIC_A2						(-8384020)				//-255.86 * 0.5
+#define WQ_Q16_TDS_CUBIC_A1						28094956				//857.39 * 0.5
+#define WQ_Q16_TDS_CAL_GAIN						382730					//5.84
+#define WQ_TDS_CAL_OFFSET						41						//Calibration offset in ppm
+#define WQ_Q16_TURBIDITY_MAX_PERCENT			229376					//3.5
+#define WQ_Q16_TURBIDITY_CLEAR_VOLTS			100270					//1.53
+#define WQ_Q16_TURBIDITY_STEP					149918					//3.5 / 1.53
+
+
+/*
+ * This is the structure of the raw sensor readings going into the conversion pipeline
+ */
+
+typedef struct
+{
+	uint32_t 		TDSCounts;									/* Decimated ADC result of the TDS sensor */
+	uint32_t 		TDSFullScale;								/* Value of TDSCounts at VDDA */
+	uint32_t 		TurbidityCounts;							/* Decimated ADC result of the turbidity sensor */
+	uint32_t 		TurbidityFullScale;							/* Value of TurbidityCounts at VDDA */
+	int16_t 		TemperatureRaw;								/* DS18B20 temperature register (°C * 16, two's complement) */
+	uint8_t 		TemperatureValid;							/* 1 if TemperatureRaw can be used for TDS compensation, 0 to use the 25°C reference */
+}WQ_RawReadings_t;
+
+/*
+ * This is the structure of the converted readings - already in the units sent to the Arduino
+ */
+
+typedef struct
+{
+	uint16_t 		TDSppm;										/* Calibrated and temperature compensated TDS in ppm */
+	uint16_t 		TurbidityTenths;							/* Turbidity in tenths of a percent (i.e., 25 = 2.5%) */
+	int16_t 		TemperatureCentiDeg;						/* Temperature in hundredths of a °C */
+}WQ_Readings_t;
+
+/*
+ * This is the binary telemetry record of one processed reading (payload of a WQ_TLM_RECORD_SAMPLE frame)
+ *
+ * NOTE: Wire format - packed, little endian (both the Cortex-M4 and the logging PC are little endian)
+ */
+
+typedef struct __attribute__ ((packed))
+{
+	int16_t 		TemperatureCentiDeg;						/* Temperature in hundredths of a °C */
+	uint16_t 		TDSppm;										/* Calibrated and temperature compensated TDS in ppm */
+	uint16_t 		TurbidityTenths;							/* Turbidity in tenths of a percent */
+	uint16_t 		TemperatureAgeMs;							/* Age of the temperature used for TDS compensation (saturates at 0xFFFF) */
+	uint8_t 		Flags;										/* Possible values from @WQ_TLM_Flags */
+}WQ_TLM_Sample_t;
+
+/*
+ * @WQ_TLM_RecordType
+ * Telemetry record types of the water quality application
+ */
+
+#define WQ_TLM_RECORD_SAMPLE					1					/* Payload is a WQ_TLM_Sample_t */
+
+/*
+ * @WQ_TLM_Flags
+ */
+
+#define WQ_TLM_FLAG_TEMP_VALID					( 1 << 0 )			/* TDS was compensated with the measured temperature (not the 25°C reference) */
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Conversion pipeline - implementation selected by WQ_USE_FIXED_POINT
+ */
+void WQ_ProcessReadings(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings);
+
+/*
+ * Individual implementations (both always available, i.e., for comparing them on the host)
+ */
+void WQ_ProcessReadingsFixed(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings);
+void WQ_ProcessReadingsFloat(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings);
+
+#endif /* INC_WATER_QUALITY_SENSORS_H_ */
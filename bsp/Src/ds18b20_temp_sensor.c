@@ -6,18 +6,209 @@
  */
 
 #include "ds18b20_temp_sensor.h"
+#include "stm32f407vg_profiler.h"
+
+PROF_SITE_DEFINE(DS18B20_MasterSendInitializeSequence);
+
+/*
+ * Interrupt driven 1-wire engine phases (what the next compare event has to do)
+ */
+#define DS18B20_PHASE_RESET_RELEASE				0		//Reset pulse has been held long enough - release bus and wait for presence pulse
+#define DS18B20_PHASE_PRESENCE_SAMPLE			1		//Sample bus for DS18B20 presence pulse
+#define DS18B20_PHASE_SLOT						2		//End of current time slot - recover and begin the next write / read time slot
+#define DS18B20_PHASE_POST_DELAY				3		//Idle time after a transaction (i.e., Convert T) has elapsed
+#define DS18B20_PHASE_UART_RESET				4		//USART transport: echo of the reset byte - sample for DS18B20 presence pulse
+#define DS18B20_PHASE_UART_SLOTS				5		//USART transport: echo of the last time slot of a DMA transfer
+#define DS18B20_PHASE_UART_BAUD					6		//USART transport: reset byte has left the shift register - switch to the time slot baud rate
+
+/*
+ * Interrupt driven 1-wire engine context
+ */
+typedef struct
+{
+	__vo uint8_t			State;
+	uint8_t					Phase;
+	DS18B20_Transaction_t	Transactions[DS18B20_MAX_TRANSACTIONS];
+	uint8_t					NumTransactions;
+	uint8_t					TransactionIndex;
+	uint16_t				BitIndex;
+	uint32_t				PhaseStart;
+	uint8_t					CmpltEvent;
+	uint8_t					*pTempBuffer;
+	uint8_t					ConvTransaction;		//Index of the transaction that issues Convert T (DS18B20_NO_CONV_TRANSACTION if none)
+	uint8_t					ConvPending;			//A conversion was started and its result has not been read yet
+	uint32_t				ConvStart;				//Time base value when the last Convert T command finished
+	uint32_t				PrevConvStart;			//Conversion start of the result read by the current job
+	uint32_t				TempTimestamp;			//Conversion start of the temperature last handed to the application
+	uint8_t					NumTemps;				//Temperatures the current job reads (1 with skip ROM, 1 per device with MATCH_ROM)
+	uint8_t					SearchBits;				//ROM search: bit (bit 0) and complement (bit 1) read in the current triplet
+	uint8_t					SearchLastDiscrepancy;	//ROM search: bit number (1-64) where the previous pass took the 0 branch last, 0 if none
+	uint8_t					SearchLastZero;			//ROM search: same for the pass under way
+	uint8_t					SearchPasses;
+	uint8_t					SearchRetries;			//ROM search: times the current pass was repeated after a CRC mismatch
+	uint8_t					Retries;				//Times the current transaction was repeated after a CRC mismatch
+	uint32_t				ConfigDevices;			//Configuration job: bit n set - device n gets the configuration written / recalled
+	uint8_t					ConfigRecall;			//Configuration job: 1 - recall E2 and read back, 0 - write DS18B20_NewConfig
+	uint8_t					NumSlots;				//USART transport: time slots (bytes) in the DMA transfer under way
+}DS18B20_Engine_t;
+
+#define DS18B20_NO_CONV_TRANSACTION				0xFF
 
 GPIO_Handle_t DS18B20_pin;
 
+static DS18B20_Engine_t DS18B20_Engine;
+static uint8_t DS18B20_CmdConvertT[2] = { MASTER_COMMAND_SKIP_ROM, MASTER_COMMAND_CONVERT_T };
+static uint8_t DS18B20_CmdReadScratchpad[2] = { MASTER_COMMAND_SKIP_ROM, MASTER_COMMAND_READ_SCRATCHPAD };
+static uint8_t DS18B20_CmdReadROM[1] = { MASTER_COMMAND_READ_ROM };
+static uint8_t DS18B20_Scratchpad[DS18B20_MAX_DEVICES][DS18B20_SCRATCHPAD_LEN];		//Last scratch pad read of each device (bus order)
+static uint32_t DS18B20_CRCErrors;
+static uint32_t DS18B20_CRCRetries;
+
+//Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1, LSB first) of every byte value - one lookup per byte instead of 8 shifts
+static const uint8_t DS18B20_CRC8Table[256] =
+{
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+	0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+	0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+	0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+	0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+	0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+	0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+	0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+	0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+	0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+	0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+	0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+	0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+	0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+	0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+	0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35};
+
+//Device table - filled by DS18B20_MasterSearchROMIT, in search order
+static uint8_t DS18B20_DeviceROM[DS18B20_MAX_DEVICES][DS18B20_ROM_LEN];
+static uint8_t DS18B20_CmdMatchReadScratchpad[DS18B20_MAX_DEVICES][DS18B20_ROM_LEN + 2];		//Match ROM, ROM code, Read scratch pad
+static uint8_t DS18B20_NumDevices;
+static uint32_t DS18B20_AlarmDevices;
+static uint8_t DS18B20_CmdSearch;
+static uint8_t DS18B20_SearchROM[DS18B20_ROM_LEN];
+static uint8_t DS18B20_SearchPrevROM[DS18B20_ROM_LEN];						//ROM the current pass started from - a pass failing its CRC is repeated from it
+
+//TH, TL and configuration register (scratch pad bytes 2-4) of each device of the table - row 0 is the only probe if the table is empty
+static uint8_t DS18B20_DeviceConfig[DS18B20_MAX_DEVICES][3];
+static const uint8_t DS18B20_DefaultConfig[3] = { 125, (uint8_t) -55, DS18B20_CONFIG_REG(DS18B20_RESOLUTION_12_BIT) };	//Assumed until written / recalled
+static uint8_t DS18B20_NewConfig[3];
+static uint8_t DS18B20_CmdWriteScratchpad[DS18B20_ROM_LEN + 5];				//Match ROM + ROM code (or skip ROM), Write scratch pad, TH, TL, configuration
+static uint8_t DS18B20_CmdCopyRecall[DS18B20_ROM_LEN + 2];						//Match ROM + ROM code (or skip ROM), Copy scratch pad / Recall E2
+static uint32_t DS18B20_ConvTimeUsecs = DS18B20_CONV_TIME_USECS;				//Conversion time of the slowest device (Convert T is broadcast)
+
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+//USART transport - one byte per time slot. Slots are what is sent, Echo what the receiver read back off the bus
+static USART_Handle_t DS18B20_USARTHandle;
+static DMA_Handle_t DS18B20_DMATxHandle;
+static DMA_Handle_t DS18B20_DMARxHandle;
+static uint8_t DS18B20_UartSlots[DS18B20_USART_MAX_SLOTS];
+static uint8_t DS18B20_UartEcho[DS18B20_USART_MAX_SLOTS];
+#endif
+
 /* Limited visibility helper function prototypes */
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+static uint8_t DS18B20_UartTxRx(uint8_t Data);
+static void DS18B20_UartStartTransfer(uint8_t NumBytes);
+static void DS18B20_UartStartSlots(void);
+static void DS18B20_UartEndSlots(void);
+#else
 static void DS18B20_GPIOControl(uint8_t InOrOut);
+static void DS18B20_DelayUsecs(uint32_t MicroSeconds);
+static void DS18B20_EngineHandleSlot(void);
+#endif
+static uint8_t DS18B20_EngineStartJob(DS18B20_Transaction_t *pTransactions, uint8_t NumTransactions, uint8_t CmpltEvent, uint8_t ConvTransaction, uint8_t *TempBuffer, uint8_t NumTemps);
+static uint8_t DS18B20_TemperatureJob(uint8_t *TempBuffer, uint8_t NumDevices, uint8_t Pipelined);
+static uint8_t DS18B20_SearchStartPass(void);
+static uint8_t DS18B20_SearchEndPass(uint8_t *pAppEvent);
+static uint8_t DS18B20_EngineSearchBranch(uint8_t *pROM, uint8_t BitNumber);
+static uint8_t DS18B20_CheckCRC(const uint8_t *pData, uint8_t Len);
+static uint8_t DS18B20_MasterReadChecked(uint8_t *pCmd, uint8_t CmdLen, uint8_t *pRxBuffer, uint8_t RxLen);
+static uint8_t DS18B20_AddressCommand(uint8_t *pCmd, uint8_t Device, uint8_t Command);
+static void DS18B20_UpdateConvTime(void);
+static void DS18B20_EngineStartTransaction(void);
+static void DS18B20_EngineNextTransaction(void);
+static void DS18B20_EngineEndTransaction(void);
+static uint16_t DS18B20_EngineTotalBits(DS18B20_Transaction_t *pTransaction);
+static uint8_t DS18B20_EngineSlotIsRead(DS18B20_Transaction_t *pTransaction, uint16_t Bit);
+static uint8_t DS18B20_EngineSlotWriteValue(DS18B20_Transaction_t *pTransaction, uint16_t Bit, uint8_t *pWriteValue);
+static void DS18B20_EngineSlotRead(DS18B20_Transaction_t *pTransaction, uint16_t Bit, uint8_t Value);
+static void DS18B20_EngineClose(uint8_t AppEvent);
+
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_Config
+
+ 	 * @brief  		- Configures the DQ pin of the 1-wire bus (or the USART and DMA streams driving it, see DS18B20_TRANSPORT) and
+ 	 * 				- starts DS18B20_TIM_PERIPHERAL as a free-running 1us time base
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
 
+ 	 * @Note		- Both the blocking and the interrupt driven APIs pace the bus off of the same time base. The timer must not be
+ 	 * 				- re-purposed (i.e., with TIM2_5_Delay) after this is called
+*/
 void DS18B20_Config(void)
 {
 
 	memset(&DS18B20_pin,0,sizeof(DS18B20_pin));
 
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	//Configure USART TX pin as DQ - open drain, the receiver reads the bus back through the same pin (half-duplex)
+	DS18B20_pin.pGPIOx = DS18B20_USART_GPIO_PORT;
+
+	DS18B20_pin.GPIO_PinConfig.GPIO_PinMode = GPIO_MODE_ALTFN;
+	DS18B20_pin.GPIO_PinConfig.GPIO_PinAltFunMode = DS18B20_USART_GPIO_ALTFN;
+	DS18B20_pin.GPIO_PinConfig.GPIO_PinOPType = GPIO_OP_TYPE_OD;					//A DS18B20 pulling the bus low shows up in the byte received
+	DS18B20_pin.GPIO_PinConfig.GPIO_PinPuPdControl = DS18B20_GPIO_PIN_NO_PUPD;		//Using external 4.7kOhm resistor
+	DS18B20_pin.GPIO_PinConfig.GPIO_PinSpeed = GPIO_OSPEED_HIGH;
+	DS18B20_pin.GPIO_PinConfig.GPIO_PinNumber = DS18B20_USART_GPIO_PIN;
+
+	GPIO_Init(&DS18B20_pin);
+
+	//8N1, starting at the reset baud rate - every transaction begins with a reset
+	memset(&DS18B20_USARTHandle,0,sizeof(DS18B20_USARTHandle));
+
+	DS18B20_USARTHandle.pUSARTx = DS18B20_USART_PERIPHERAL;
+	DS18B20_USARTHandle.USART_Config.USART_Mode = USART_MODE_HALF_DUPLEX;
+	DS18B20_USARTHandle.USART_Config.USART_Baud = DS18B20_USART_RESET_BAUD;
+	DS18B20_USARTHandle.USART_Config.USART_NoOfStopBits = USART_STOPBITS_1;
+	DS18B20_USARTHandle.USART_Config.USART_WordLength = USART_WORDLEN_8BITS;
+	DS18B20_USARTHandle.USART_Config.USART_ParityControl = USART_PARITY_DISABLE;
+	DS18B20_USARTHandle.USART_Config.USART_HWFlowControl = USART_HW_FLOW_CTRL_NONE;
+
+	USART_Init(&DS18B20_USARTHandle);
+	USART_PeripheralControl(DS18B20_USART_PERIPHERAL, ENABLE);
+
+	//Rx stream (DR to echo buffer) and Tx stream (slot buffer to DR) - one byte per request, direct mode
+	memset(&DS18B20_DMARxHandle,0,sizeof(DS18B20_DMARxHandle));
+
+	DS18B20_DMARxHandle.pDMAx = DS18B20_USART_DMA;
+	DS18B20_DMARxHandle.StreamNumber = DS18B20_USART_DMA_RX_STREAM;
+	DS18B20_DMARxHandle.DMA_Config.DMA_Channel = DS18B20_USART_DMA_CHANNEL;
+	DS18B20_DMARxHandle.DMA_Config.DMA_Direction = DMA_DIR_PERIPH_TO_MEM;
+	DS18B20_DMARxHandle.DMA_Config.DMA_Mode = DMA_MODE_NORMAL;
+	DS18B20_DMARxHandle.DMA_Config.DMA_PeriphDataSize = DMA_DATA_SIZE_BYTE;
+	DS18B20_DMARxHandle.DMA_Config.DMA_MemDataSize = DMA_DATA_SIZE_BYTE;
+	DS18B20_DMARxHandle.DMA_Config.DMA_PeriphInc = DMA_INC_DISABLE;
+	DS18B20_DMARxHandle.DMA_Config.DMA_MemInc = DMA_INC_ENABLE;
+	DS18B20_DMARxHandle.DMA_Config.DMA_Priority = DMA_PRIORITY_VERY_HIGH;			//An echo left in DR past the next one is an overrun
+	DS18B20_DMARxHandle.DMA_Config.DMA_FIFOMode = DMA_FIFO_DISABLE;
+
+	DMA_Init(&DS18B20_DMARxHandle);
+
+	DS18B20_DMATxHandle = DS18B20_DMARxHandle;
+	DS18B20_DMATxHandle.StreamNumber = DS18B20_USART_DMA_TX_STREAM;
+	DS18B20_DMATxHandle.DMA_Config.DMA_Direction = DMA_DIR_MEM_TO_PERIPH;
+
+	DMA_Init(&DS18B20_DMATxHandle);
+#else
 	//Configure DQ pin
 	DS18B20_pin.pGPIOx = DS18B20_GPIO_PORT;
 
@@ -28,9 +219,18 @@ void DS18B20_Config(void)
 	DS18B20_pin.GPIO_PinConfig.GPIO_PinNumber = DS18B20_GPIO_PIN;
 
 	GPIO_Init(&DS18B20_pin);
+#endif
 
-	TIM2_5_SetDelayInit(DS18B20_TIM_PERIPHERAL);
+	TIM2_5_SetFreeRunningInit(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_TICK_FREQ);
 
+	//Power-on resolution until the application writes or recalls the configuration
+	for(uint8_t d = 0; d < DS18B20_MAX_DEVICES; d++)
+	{
+		memcpy(DS18B20_DeviceConfig[d], DS18B20_DefaultConfig, sizeof(DS18B20_DefaultConfig));
+	}
+	DS18B20_UpdateConvTime();
+
+	DS18B20_Engine.State = DS18B20_READY;
 }
 
 
@@ -87,20 +287,67 @@ void DS18B20_MasterReceiveData(uint8_t *RxBuffer, uint8_t len)
 }
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterReadScratchpad
+
+ 	 * @brief  		- Blocking read of the whole scratch pad of the only probe on the bus (skip ROM), CRC-8 checked
+
+ 	 * @param 		- *Scratchpad : DS18B20_SCRATCHPAD_LEN byte buffer, bus order (temperature LSB first, CRC last)
+
+ 	 * @retval 		- DS18B20_EVENT_TRANSFER_CMPLT, or DS18B20_ERROR_CRC if DS18B20_MAX_CRC_RETRIES repeated reads failed too
+
+ 	 * @Note		- Scratchpad holds the last read even if it failed. Counted in DS18B20_GetCRCErrors / DS18B20_GetCRCRetries
+*/
+uint8_t DS18B20_MasterReadScratchpad(uint8_t *Scratchpad)
+{
+	return DS18B20_MasterReadChecked(DS18B20_CmdReadScratchpad, sizeof(DS18B20_CmdReadScratchpad), Scratchpad, DS18B20_SCRATCHPAD_LEN);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterReadROM
+
+ 	 * @brief  		- Blocking read of the 64-bit ROM code of the only device on the bus (Read ROM), CRC-8 checked
+
+ 	 * @param 		- *ROM : DS18B20_ROM_LEN byte buffer, bus order (family code first, CRC last)
+
+ 	 * @retval 		- DS18B20_EVENT_TRANSFER_CMPLT, or DS18B20_ERROR_CRC if DS18B20_MAX_CRC_RETRIES repeated reads failed too
+
+ 	 * @Note		- With more than one device on the bus every ROM collides (wired AND) - use DS18B20_MasterSearchROMIT
+*/
+uint8_t DS18B20_MasterReadROM(uint8_t *ROM)
+{
+	return DS18B20_MasterReadChecked(DS18B20_CmdReadROM, sizeof(DS18B20_CmdReadROM), ROM, DS18B20_ROM_LEN);
+}
+
+
 void DS18B20_MasterSendInitializeSequence(void)
 {
+	PROF_ENTER(DS18B20_MasterSendInitializeSequence);
+
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	//1. Reset pulse at the reset baud rate - 0xF0 holds the bus low for 520us (start bit + 4 zeros), the 4 ones and the
+	//	 stop bit are the master Rx phase (a presence pulse clears some of them)
+	USART_SetBaud(&DS18B20_USARTHandle, DS18B20_USART_RESET_BAUD);
+	DS18B20_UartTxRx(DS18B20_USART_RESET_BYTE);
+
+	//2. Time slots run at the slot baud rate
+	USART_SetBaud(&DS18B20_USARTHandle, DS18B20_USART_SLOT_BAUD);
+#else
 	//1. Master send reset pulse - send logic low on bus
 	DS18B20_GPIOControl( MASTER_SET_PIN_OUTPUT );
 	GPIO_WriteToOutputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN, 0);
 
 	//2. Wait 480us
-	TIM2_5_Delay(DS18B20_TIM_PERIPHERAL, MASTER_TX_RESET_HOLD_USECS);
+	DS18B20_DelayUsecs(MASTER_TX_RESET_HOLD_USECS);
 
 	//3. DS18B20 waits 15-60us to send
 
 	//4. Master read presence pulse - DS18B20 write a logic 0 to the bus and holds it for 60-180us
 	DS18B20_GPIOControl( MASTER_SET_PIN_INPUT );
-	TIM2_5_Delay(DS18B20_TIM_PERIPHERAL, MASTER_RX_PRESENCE_PULSE_USECS);
+	DS18B20_DelayUsecs(MASTER_RX_PRESENCE_PULSE_USECS);
 		//Time elapsed at this point: ~630us+
 
 	//5. Master confirms presence pulse was sent from DS18B20
@@ -108,13 +355,20 @@ void DS18B20_MasterSendInitializeSequence(void)
 		;
 
 	//6. Fulfill 1-wire requirement of master Rx phase being at least 480us
-	TIM2_5_Delay(DS18B20_TIM_PERIPHERAL, MASTER_RX_PRESENCE_HOLD_USECS);
+	DS18B20_DelayUsecs(MASTER_RX_PRESENCE_HOLD_USECS);
 		//Time elapsed at this point: ~960us+
+#endif
+
+	PROF_EXIT(DS18B20_MasterSendInitializeSequence);
 }
 
 
 void DS18B20_MasterGenerateWriteTimeSlot(uint8_t WriteValue)
 {
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	//0xFF: start bit only (8.7us low) - write '1'. 0x00: start bit + 8 zeros (78us low) - write '0'. Stop bit is the recovery time
+	DS18B20_UartTxRx( ( WriteValue ) ? 0xFF : 0x00 );
+#else
 	//1. Master pulls 1-wire bus low and releases within 15us
 	DS18B20_GPIOControl(MASTER_SET_PIN_OUTPUT);
 	GPIO_WriteToOutputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN, 0);
@@ -128,17 +382,22 @@ void DS18B20_MasterGenerateWriteTimeSlot(uint8_t WriteValue)
 	}
 
 	//3. wait until end of write time slot for DS18B20 to sample the data bus (min. 60us)
-	TIM2_5_Delay(DS18B20_TIM_PERIPHERAL, MASTER_TX_RX_TIMESLOT_HOLD_USECS);
+	DS18B20_DelayUsecs(MASTER_TX_RX_TIMESLOT_HOLD_USECS);
 
 	//4. Release bus and wait recovery time in-between read or write time slots
 
 	//NOTE: THERE IS A NATURAL 5.75us DELAY FROM SETTING GPIO PIN AS INPUT
 	DS18B20_GPIOControl(MASTER_SET_PIN_INPUT);
+#endif
 }
 
 
 uint8_t DS18B20_MasterGenerateReadTimeSlot(void)
 {
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	//Start bit initiates the slot. A DS18B20 sending a '0' keeps the bus low past it, clearing the first data bits read back
+	return ( DS18B20_UartTxRx(0xFF) == 0xFF );
+#else
 	//1. Master pulls 1-wire bus low for at least 1us then and releases
 
 	DS18B20_GPIOControl(MASTER_SET_PIN_OUTPUT);
@@ -148,37 +407,1488 @@ uint8_t DS18B20_MasterGenerateReadTimeSlot(void)
 	DS18B20_GPIOControl(MASTER_SET_PIN_INPUT);
 
 	//2. DS18B20 begins transmitting either a 1 or 0. Data is valid for at most 15us, so master should sample data before then
-	//TIM2_5_Delay(DS18B20_TIM_PERIPHERAL, MASTER_RX_SAMPLE_USECS);
+	//DS18B20_DelayUsecs(MASTER_RX_SAMPLE_USECS);
 	uint8_t val = GPIO_ReadFromInputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN);
 
 	//3. wait until end of read time slot for DS18B20 to sample the data bus (min. 60us)
-	TIM2_5_Delay(DS18B20_TIM_PERIPHERAL, MASTER_TX_RX_TIMESLOT_HOLD_USECS);
+	DS18B20_DelayUsecs(MASTER_TX_RX_TIMESLOT_HOLD_USECS);
 
 	return val;
+#endif
 }
 
 
-float DS18B20_ConvertTemp(uint8_t *TempBuffer)
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterTransferIT
+
+ 	 * @brief  		- Starts a non-blocking job of up to DS18B20_MAX_TRANSACTIONS 1-wire transactions. Each transaction is a reset +
+ 	 * 				- presence pulse, followed by TxLen bytes written and RxLen bytes read (LSB first over the bus, stored in bus order)
+
+ 	 * @param 		- *pTransactions : Array of transactions to run back to back (copied, may live on the caller's stack)
+ 	 * @param 		- NumTransactions : Number of transactions in the array
+
+ 	 * @retval 		- State of the 1-wire engine before the call. The job is only started if DS18B20_READY is returned
+
+ 	 * @Note		- Time slots are paced by output compare events of DS18B20_TIM_PERIPHERAL. The short, timing critical
+ 	 * 				- portions of each slot (< 15us) are done inside the ISR, everything else is left to the timer
+ 	 * 				- DS18B20_ApplicationEventCallBack is called with DS18B20_EVENT_TRANSFER_CMPLT once the job is done
+*/
+uint8_t DS18B20_MasterTransferIT(DS18B20_Transaction_t *pTransactions, uint8_t NumTransactions)
+{
+	return DS18B20_EngineStartJob(pTransactions, NumTransactions, DS18B20_EVENT_TRANSFER_CMPLT, DS18B20_NO_CONV_TRANSACTION, NULL, 0);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterGetTemperatureIT
+
+ 	 * @brief  		- Non-blocking temperature read: Convert T, wait for the conversion to finish, read the whole scratch
+ 	 * 				- pad (CRC-8 checked, repeated on mismatch)
+
+ 	 * @param 		- *TempBuffer : 2 byte buffer where the raw temperature is stored (MSB first, LSB last - see DS18B20_ConvertTemp)
+
+ 	 * @retval 		- State of the 1-wire engine before the call. The job is only started if DS18B20_READY is returned
+
+ 	 * @Note		- DS18B20_ApplicationEventCallBack is called with DS18B20_EVENT_TEMP_READY once TempBuffer is valid
+*/
+uint8_t DS18B20_MasterGetTemperatureIT(uint8_t *TempBuffer)
 {
-	//This assumes a 2-element array is passed with MSB byte first then LSB byte last
-	uint16_t temperature = (*TempBuffer) << 8;
-	temperature |= *(++TempBuffer);
+	//Skip ROM - only 1 slave on bus
+	return DS18B20_TemperatureJob(TempBuffer, 0, 0);
+}
 
-	return ( (float) temperature / 16.0 );
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterPipelineTemperatureIT
+
+ 	 * @brief  		- Split-phase (pipelined) temperature read meant to be called once per sample period. Reads the result of the
+ 	 * 				- conversion started by the previous call, then immediately starts the next conversion. The conversion (up to
+ 	 * 				- 750ms, see DS18B20_GetConvTimeUsecs) is hidden behind the sample period instead of being waited out on every sample
+
+ 	 * @param 		- *TempBuffer : 2 byte buffer where the raw temperature is stored (MSB first, LSB last - see DS18B20_ConvertTemp)
+
+ 	 * @retval 		- DS18B20_READY if the job was started. DS18B20_BUSY if the 1-wire engine is busy or the previous conversion
+ 	 * 				- has not had DS18B20_GetConvTimeUsecs() to finish yet (call period is too short)
+
+ 	 * @Note		- First call (or first call after an error) only starts a conversion and reports DS18B20_EVENT_CONV_STARTED
+ 	 * 				- Following calls report DS18B20_EVENT_TEMP_READY. The temperature was measured by the conversion started at
+ 	 * 				- DS18B20_GetTemperatureTimestamp() - its age is known to the application
+*/
+uint8_t DS18B20_MasterPipelineTemperatureIT(uint8_t *TempBuffer)
+{
+	//Skip ROM - only 1 slave on bus
+	return DS18B20_TemperatureJob(TempBuffer, 0, 1);
 }
 
 
-/*************************** Helper functions ****************************/
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterSearchROMIT
 
-static void DS18B20_GPIOControl(uint8_t InOrOut)
+ 	 * @brief  		- Non-blocking enumeration of the 1-wire bus (ROM search, Maxim AN187). Every pass walks one branch of the ROM
+ 	 * 				- code tree - 64 triplets of read bit / read complement / write direction - and the next pass is started
+ 	 * 				- from the ISR until no branch is left
+
+ 	 * @param 		- SearchCommand : MASTER_COMMAND_SEARCH_ROM (fills the device table) or MASTER_COMMAND_ALARM_SEARCH (flags the
+ 	 * 				- devices of the table whose last conversion was outside their alarm thresholds - see DS18B20_GetAlarmDevices)
+
+ 	 * @retval 		- State of the 1-wire engine before the call. The search is only started if DS18B20_READY is returned
+
+ 	 * @Note		- DS18B20_ApplicationEventCallBack is called with DS18B20_EVENT_SEARCH_CMPLT once the bus is enumerated, or with
+ 	 * 				- DS18B20_ERROR_SEARCH / DS18B20_ERROR_NO_PRESENCE (devices found up to then are kept).
+ 	 * 				- An alarm search with no device in alarm completes with DS18B20_EVENT_SEARCH_CMPLT and DS18B20_GetAlarmDevices() 0
+ 	 * 				- (devices not in alarm still answer the reset, then nobody answers the first ROM bit).
+ 	 * 				- Only DS18B20 family codes go into the table, at most DS18B20_MAX_DEVICES. A search drops a pipelined
+ 	 * 				- conversion - the next pipelined call starts a new one
+*/
+uint8_t DS18B20_MasterSearchROMIT(uint8_t SearchCommand)
 {
-	if( InOrOut == MASTER_SET_PIN_INPUT )
+	if( DS18B20_Engine.State == DS18B20_BUSY )
 	{
-		DS18B20_GPIO_PORT->MODER &= ~( 0x3 << ( DS18B20_GPIO_PIN * 2 ) );
+		return DS18B20_BUSY;
+	}
+
+	if( ( SearchCommand != MASTER_COMMAND_SEARCH_ROM ) && ( SearchCommand != MASTER_COMMAND_ALARM_SEARCH ) )
+	{
+		//Not a search ROM command. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//1. First pass takes the 0 branch at every discrepancy
+	DS18B20_CmdSearch = SearchCommand;
+	DS18B20_Engine.SearchLastDiscrepancy = 0;
+	DS18B20_Engine.SearchPasses = 0;
+	DS18B20_Engine.SearchRetries = 0;
+	memset(DS18B20_SearchROM, 0, sizeof(DS18B20_SearchROM));
+
+	if( SearchCommand == MASTER_COMMAND_SEARCH_ROM )
+	{
+		DS18B20_NumDevices = 0;
 	}
 	else
 	{
-		DS18B20_GPIO_PORT->MODER &= ~( 0x3 << ( DS18B20_GPIO_PIN * 2 ) ); 	//clear mode bit field first
-		DS18B20_GPIO_PORT->MODER |= ( 0x1 << ( DS18B20_GPIO_PIN * 2 ) );	//set pin as OUT
+		DS18B20_AlarmDevices = 0;
+	}
+
+	return DS18B20_SearchStartPass();
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterGetAllTemperaturesIT
+
+ 	 * @brief  		- Non-blocking temperature read of every device of the table: one broadcast Convert T (skip ROM), one wait
+ 	 * 				- for the conversion, then a MATCH_ROM scratch pad read per device
+
+ 	 * @param 		- *TempBuffers : 2 bytes per device of the table, in table order (each MSB first - see DS18B20_ConvertTemp)
+
+ 	 * @retval 		- State of the 1-wire engine before the call. The job is only started if DS18B20_READY is returned
+
+ 	 * @Note		- N probes cost one conversion time, not N. DS18B20_EVENT_TEMP_READY once every buffer is valid.
+ 	 * 				- Falls back to a skip ROM read (1 temperature) if the table is empty
+*/
+uint8_t DS18B20_MasterGetAllTemperaturesIT(uint8_t *TempBuffers)
+{
+	return DS18B20_TemperatureJob(TempBuffers, DS18B20_NumDevices, 0);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterPipelineAllTemperaturesIT
+
+ 	 * @brief  		- Pipelined version of DS18B20_MasterGetAllTemperaturesIT: reads every device of the table (conversion
+ 	 * 				- started by the previous call), then starts the next broadcast conversion
+
+ 	 * @param 		- *TempBuffers : 2 bytes per device of the table, in table order (each MSB first - see DS18B20_ConvertTemp)
+
+ 	 * @retval 		- Same as DS18B20_MasterPipelineTemperatureIT
+
+ 	 * @Note		- Same events and timestamp as DS18B20_MasterPipelineTemperatureIT - every probe was converted at the same time
+*/
+uint8_t DS18B20_MasterPipelineAllTemperaturesIT(uint8_t *TempBuffers)
+{
+	return DS18B20_TemperatureJob(TempBuffers, DS18B20_NumDevices, 1);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetNumOfDevices
+
+ 	 * @brief  		- Returns the number of DS18B20s in the device table (last DS18B20_MasterSearchROMIT)
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- 0 to DS18B20_MAX_DEVICES
+
+ 	 * @Note		- none
+*/
+uint8_t DS18B20_GetNumOfDevices(void)
+{
+	return DS18B20_NumDevices;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetDeviceROM
+
+ 	 * @brief  		- Returns the 64-bit ROM code of a device of the table
+
+ 	 * @param 		- Device : index in the device table
+
+ 	 * @retval 		- DS18B20_ROM_LEN bytes in bus order (family code first, CRC last), NULL if there is no such device
+
+ 	 * @Note		- none
+*/
+const uint8_t *DS18B20_GetDeviceROM(uint8_t Device)
+{
+	return ( Device < DS18B20_NumDevices ) ? DS18B20_DeviceROM[Device] : NULL;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetAlarmDevices
+
+ 	 * @brief  		- Returns the devices found by the last alarm search
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- Bit n set - device n of the table is in alarm
+
+ 	 * @Note		- none
+*/
+uint32_t DS18B20_GetAlarmDevices(void)
+{
+	return DS18B20_AlarmDevices;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterWriteConfigIT
+
+ 	 * @brief  		- Non-blocking write of the alarm thresholds and resolution (Write scratch pad), optionally copied to EEPROM
+ 	 * 				- (Copy scratch pad) so the device powers up with them
+
+ 	 * @param 		- Device : index in the device table (0 for the only probe if the table is empty) or DS18B20_ALL_DEVICES (skip ROM)
+ 	 * @param 		- AlarmHigh : TH in °C - an alarm search finds the device if its last conversion was above it
+ 	 * @param 		- AlarmLow : TL in °C - an alarm search finds the device if its last conversion was below it
+ 	 * @param 		- Resolution : possible values from @DS18B20_Resolution
+ 	 * @param 		- Save : 1 - copy to EEPROM (DS18B20_COPY_TIME_USECS more), 0 - scratch pad only (lost at power down)
+
+ 	 * @retval 		- State of the 1-wire engine before the call. The job is only started if DS18B20_READY is returned
+
+ 	 * @Note		- DS18B20_ApplicationEventCallBack is called with DS18B20_EVENT_CONFIG_CMPLT once written. From then on the
+ 	 * 				- conversion time budget (DS18B20_GetConvTimeUsecs) follows the slowest device and the undefined low bits of
+ 	 * 				- lower resolution temperatures are cleared. Drops a pipelined conversion, like any other job
+*/
+uint8_t DS18B20_MasterWriteConfigIT(uint8_t Device, int8_t AlarmHigh, int8_t AlarmLow, uint8_t Resolution, uint8_t Save)
+{
+	DS18B20_Transaction_t Transactions[2];
+	uint8_t NumDevices = ( DS18B20_NumDevices ) ? DS18B20_NumDevices : 1;
+	uint8_t len;
+
+	if( DS18B20_Engine.State == DS18B20_BUSY )
+	{
+		return DS18B20_BUSY;
+	}
+
+	if( ( Resolution > DS18B20_RESOLUTION_12_BIT ) || ( ( Device != DS18B20_ALL_DEVICES ) && ( Device >= NumDevices ) ) )
+	{
+		//Not a resolution / device of the table. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	memset(Transactions,0,sizeof(Transactions));
+
+	DS18B20_NewConfig[0] = (uint8_t) AlarmHigh;
+	DS18B20_NewConfig[1] = (uint8_t) AlarmLow;
+	DS18B20_NewConfig[2] = DS18B20_CONFIG_REG(Resolution);
+
+	//1. Write scratch pad - TH, TL and configuration register, in that order
+	len = DS18B20_AddressCommand(DS18B20_CmdWriteScratchpad, Device, MASTER_COMMAND_WRITE_SCRATCHPAD);
+	memcpy(&DS18B20_CmdWriteScratchpad[len], DS18B20_NewConfig, sizeof(DS18B20_NewConfig));
+
+	Transactions[0].pTxBuffer = DS18B20_CmdWriteScratchpad;
+	Transactions[0].TxLen = len + sizeof(DS18B20_NewConfig);
+
+	//2. Copy scratch pad to EEPROM, then leave the bus idle until the copy is done
+	if( Save )
+	{
+		Transactions[1].pTxBuffer = DS18B20_CmdCopyRecall;
+		Transactions[1].TxLen = DS18B20_AddressCommand(DS18B20_CmdCopyRecall, Device, MASTER_COMMAND_COPY_SCRATCHPAD);
+		Transactions[1].PostDelayUsecs = DS18B20_COPY_TIME_USECS;
+	}
+
+	DS18B20_Engine.ConfigDevices = ( Device == DS18B20_ALL_DEVICES ) ? ( ( 1UL << NumDevices ) - 1 ) : ( 1UL << Device );
+	DS18B20_Engine.ConfigRecall = 0;
+
+	return DS18B20_EngineStartJob(Transactions, ( Save ) ? 2 : 1, DS18B20_EVENT_CONFIG_CMPLT, DS18B20_NO_CONV_TRANSACTION, NULL, 0);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_MasterRecallConfigIT
+
+ 	 * @brief  		- Non-blocking reload of the alarm thresholds and resolution from EEPROM (Recall E2), read back from the
+ 	 * 				- scratch pad so the driver knows the settings the device actually runs with
+
+ 	 * @param 		- Device : index in the device table (0 for the only probe if the table is empty) or DS18B20_ALL_DEVICES (one
+ 	 * 				- broadcast recall, then one scratch pad read per device)
+
+ 	 * @retval 		- State of the 1-wire engine before the call. The job is only started if DS18B20_READY is returned
+
+ 	 * @Note		- DS18B20_ApplicationEventCallBack is called with DS18B20_EVENT_CONFIG_CMPLT once read back.
+ 	 * 				- Until then the driver assumes 12-bit resolution (longest conversion) for devices it has not configured
+*/
+uint8_t DS18B20_MasterRecallConfigIT(uint8_t Device)
+{
+	DS18B20_Transaction_t Transactions[DS18B20_MAX_TRANSACTIONS];
+	uint8_t NumDevices = ( DS18B20_NumDevices ) ? DS18B20_NumDevices : 1;
+	uint8_t n = 0;
+
+	if( DS18B20_Engine.State == DS18B20_BUSY )
+	{
+		return DS18B20_BUSY;
+	}
+
+	if( ( Device != DS18B20_ALL_DEVICES ) && ( Device >= NumDevices ) )
+	{
+		//Not a device of the table. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	memset(Transactions,0,sizeof(Transactions));
+
+	//1. Recall E2 - TH, TL and configuration register back into the scratch pad
+	Transactions[n].pTxBuffer = DS18B20_CmdCopyRecall;
+	Transactions[n].TxLen = DS18B20_AddressCommand(DS18B20_CmdCopyRecall, Device, MASTER_COMMAND_RECALL_E2);
+	Transactions[n].PostDelayUsecs = DS18B20_RECALL_TIME_USECS;
+	n++;
+
+	//2. Read the scratch pad of each device - TH, TL and configuration register are bytes 2-4
+	for(uint8_t d = 0; d < NumDevices; d++)
+	{
+		if( ( Device != DS18B20_ALL_DEVICES ) && ( Device != d ) )
+		{
+			continue;
+		}
+
+		Transactions[n].pTxBuffer = ( DS18B20_NumDevices ) ? DS18B20_CmdMatchReadScratchpad[d] : DS18B20_CmdReadScratchpad;
+		Transactions[n].TxLen = ( DS18B20_NumDevices ) ? sizeof(DS18B20_CmdMatchReadScratchpad[d]) : sizeof(DS18B20_CmdReadScratchpad);
+		Transactions[n].pRxBuffer = DS18B20_Scratchpad[d];
+		Transactions[n].RxLen = sizeof(DS18B20_Scratchpad[d]);
+		Transactions[n].CheckCRC = 1;
+		n++;
+	}
+
+	DS18B20_Engine.ConfigDevices = ( Device == DS18B20_ALL_DEVICES ) ? ( ( 1UL << NumDevices ) - 1 ) : ( 1UL << Device );
+	DS18B20_Engine.ConfigRecall = 1;
+
+	return DS18B20_EngineStartJob(Transactions, n, DS18B20_EVENT_CONFIG_CMPLT, DS18B20_NO_CONV_TRANSACTION, NULL, 0);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetResolution
+
+ 	 * @brief  		- Returns the resolution a device was last configured with (written or recalled)
+
+ 	 * @param 		- Device : index in the device table (0 for the only probe if the table is empty)
+
+ 	 * @retval 		- @DS18B20_Resolution
+
+ 	 * @Note		- none
+*/
+uint8_t DS18B20_GetResolution(uint8_t Device)
+{
+	return DS18B20_CONFIG_RESOLUTION(DS18B20_DeviceConfig[Device % DS18B20_MAX_DEVICES][2]);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetAlarmThresholds
+
+ 	 * @brief  		- Returns the alarm thresholds a device was last configured with (written or recalled)
+
+ 	 * @param 		- Device : index in the device table (0 for the only probe if the table is empty)
+ 	 * @param 		- *pAlarmHigh : TH in °C
+ 	 * @param 		- *pAlarmLow : TL in °C
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+*/
+void DS18B20_GetAlarmThresholds(uint8_t Device, int8_t *pAlarmHigh, int8_t *pAlarmLow)
+{
+	*pAlarmHigh = (int8_t) DS18B20_DeviceConfig[Device % DS18B20_MAX_DEVICES][0];
+	*pAlarmLow = (int8_t) DS18B20_DeviceConfig[Device % DS18B20_MAX_DEVICES][1];
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetLSBWeight
+
+ 	 * @brief  		- Returns the weight of the least significant valid bit of a device's temperature
+
+ 	 * @param 		- Device : index in the device table (0 for the only probe if the table is empty)
+
+ 	 * @retval 		- °C per step - 0.5 (9-bit) to 0.0625 (12-bit)
+
+ 	 * @Note		- Raw temperatures keep their 1/16°C scale (DS18B20_TEMP_COUNTS_PER_DEGREE) - they move in steps of this size
+*/
+float DS18B20_GetLSBWeight(uint8_t Device)
+{
+	return ( (float) ( 1 << ( DS18B20_RESOLUTION_12_BIT - DS18B20_GetResolution(Device) ) ) / DS18B20_TEMP_COUNTS_PER_DEGREE );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetConvTimeUsecs
+
+ 	 * @brief  		- Returns the conversion time budget of a broadcast Convert T - the one of the slowest device
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- 93750us (every device 9-bit) to DS18B20_CONV_TIME_USECS (any device 12-bit)
+
+ 	 * @Note		- One-shot reads wait this long, pipelined reads have to be called at least this far apart
+*/
+uint32_t DS18B20_GetConvTimeUsecs(void)
+{
+	return DS18B20_ConvTimeUsecs;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetState
+
+ 	 * @brief  		- Returns the state of the interrupt driven 1-wire engine
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- DS18B20_READY or DS18B20_BUSY
+
+ 	 * @Note		- none
+*/
+uint8_t DS18B20_GetState(void)
+{
+	return DS18B20_Engine.State;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetTimestamp
+
+ 	 * @brief  		- Returns the current value of the 1-wire time base
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- Time in microseconds (free-running, rolls over every ~71.6 minutes)
+
+ 	 * @Note		- Use unsigned subtraction to compute ages (now - timestamp)
+*/
+uint32_t DS18B20_GetTimestamp(void)
+{
+	return DS18B20_TIM_PERIPHERAL->CNT;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetTemperatureTimestamp
+
+ 	 * @brief  		- Returns when the conversion behind the last DS18B20_EVENT_TEMP_READY result was started
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- Time base value (microseconds) at which Convert T was issued
+
+ 	 * @Note		- none
+*/
+uint32_t DS18B20_GetTemperatureTimestamp(void)
+{
+	return DS18B20_Engine.TempTimestamp;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_IRQHandling
+
+ 	 * @brief  		- Advances the 1-wire engine by one phase. Must be called from the IRQ handler of DS18B20_TIM_PERIPHERAL
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Ignores other events of the timer, so the IRQ can be shared with other users of the time base
+*/
+void DS18B20_IRQHandling(void)
+{
+	TIM2_5_RegDef_t *pTIMx = DS18B20_TIM_PERIPHERAL;
+
+	if( !( pTIMx->DIER & ( 1 << DS18B20_TIM_CHANNEL ) ) || !TIM2_5_GetFlagStatus(pTIMx, ( 1 << DS18B20_TIM_CHANNEL ) ) )
+	{
+		return;
+	}
+
+	TIM2_5_ClearFlag(pTIMx, ( 1 << DS18B20_TIM_CHANNEL ) );
+
+	if( DS18B20_Engine.Phase == DS18B20_PHASE_POST_DELAY )
+	{
+		DS18B20_EngineNextTransaction();
+	}
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	else if( DS18B20_Engine.Phase == DS18B20_PHASE_UART_BAUD )
+	{
+		//1. Stop bit of the reset byte is out and the master Rx phase (480us) is over - time slots run at the slot baud rate
+		USART_SetBaud(&DS18B20_USARTHandle, DS18B20_USART_SLOT_BAUD);
+
+		if( DS18B20_Engine.BitIndex >= DS18B20_EngineTotalBits(&DS18B20_Engine.Transactions[DS18B20_Engine.TransactionIndex]) )
+		{
+			DS18B20_EngineEndTransaction();
+		}
+		else
+		{
+			DS18B20_UartStartSlots();
+		}
+	}
+#else
+	else if( DS18B20_Engine.Phase == DS18B20_PHASE_RESET_RELEASE )
+	{
+		//1. Reset pulse is done - release the bus. DS18B20 waits 15-60us, then pulls the bus low for 60-240us
+		DS18B20_GPIOControl( MASTER_SET_PIN_INPUT );
+		DS18B20_Engine.PhaseStart = pTIMx->CNT;
+
+		DS18B20_Engine.Phase = DS18B20_PHASE_PRESENCE_SAMPLE;
+		TIM2_5_SetCompareIT(pTIMx, DS18B20_TIM_CHANNEL, DS18B20_Engine.PhaseStart + MASTER_RX_PRESENCE_SAMPLE_USECS);
+	}
+	else if( DS18B20_Engine.Phase == DS18B20_PHASE_PRESENCE_SAMPLE )
+	{
+		//2. Bus still high means nothing answered the reset pulse
+		if( GPIO_ReadFromInputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN) )
+		{
+			DS18B20_EngineClose(DS18B20_ERROR_NO_PRESENCE);
+			return;
+		}
+
+		//3. Fulfill 1-wire requirement of master Rx phase being at least 480us before the first time slot
+		DS18B20_Engine.Phase = DS18B20_PHASE_SLOT;
+		TIM2_5_SetCompareIT(pTIMx, DS18B20_TIM_CHANNEL, DS18B20_Engine.PhaseStart + MASTER_TX_RESET_HOLD_USECS);
+	}
+	else if( DS18B20_Engine.Phase == DS18B20_PHASE_SLOT )
+	{
+		DS18B20_EngineHandleSlot();
+	}
+#endif
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_DMAIRQHandling
+
+ 	 * @brief  		- Handles the end of a USART transport DMA transfer (echo of the reset byte or of a run of time slots). Must be
+ 	 * 				- called from the IRQ handler of the DS18B20_USART_DMA_RX_IRQ stream
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Does nothing with the GPIO transport. Only the Rx stream interrupts - the last echo comes back after the
+ 	 * 				- last byte sent, so it also marks the end of the Tx stream
+*/
+void DS18B20_DMAIRQHandling(void)
+{
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	USART_RegDef_t *pUSARTx = DS18B20_USART_PERIPHERAL;
+
+	if( DMA_GetFlagStatus(&DS18B20_DMARxHandle, DMA_FLAG_TEIF) || DMA_GetFlagStatus(&DS18B20_DMARxHandle, DMA_FLAG_DMEIF) )
+	{
+		//1. Transfer or direct mode error - stream is disabled by hardware, abandon the job
+		DMA_ClearFlag(&DS18B20_DMARxHandle, ( DMA_FLAG_TEIF | DMA_FLAG_DMEIF ) );
+		DMA_StopTransfer(&DS18B20_DMATxHandle);
+
+		pUSARTx->CR3 &= ~( ( 1 << USART_CR3_DMAR ) | ( 1 << USART_CR3_DMAT ) );
+
+		DS18B20_EngineClose(DS18B20_ERROR_TRANSPORT);
+		return;
+	}
+
+	if( !DMA_GetFlagStatus(&DS18B20_DMARxHandle, DMA_FLAG_TCIF) )
+	{
+		return;
+	}
+
+	//2. Echo of every byte is in - no DMA requests until the next transfer is set up
+	DMA_ClearFlag(&DS18B20_DMARxHandle, DMA_FLAG_TCIF);
+
+	pUSARTx->CR3 &= ~( ( 1 << USART_CR3_DMAR ) | ( 1 << USART_CR3_DMAT ) );
+
+	if( DS18B20_Engine.Phase == DS18B20_PHASE_UART_RESET )
+	{
+		//3. The reset byte comes back unchanged if nothing answered - a presence pulse clears some of its high bits
+		if( DS18B20_UartEcho[0] == DS18B20_USART_RESET_BYTE )
+		{
+			DS18B20_EngineClose(DS18B20_ERROR_NO_PRESENCE);
+			return;
+		}
+
+		//4. Echo is sampled mid stop bit - change the baud rate once the rest of it has left the shift register
+		DS18B20_Engine.Phase = DS18B20_PHASE_UART_BAUD;
+		TIM2_5_SetCompareIT(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_CHANNEL, DS18B20_TIM_PERIPHERAL->CNT + DS18B20_USART_RESET_TAIL_USECS);
+	}
+	else if( DS18B20_Engine.Phase == DS18B20_PHASE_UART_SLOTS )
+	{
+		//3. Half a stop bit (< 5us) at the slot baud rate is left - the next transfer or baud rate change starts on an idle line
+		while( !USART_GetFlagStatus(pUSARTx, USART_FLAG_TC) )
+			SIM_POLL();
+
+		DS18B20_UartEndSlots();
+	}
+#endif
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_StopAllowed
+
+ 	 * @brief  		- Tells the idle manager whether the 1-wire bus can be left in STOP mode right now
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- 1 if STOP is safe, 0 while the USART transport is shifting bytes
+
+ 	 * @Note		- Call from PWR_ApplicationStopAllowed. STOP gates the USART and DMA clocks mid time slot. The timer phases
+ 	 * 				- (GPIO transport, post delays) are scheduled compare events the idle manager wakes up for
+*/
+uint8_t DS18B20_StopAllowed(void)
+{
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	return !( ( DS18B20_Engine.State == DS18B20_BUSY ) &&
+			  ( ( DS18B20_Engine.Phase == DS18B20_PHASE_UART_RESET ) || ( DS18B20_Engine.Phase == DS18B20_PHASE_UART_SLOTS ) ) );
+#else
+	return 1;
+#endif
+}
+
+
+float DS18B20_ConvertTemp(uint8_t *TempBuffer)
+{
+	//This assumes a 2-element array is passed with MSB byte first then LSB byte last. Register is signed, 1/16°C at every resolution
+	return ( (float) DS18B20_ConvertTempRaw(TempBuffer) / DS18B20_TEMP_COUNTS_PER_DEGREE );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_ConvertTempRaw
+
+ 	 * @brief  		- API that assembles the temperature register read by the master into a signed integer
+
+ 	 * @param 		- *TempBuffer : 2-element array, MSB byte first then LSB byte last
+
+ 	 * @retval 		- Temperature in 1/16 °C (two's complement, i.e., 0x0191 = 25.0625°C, 0xFF5E = -10.125°C)
+
+ 	 * @Note		- Integer only - safe to call from an ISR without touching float routines
+
+*/
+int16_t DS18B20_ConvertTempRaw(uint8_t *TempBuffer)
+{
+	return (int16_t) ( ( TempBuffer[0] << 8 ) | TempBuffer[1] );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_CRC8
+
+ 	 * @brief  		- Dallas/Maxim 1-wire CRC-8 (x^8 + x^5 + x^4 + 1) of a ROM code or scratch pad, table driven
+
+ 	 * @param 		- *pData : bytes in bus order
+ 	 * @param 		- Len : number of bytes
+
+ 	 * @retval 		- CRC-8. Over the data and its CRC byte the result is 0
+
+ 	 * @Note		- One table lookup per byte - cheap enough for the 1-wire ISR
+*/
+uint8_t DS18B20_CRC8(const uint8_t *pData, uint8_t Len)
+{
+	uint8_t crc = 0;
+
+	while( Len-- )
+	{
+		crc = DS18B20_CRC8Table[crc ^ *pData++];
+	}
+
+	return crc;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetCRCErrors
+
+ 	 * @brief  		- Returns the number of reads (scratch pad, ROM, search pass) that failed their CRC-8 since start up
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- Reads failing their CRC, retried or not
+
+ 	 * @Note		- A count growing faster than DS18B20_GetCRCRetries means reads are being dropped (DS18B20_ERROR_CRC)
+*/
+uint32_t DS18B20_GetCRCErrors(void)
+{
+	return DS18B20_CRCErrors;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_GetCRCRetries
+
+ 	 * @brief  		- Returns the number of reads repeated after a CRC-8 mismatch since start up
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- Repeated reads
+
+ 	 * @Note		- none
+*/
+uint32_t DS18B20_GetCRCRetries(void)
+{
+	return DS18B20_CRCRetries;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DS18B20_ApplicationEventCallBack
+
+ 	 * @brief  		- Application callback for the interrupt driven 1-wire engine. To be implemented by the application
+
+ 	 * @param 		- AppEvent : Event that occurred (@DS18B20_EVENT_x / @DS18B20_ERROR_x macros)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called from the DS18B20_TIM_PERIPHERAL ISR (or the DMA ISR with the USART transport). Weak implementation that can be overwritten by the application
+*/
+__weak void DS18B20_ApplicationEventCallBack(uint8_t AppEvent)
+{
+
+}
+
+
+/*************************** Helper functions ****************************/
+
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+static uint8_t DS18B20_UartTxRx(uint8_t Data)
+{
+	//Blocking transport primitive - send one byte and return what the receiver read back off the bus while it went out
+	USART_RegDef_t *pUSARTx = DS18B20_USART_PERIPHERAL;
+
+	(void) pUSARTx->DR;
+
+	while( !USART_GetFlagStatus(pUSARTx, USART_FLAG_TXE) )
+		SIM_POLL();
+
+	pUSARTx->DR = Data;
+
+	while( !USART_GetFlagStatus(pUSARTx, USART_FLAG_RXNE) )
+		SIM_POLL();
+
+	Data = (uint8_t) pUSARTx->DR;
+
+	//Echo is sampled mid stop bit - the next byte or baud rate change has to wait for an idle line
+	while( !USART_GetFlagStatus(pUSARTx, USART_FLAG_TC) )
+		SIM_POLL();
+
+	return Data;
+}
+
+
+static void DS18B20_UartStartTransfer(uint8_t NumBytes)
+{
+	USART_RegDef_t *pUSARTx = DS18B20_USART_PERIPHERAL;
+
+	//1. Bytes are timed by the baud rate generator now - no compare event until the echo is in
+	TIM2_5_DisableCompareIT(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_CHANNEL);
+
+	//2. Drop anything left in DR, every echo has to land in the slot it belongs to. Rx stream is armed before the first byte goes out
+	(void) pUSARTx->DR;
+
+	DMA_StartTransfer(&DS18B20_DMARxHandle, (uint32_t) &( pUSARTx->DR ), (uint32_t) DS18B20_UartEcho, NumBytes);
+	DMA_StartTransfer(&DS18B20_DMATxHandle, (uint32_t) &( pUSARTx->DR ), (uint32_t) DS18B20_UartSlots, NumBytes);
+
+	pUSARTx->CR3 |= ( ( 1 << USART_CR3_DMAR ) | ( 1 << USART_CR3_DMAT ) );
+}
+
+
+static void DS18B20_UartStartSlots(void)
+{
+	DS18B20_Transaction_t *pTransaction = &DS18B20_Engine.Transactions[DS18B20_Engine.TransactionIndex];
+	uint16_t TotalBits = DS18B20_EngineTotalBits(pTransaction);
+	uint16_t bit = DS18B20_Engine.BitIndex;
+	uint8_t WriteValue;
+	uint8_t n = 0;
+
+	//1. One byte per time slot, back to back: 0xFF for a read or write '1' time slot (start bit only), 0x00 for a write '0'
+	while( ( bit < TotalBits ) && ( n < DS18B20_USART_MAX_SLOTS ) )
+	{
+		if( DS18B20_EngineSlotIsRead(pTransaction, bit) )
+		{
+			DS18B20_UartSlots[n] = 0xFF;
+		}
+		else
+		{
+			//2. ROM search branch depends on the bit and complement before it - they have to come back first
+			if( ( n ) && ( bit >= ( pTransaction->TxLen * 8 ) ) )
+			{
+				break;
+			}
+
+			if( !DS18B20_EngineSlotWriteValue(pTransaction, bit, &WriteValue) )
+			{
+				return;
+			}
+
+			DS18B20_UartSlots[n] = ( WriteValue ) ? 0xFF : 0x00;
+		}
+
+		n++;
+		bit++;
+	}
+
+	DS18B20_Engine.NumSlots = n;
+	DS18B20_Engine.Phase = DS18B20_PHASE_UART_SLOTS;
+
+	DS18B20_UartStartTransfer(n);
+}
+
+
+static void DS18B20_UartEndSlots(void)
+{
+	DS18B20_Transaction_t *pTransaction = &DS18B20_Engine.Transactions[DS18B20_Engine.TransactionIndex];
+
+	//1. A read slot comes back 0xFF for a '1' - a DS18B20 sending a '0' holds the bus low past the start bit
+	for(uint8_t i = 0; i < DS18B20_Engine.NumSlots; i++)
+	{
+		if( DS18B20_EngineSlotIsRead(pTransaction, DS18B20_Engine.BitIndex) )
+		{
+			DS18B20_EngineSlotRead(pTransaction, DS18B20_Engine.BitIndex, ( DS18B20_UartEcho[i] == 0xFF ) );
+		}
+
+		DS18B20_Engine.BitIndex++;
+	}
+
+	//2. Next run of time slots, or the transaction is done
+	if( DS18B20_Engine.BitIndex >= DS18B20_EngineTotalBits(pTransaction) )
+	{
+		DS18B20_EngineEndTransaction();
+	}
+	else
+	{
+		DS18B20_UartStartSlots();
+	}
+}
+#else
+static void DS18B20_GPIOControl(uint8_t InOrOut)
+{
+	if( InOrOut == MASTER_SET_PIN_INPUT )
+	{
+		DS18B20_GPIO_PORT->MODER &= ~( 0x3 << ( DS18B20_GPIO_PIN * 2 ) );
+	}
+	else
+	{
+		DS18B20_GPIO_PORT->MODER &= ~( 0x3 << ( DS18B20_GPIO_PIN * 2 ) ); 	//clear mode bit field first
+		DS18B20_GPIO_PORT->MODER |= ( 0x1 << ( DS18B20_GPIO_PIN * 2 ) );	//set pin as OUT
+	}
+}
+
+
+static void DS18B20_DelayUsecs(uint32_t MicroSeconds)
+{
+	//Busy-wait on the free-running time base. Waiting for one extra tick guarantees at least the requested delay
+	uint32_t start = DS18B20_TIM_PERIPHERAL->CNT;
+
+	while( ( DS18B20_TIM_PERIPHERAL->CNT - start ) <= MicroSeconds )
+		SIM_POLL();
+}
+#endif
+
+
+static uint8_t DS18B20_EngineStartJob(DS18B20_Transaction_t *pTransactions, uint8_t NumTransactions, uint8_t CmpltEvent, uint8_t ConvTransaction, uint8_t *TempBuffer, uint8_t NumTemps)
+{
+	uint8_t state = DS18B20_Engine.State;
+
+	if( ( state != DS18B20_BUSY ) && ( NumTransactions ) && ( NumTransactions <= DS18B20_MAX_TRANSACTIONS ) )
+	{
+		memcpy(DS18B20_Engine.Transactions, pTransactions, NumTransactions * sizeof(DS18B20_Transaction_t));
+		DS18B20_Engine.NumTransactions = NumTransactions;
+		DS18B20_Engine.TransactionIndex = 0;
+		DS18B20_Engine.Retries = 0;
+		DS18B20_Engine.CmpltEvent = CmpltEvent;
+		DS18B20_Engine.ConvTransaction = ConvTransaction;
+		DS18B20_Engine.pTempBuffer = TempBuffer;
+		DS18B20_Engine.NumTemps = NumTemps;
+		DS18B20_Engine.PrevConvStart = DS18B20_Engine.ConvStart;
+		DS18B20_Engine.State = DS18B20_BUSY;
+
+		DS18B20_EngineStartTransaction();
+	}
+
+	return state;
+}
+
+
+static void DS18B20_EngineStartTransaction(void)
+{
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_USART )
+	//1. Reset pulse at the reset baud rate - 0xF0 holds the bus low for 520us, DS18B20_DMAIRQHandling gets its echo
+	USART_SetBaud(&DS18B20_USARTHandle, DS18B20_USART_RESET_BAUD);
+
+	DS18B20_UartSlots[0] = DS18B20_USART_RESET_BYTE;
+
+	DS18B20_Engine.PhaseStart = DS18B20_TIM_PERIPHERAL->CNT;
+	DS18B20_Engine.BitIndex = 0;
+	DS18B20_Engine.Phase = DS18B20_PHASE_UART_RESET;
+
+	DS18B20_UartStartTransfer(1);
+#else
+	//1. Master send reset pulse - send logic low on bus, come back once 480us have passed
+	DS18B20_GPIOControl( MASTER_SET_PIN_OUTPUT );
+	GPIO_WriteToOutputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN, 0);
+
+	DS18B20_Engine.PhaseStart = DS18B20_TIM_PERIPHERAL->CNT;
+	DS18B20_Engine.BitIndex = 0;
+	DS18B20_Engine.Phase = DS18B20_PHASE_RESET_RELEASE;
+
+	TIM2_5_SetCompareIT(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_CHANNEL, DS18B20_Engine.PhaseStart + MASTER_TX_RESET_HOLD_USECS);
+#endif
+}
+
+
+static void DS18B20_EngineNextTransaction(void)
+{
+	if( DS18B20_Engine.TransactionIndex < DS18B20_Engine.NumTransactions )
+	{
+		DS18B20_EngineStartTransaction();
+	}
+	else
+	{
+		DS18B20_EngineClose(DS18B20_Engine.CmpltEvent);
+	}
+}
+
+
+static void DS18B20_EngineEndTransaction(void)
+{
+	DS18B20_Transaction_t *pTransaction = &DS18B20_Engine.Transactions[DS18B20_Engine.TransactionIndex];
+
+	//1. Data failing its CRC-8 (noise on a long cable) is read again, up to DS18B20_MAX_CRC_RETRIES times
+	if( ( pTransaction->CheckCRC ) && ( !DS18B20_CheckCRC(pTransaction->pRxBuffer, pTransaction->RxLen) ) )
+	{
+		DS18B20_CRCErrors++;
+
+		if( DS18B20_Engine.Retries < DS18B20_MAX_CRC_RETRIES )
+		{
+			DS18B20_Engine.Retries++;
+			DS18B20_CRCRetries++;
+			DS18B20_EngineStartTransaction();
+		}
+		else
+		{
+			DS18B20_EngineClose(DS18B20_ERROR_CRC);
+		}
+		return;
+	}
+
+	DS18B20_Engine.Retries = 0;
+
+	if( DS18B20_Engine.TransactionIndex == DS18B20_Engine.ConvTransaction )
+	{
+		DS18B20_Engine.ConvStart = DS18B20_TIM_PERIPHERAL->CNT;
+	}
+
+	DS18B20_Engine.TransactionIndex++;
+
+	//2. Idle for the requested time, or move straight on to the next transaction
+	if( pTransaction->PostDelayUsecs )
+	{
+		DS18B20_Engine.Phase = DS18B20_PHASE_POST_DELAY;
+		TIM2_5_SetCompareIT(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_CHANNEL, DS18B20_TIM_PERIPHERAL->CNT + pTransaction->PostDelayUsecs);
+	}
+	else
+	{
+		DS18B20_EngineNextTransaction();
+	}
+}
+
+
+static uint16_t DS18B20_EngineTotalBits(DS18B20_Transaction_t *pTransaction)
+{
+	//Command bits, data bits, then the 64 ROM search triplets (if any)
+	return ( ( pTransaction->TxLen + pTransaction->RxLen ) * 8 ) + ( ( pTransaction->pSearchROM != NULL ) ? DS18B20_SEARCH_SLOTS : 0 );
+}
+
+
+static uint8_t DS18B20_EngineSlotIsRead(DS18B20_Transaction_t *pTransaction, uint16_t Bit)
+{
+	//Command bytes are written, data bytes read. A ROM search triplet reads the ROM bit and its complement, then writes the branch taken
+	uint16_t TxBits = pTransaction->TxLen * 8;
+	uint16_t RxEnd = TxBits + ( pTransaction->RxLen * 8 );
+
+	return ( ( Bit >= TxBits ) && ( ( Bit < RxEnd ) || ( ( ( Bit - RxEnd ) % 3 ) != 2 ) ) );
+}
+
+
+static uint8_t DS18B20_EngineSlotWriteValue(DS18B20_Transaction_t *pTransaction, uint16_t Bit, uint8_t *pWriteValue)
+{
+	//Value of a write time slot, LSB first. The search branch is decided before its slot begins - returns 0 (job closed) if no device is left
+	uint16_t TxBits = pTransaction->TxLen * 8;
+	uint16_t RxEnd = TxBits + ( pTransaction->RxLen * 8 );
+	uint8_t RomBit;
+
+	if( Bit < TxBits )
+	{
+		*pWriteValue = ( ( pTransaction->pTxBuffer[Bit / 8] >> ( Bit % 8 ) ) & 0x1 );
+		return 1;
+	}
+
+	RomBit = ( Bit - RxEnd ) / 3;
+
+	if( !DS18B20_EngineSearchBranch(pTransaction->pSearchROM, RomBit + 1) )
+	{
+		//Alarm search: devices not in alarm answer the reset but stay out of the search - nobody at the first ROM bit of the
+		//first pass means no device is in alarm. Anywhere else the devices taking part were lost mid pass
+		if( ( DS18B20_CmdSearch == MASTER_COMMAND_ALARM_SEARCH ) && ( RomBit == 0 ) && ( DS18B20_Engine.SearchPasses == 0 ) &&
+			( DS18B20_Engine.SearchLastDiscrepancy == 0 ) )
+		{
+			DS18B20_EngineClose(DS18B20_EVENT_SEARCH_CMPLT);
+		}
+		else
+		{
+			DS18B20_EngineClose(DS18B20_ERROR_SEARCH);
+		}
+
+		return 0;
+	}
+
+	*pWriteValue = ( ( pTransaction->pSearchROM[RomBit / 8] >> ( RomBit % 8 ) ) & 0x1 );
+	return 1;
+}
+
+
+static void DS18B20_EngineSlotRead(DS18B20_Transaction_t *pTransaction, uint16_t Bit, uint8_t Value)
+{
+	//Data bits go to the Rx buffer LSB first, ROM search bits to the triplet (bit, then complement)
+	uint16_t TxBits = pTransaction->TxLen * 8;
+	uint16_t RxEnd = TxBits + ( pTransaction->RxLen * 8 );
+
+	if( Bit < RxEnd )
+	{
+		uint16_t RxBit = Bit - TxBits;
+		uint8_t *pRxByte = &pTransaction->pRxBuffer[RxBit / 8];
+
+		if( ( RxBit % 8 ) == 0 )
+		{
+			*pRxByte = 0;
+		}
+
+		*pRxByte |= ( Value << ( RxBit % 8 ) );
+	}
+	else if( ( ( Bit - RxEnd ) % 3 ) == 0 )
+	{
+		DS18B20_Engine.SearchBits = Value;
+	}
+	else
+	{
+		DS18B20_Engine.SearchBits |= ( Value << 1 );
+	}
+}
+
+
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_GPIO )
+static void DS18B20_EngineHandleSlot(void)
+{
+	DS18B20_Transaction_t *pTransaction = &DS18B20_Engine.Transactions[DS18B20_Engine.TransactionIndex];
+	uint16_t bit = DS18B20_Engine.BitIndex;
+	uint8_t ReadSlot;
+	uint8_t WriteValue = 0;
+
+	//1. End of the previous time slot (if any): release bus and wait recovery time in-between time slots
+	DS18B20_GPIOControl(MASTER_SET_PIN_INPUT);
+	DS18B20_DelayUsecs(MASTER_TX_RX_RECOVERY_USECS);
+
+	//2. All bits of this transaction are done
+	if( bit >= DS18B20_EngineTotalBits(pTransaction) )
+	{
+		DS18B20_EngineEndTransaction();
+		return;
+	}
+
+	//3. Write slots (command bytes, ROM search branch) know their value before the slot begins
+	ReadSlot = DS18B20_EngineSlotIsRead(pTransaction, bit);
+
+	if( ( !ReadSlot ) && ( !DS18B20_EngineSlotWriteValue(pTransaction, bit, &WriteValue) ) )
+	{
+		return;
+	}
+
+	//4. Begin the next time slot - master pulls 1-wire bus low
+	DS18B20_Engine.PhaseStart = DS18B20_TIM_PERIPHERAL->CNT;
+	DS18B20_GPIOControl(MASTER_SET_PIN_OUTPUT);
+	GPIO_WriteToOutputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN, 0);
+
+	if( !ReadSlot )
+	{
+		//5. Write time slot, LSB first. For a '1' release bus within 15us (but after at least 1us), for a '0' hold low for the whole slot
+		if( WriteValue )
+		{
+			DS18B20_DelayUsecs(MASTER_TX_WRITE_ONE_LOW_USECS);
+			DS18B20_GPIOControl(MASTER_SET_PIN_INPUT);
+		}
+	}
+	else
+	{
+		//6. Read time slot, LSB first. Release after at least 1us and sample before the data goes invalid 15us into the slot
+		DS18B20_DelayUsecs(MASTER_RX_INITIATE_USECS);
+		DS18B20_GPIOControl(MASTER_SET_PIN_INPUT);
+
+		while( ( DS18B20_TIM_PERIPHERAL->CNT - DS18B20_Engine.PhaseStart ) < MASTER_RX_SAMPLE_USECS )
+			SIM_POLL();
+
+		DS18B20_EngineSlotRead(pTransaction, bit, GPIO_ReadFromInputPin(DS18B20_GPIO_PORT, DS18B20_GPIO_PIN));
+	}
+
+	//7. Come back at the end of the time slot (min. 60us)
+	DS18B20_Engine.BitIndex++;
+	TIM2_5_SetCompareIT(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_CHANNEL, DS18B20_Engine.PhaseStart + MASTER_TX_RX_TIMESLOT_HOLD_USECS);
+}
+#endif
+
+
+static void DS18B20_EngineClose(uint8_t AppEvent)
+{
+	TIM2_5_DisableCompareIT(DS18B20_TIM_PERIPHERAL, DS18B20_TIM_CHANNEL);
+#if ( DS18B20_TRANSPORT == DS18B20_TRANSPORT_GPIO )
+	DS18B20_GPIOControl(MASTER_SET_PIN_INPUT);
+#endif
+
+	if( ( AppEvent == DS18B20_EVENT_SEARCH_CMPLT ) && ( DS18B20_Engine.SearchBits != 0x3 ) )
+	{
+		//One pass of a ROM search is done - the next one starts right away while branches are left (0x3: empty alarm search, no ROM read)
+		if( DS18B20_SearchEndPass(&AppEvent) )
+		{
+			return;
+		}
+	}
+
+	if( AppEvent == DS18B20_EVENT_TEMP_READY )
+	{
+		//Scratch pad is read LSB first - hand back MSB first to match DS18B20_ConvertTemp. Below 12-bit the low bits are undefined.
+		//TH, TL and configuration register come with every read - the settings tracked can't drift from the device's
+		for(uint8_t d = 0; d < DS18B20_Engine.NumTemps; d++)
+		{
+			uint8_t Undefined;
+
+			memcpy(DS18B20_DeviceConfig[d], &DS18B20_Scratchpad[d][2], 3);
+			Undefined = ( 1 << ( DS18B20_RESOLUTION_12_BIT - DS18B20_GetResolution(d) ) ) - 1;
+
+			DS18B20_Engine.pTempBuffer[2 * d] = DS18B20_Scratchpad[d][1];
+			DS18B20_Engine.pTempBuffer[( 2 * d ) + 1] = DS18B20_Scratchpad[d][0] & ~Undefined;
+		}
+
+		DS18B20_UpdateConvTime();
+
+		//Pipelined reads return the conversion started by the previous job, one-shot reads the one they started
+		DS18B20_Engine.TempTimestamp = ( DS18B20_Engine.ConvTransaction == 0 ) ? DS18B20_Engine.ConvStart : DS18B20_Engine.PrevConvStart;
+	}
+	else if( AppEvent == DS18B20_EVENT_CONFIG_CMPLT )
+	{
+		//Track what each device now runs with - the conversion time budget follows the slowest one
+		for(uint8_t d = 0; d < DS18B20_MAX_DEVICES; d++)
+		{
+			if( DS18B20_Engine.ConfigDevices & ( 1UL << d ) )
+			{
+				memcpy(DS18B20_DeviceConfig[d], ( DS18B20_Engine.ConfigRecall ) ? &DS18B20_Scratchpad[d][2] : DS18B20_NewConfig, 3);
+			}
+		}
+
+		DS18B20_UpdateConvTime();
+	}
+
+	//A conversion is left running on the sensor only if the job ran to its end and ended with one (pipelined mode)
+	DS18B20_Engine.ConvPending = ( ( AppEvent == DS18B20_Engine.CmpltEvent ) && ( DS18B20_Engine.ConvTransaction != DS18B20_NO_CONV_TRANSACTION ) &&
+								   ( DS18B20_Engine.ConvTransaction == ( DS18B20_Engine.NumTransactions - 1 ) ) );
+
+	DS18B20_Engine.State = DS18B20_READY;
+
+	DS18B20_ApplicationEventCallBack(AppEvent);
+}
+
+
+static uint8_t DS18B20_TemperatureJob(uint8_t *TempBuffer, uint8_t NumDevices, uint8_t Pipelined)
+{
+	//NumDevices 0: skip ROM read of the only probe. Otherwise one MATCH_ROM read per device of the table
+	DS18B20_Transaction_t Transactions[DS18B20_MAX_TRANSACTIONS];
+	uint8_t NumReads = ( NumDevices ) ? NumDevices : 1;
+	uint8_t n = 0;
+
+	memset(Transactions,0,sizeof(Transactions));
+
+	if( Pipelined )
+	{
+		if( ( DS18B20_Engine.State != DS18B20_BUSY ) && ( DS18B20_Engine.ConvPending ) &&
+			( ( DS18B20_TIM_PERIPHERAL->CNT - DS18B20_Engine.ConvStart ) < DS18B20_ConvTimeUsecs ) )
+		{
+			//Previous conversion may still be running - reading now would return the result before it
+			return DS18B20_BUSY;
+		}
+
+		if( !DS18B20_Engine.ConvPending )
+		{
+			//1. Nothing to read yet - skip ROM + Convert T only
+			Transactions[0].pTxBuffer = DS18B20_CmdConvertT;
+			Transactions[0].TxLen = sizeof(DS18B20_CmdConvertT);
+
+			return DS18B20_EngineStartJob(Transactions, 1, DS18B20_EVENT_CONV_STARTED, 0, NULL, 0);
+		}
+	}
+	else
+	{
+		//1. Skip ROM + Convert T (every probe converts at once), then wait out the conversion on the timer
+		Transactions[n].pTxBuffer = DS18B20_CmdConvertT;
+		Transactions[n].TxLen = sizeof(DS18B20_CmdConvertT);
+		Transactions[n].PostDelayUsecs = DS18B20_ConvTimeUsecs;
+		n++;
+	}
+
+	//2. Read the whole scratch pad of each probe - a read failing its CRC-8 is repeated before it can reach the application
+	for(uint8_t d = 0; d < NumReads; d++)
+	{
+		Transactions[n].pTxBuffer = ( NumDevices ) ? DS18B20_CmdMatchReadScratchpad[d] : DS18B20_CmdReadScratchpad;
+		Transactions[n].TxLen = ( NumDevices ) ? sizeof(DS18B20_CmdMatchReadScratchpad[d]) : sizeof(DS18B20_CmdReadScratchpad);
+		Transactions[n].pRxBuffer = DS18B20_Scratchpad[d];
+		Transactions[n].RxLen = sizeof(DS18B20_Scratchpad[d]);
+		Transactions[n].CheckCRC = 1;
+		n++;
+	}
+
+	//3. Pipelined: skip ROM + Convert T for the next call
+	if( Pipelined )
+	{
+		Transactions[n].pTxBuffer = DS18B20_CmdConvertT;
+		Transactions[n].TxLen = sizeof(DS18B20_CmdConvertT);
+		n++;
+	}
+
+	return DS18B20_EngineStartJob(Transactions, n, DS18B20_EVENT_TEMP_READY, ( Pipelined ) ? NumReads : 0, TempBuffer, NumReads);
+}
+
+
+static uint8_t DS18B20_SearchStartPass(void)
+{
+	//Search command followed by the 64 triplets - DS18B20_SearchROM holds the ROM of the previous pass
+	DS18B20_Transaction_t Transaction;
+	memset(&Transaction,0,sizeof(Transaction));
+
+	Transaction.pTxBuffer = &DS18B20_CmdSearch;
+	Transaction.TxLen = 1;
+	Transaction.pSearchROM = DS18B20_SearchROM;
+
+	DS18B20_Engine.SearchLastZero = 0;
+	memcpy(DS18B20_SearchPrevROM, DS18B20_SearchROM, DS18B20_ROM_LEN);
+
+	return DS18B20_EngineStartJob(&Transaction, 1, DS18B20_EVENT_SEARCH_CMPLT, DS18B20_NO_CONV_TRANSACTION, NULL, 0);
+}
+
+
+static uint8_t DS18B20_SearchEndPass(uint8_t *pAppEvent)
+{
+	uint8_t *pROM = DS18B20_SearchROM;
+
+	//1. The ROM has to pass its CRC, or the branches taken can't be trusted - the pass is repeated from the same starting point
+	if( ( pROM[0] == 0 ) || ( !DS18B20_CheckCRC(pROM, DS18B20_ROM_LEN) ) )
+	{
+		DS18B20_CRCErrors++;
+
+		if( DS18B20_Engine.SearchRetries >= DS18B20_MAX_CRC_RETRIES )
+		{
+			*pAppEvent = DS18B20_ERROR_SEARCH;
+			return 0;
+		}
+
+		DS18B20_Engine.SearchRetries++;
+		DS18B20_CRCRetries++;
+
+		memcpy(DS18B20_SearchROM, DS18B20_SearchPrevROM, DS18B20_ROM_LEN);
+		DS18B20_Engine.State = DS18B20_READY;
+		DS18B20_SearchStartPass();
+
+		return 1;
+	}
+
+	DS18B20_Engine.SearchRetries = 0;
+
+	//2. Search ROM: add a DS18B20 to the table (other families on the bus are skipped). Alarm search: flag the device of the table
+	if( DS18B20_CmdSearch == MASTER_COMMAND_SEARCH_ROM )
+	{
+		if( ( pROM[0] == DS18B20_FAMILY_CODE ) && ( DS18B20_NumDevices < DS18B20_MAX_DEVICES ) )
+		{
+			memcpy(DS18B20_DeviceROM[DS18B20_NumDevices], pROM, DS18B20_ROM_LEN);
+
+			DS18B20_CmdMatchReadScratchpad[DS18B20_NumDevices][0] = MASTER_COMMAND_MATCH_ROM;
+			memcpy(&DS18B20_CmdMatchReadScratchpad[DS18B20_NumDevices][1], pROM, DS18B20_ROM_LEN);
+			DS18B20_CmdMatchReadScratchpad[DS18B20_NumDevices][DS18B20_ROM_LEN + 1] = MASTER_COMMAND_READ_SCRATCHPAD;
+
+			//Settings of a new device are unknown until written / recalled - assume the slowest
+			memcpy(DS18B20_DeviceConfig[DS18B20_NumDevices], DS18B20_DefaultConfig, sizeof(DS18B20_DefaultConfig));
+
+			DS18B20_NumDevices++;
+			DS18B20_UpdateConvTime();
+		}
+	}
+	else
+	{
+		for(uint8_t d = 0; d < DS18B20_NumDevices; d++)
+		{
+			if( memcmp(DS18B20_DeviceROM[d], pROM, DS18B20_ROM_LEN) == 0 )
+			{
+				DS18B20_AlarmDevices |= ( 1UL << d );
+			}
+		}
+	}
+
+	//3. Done once no discrepancy was left at 0 (or the table is full), otherwise take the 1 branch of the last one
+	DS18B20_Engine.SearchLastDiscrepancy = DS18B20_Engine.SearchLastZero;
+
+	if( ( DS18B20_Engine.SearchLastDiscrepancy == 0 ) || ( ( DS18B20_CmdSearch == MASTER_COMMAND_SEARCH_ROM ) && ( DS18B20_NumDevices == DS18B20_MAX_DEVICES ) ) )
+	{
+		return 0;
+	}
+
+	if( ++DS18B20_Engine.SearchPasses >= DS18B20_MAX_SEARCH_PASSES )
+	{
+		*pAppEvent = DS18B20_ERROR_SEARCH;
+		return 0;
+	}
+
+	DS18B20_Engine.State = DS18B20_READY;
+	DS18B20_SearchStartPass();
+
+	return 1;
+}
+
+
+static uint8_t DS18B20_EngineSearchBranch(uint8_t *pROM, uint8_t BitNumber)
+{
+	//Picks the value of ROM bit BitNumber (1-64) from the bit and complement just read. Returns 0 if no device is left on the search
+	uint8_t Direction;
+	uint8_t Mask = ( 1 << ( ( BitNumber - 1 ) % 8 ) );
+	uint8_t *pByte = &pROM[( BitNumber - 1 ) / 8];
+
+	if( DS18B20_Engine.SearchBits == 0x3 )
+	{
+		return 0;
+	}
+
+	if( DS18B20_Engine.SearchBits != 0x0 )
+	{
+		//Every device left has the same value - the bit read
+		Direction = ( DS18B20_Engine.SearchBits & 0x1 );
+	}
+	else
+	{
+		//Discrepancy - same branch as the previous pass before its last discrepancy, 1 at it, 0 after it
+		if( BitNumber < DS18B20_Engine.SearchLastDiscrepancy )
+		{
+			Direction = ( ( *pByte & Mask ) != 0 );
+		}
+		else
+		{
+			Direction = ( BitNumber == DS18B20_Engine.SearchLastDiscrepancy );
+		}
+
+		if( !Direction )
+		{
+			DS18B20_Engine.SearchLastZero = BitNumber;
+		}
+	}
+
+	if( Direction )
+	{
+		*pByte |= Mask;
+	}
+	else
+	{
+		*pByte &= ~Mask;
+	}
+
+	return 1;
+}
+
+
+static uint8_t DS18B20_AddressCommand(uint8_t *pCmd, uint8_t Device, uint8_t Command)
+{
+	//Skip ROM for a broadcast or the only probe, Match ROM + ROM code for a device of the table. Returns the command length
+	uint8_t len = 0;
+
+	if( ( Device == DS18B20_ALL_DEVICES ) || ( DS18B20_NumDevices == 0 ) )
+	{
+		pCmd[len++] = MASTER_COMMAND_SKIP_ROM;
+	}
+	else
+	{
+		pCmd[len++] = MASTER_COMMAND_MATCH_ROM;
+		memcpy(&pCmd[len], DS18B20_DeviceROM[Device], DS18B20_ROM_LEN);
+		len += DS18B20_ROM_LEN;
+	}
+
+	pCmd[len++] = Command;
+
+	return len;
+}
+
+
+static void DS18B20_UpdateConvTime(void)
+{
+	uint8_t NumDevices = ( DS18B20_NumDevices ) ? DS18B20_NumDevices : 1;
+	uint8_t Resolution = DS18B20_RESOLUTION_9_BIT;
+
+	for(uint8_t d = 0; d < NumDevices; d++)
+	{
+		if( DS18B20_GetResolution(d) > Resolution )
+		{
+			Resolution = DS18B20_GetResolution(d);
+		}
+	}
+
+	DS18B20_ConvTimeUsecs = DS18B20_CONV_TIME_RES_USECS(Resolution);
+}
+
+
+static uint8_t DS18B20_CheckCRC(const uint8_t *pData, uint8_t Len)
+{
+	//Last byte is the CRC-8 of the ones before it. All zeros (bus held low) has a valid CRC - not valid data though
+	uint8_t Zeros = 0;
+
+	for(uint8_t i = 0; i < Len; i++)
+	{
+		Zeros |= pData[i];
+	}
+
+	return ( ( Zeros != 0 ) && ( DS18B20_CRC8(pData, Len - 1) == pData[Len - 1] ) );
+}
+
+
+static uint8_t DS18B20_MasterReadChecked(uint8_t *pCmd, uint8_t CmdLen, uint8_t *pRxBuffer, uint8_t RxLen)
+{
+	uint8_t RxBuffer[DS18B20_SCRATCHPAD_LEN];
+	uint8_t Retries = 0;
+
+	while(1)
+	{
+		//1. Reset + command, then every byte including the CRC - a partial read is never handed back
+		DS18B20_MasterSendInitializeSequence();
+		DS18B20_MasterSendData(pCmd, CmdLen);
+		DS18B20_MasterReceiveData(RxBuffer, RxLen);
+
+		//2. DS18B20_MasterReceiveData stores the first byte last - put it back in bus order
+		for(uint8_t i = 0; i < RxLen; i++)
+		{
+			pRxBuffer[i] = RxBuffer[RxLen - 1 - i];
+		}
+
+		if( DS18B20_CheckCRC(pRxBuffer, RxLen) )
+		{
+			return DS18B20_EVENT_TRANSFER_CMPLT;
+		}
+
+		DS18B20_CRCErrors++;
+
+		if( Retries >= DS18B20_MAX_CRC_RETRIES )
+		{
+			return DS18B20_ERROR_CRC;
+		}
+
+		Retries++;
+		DS18B20_CRCRetries++;
 	}
 }
@@ -0,0 +1,240 @@
+/*
+ * water_quality_sensors.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "water_quality_sensors.h"
+
+/*********** Driver-specific helper functions prototype section ***********/
+static uint32_t WQ_Q16_CountsToVolts(uint32_t Counts, uint32_t FullScale);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- WQ_ProcessReadings
+
+ 	 * @brief  		- API that converts raw ADC counts and the DS18B20 register into ppm, tenths of a percent and °C
+
+ 	 * @param 		- *pRaw : raw readings of one sample period
+ 	 * @param 		- *pReadings : converted readings
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Runs the fixed point pipeline if WQ_USE_FIXED_POINT is set, otherwise the float pipeline
+
+*/
+void WQ_ProcessReadings(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings)
+{
+#if WQ_USE_FIXED_POINT
+	WQ_ProcessReadingsFixed(pRaw, pReadings);
+#else
+	WQ_ProcessReadingsFloat(pRaw, pReadings);
+#endif
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- WQ_ProcessReadingsFixed
+
+ 	 * @brief  		- API that runs the conversion pipeline in integer math (Q16 volts and coefficients)
+
+ 	 * @param 		- *pRaw : raw readings of one sample period
+ 	 * @param 		- *pReadings : converted readings
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- No float or double routines are pulled in - only 32x32->64 bit multiplies and 32 bit divides.
+ 	 * 				- Results truncate like the float pipeline's casts do, so both agree within 1 LSB
+
+*/
+void WQ_ProcessReadingsFixed(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings)
+{
+	int32_t Coef;
+	uint32_t Volts, CompensatedVolts;
+	int64_t Acc;
+	int32_t ppm;
+
+	//1. Temperature compensation coefficient = 1 + 0.02 * (T - 25). T is in 1/16 °C, so 1 LSB = 0.02 / 16 = 8192 / 100 in Q16
+	if( pRaw->TemperatureValid )
+	{
+		Coef = WQ_Q16_ONE + ( ( (int32_t) pRaw->TemperatureRaw - ( 25 * 16 ) ) * 8192 ) / 100;
+
+		if( Coef < WQ_Q16_TDS_MIN_TEMP_COEF )
+		{
+			Coef = WQ_Q16_TDS_MIN_TEMP_COEF;
+		}
+	}
+	else
+	{
+		Coef = WQ_Q16_ONE;
+	}
+
+	//2. TDS - compensate voltage. Numerator is pre-shifted by 14 only so it stays in 32 bits (3.3V max), divisor loses the same 2 bits
+	Volts = WQ_Q16_CountsToVolts(pRaw->TDSCounts, pRaw->TDSFullScale);
+	CompensatedVolts = ( Volts << 14 ) / ( (uint32_t) Coef >> 2 );
+
+	//2.1 Cubic fit of the sensor (halved) evaluated with Horner's method: ((a3 * V + a2) * V + a1) * V
+	Acc = WQ_Q16_TDS_CUBIC_A3;
+	Acc = ( ( Acc * CompensatedVolts ) >> 16 ) + WQ_Q16_TDS_CUBIC_A2;
+	Acc = ( ( Acc * CompensatedVolts ) >> 16 ) + WQ_Q16_TDS_CUBIC_A1;
+	Acc = ( ( Acc * CompensatedVolts ) >> 16 ) >> 16;
+
+	if( Acc > WQ_TDS_MAX_PPM )
+	{
+		Acc = WQ_TDS_MAX_PPM;
+	}
+
+	//2.2 Calibrate: CorrectedValue = 5.84 * MeasuredValue - 41
+	ppm = (int32_t) ( ( (uint64_t) Acc * WQ_Q16_TDS_CAL_GAIN ) >> 16 ) - WQ_TDS_CAL_OFFSET;
+
+	if( ppm < 0 )
+	{
+		ppm = 0;
+	}
+	else if( ppm > WQ_TDS_MAX_PPM )
+	{
+		ppm = WQ_TDS_MAX_PPM;
+	}
+
+	pReadings->TDSppm = (uint16_t) ppm;
+
+	//3. Turbidity - 0V = 3.5%, anything above the guard banded 1.53V is 100% clear
+	Volts = WQ_Q16_CountsToVolts(pRaw->TurbidityCounts, pRaw->TurbidityFullScale);
+
+	if( Volts > WQ_Q16_TURBIDITY_CLEAR_VOLTS )
+	{
+		pReadings->TurbidityTenths = 0;
+	}
+	else
+	{
+		uint32_t Percentage = WQ_Q16_TURBIDITY_MAX_PERCENT - ( ( (uint64_t) Volts * WQ_Q16_TURBIDITY_STEP ) >> 16 );
+		pReadings->TurbidityTenths = (uint16_t) ( ( Percentage * 10 ) >> 16 );
+	}
+
+	//4. Temperature - 1/16 °C to 1/100 °C
+	pReadings->TemperatureCentiDeg = (int16_t) ( ( (int32_t) pRaw->TemperatureRaw * 25 ) / 4 );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- WQ_ProcessReadingsFloat
+
+ 	 * @brief  		- API that runs the conversion pipeline in floating point
+
+ 	 * @param 		- *pRaw : raw readings of one sample period
+ 	 * @param 		- *pReadings : converted readings
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Reference implementation - same math the application used to run in the ADC ISR
+
+*/
+void WQ_ProcessReadingsFloat(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings)
+{
+	float Temperature, Coef, Volts, CompensatedVolts, TDSppm, TurbidityPercentage;
+	uint16_t UncalibratedTDSppm;
+
+	//1. Temperature compensation coefficient
+	Temperature = pRaw->TemperatureRaw / 16.0f;
+
+	if( pRaw->TemperatureValid )
+	{
+		Coef = 1.0f + ( WQ_TDS_TEMP_COEF_PER_DEG * ( Temperature - WQ_TDS_REF_TEMP_DEG ) );
+
+		if( Coef < WQ_TDS_MIN_TEMP_COEF )
+		{
+			Coef = WQ_TDS_MIN_TEMP_COEF;
+		}
+	}
+	else
+	{
+		Coef = 1.0f;
+	}
+
+	//2. TDS - compensate voltage, then convert voltage value to tds value
+	Volts = pRaw->TDSCounts * WQ_VREF_VOLTS / pRaw->TDSFullScale;
+	CompensatedVolts = Volts / Coef;
+
+	TDSppm = (133.42f*CompensatedVolts*CompensatedVolts*CompensatedVolts - 255.86f*CompensatedVolts*CompensatedVolts + 857.39f*CompensatedVolts) * 0.5f;
+
+	if( TDSppm > (float) WQ_TDS_MAX_PPM )
+	{
+		TDSppm = WQ_TDS_MAX_PPM;
+	}
+
+	UncalibratedTDSppm = TDSppm;
+
+	//2.1 Calibrate: CorrectedValue = 5.84 * MeasuredValue - 41
+	TDSppm = 5.84f * UncalibratedTDSppm - WQ_TDS_CAL_OFFSET;
+
+	if( TDSppm < 0.0f )
+	{
+		TDSppm = 0.0f;
+	}
+	else if( TDSppm > (float) WQ_TDS_MAX_PPM )
+	{
+		TDSppm = WQ_TDS_MAX_PPM;
+	}
+
+	pReadings->TDSppm = TDSppm;
+
+	//3. Turbidity
+	Volts = pRaw->TurbidityCounts * WQ_VREF_VOLTS / pRaw->TurbidityFullScale;
+
+	if( Volts > WQ_TURBIDITY_CLEAR_VOLTS )
+	{
+		pReadings->TurbidityTenths = 0;
+	}
+	else
+	{
+		TurbidityPercentage = WQ_TURBIDITY_MAX_PERCENT - Volts * ( WQ_TURBIDITY_MAX_PERCENT / WQ_TURBIDITY_CLEAR_VOLTS );
+		pReadings->TurbidityTenths = TurbidityPercentage * 10.0f;
+	}
+
+	//4. Temperature
+	pReadings->TemperatureCentiDeg = Temperature * 100.0f;
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- WQ_Q16_CountsToVolts
+
+ 	 * @brief  		- Helper API that scales an ADC result to volts in Q16
+
+ 	 * @param 		- Counts : ADC result
+ 	 * @param 		- FullScale : ADC result at VDDA
+
+ 	 * @retval 		- Voltage * 65536
+
+ 	 * @Note		- Counts are first turned into a Q16 fraction of full scale so any resolution (oversampled or not) fits
+
+*/
+static uint32_t WQ_Q16_CountsToVolts(uint32_t Counts, uint32_t FullScale)
+{
+	uint32_t Fraction;
+
+	if( Counts >= FullScale )
+	{
+		return WQ_Q16_VREF;
+	}
+
+	//Results are at most 16 bits (12 bit ADC + 4 enhanced bits), so the shifted count still fits a 32 bit divide
+	Fraction = ( Counts << 16 ) / FullScale;
+
+	return (uint32_t) ( ( (uint64_t) Fraction * WQ_Q16_VREF ) >> 16 );
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -17,34 +17,121 @@
 #define __vo 									volatile
 #define __weak									__attribute__ ((weak))
 
+/*
+ * Host build (host/Makefile) - every register below is backed by the simulated register file in host/sim instead of the
+ * MCU memory map. SIM_POLL() lets the simulator's behavioural models run while a driver waits on a flag (nothing on target)
+ */
+#ifdef STM32F407VG_HOST_SIM
+#include "stm32f407vg_sim_regs.h"
+#define SIM_POLL()								SIM_Poll()
+#else
+#define SIM_POLL()
+#endif
+
 
 
 /*		-----------------------------------		START: Processor Specific Details		-----------------------------------		*/
 
+/*
+ * ARM Cortex M4 processor private peripheral bus base address (NVIC, SCB, DWT)
+ */
+
+#ifdef STM32F407VG_HOST_SIM
+#define CORE_PERIPH_BASE_ADDR					SIM_CORE_REG_FILE_ADDR
+#else
+#define CORE_PERIPH_BASE_ADDR					0xE0000000U
+#endif
+
 /*
  * ARM Cortex M4 processor NVIC interrupt set-enable register addresses
  */
 
-#define NVIC_ISER0								( (__vo uint32_t*) 0xE000E100 )
-#define NVIC_ISER1								( (__vo uint32_t*) 0xE000E104 )
-#define NVIC_ISER2								( (__vo uint32_t*) 0xE000E108 )
+#define NVIC_ISER0								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE100 ) )
+#define NVIC_ISER1								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE104 ) )
+#define NVIC_ISER2								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE108 ) )
 
 /*
  * ARM Cortex M4 processor NVIC interrupt clear-enable register addresses
  */
 
-#define NVIC_ICER0								( (__vo uint32_t*) 0xE000E180 )
-#define NVIC_ICER1								( (__vo uint32_t*) 0xE000E104 )
-#define NVIC_ICER2								( (__vo uint32_t*) 0xE000E108 )
+#define NVIC_ICER0								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE180 ) )
+#define NVIC_ICER1								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE184 ) )
+#define NVIC_ICER2								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE188 ) )
 
 /*
  * ARM Cortex M4 processor NVIC interrupt priority registers base address
  */
 
-#define NVIC_IPR_BASE_ADDR						( (__vo uint32_t*) 0xE000E400 )
+#define NVIC_IPR_BASE_ADDR						( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xE400 ) )
 
 #define NO_PR_BITS_IMPLEMENTED					4
 
+/*
+ * ARM Cortex M4 processor debug registers used for cycle counting (DWT cycle counter)
+ */
+
+#define DEMCR									( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xEDFC ) )	//Debug exception and monitor control register
+#define DWT_CTRL								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0x1000 ) )	//DWT control register
+#define DWT_CYCCNT								( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0x1004 ) )	//DWT cycle count register
+
+#define DEMCR_TRCENA							24										//Enables DWT (trace) block
+#define DWT_CTRL_CYCCNTENA						0										//Enables cycle counter
+
+/*
+ * ARM Cortex M4 processor system control register - what WFI does (Sleep, or the deep sleep the PWR peripheral turns into STOP)
+ */
+
+#define SCB_SCR									( (__vo uint32_t*) ( CORE_PERIPH_BASE_ADDR + 0xED10 ) )	//System control register
+
+#define SCB_SCR_SLEEPONEXIT						1										//Sleep again when the last ISR returns
+#define SCB_SCR_SLEEPDEEP						2										//WFI enters deep sleep (STOP/Standby, see PWR_CR)
+
+/*
+ * ARM Cortex M4 processor interrupt masking (PRIMASK) for short critical sections shared between ISRs of different priorities
+ * NOTE: ENTER saves the current mask in its uint32_t argument, so critical sections nest and can be entered from any ISR
+ */
+
+#ifdef STM32F407VG_HOST_SIM
+#define CRITICAL_SECTION_ENTER(primask)			do{ (primask) = SIM_PRIMASK; SIM_PRIMASK = 1; }while(0)
+#define CRITICAL_SECTION_EXIT(primask)			do{ SIM_PRIMASK = (primask); }while(0)
+#else
+#define CRITICAL_SECTION_ENTER(primask)			__asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory")
+#define CRITICAL_SECTION_EXIT(primask)			__asm volatile ("msr primask, %0" : : "r" (primask) : "memory")
+#endif
+
+/*
+ * ARM Cortex M4 processor execution context - code that waits on an interrupt must be in thread mode (IPSR = 0) with PRIMASK clear
+ */
+
+#ifdef STM32F407VG_HOST_SIM
+#define CPU_IN_HANDLER_MODE()					( SIM_InISR != 0 )
+#define CPU_IRQ_MASKED()						( SIM_PRIMASK != 0 )
+#else
+#define CPU_IN_HANDLER_MODE()					({ uint32_t ipsr; __asm volatile ("mrs %0, ipsr" : "=r" (ipsr)); ( ( ipsr & 0x1FF ) != 0 ); })
+#define CPU_IRQ_MASKED()						({ uint32_t primask; __asm volatile ("mrs %0, primask" : "=r" (primask)); ( ( primask & 1 ) != 0 ); })
+#endif
+
+/*
+ * ARM Cortex M4 processor data memory barrier - orders a buffer write before the index write that publishes it (lock-free rings)
+ */
+
+#ifdef STM32F407VG_HOST_SIM
+#define MEMORY_BARRIER()						__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define MEMORY_BARRIER()						__asm volatile ("dmb" : : : "memory")
+#endif
+
+/*
+ * ARM Cortex M4 processor wait for interrupt - also returns on an interrupt that is pending while PRIMASK is set (its ISR
+ * runs once PRIMASK is cleared)
+ */
+
+#ifdef STM32F407VG_HOST_SIM
+#define CPU_WAIT_FOR_INTERRUPT()				SIM_WaitForInterrupt()
+#else
+#define CPU_WAIT_FOR_INTERRUPT()				__asm volatile ("dsb\n\twfi\n\tisb" : : : "memory")
+#endif
+
 
 /*		-----------------------------------		END: Processor Specific Details		-----------------------------------		*/
 
@@ -65,10 +152,14 @@
  * AHBx and APBx bus peripheral base addresses
  */
 
+#ifdef STM32F407VG_HOST_SIM
+#define PERIPH_BASE_ADDR 						SIM_PERIPH_REG_FILE_ADDR			//Simulated register file (host build)
+#else
 #define PERIPH_BASE_ADDR 						0x40000000U							//Base address of all peripherals supported by STM32F407
+#endif
 #define APB1PERIPH_BASE_ADDR 					PERIPH_BASE_ADDR 					//Base address of APB1 peripheral base
-#define APB2PERIPH_BASE_ADDR					0x40010000U 						//Base address of APB2 peripheral base
-#define AHB1PERIPH_BASE_ADDR					0x40020000U 						//Base address of AHB1 peripheral base
+#define APB2PERIPH_BASE_ADDR					(PERIPH_BASE_ADDR + 0x10000) 		//Base address of APB2 peripheral base
+#define AHB1PERIPH_BASE_ADDR					(PERIPH_BASE_ADDR + 0x20000) 		//Base address of AHB1 peripheral base
 #define AHB2PERIPH_BASE_ADDR 					0x50000000U							//Base address of AHB2 peripheral base
 
 /*
@@ -86,6 +177,10 @@
 #define GPIOI_BASE_ADDR 						(AHB1PERIPH_BASE_ADDR + 0x2000)		//Base address of GPIOI port peripheral
 
 #define RCC_BASE_ADDR							(AHB1PERIPH_BASE_ADDR + 0x3800)		//Base address of RCC peripheral
+#define FLASH_R_BASE_ADDR						(AHB1PERIPH_BASE_ADDR + 0x3C00)		//Base address of FLASH interface registers
+
+#define DMA1_BASE_ADDR							(AHB1PERIPH_BASE_ADDR + 0x6000)		//Base address of DMA1 controller
+#define DMA2_BASE_ADDR							(AHB1PERIPH_BASE_ADDR + 0x6400)		//Base address of DMA2 controller
 
 /*
  * Base addresses of peripherals which are hanging on APB1 bus (peripherals listed are only those that used in this project)
@@ -104,8 +199,13 @@
 #define UART5_BASE_ADDR 						(APB1PERIPH_BASE_ADDR + 0x5000)		//Base address of UART5 peripheral
 
 #define TIM2_BASE_ADDR							(APB1PERIPH_BASE_ADDR)				//Base address of TIM2 peripheral
+#define TIM3_BASE_ADDR							(APB1PERIPH_BASE_ADDR + 0x0400)		//Base address of TIM3 peripheral
+#define TIM4_BASE_ADDR							(APB1PERIPH_BASE_ADDR + 0x0800)		//Base address of TIM4 peripheral
 #define TIM5_BASE_ADDR							(APB1PERIPH_BASE_ADDR + 0x0C00)		//Base address of TIM5 peripheral
 
+#define RTC_BASE_ADDR							(APB1PERIPH_BASE_ADDR + 0x2800)		//Base address of RTC and backup registers
+#define PWR_BASE_ADDR							(APB1PERIPH_BASE_ADDR + 0x7000)		//Base address of PWR peripheral
+
 /*
  * Base addresses of peripherals which are hanging on APB2 bus (peripherals listed are only those that used in this project)
  */
@@ -325,6 +425,86 @@ typedef struct
 	__vo uint32_t 	TIM_OR;				/* TIM option register												Address Offset: 0x50 */
 }TIM2_5_RegDef_t;
 
+/*
+ * DMA stream specific registers structure definition (one per stream, 8 streams per DMA controller)
+ */
+
+typedef struct
+{
+	__vo uint32_t 	CR;					/* DMA stream x configuration register								Address Offset: 0x10 + 0x18 * x */
+	__vo uint32_t 	NDTR;				/* DMA stream x number of data register								Address Offset: 0x14 + 0x18 * x */
+	__vo uint32_t 	PAR;				/* DMA stream x peripheral address register							Address Offset: 0x18 + 0x18 * x */
+	__vo uint32_t 	M0AR;				/* DMA stream x memory 0 address register							Address Offset: 0x1C + 0x18 * x */
+	__vo uint32_t 	M1AR;				/* DMA stream x memory 1 address register							Address Offset: 0x20 + 0x18 * x */
+	__vo uint32_t 	FCR;				/* DMA stream x FIFO control register								Address Offset: 0x24 + 0x18 * x */
+}DMA_Stream_RegDef_t;
+
+/*
+ * DMA controller registers structure definition
+ */
+
+typedef struct
+{
+	__vo uint32_t 			LISR;		/* DMA low interrupt status register (streams 0-3)					Address Offset: 0x00 */
+	__vo uint32_t 			HISR;		/* DMA high interrupt status register (streams 4-7)					Address Offset: 0x04 */
+	__vo uint32_t 			LIFCR;		/* DMA low interrupt flag clear register (streams 0-3)				Address Offset: 0x08 */
+	__vo uint32_t 			HIFCR;		/* DMA high interrupt flag clear register (streams 4-7)				Address Offset: 0x0C */
+	DMA_Stream_RegDef_t 	STREAM[8];	/* DMA stream 0-7 registers											Address Offset: 0x10 - 0xCC */
+}DMA_RegDef_t;
+
+/*
+ * FLASH interface registers structure definition
+ */
+
+typedef struct
+{
+	__vo uint32_t 	ACR;				/* Flash access control register									Address Offset: 0x00 */
+	__vo uint32_t 	KEYR;				/* Flash key register												Address Offset: 0x04 */
+	__vo uint32_t 	OPTKEYR;			/* Flash option key register										Address Offset: 0x08 */
+	__vo uint32_t 	SR;					/* Flash status register											Address Offset: 0x0C */
+	__vo uint32_t 	CR;					/* Flash control register											Address Offset: 0x10 */
+	__vo uint32_t 	OPTCR;				/* Flash option control register									Address Offset: 0x14 */
+}FLASH_RegDef_t;
+
+/*
+ * PWR peripheral registers structure definition
+ */
+
+typedef struct
+{
+	__vo uint32_t 	CR;					/* PWR power control register										Address Offset: 0x00 */
+	__vo uint32_t 	CSR;				/* PWR power control/status register								Address Offset: 0x04 */
+}PWR_RegDef_t;
+
+/*
+ * RTC peripheral registers structure definition
+ */
+
+typedef struct
+{
+	__vo uint32_t 	TR;					/* RTC time register												Address Offset: 0x00 */
+	__vo uint32_t 	DR;					/* RTC date register												Address Offset: 0x04 */
+	__vo uint32_t 	CR;					/* RTC control register												Address Offset: 0x08 */
+	__vo uint32_t 	ISR;				/* RTC initialization and status register							Address Offset: 0x0C */
+	__vo uint32_t 	PRER;				/* RTC prescaler register											Address Offset: 0x10 */
+	__vo uint32_t 	WUTR;				/* RTC wakeup timer register										Address Offset: 0x14 */
+	__vo uint32_t 	CALIBR;				/* RTC calibration register											Address Offset: 0x18 */
+	__vo uint32_t 	ALRMAR;				/* RTC alarm A register												Address Offset: 0x1C */
+	__vo uint32_t 	ALRMBR;				/* RTC alarm B register												Address Offset: 0x20 */
+	__vo uint32_t 	WPR;				/* RTC write protection register									Address Offset: 0x24 */
+	__vo uint32_t 	SSR;				/* RTC sub second register											Address Offset: 0x28 */
+	__vo uint32_t 	SHIFTR;				/* RTC shift control register										Address Offset: 0x2C */
+	__vo uint32_t 	TSTR;				/* RTC time stamp time register										Address Offset: 0x30 */
+	__vo uint32_t 	TSDR;				/* RTC time stamp date register										Address Offset: 0x34 */
+	__vo uint32_t 	TSSSR;				/* RTC time stamp sub second register								Address Offset: 0x38 */
+	__vo uint32_t 	CALR;				/* RTC calibration register											Address Offset: 0x3C */
+	__vo uint32_t 	TAFCR;				/* RTC tamper and alternate function configuration register			Address Offset: 0x40 */
+	__vo uint32_t 	ALRMASSR;			/* RTC alarm A sub second register									Address Offset: 0x44 */
+	__vo uint32_t 	ALRMBSSR;			/* RTC alarm B sub second register									Address Offset: 0x48 */
+	uint32_t 		RESERVED0;			/* Reserved memory space											Address Offset: 0x4C */
+	__vo uint32_t 	BKPR[20];			/* RTC backup registers												Address Offset: 0x50 - 0x9C */
+}RTC_RegDef_t;
+
 
 /*
  * Peripheral definitions (peripheral base addresses type-casted to the appropriate register structure)
@@ -342,6 +522,12 @@ typedef struct
 
 #define RCC										( (RCC_RegDef_t* ) RCC_BASE_ADDR )
 
+#define FLASH									( (FLASH_RegDef_t* ) FLASH_R_BASE_ADDR )
+
+#define PWR										( (PWR_RegDef_t* ) PWR_BASE_ADDR )
+
+#define RTC										( (RTC_RegDef_t* ) RTC_BASE_ADDR )
+
 #define EXTI									( (EXTI_RegDef_t* ) EXTI_BASE_ADDR )
 
 #define SYSCFG									( (SYSCFG_RegDef_t* ) SYSCFG_BASE_ADDR )
@@ -367,8 +553,13 @@ typedef struct
 #define ADCCOMMON								( (ADC_Common_RegDef_t* ) ADC_COMMON_REG_BASE_ADDR )
 
 #define TIM2 									( ( TIM2_5_RegDef_t *) TIM2_BASE_ADDR )
+#define TIM3 									( ( TIM2_5_RegDef_t *) TIM3_BASE_ADDR )
+#define TIM4 									( ( TIM2_5_RegDef_t *) TIM4_BASE_ADDR )
 #define TIM5 									( ( TIM2_5_RegDef_t *) TIM5_BASE_ADDR )
 
+#define DMA1									( (DMA_RegDef_t* ) DMA1_BASE_ADDR )
+#define DMA2									( (DMA_RegDef_t* ) DMA2_BASE_ADDR )
+
 /*
  * Clock enable macros for GPIOx peripherals
  */
@@ -434,8 +625,23 @@ typedef struct
  */
 
 #define TIM2_PCLK_EN()							( RCC -> APB1ENR |= ( 1 << 0 ) )			//Enabling clock to TIM2 peripheral
+#define TIM3_PCLK_EN()							( RCC -> APB1ENR |= ( 1 << 1 ) )			//Enabling clock to TIM3 peripheral
+#define TIM4_PCLK_EN()							( RCC -> APB1ENR |= ( 1 << 2 ) )			//Enabling clock to TIM4 peripheral
 #define TIM5_PCLK_EN()							( RCC -> APB1ENR |= ( 1 << 3 ) )			//Enabling clock to TIM5 peripheral
 
+/*
+ * Clock enable macros for DMAx controllers
+ */
+
+#define DMA1_PCLK_EN()							( RCC -> AHB1ENR |= ( 1 << 21 ) )			//Enabling clock to DMA1 controller
+#define DMA2_PCLK_EN()							( RCC -> AHB1ENR |= ( 1 << 22 ) )			//Enabling clock to DMA2 controller
+
+/*
+ * Clock enable macro for the PWR peripheral
+ */
+
+#define PWR_PCLK_EN()							( RCC -> APB1ENR |= ( 1 << 28 ) )			//Enabling clock to PWR peripheral
+
 
 /*
  * Clock disable macros for GPIOx peripherals
@@ -501,8 +707,23 @@ typedef struct
  */
 
 #define TIM2_PCLK_DI()							( RCC -> APB1ENR &= ~( 1 << 0 ) )			//Disable clock to TIM2 peripheral
+#define TIM3_PCLK_DI()							( RCC -> APB1ENR &= ~( 1 << 1 ) )			//Disable clock to TIM3 peripheral
+#define TIM4_PCLK_DI()							( RCC -> APB1ENR &= ~( 1 << 2 ) )			//Disable clock to TIM4 peripheral
 #define TIM5_PCLK_DI()							( RCC -> APB1ENR &= ~( 1 << 3 ) )			//Disable clock to TIM2 peripheral
 
+/*
+ * Clock disable macros for DMAx controllers
+ */
+
+#define DMA1_PCLK_DI()							( RCC -> AHB1ENR &= ~( 1 << 21 ) )			//Disabling clock to DMA1 controller
+#define DMA2_PCLK_DI()							( RCC -> AHB1ENR &= ~( 1 << 22 ) )			//Disabling clock to DMA2 controller
+
+/*
+ * Clock disable macro for the PWR peripheral
+ */
+
+#define PWR_PCLK_DI()							( RCC -> APB1ENR &= ~( 1 << 28 ) )			//Disabling clock to PWR peripheral
+
 
 /*
  * Register reset macros for PGIOx peripherals
@@ -556,8 +777,17 @@ typedef struct
  */
 
 #define TIM2_REG_RESET()						( do{ ( RCC -> APB1RSTR |= ( 1 << 0 ) );		( RCC -> APB1RSTR &= ~( 1 << 0 ) ); }while(0) )	//Setting and clearing the reset bit of the RCC peripheral reset register for TIM2 peripheral interface.
+#define TIM3_REG_RESET()						( do{ ( RCC -> APB1RSTR |= ( 1 << 1 ) );		( RCC -> APB1RSTR &= ~( 1 << 1 ) ); }while(0) )	//Setting and clearing the reset bit of the RCC peripheral reset register for TIM3 peripheral interface.
+#define TIM4_REG_RESET()						( do{ ( RCC -> APB1RSTR |= ( 1 << 2 ) );		( RCC -> APB1RSTR &= ~( 1 << 2 ) ); }while(0) )	//Setting and clearing the reset bit of the RCC peripheral reset register for TIM4 peripheral interface.
 #define TIM5_REG_RESET()						( do{ ( RCC -> APB1RSTR |= ( 1 << 3 ) );		( RCC -> APB1RSTR &= ~( 1 << 3 ) ); }while(0) )	//Setting and clearing the reset bit of the RCC peripheral reset register for TIM5 peripheral interface.
 
+/*
+ * Register reset macros for DMAx controllers
+ */
+
+#define DMA1_REG_RESET()						do{ ( RCC -> AHB1RSTR |= ( 1 << 21 ) );		( RCC -> AHB1RSTR &= ~( 1 << 21 ) ); }while(0)		//Setting and clearing the reset bit of the RCC peripheral reset register for DMA1 controller.
+#define DMA2_REG_RESET()						do{ ( RCC -> AHB1RSTR |= ( 1 << 22 ) );		( RCC -> AHB1RSTR &= ~( 1 << 22 ) ); }while(0)		//Setting and clearing the reset bit of the RCC peripheral reset register for DMA2 controller.
+
 
 /*
  * Macros used to generate configuration values for SYSCFG_EXTICRx registers (see RM 9.2.3 - 9.2.6)
@@ -590,9 +820,18 @@ typedef struct
 #define IRQ_NO_EXTI2							8											//EXTI Line2 interrupt
 #define IRQ_NO_EXTI3							9											//EXTI Line3 interrupt
 #define IRQ_NO_EXTI4							10											//EXTI Line4 interrupt
+#define IRQ_NO_DMA1_STREAM0						11											//DMA1 Stream0 global interrupt
+#define IRQ_NO_DMA1_STREAM1						12											//DMA1 Stream1 global interrupt
+#define IRQ_NO_DMA1_STREAM2						13											//DMA1 Stream2 global interrupt
+#define IRQ_NO_DMA1_STREAM3						14											//DMA1 Stream3 global interrupt
+#define IRQ_NO_DMA1_STREAM4						15											//DMA1 Stream4 global interrupt
+#define IRQ_NO_DMA1_STREAM5						16											//DMA1 Stream5 global interrupt
+#define IRQ_NO_DMA1_STREAM6						17											//DMA1 Stream6 global interrupt
 #define IRQ_NO_ADC								18											//ADC1, ADC2 and ADC3 global interrupts
 #define IRQ_NO_EXTI9_5							23											//EXTI Line[9:5] interrupts
 #define IRQ_NO_TIM2								28											//TIM2 global interrupt
+#define IRQ_NO_TIM3								29											//TIM3 global interrupt
+#define IRQ_NO_TIM4								30											//TIM4 global interrupt
 #define IRQ_NO_I2C1_EV							31											//I2C1 event interrupt
 #define IRQ_NO_I2C1_ER							32											//I2C1 error interrupt
 #define IRQ_NO_I2C2_EV							33											//I2C2 event interrupt
@@ -603,10 +842,19 @@ typedef struct
 #define IRQ_NO_USART2							38											//USART2 global interrupt
 #define IRQ_NO_USART3							39											//USART3 global interrupt
 #define IRQ_NO_EXTI15_10						40											//EXTI Line[15:10] interrupts
+#define IRQ_NO_DMA1_STREAM7						47											//DMA1 Stream7 global interrupt
 #define IRQ_NO_TIM5								50											//TIM5 global interrupt
 #define IRQ_NO_SPI3								51											//SPI3 global interrupt
 #define IRQ_NO_UART4							52											//UART4 global interrupt
 #define IRQ_NO_UART5							53											//UART5 global interrupt
+#define IRQ_NO_DMA2_STREAM0						56											//DMA2 Stream0 global interrupt
+#define IRQ_NO_DMA2_STREAM1						57											//DMA2 Stream1 global interrupt
+#define IRQ_NO_DMA2_STREAM2						58											//DMA2 Stream2 global interrupt
+#define IRQ_NO_DMA2_STREAM3						59											//DMA2 Stream3 global interrupt
+#define IRQ_NO_DMA2_STREAM4						60											//DMA2 Stream4 global interrupt
+#define IRQ_NO_DMA2_STREAM5						68											//DMA2 Stream5 global interrupt
+#define IRQ_NO_DMA2_STREAM6						69											//DMA2 Stream6 global interrupt
+#define IRQ_NO_DMA2_STREAM7						70											//DMA2 Stream7 global interrupt
 #define IRQ_NO_USART6							71											//USART6 global interrupt
 #define IRQ_NO_I2C3_EV							72											//I2C3 event interrupt
 #define IRQ_NO_I2C3_ER							73											//I2C3 error interrupt
@@ -651,6 +899,103 @@ typedef struct
 #define MAX_UINT32_VAL							4294967295
 
 
+/*		-----------------------------------		Bit Position Definitions of the RCC Peripheral Registers		-----------------------------------		*/
+
+//Register: RCC_CR
+#define RCC_CR_HSION							0
+#define RCC_CR_HSIRDY							1
+#define RCC_CR_HSEON							16
+#define RCC_CR_HSERDY							17
+#define RCC_CR_HSEBYP							18
+#define RCC_CR_CSSON							19
+#define RCC_CR_PLLON							24
+#define RCC_CR_PLLRDY							25
+
+//Register: RCC_PLLCFGR
+#define RCC_PLLCFGR_PLLM_5_0					0
+#define RCC_PLLCFGR_PLLN_8_0					6
+#define RCC_PLLCFGR_PLLP_1_0					16
+#define RCC_PLLCFGR_PLLSRC						22
+#define RCC_PLLCFGR_PLLQ_3_0					24
+
+//Register: RCC_CFGR
+#define RCC_CFGR_SW_1_0							0
+#define RCC_CFGR_SWS_1_0						2
+#define RCC_CFGR_HPRE_3_0						4
+#define RCC_CFGR_PPRE1_2_0						10
+#define RCC_CFGR_PPRE2_2_0						13
+
+//Register: RCC_BDCR
+#define RCC_BDCR_LSEON							0
+#define RCC_BDCR_LSERDY							1
+#define RCC_BDCR_LSEBYP							2
+#define RCC_BDCR_RTCSEL_1_0						8
+#define RCC_BDCR_RTCEN							15
+#define RCC_BDCR_BDRST							16
+
+//Register: RCC_CSR
+#define RCC_CSR_LSION							0
+#define RCC_CSR_LSIRDY							1
+#define RCC_CSR_RMVF							24
+
+
+/*		-----------------------------------		Bit Position Definitions of the PWR Peripheral Registers		-----------------------------------		*/
+
+//Register: PWR_CR
+#define PWR_CR_LPDS								0
+#define PWR_CR_PDDS								1
+#define PWR_CR_CWUF								2
+#define PWR_CR_CSBF								3
+#define PWR_CR_DBP								8
+#define PWR_CR_FPDS								9
+
+//Register: PWR_CSR
+#define PWR_CSR_WUF								0
+#define PWR_CSR_SBF								1
+
+
+/*		-----------------------------------		Bit Position Definitions of the RTC Peripheral Registers		-----------------------------------		*/
+
+//Register: RTC_TR
+#define RTC_TR_SU_3_0							0
+#define RTC_TR_ST_2_0							4
+#define RTC_TR_MNU_3_0							8
+#define RTC_TR_MNT_2_0							12
+#define RTC_TR_HU_3_0							16
+#define RTC_TR_HT_1_0							20
+#define RTC_TR_PM								22
+
+//Register: RTC_CR
+#define RTC_CR_WUCKSEL_2_0						0
+#define RTC_CR_BYPSHAD							5
+#define RTC_CR_FMT								6
+#define RTC_CR_WUTE								10
+#define RTC_CR_WUTIE							14
+
+//Register: RTC_ISR
+#define RTC_ISR_WUTWF							2
+#define RTC_ISR_INITS							4
+#define RTC_ISR_RSF								5
+#define RTC_ISR_INITF							6
+#define RTC_ISR_INIT							7
+#define RTC_ISR_WUTF							10
+
+//Register: RTC_PRER
+#define RTC_PRER_PREDIV_S_14_0					0
+#define RTC_PRER_PREDIV_A_6_0					16
+
+
+/*		-----------------------------------		Bit Position Definitions of the FLASH Interface Registers		-----------------------------------		*/
+
+//Register: FLASH_ACR
+#define FLASH_ACR_LATENCY_2_0					0
+#define FLASH_ACR_PRFTEN						8
+#define FLASH_ACR_ICEN							9
+#define FLASH_ACR_DCEN							10
+#define FLASH_ACR_ICRST							11
+#define FLASH_ACR_DCRST							12
+
+
 /*		-----------------------------------		Bit Position Definitions of the SPI Peripheral Registers		-----------------------------------		*/
 
 //Register: SPI_CR1
@@ -939,14 +1284,53 @@ typedef struct
 #define TIM2_5_EGR_TG							6
 
 
+/*		-----------------------------------		Bit Position Definitions of the DMA Controller Registers		-----------------------------------		*/
+
+//Register: DMA_LISR / DMA_HISR / DMA_LIFCR / DMA_HIFCR (stream 0 / stream 4 positions - see DMA_GetFlagShift in DMA driver)
+#define DMA_ISR_FEIF							0
+#define DMA_ISR_DMEIF							2
+#define DMA_ISR_TEIF							3
+#define DMA_ISR_HTIF							4
+#define DMA_ISR_TCIF							5
+
+//Register: DMA_SxCR
+#define DMA_SxCR_EN								0
+#define DMA_SxCR_DMEIE							1
+#define DMA_SxCR_TEIE							2
+#define DMA_SxCR_HTIE							3
+#define DMA_SxCR_TCIE							4
+#define DMA_SxCR_PFCTRL							5
+#define DMA_SxCR_DIR_1_0						6
+#define DMA_SxCR_CIRC							8
+#define DMA_SxCR_PINC							9
+#define DMA_SxCR_MINC							10
+#define DMA_SxCR_PSIZE_1_0						11
+#define DMA_SxCR_MSIZE_1_0						13
+#define DMA_SxCR_PINCOS							15
+#define DMA_SxCR_PL_1_0							16
+#define DMA_SxCR_DBM							18
+#define DMA_SxCR_CT								19
+#define DMA_SxCR_PBURST_1_0						21
+#define DMA_SxCR_MBURST_1_0						23
+#define DMA_SxCR_CHSEL_2_0						25
+
+//Register: DMA_SxFCR
+#define DMA_SxFCR_FTH_1_0						0
+#define DMA_SxFCR_DMDIS							2
+#define DMA_SxFCR_FS_2_0						3
+#define DMA_SxFCR_FEIE							7
+
+
 
 #include "stm32f407vg_gpio_driver.h"
+#include "stm32f407vg_dma_driver.h"
 #include "stm32f407vg_spi_driver.h"
 #include "stm32f407vg_i2c_driver.h"
 #include "stm32f407vg_usart_driver.h"
 #include "stm32f407vg_rcc_driver.h"
 #include "stm32f407vg_adc_driver.h"
 #include "stm32f407vg_tim_driver.h"
+#include "stm32f407vg_pwr_driver.h"
 
 #endif /* INC_STM32F407VG_H_ */
 
@@ -23,20 +23,30 @@ typedef struct
 	uint8_t 		ADC_SamplingTime[19];						/* Possible values from @ADC_SamplingTime */
 	uint16_t 		ADC_AWDHT;									/* Possible values range from 0-4095 */
 	uint16_t 		ADC_AWDLT;									/* Possible values range from 0-4095 */
-	uint8_t 		ADC_Seq_Len;								/* Possible values from 0-16 */
+	uint8_t 		ADC_Seq_Len;								/* Possible values from 1-16 */
 	uint8_t 		ADC_Seq_Order[16];							/* Possible values from @ADC_Seq_Order */
+	uint8_t 		ADC_ExtTrigSource;							/* Possible values from @ADC_ExtTrigSource - only used if ADC_ExtTrigEdge is not ADC_EXT_TRIG_DISABLE */
+	uint8_t 		ADC_ExtTrigEdge;							/* Possible values from @ADC_ExtTrigEdge */
+	uint8_t 		ADC_MultiMode;								/* Possible values from @ADC_MultiMode - ADC1 handle only, leave 0 on ADC2/ADC3 */
+	uint8_t 		ADC_MultiDelay;								/* Possible values from @ADC_MultiDelay - interleaved modes only */
 }ADC_Config_t;
 
 /*
  * This is the handle structure for the ADCx peripheral
+ *
+ * NOTE: In a multi ADC mode the ADC1 handle drives the group - ADC2 (and ADC3) are started by its trigger and their
+ * 		 results are read packed from ADC_CDR by its DMA stream. ADC_Init of the ADC1 handle initializes the slave handles
  */
 
-typedef struct
+typedef struct ADC_Handle
 {
 	ADC_RegDef_t 		*pADCx;									/* This pointer holds the base address of the ADC peripheral */
 	ADC_Config_t 		ADC_Config;								/* This variable holds ADC peripheral configuration settings */
 	uint16_t 			*pADC_DataBuffer;						/* Buffer that holds converted data from the ADC data register */
 	uint8_t 			ADC_SeqLen;								/* This variable holds number of conversion in sequence - used in ADC interrupts */
+	uint16_t 			ADC_DMALen;								/* Number of items in the DMA buffer - used to re-arm a burst */
+	DMA_Handle_t 		*pDMAHandle;							/* DMA stream used by ADC_StartDMA (ADC1: DMA2 stream 0/4 channel 0) - NULL if DMA is not used */
+	struct ADC_Handle 	*pSlaveHandle[2];						/* ADC2 and ADC3 handles of a multi ADC mode (ADC1 handle only) - NULL if not used */
 }ADC_Handle_t;
 
 /*
@@ -122,6 +132,68 @@ typedef struct
 #define ADC_IN17							17
 #define ADC_IN18							18
 
+/*
+ * @ADC_ExtTrigSource
+ * Macros for ADC regular group external trigger source (see RM 13.6)
+ */
+
+#define ADC_EXT_TRIG_TIM1_CC1				0
+#define ADC_EXT_TRIG_TIM1_CC2				1
+#define ADC_EXT_TRIG_TIM1_CC3				2
+#define ADC_EXT_TRIG_TIM2_CC2				3
+#define ADC_EXT_TRIG_TIM2_CC3				4
+#define ADC_EXT_TRIG_TIM2_CC4				5
+#define ADC_EXT_TRIG_TIM2_TRGO				6
+#define ADC_EXT_TRIG_TIM3_CC1				7
+#define ADC_EXT_TRIG_TIM3_TRGO				8
+#define ADC_EXT_TRIG_TIM4_CC4				9
+#define ADC_EXT_TRIG_TIM5_CC1				10
+#define ADC_EXT_TRIG_TIM5_CC2				11
+#define ADC_EXT_TRIG_TIM5_CC3				12
+#define ADC_EXT_TRIG_TIM8_CC1				13
+#define ADC_EXT_TRIG_TIM8_TRGO				14
+#define ADC_EXT_TRIG_EXTI_11				15
+
+/*
+ * @ADC_ExtTrigEdge
+ * Macros for ADC regular group external trigger edge
+ *
+ * NOTE: With ADC_EXT_TRIG_DISABLE, conversions are started by software (SWSTART) in ADC_StartADC
+ */
+
+#define ADC_EXT_TRIG_DISABLE				0
+#define ADC_EXT_TRIG_RISING					1
+#define ADC_EXT_TRIG_FALLING				2
+#define ADC_EXT_TRIG_BOTH					3
+
+/*
+ * @ADC_MultiMode
+ * Macros for the regular group multi ADC modes (ADC_CCR MULTI, see RM 13.9)
+ *
+ * NOTE: Simultaneous - every ADC converts its own sequence (same length and sampling times) at the same instant.
+ * 		 Interleaved - the ADCs convert the same channel one after the other, ADC_MultiDelay apart, for up to 2x/3x the
+ * 		 rate of one ADC. Either way, the DMA buffer holds ADC1, ADC2 (, ADC3) results in turn (see ADC_GetScanChannel)
+ */
+
+#define ADC_MULTI_INDEPENDENT				0x00
+#define ADC_MULTI_DUAL_REG_SIMULT			0x06				/* ADC1 and ADC2 */
+#define ADC_MULTI_DUAL_INTERLEAVED			0x07
+#define ADC_MULTI_TRIPLE_REG_SIMULT			0x16				/* ADC1, ADC2 and ADC3 */
+#define ADC_MULTI_TRIPLE_INTERLEAVED		0x17
+
+/*
+ * @ADC_MultiDelay
+ * Delay between the sampling phases of two ADCs in interleaved mode: 5 + value ADCCLK cycles (0 - 15)
+ *
+ * NOTE: An ADC can't sample again before its own conversion is done - 12 bit conversions need at least 7 (dual) or
+ * 		 5 (triple, 2 x delay) to keep their spacing even
+ */
+
+#define ADC_MULTI_DELAY_5_CYCLES			0
+#define ADC_MULTI_DELAY_7_CYCLES			2
+#define ADC_MULTI_DELAY_12_CYCLES			7
+#define ADC_MULTI_DELAY_20_CYCLES			15
+
 
 /*
  * ADC status register related flag status definitions
@@ -144,6 +216,10 @@ typedef struct
 #define ADC_EVENT_AWD						1
 #define ADC_EVENT_OVR						2
 #define ADC_EVENT_EOC						3
+#define ADC_EVENT_DMA_HALF_CMPLT			4
+#define ADC_EVENT_DMA_CMPLT					5
+
+#define ADC_ERROR_DMA						6
 
 
 
@@ -175,10 +251,20 @@ void ADC_EnableIT(ADC_Handle_t *pADCHandle, uint16_t *ConvBuffer, uint8_t Length
 void ADC_DisableIT(ADC_Handle_t *pADCHandle);
 void ADC_IRQHandling(ADC_Handle_t *pADCHandle);
 
+/*
+ * ADC scan with DMA (circular buffer, or one burst of sequences per trigger)
+ */
+void ADC_StartDMA(ADC_Handle_t *pADCHandle, uint16_t *pBuffer, uint16_t Length);
+void ADC_StartBurstDMA(ADC_Handle_t *pADCHandle, uint16_t *pBuffer, uint16_t Length);
+void ADC_StopDMA(ADC_Handle_t *pADCHandle);
+void ADC_DMA_IRQHandling(ADC_Handle_t *pADCHandle);
+
 /*
  * Other peripheral control APIs
  */
 void ADC_PeripheralOnOffControl(ADC_RegDef_t *pADCx, uint8_t EnOrDi);
+uint8_t ADC_GetScanLen(ADC_Handle_t *pADCHandle);
+uint8_t ADC_GetScanChannel(ADC_Handle_t *pADCHandle, uint8_t Index);
 uint8_t ADC_GetFlagStatus(ADC_RegDef_t *pADCx, uint32_t FlagName);
 void ADC_ClearFlag(ADC_RegDef_t *pADCx, uint32_t FlagName);
 void ADC_StartADC(ADC_Handle_t *pADCHandle);
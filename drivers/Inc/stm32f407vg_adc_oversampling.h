@@ -0,0 +1,83 @@
+/*
+ * stm32f407vg_adc_oversampling.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_ADC_OVERSAMPLING_H_
+#define INC_STM32F407VG_ADC_OVERSAMPLING_H_
+
+#include "stm32f407vg.h"
+
+/*
+ * This is the ADC oversampling configuration settings structure
+ */
+
+typedef struct
+{
+	uint8_t 		ADC_OVS_Ratio[19];							/* Possible values from @ADC_OVS_Ratio - indexed by channel like ADC_SamplingTime */
+	uint8_t 		ADC_OVS_Mode[19];							/* Possible values from @ADC_OVS_Mode - indexed by channel like ADC_SamplingTime */
+}ADC_OVS_Config_t;
+
+/*
+ * This is the handle structure for the oversampling layer of an ADCx peripheral
+ */
+
+typedef struct
+{
+	ADC_Handle_t 		*pADCHandle;							/* ADC (with its DMA handle) the bursts are taken from */
+	ADC_OVS_Config_t 	ADC_OVS_Config;							/* This variable holds oversampling configuration settings */
+	uint16_t 			*pBurstBuffer;							/* Raw burst written by DMA: sequence after sequence */
+	uint16_t 			BurstLen;								/* Number of sequences per burst (largest ratio of the sequence) */
+	uint32_t 			Result[16];								/* Decimated value of each sequence rank (ADC by ADC in a multi ADC mode) */
+	uint32_t 			FullScale[16];							/* Value of Result[] at full-scale input (VDDA) */
+	uint8_t 			ResultBits[16];							/* Effective resolution of Result[] in bits */
+	uint32_t 			Cycles[16];								/* CPU cycles spent accumulating and decimating Result[] (DWT cycle counter) */
+}ADC_OVS_Handle_t;
+
+/*
+ * @ADC_OVS_Ratio
+ * Macros for number of conversions accumulated per decimated sample (log2 of the ratio)
+ */
+
+#define ADC_OVS_RATIO_1						0
+#define ADC_OVS_RATIO_2						1
+#define ADC_OVS_RATIO_4						2
+#define ADC_OVS_RATIO_8						3
+#define ADC_OVS_RATIO_16					4
+#define ADC_OVS_RATIO_32					5
+#define ADC_OVS_RATIO_64					6
+#define ADC_OVS_RATIO_128					7
+#define ADC_OVS_RATIO_256					8
+
+/*
+ * @ADC_OVS_Mode
+ * Macros for decimation mode
+ *
+ * NOTE: Enhance keeps 1 extra bit for every 4x of oversampling (i.e., 16x gives 14 bits from a 12 bit ADC). This only
+ * 		 works if there is at least 1 LSB of noise on the input - otherwise all samples are equal and it is an average
+ */
+
+#define ADC_OVS_MODE_AVERAGE				0					/* Sum / ratio - same resolution as the ADC, less noise */
+#define ADC_OVS_MODE_ENHANCE				1					/* Sum >> (log2(ratio) - log2(ratio)/2) - extra bits of resolution */
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Oversampling initialization and start
+ */
+void ADC_OVS_Init(ADC_OVS_Handle_t *pOVSHandle, uint16_t *pBurstBuffer, uint16_t Length);
+
+/*
+ * Decimation - call from ADC_ApplicationEventCallBack on ADC_EVENT_DMA_CMPLT
+ */
+void ADC_OVS_Decimate(ADC_OVS_Handle_t *pOVSHandle);
+
+#endif /* INC_STM32F407VG_ADC_OVERSAMPLING_H_ */
@@ -0,0 +1,186 @@
+/*
+ * stm32f407vg_dma_driver.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_DMA_DRIVER_H_
+#define INC_STM32F407VG_DMA_DRIVER_H_
+
+#include "stm32f407vg.h"
+
+/*
+ * This is the DMA stream configuration settings structure
+ */
+
+typedef struct
+{
+	uint8_t 		DMA_Channel;								/* Possible values from @DMA_Channel - request mapping per stream, see RM 10.3.3 tables 42/43 */
+	uint8_t 		DMA_Direction;								/* Possible values from @DMA_Direction */
+	uint8_t 		DMA_Mode;									/* Possible values from @DMA_Mode */
+	uint8_t 		DMA_PeriphDataSize;							/* Possible values from @DMA_DataSize */
+	uint8_t 		DMA_MemDataSize;							/* Possible values from @DMA_DataSize */
+	uint8_t 		DMA_PeriphInc;								/* Possible values from @DMA_Increment */
+	uint8_t 		DMA_MemInc;									/* Possible values from @DMA_Increment */
+	uint8_t 		DMA_Priority;								/* Possible values from @DMA_Priority */
+	uint8_t 		DMA_FIFOMode;								/* Possible values from @DMA_FIFOMode */
+	uint8_t 		DMA_FIFOThreshold;							/* Possible values from @DMA_FIFOThreshold - only used when FIFO is enabled */
+}DMA_Config_t;
+
+/*
+ * This is the handle structure for a DMA stream
+ */
+
+typedef struct
+{
+	DMA_RegDef_t 	*pDMAx;										/* This holds the base address of the DMA controller */
+	uint8_t 		StreamNumber;								/* Stream of the DMA controller used by this handle (0-7) */
+	DMA_Config_t 	DMA_Config;									/* This variable holds DMA stream configuration settings */
+}DMA_Handle_t;
+
+/*
+ * @DMA_Channel
+ * Macros for the DMA stream channel (request) selection
+ */
+
+#define DMA_CHANNEL_0						0
+#define DMA_CHANNEL_1						1
+#define DMA_CHANNEL_2						2
+#define DMA_CHANNEL_3						3
+#define DMA_CHANNEL_4						4
+#define DMA_CHANNEL_5						5
+#define DMA_CHANNEL_6						6
+#define DMA_CHANNEL_7						7
+
+/*
+ * @DMA_Direction
+ * Macros for DMA data transfer direction
+ *
+ * NOTE: Memory to memory is only supported by DMA2
+ */
+
+#define DMA_DIR_PERIPH_TO_MEM				0
+#define DMA_DIR_MEM_TO_PERIPH				1
+#define DMA_DIR_MEM_TO_MEM					2
+
+/*
+ * @DMA_Mode
+ * Macros for DMA stream mode
+ */
+
+#define DMA_MODE_NORMAL						0					/* Stream is disabled by hardware once NDTR reaches 0 */
+#define DMA_MODE_CIRCULAR					1					/* NDTR and addresses are reloaded once NDTR reaches 0 */
+
+/*
+ * @DMA_DataSize
+ * Macros for DMA peripheral and memory data sizes
+ */
+
+#define DMA_DATA_SIZE_BYTE					0
+#define DMA_DATA_SIZE_HALFWORD				1
+#define DMA_DATA_SIZE_WORD					2
+
+/*
+ * @DMA_Increment
+ * Macros for DMA peripheral and memory address increment
+ */
+
+#define DMA_INC_DISABLE						0
+#define DMA_INC_ENABLE						1
+
+/*
+ * @DMA_Priority
+ * Macros for DMA stream software priority
+ */
+
+#define DMA_PRIORITY_LOW					0
+#define DMA_PRIORITY_MEDIUM					1
+#define DMA_PRIORITY_HIGH					2
+#define DMA_PRIORITY_VERY_HIGH				3
+
+/*
+ * @DMA_FIFOMode
+ * Macros for DMA FIFO (disabled = direct mode)
+ */
+
+#define DMA_FIFO_DISABLE					0
+#define DMA_FIFO_ENABLE						1
+
+/*
+ * @DMA_FIFOThreshold
+ * Macros for DMA FIFO threshold selection
+ */
+
+#define DMA_FIFO_THRESHOLD_1_4				0
+#define DMA_FIFO_THRESHOLD_1_2				1
+#define DMA_FIFO_THRESHOLD_3_4				2
+#define DMA_FIFO_THRESHOLD_FULL				3
+
+
+/*
+ * DMA interrupt status register related flag status definitions
+ * NOTE: Values are for the stream's own flag group - the driver shifts them to the stream position in LISR/HISR
+ */
+
+#define DMA_FLAG_FEIF						( 1 << DMA_ISR_FEIF )
+#define DMA_FLAG_DMEIF						( 1 << DMA_ISR_DMEIF )
+#define DMA_FLAG_TEIF						( 1 << DMA_ISR_TEIF )
+#define DMA_FLAG_HTIF						( 1 << DMA_ISR_HTIF )
+#define DMA_FLAG_TCIF						( 1 << DMA_ISR_TCIF )
+#define DMA_FLAG_ALL						( DMA_FLAG_FEIF | DMA_FLAG_DMEIF | DMA_FLAG_TEIF | DMA_FLAG_HTIF | DMA_FLAG_TCIF )
+
+
+/*
+ * DMA application event macros (possible arguments for "DMA_ApplicationEventCallback" function)
+ */
+
+#define DMA_EVENT_HALF_CMPLT				0
+#define DMA_EVENT_CMPLT						1
+
+#define DMA_ERROR_TE						2
+#define DMA_ERROR_DME						3
+#define DMA_ERROR_FE						4
+
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Peripheral clock setup
+ */
+void DMA_PeriClockControl(DMA_RegDef_t *pDMAx, uint8_t EnOrDi);
+
+/*
+ * DMA Initialization and De-initialization (setting register back to reset state)
+ */
+void DMA_Init(DMA_Handle_t *pDMAHandle);
+void DMA_DeInit(DMA_RegDef_t *pDMAx);
+
+/*
+ * Transfer control
+ */
+void DMA_StartTransfer(DMA_Handle_t *pDMAHandle, uint32_t PeriphAddr, uint32_t MemAddr, uint16_t Length);
+void DMA_StopTransfer(DMA_Handle_t *pDMAHandle);
+uint16_t DMA_GetCurrDataCounter(DMA_Handle_t *pDMAHandle);
+
+/*
+ * DMA interrupt initialization and handling
+ */
+void DMA_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi);
+void DMA_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
+void DMA_IRQHandling(DMA_Handle_t *pDMAHandle);
+
+/*
+ * Other peripheral control APIs
+ */
+uint8_t DMA_GetFlagStatus(DMA_Handle_t *pDMAHandle, uint32_t FlagName);
+void DMA_ClearFlag(DMA_Handle_t *pDMAHandle, uint32_t FlagName);
+__weak void DMA_ApplicationEventCallBack(DMA_Handle_t *pDMAHandle, uint8_t AppEvent);
+
+#endif /* INC_STM32F407VG_DMA_DRIVER_H_ */
@@ -38,6 +38,8 @@ typedef struct
 	uint8_t 		Slave_Address;								/* Address of slave device */
 	uint32_t 		RxSize;										/* Used to hold slave-provided value for number of bytes master will receive */
 	uint8_t 		Sr;											/* Enables or disables the repeated starting */
+	DMA_Handle_t 	*pDMATxHandle;								/* DMA stream for I2C_MasterSendDataDMA (NULL if not used) - see RM table 42 for the I2Cx_TX stream/channel */
+	DMA_Handle_t 	*pDMARxHandle;								/* DMA stream for I2C_MasterReceiveDataDMA (NULL if not used) - see RM table 42 for the I2Cx_RX stream/channel */
 }I2C_Handle_t;
 
 
@@ -116,6 +118,7 @@ typedef struct
 
 #define I2C_EV_DATA_REQUEST					8
 #define I2C_EV_DATA_RECEIVE					9
+#define I2C_ERROR_DMA						10					/* DMA transfer or direct mode error - transfer has been abandoned */
 
 
 
@@ -147,6 +150,8 @@ void I2C_MasterReceiveData(I2C_Handle_t *pI2CHandle, uint8_t *pRxBuffer, uint32_
 uint8_t I2C_MasterSendDataIT(I2C_Handle_t *pI2CHandle, uint8_t *pTxBuffer, uint32_t Len, uint8_t SlaveAddr, uint8_t Sr);
 uint8_t I2C_MasterReceiveDataIT(I2C_Handle_t *pI2CHandle, uint8_t *pRxBuffer, uint32_t Len, uint8_t SlaveAddr, uint8_t Sr);
 
+uint8_t I2C_MasterSendDataDMA(I2C_Handle_t *pI2CHandle, uint8_t *pTxBuffer, uint32_t Len, uint8_t SlaveAddr, uint8_t Sr);
+uint8_t I2C_MasterReceiveDataDMA(I2C_Handle_t *pI2CHandle, uint8_t *pRxBuffer, uint32_t Len, uint8_t SlaveAddr, uint8_t Sr);
 void I2C_CloseSendData(I2C_Handle_t *pI2CHandle);
 void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle);
 
@@ -161,6 +166,8 @@ void I2C_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi);
 void I2C_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
 void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle);
 void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle);
+void I2C_DMA_TxIRQHandling(I2C_Handle_t *pI2CHandle);
+void I2C_DMA_RxIRQHandling(I2C_Handle_t *pI2CHandle);
 
 /*
  * Other peripheral control APIs
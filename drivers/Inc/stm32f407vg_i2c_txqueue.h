@@ -0,0 +1,108 @@
+/*
+ * stm32f407vg_i2c_txqueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_I2C_TXQUEUE_H_
+#define INC_STM32F407VG_I2C_TXQUEUE_H_
+
+#include "stm32f407vg.h"
+
+/*
+ * Build configurable items
+ */
+#ifndef I2C_TXQ_DEPTH
+#define I2C_TXQ_DEPTH							4						//Frames held by the queue, including the one on the bus
+#endif
+
+#if ( I2C_TXQ_DEPTH < 2 )
+#error "I2C_TXQ_DEPTH must leave room for one waiting frame next to the one on the bus"
+#endif
+
+#ifndef I2C_TXQ_MAX_FRAME_LEN
+#define I2C_TXQ_MAX_FRAME_LEN					8						//Largest frame (bytes after the address) that can be queued
+#endif
+
+/*
+ * This is a frame waiting in (or being sent from) the transmit queue
+ */
+
+typedef struct
+{
+	uint8_t 		Data[I2C_TXQ_MAX_FRAME_LEN];				/* Copy of the user data - the caller's buffer is free as soon as enqueue returns */
+	uint8_t 		Len;										/* Number of valid bytes in Data */
+	uint8_t 		SlaveAddr;									/* 7 bit address of the slave the frame is sent to */
+}I2C_TXQ_Frame_t;
+
+/*
+ * This is the handle structure for a master transmit queue on an I2Cx peripheral
+ */
+
+typedef struct
+{
+	I2C_Handle_t 		*pI2CHandle;							/* I2C peripheral (already initialized with I2C_Init) frames are sent on - with DMA if pDMATxHandle is set */
+	uint8_t 			Policy;									/* Possible values from @I2C_TXQ_Policy - what enqueue does when the queue is full */
+	I2C_TXQ_Frame_t 	Frames[I2C_TXQ_DEPTH];					/* Circular buffer of frames - Frames[Tail] is the oldest */
+	__vo uint8_t 		Head;									/* Next free slot */
+	__vo uint8_t 		Tail;									/* Oldest frame (the one on the bus when InFlight is set) */
+	__vo uint8_t 		Count;									/* Frames in the queue, including the one on the bus */
+	__vo uint8_t 		InFlight;								/* 1 while Frames[Tail] is being transmitted */
+	__vo uint32_t 		Sent;									/* Frames transmitted and acknowledged */
+	__vo uint32_t 		Dropped;								/* Frames discarded because the queue was full */
+	__vo uint32_t 		Coalesced;								/* Queued frames replaced by a newer one */
+	__vo uint32_t 		Errors;									/* Frames abandoned because of a bus error (NACK, arbitration lost, ...) */
+}I2C_TXQ_Handle_t;
+
+/*
+ * @I2C_TXQ_Policy
+ * Macros for what happens to a new frame when the queue is full
+ *
+ * NOTE: The frame on the bus is never touched - only frames still waiting are dropped or replaced
+ */
+
+#define I2C_TXQ_POLICY_DROP_OLDEST				0					/* Oldest waiting frame is discarded to make room */
+#define I2C_TXQ_POLICY_COALESCE					1					/* Newest waiting frame is overwritten - the slave always gets the latest value */
+#define I2C_TXQ_POLICY_DROP_NEWEST				2					/* New frame is discarded, waiting frames are kept */
+
+/*
+ * @I2C_TXQ_Status
+ * Possible return values of I2C_TXQ_Enqueue
+ */
+
+#define I2C_TXQ_QUEUED							0
+#define I2C_TXQ_COALESCED						1
+#define I2C_TXQ_DROPPED_OLDEST					2
+#define I2C_TXQ_DROPPED_NEWEST					3
+#define I2C_TXQ_INVALID_LEN						4
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Queue initialization
+ */
+void I2C_TXQ_Init(I2C_TXQ_Handle_t *pTXQHandle, I2C_Handle_t *pI2CHandle, uint8_t Policy);
+
+/*
+ * Queue a frame - safe to call from any ISR or thread mode, never waits on the bus
+ */
+uint8_t I2C_TXQ_Enqueue(I2C_TXQ_Handle_t *pTXQHandle, uint8_t SlaveAddr, uint8_t *pData, uint8_t Len);
+
+/*
+ * Event handling - call from I2C_ApplicationEventCallBack
+ */
+void I2C_TXQ_EventHandling(I2C_TXQ_Handle_t *pTXQHandle, uint8_t AppEvent);
+
+/*
+ * Other queue APIs
+ */
+uint8_t I2C_TXQ_GetCount(I2C_TXQ_Handle_t *pTXQHandle);
+
+#endif /* INC_STM32F407VG_I2C_TXQUEUE_H_ */
@@ -0,0 +1,111 @@
+/*
+ * stm32f407vg_profiler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_PROFILER_H_
+#define INC_STM32F407VG_PROFILER_H_
+
+#include "stm32f407vg.h"
+
+#ifdef STM32F407VG_HOST_SIM
+#include <time.h>
+#endif
+
+/*
+ * Build configurable items
+ *
+ * NOTE: Set PROF_ENABLE to 0 (i.e., -DPROF_ENABLE=0) to compile every PROF_ENTER/PROF_EXIT out of the drivers and the application
+ */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE								1
+#endif
+
+#define PROF_HIST_BINS							32						//Bin n counts 2^(n-1) <= elapsed < 2^n (bin 0 is 0), last bin holds everything above
+
+/*
+ * Time base - DWT cycle counter on target. The host build (host/sim) has no core clock to count, it reports host nanoseconds
+ */
+#ifdef STM32F407VG_HOST_SIM
+#define PROF_UNITS								"ns"
+#else
+#define PROF_UNITS								"cycles"
+#endif
+
+/*
+ * This is one profiled code site - defined with PROF_SITE_DEFINE, statistics are updated by PROF_EXIT
+ */
+
+typedef struct PROF_Site
+{
+	const char 			*Name;									/* Site name as given to PROF_SITE_DEFINE */
+	uint32_t 			Start;									/* Time base at the last PROF_ENTER */
+	uint32_t 			Count;									/* Number of ENTER/EXIT pairs recorded */
+	uint32_t 			Min;									/* Shortest run (PROF_UNITS) */
+	uint32_t 			Max;									/* Longest run (PROF_UNITS) */
+	uint64_t 			Total;									/* Sum of all runs - mean is Total / Count */
+	uint32_t 			Hist[PROF_HIST_BINS];					/* log2 histogram of runs */
+	struct PROF_Site 	*pNext;									/* Next site reported by PROF_Dump - linked in on the first PROF_EXIT */
+	uint8_t 			Registered;
+}PROF_Site_t;
+
+/*
+ * Instrumentation macros - a site is entered and exited from the same context (an ISR, or thread mode)
+ *
+ * 		PROF_SITE_DEFINE(TIM2_IRQHandler);			//file scope
+ * 		...
+ * 		PROF_ENTER(TIM2_IRQHandler);
+ * 		...
+ * 		PROF_EXIT(TIM2_IRQHandler);
+ *
+ * NOTE: A site is not re-entrant - only the innermost of two nested ENTERs of the same site is measured
+ */
+#if PROF_ENABLE
+#define PROF_SITE_DEFINE(site)					static PROF_Site_t PROF_Site_##site = { .Name = #site, .Min = 0xFFFFFFFF }
+#define PROF_ENTER(site)						do{ PROF_Site_##site.Start = PROF_Now(); }while(0)
+#define PROF_EXIT(site)							PROF_Record(&PROF_Site_##site, PROF_Now() - PROF_Site_##site.Start)
+#else
+#define PROF_SITE_DEFINE(site)					typedef int PROF_Site_##site##_Unused_t
+#define PROF_ENTER(site)						do{ }while(0)
+#define PROF_EXIT(site)							do{ }while(0)
+#endif
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Profiler initialization and statistics
+ */
+void PROF_Init(void);
+void PROF_Record(PROF_Site_t *pSite, uint32_t Elapsed);
+void PROF_Reset(void);
+
+/*
+ * Report - every site that has run at least once, over USART (pUSARTHandle already initialized) or printf (NULL)
+ */
+void PROF_Dump(USART_Handle_t *pUSARTHandle);
+
+/*
+ * Time base
+ */
+static inline uint32_t PROF_Now(void)
+{
+#ifdef STM32F407VG_HOST_SIM
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint32_t) ( (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec );
+#else
+	return *DWT_CYCCNT;
+#endif
+}
+
+#endif /* INC_STM32F407VG_PROFILER_H_ */
@@ -0,0 +1,101 @@
+/*
+ * stm32f407vg_pwr_driver.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_PWR_DRIVER_H_
+#define INC_STM32F407VG_PWR_DRIVER_H_
+
+#include "stm32f407vg.h"
+
+#define PWR_MAX_TIMERS							2					/* Timers whose interrupts are the scheduled events (see PWR_Config_t) */
+#define PWR_LSI_NOMINAL_FREQ					32000U				/* LSI is only specified 17kHz - 47kHz, PWR_Init measures it */
+
+/*
+ * This is the idle manager configuration settings structure
+ *
+ * NOTE: Everything the application waits for has to be one of these timers' interrupts (update or compare), an EXTI line
+ * 		 or the RTC wakeup - those are the only events the next STOP period is planned around
+ */
+
+typedef struct
+{
+	uint8_t 			PWR_Mode;								/* Deepest state allowed - possible values from @PWR_Mode */
+	RCC_Config_t 		*pRunClock;								/* Clock tree restored with RCC_ClockConfig when STOP ends (HSI after wake up) */
+	TIM2_5_RegDef_t 	*pTIMx[PWR_MAX_TIMERS];					/* [0]: free running 32-bit time base (TIM2/TIM5, see TIM2_5_SetFreeRunningInit) the
+																   time in each state is counted in. [1]: another scheduling timer or NULL */
+	uint32_t 			PWR_MinStopUsecs;						/* Shortest idle period STOP is worth it for - Sleep below */
+	uint32_t 			PWR_WakeupUsecs;						/* STOP exit and clock restore time (HSE start-up, PLL lock) - STOP ends this early */
+}PWR_Config_t;
+
+/*
+ * This is the handle structure for the idle manager
+ */
+
+typedef struct
+{
+	PWR_Config_t 		PWR_Config;
+	uint32_t 			LSIFreq;								/* Measured LSI frequency (Hz) - RTC counts are turned into timer ticks with it */
+	uint32_t 			LastStamp;								/* pTIMx[0] count at the end of the last period accounted for */
+	uint64_t 			Ticks[3];								/* Time spent in each @PWR_State (pTIMx[0] ticks) */
+	uint32_t 			Entries[3];								/* Times each @PWR_State was entered from PWR_Idle (Run: nothing to wait for) */
+	uint32_t 			StopVetoes;								/* STOP long enough but refused by PWR_ApplicationStopAllowed */
+	uint32_t 			LateWakeups;							/* STOP ended after a scheduled event was due - the event ran late */
+}PWR_Handle_t;
+
+/*
+ * @PWR_Mode
+ * Deepest power state PWR_Idle may enter
+ */
+
+#define PWR_MODE_SLEEP							0					/* Core clock stopped, peripherals running - any interrupt wakes */
+#define PWR_MODE_STOP							1					/* 1.2V domain clocks stopped, SRAM and registers kept - RTC/EXTI wake */
+
+/*
+ * @PWR_State
+ * Power states (return value of PWR_Idle, index of Ticks/Entries)
+ */
+
+#define PWR_STATE_RUN							0
+#define PWR_STATE_SLEEP							1
+#define PWR_STATE_STOP							2
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Init (RTC on the LSI, STOP settings, LSI measurement)
+ */
+void PWR_Init(PWR_Handle_t *pPWRHandle);
+void PWR_CalibrateLSI(PWR_Handle_t *pPWRHandle);
+
+/*
+ * Idle - called by the main loop with interrupts masked once it has nothing left to do
+ */
+uint8_t PWR_Idle(PWR_Handle_t *pPWRHandle);
+
+/*
+ * IRQ Configuration and ISR handling
+ */
+void PWR_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi);
+void PWR_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
+void PWR_RTCWakeupIRQHandling(void);
+
+/*
+ * Other Peripheral Control APIs
+ */
+uint64_t PWR_GetStateUsecs(PWR_Handle_t *pPWRHandle, uint8_t State);
+
+/*
+ * Application callback - STOP gates the clock of every peripheral, so a transfer under way has to finish first
+ */
+uint8_t PWR_ApplicationStopAllowed(PWR_Handle_t *pPWRHandle);
+
+#endif /* INC_STM32F407VG_PWR_DRIVER_H_ */
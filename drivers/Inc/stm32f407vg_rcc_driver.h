@@ -10,6 +10,115 @@
 
 #include "stm32f407vg.h"
 
+/*
+ * Oscillator frequencies
+ *
+ * NOTE: RCC_HSE_FREQ is the 8MHz crystal of the STM32F4 Discovery board - override it (i.e., -DRCC_HSE_FREQ=25000000U)
+ * 		 for a different board
+ */
+
+#define RCC_HSI_FREQ							16000000U
+#ifndef RCC_HSE_FREQ
+#define RCC_HSE_FREQ							8000000U
+#endif
+
+/*
+ * Maximum bus frequencies (see DS, VOS scale 1, 2.7V - 3.6V supply)
+ */
+
+#define RCC_MAX_SYSCLK_FREQ						168000000U
+#define RCC_MAX_PCLK1_FREQ						42000000U
+#define RCC_MAX_PCLK2_FREQ						84000000U
+#define RCC_FLASH_WS_FREQ						30000000U			/* HCLK covered by each flash wait state (see RM 3.5.1, 2.7V - 3.6V) */
+
+#define RCC_MAX_CLOCK_CALLBACKS					8					/* Drivers that can be told about a clock tree change (see RCC_RegisterClockCallback) */
+
+/*
+ * This is the RCC clock tree configuration settings structure
+ */
+
+typedef struct
+{
+	uint8_t 		RCC_ClkSource;								/* Possible values from @RCC_ClkSource */
+	uint8_t 		RCC_PLLSource;								/* Possible values from @RCC_PLLSource - only used if RCC_ClkSource is RCC_CLK_SRC_PLL */
+	uint8_t 		RCC_PLL_M;									/* Possible values range from 2-63. VCO input = PLL source / M must be 1-2MHz */
+	uint16_t 		RCC_PLL_N;									/* Possible values range from 50-432. VCO output = VCO input * N must be 100-432MHz */
+	uint8_t 		RCC_PLL_P;									/* Possible values 2, 4, 6, 8. SYSCLK = VCO output / P */
+	uint8_t 		RCC_PLL_Q;									/* Possible values range from 2-15. USB/SDIO/RNG clock = VCO output / Q, at most 48MHz */
+	uint8_t 		RCC_AHBPrescaler;							/* Possible values from @RCC_AHBPrescaler */
+	uint8_t 		RCC_APB1Prescaler;							/* Possible values from @RCC_APBPrescaler */
+	uint8_t 		RCC_APB2Prescaler;							/* Possible values from @RCC_APBPrescaler */
+	uint8_t 		RCC_FlashART;								/* ENABLE or DISABLE - flash prefetch, instruction cache and data cache */
+}RCC_Config_t;
+
+/*
+ * These are the bus clock frequencies (Hz) cached by the driver - decoded from the RCC registers once per clock tree change
+ * instead of on every query
+ */
+
+typedef struct
+{
+	uint32_t 		SysClk;										/* SYSCLK */
+	uint32_t 		HClk;										/* AHB bus and core */
+	uint32_t 		PClk1;										/* APB1 bus */
+	uint32_t 		PClk2;										/* APB2 bus */
+	uint32_t 		TimClk1;									/* APB1 timers - PClk1, or 2 x PClk1 if the APB1 prescaler is not 1 */
+	uint32_t 		TimClk2;									/* APB2 timers - PClk2, or 2 x PClk2 if the APB2 prescaler is not 1 */
+}RCC_Clocks_t;
+
+/*
+ * Clock change callback - called with the context it was registered with after the bus clocks have changed, so a driver can
+ * recompute its clock derived settings (baud rate, SCL timing, pre-scaler/auto-reload)
+ */
+
+typedef void (*RCC_ClockCallback_t)(void *pContext);
+
+/*
+ * @RCC_ClkSource
+ * Macros for the system clock source (RCC_CFGR SW bits)
+ */
+
+#define RCC_CLK_SRC_HSI							0
+#define RCC_CLK_SRC_HSE							1
+#define RCC_CLK_SRC_PLL							2
+
+/*
+ * @RCC_PLLSource
+ * Macros for the main PLL (and PLLI2S) input clock
+ */
+
+#define RCC_PLL_SRC_HSI							0
+#define RCC_PLL_SRC_HSE							1
+
+/*
+ * @RCC_AHBPrescaler
+ * Macros for the AHB prescaler (RCC_CFGR HPRE bits) - HCLK = SYSCLK / prescaler
+ */
+
+#define RCC_AHB_DIV_1							0
+#define RCC_AHB_DIV_2							8
+#define RCC_AHB_DIV_4							9
+#define RCC_AHB_DIV_8							10
+#define RCC_AHB_DIV_16							11
+#define RCC_AHB_DIV_64							12
+#define RCC_AHB_DIV_128							13
+#define RCC_AHB_DIV_256							14
+#define RCC_AHB_DIV_512							15
+
+/*
+ * @RCC_APBPrescaler
+ * Macros for the APB1/APB2 prescalers (RCC_CFGR PPRE1/PPRE2 bits) - PCLKx = HCLK / prescaler
+ *
+ * NOTE: Timers on a bus with a prescaler other than 1 are clocked at 2 x PCLKx (see RCC_GetTIMCLK1Val/RCC_GetTIMCLK2Val)
+ */
+
+#define RCC_APB_DIV_1							0
+#define RCC_APB_DIV_2							4
+#define RCC_APB_DIV_4							5
+#define RCC_APB_DIV_8							6
+#define RCC_APB_DIV_16							7
+
+
 
 
 /**********************************************************************************************************************
@@ -18,8 +127,28 @@
  **********************************************************************************************************************/
 
 /*
- * Return value of operating frequency for busses that the corresponding peripherals are hanging off of
+ * Clock tree configuration (oscillators, PLL, bus prescalers, flash wait states and ART accelerator)
+ */
+void RCC_ClockConfig(RCC_Config_t *pRCCConfig);
+
+/*
+ * Cached bus clocks and clock change notification
  */
+void RCC_UpdateClockState(void);
+const RCC_Clocks_t *RCC_GetClocks(void);
+void RCC_RegisterClockCallback(RCC_ClockCallback_t pCallback, void *pContext);
+void RCC_UnregisterClockCallback(RCC_ClockCallback_t pCallback, void *pContext);
+
+/*
+ * Return value of operating frequency for busses that the corresponding peripherals are hanging off of (cached - see RCC_GetClocks)
+ */
+
+//Main PLL output (P) and system clock
+uint32_t RCC_GetPLLOutputClk(void);
+uint32_t RCC_GetSysClkVal(void);
+
+//AHB bus (core, DMA, GPIO)
+uint32_t RCC_GetHCLKVal(void);
 
 //APB1 bus
 uint32_t RCC_GetPCLK1Val(void);
@@ -27,5 +156,9 @@ uint32_t RCC_GetPCLK1Val(void);
 //APB2 bus
 uint32_t RCC_GetPCLK2Val(void);
 
+//Timer kernel clocks of the APB1 (TIM2-7, TIM12-14) and APB2 (TIM1, TIM8-11) timers
+uint32_t RCC_GetTIMCLK1Val(void);
+uint32_t RCC_GetTIMCLK2Val(void);
+
 
 #endif /* INC_STM32F407VG_RCC_DRIVER_H_ */
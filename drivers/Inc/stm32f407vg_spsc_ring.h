@@ -0,0 +1,65 @@
+/*
+ * stm32f407vg_spsc_ring.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_SPSC_RING_H_
+#define INC_STM32F407VG_SPSC_RING_H_
+
+#include "stm32f407vg.h"
+
+/*
+ * This is the handle structure for a single producer / single consumer ring of fixed size records
+ *
+ * NOTE: Lock-free - Head is only written by the producer and Tail only by the consumer. Both count up forever and are
+ * 		 masked with Capacity - 1 on use, so Head - Tail is the fill level even across the 32 bit wrap. Aligned 32 bit
+ * 		 loads and stores are atomic on the Cortex-M4, so no interrupt masking is needed on either side
+ */
+
+typedef struct
+{
+	uint8_t 		*pBuffer;									/* User buffer of Capacity * ItemSize bytes */
+	uint16_t 		ItemSize;									/* Bytes per record */
+	uint16_t 		Capacity;									/* Records the ring holds - power of two */
+	__vo uint32_t 	Head;										/* Records ever put (producer) */
+	__vo uint32_t 	Tail;										/* Records ever taken (consumer) */
+	__vo uint32_t 	Overflows;									/* Records dropped because the ring was full (producer) */
+	__vo uint16_t 	HighWater;									/* Highest fill level seen by the producer */
+}RING_Handle_t;
+
+/*
+ * @RING_Status
+ * Possible return values of RING_Put / RING_Get
+ */
+
+#define RING_OK									0
+#define RING_FULL								1					/* Put: record dropped, Overflows incremented */
+#define RING_EMPTY								2					/* Get: nothing to take */
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Ring initialization
+ */
+void RING_Init(RING_Handle_t *pRingHandle, void *pBuffer, uint16_t ItemSize, uint16_t Capacity);
+
+/*
+ * Producer side (i.e., an ISR) and consumer side (i.e., the main loop) - one context each
+ */
+uint8_t RING_Put(RING_Handle_t *pRingHandle, const void *pItem);
+uint8_t RING_Get(RING_Handle_t *pRingHandle, void *pItem);
+
+/*
+ * Other ring APIs
+ */
+uint16_t RING_GetCount(RING_Handle_t *pRingHandle);
+
+#endif /* INC_STM32F407VG_SPSC_RING_H_ */
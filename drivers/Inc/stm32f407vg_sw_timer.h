@@ -0,0 +1,120 @@
+/*
+ * stm32f407vg_sw_timer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_SW_TIMER_H_
+#define INC_STM32F407VG_SW_TIMER_H_
+
+#include "stm32f407vg.h"
+#include "stm32f407vg_tim_driver.h"
+
+/*
+ * Wheel geometry - SWT_LEVELS levels of SWT_SLOTS slots. Level n slots are 64^n ticks wide, so 6 levels cover the whole
+ * 32-bit count (the top level only uses 4 slots)
+ */
+
+#define SWT_LEVEL_BITS							6
+#define SWT_SLOTS								( 1 << SWT_LEVEL_BITS )
+#define SWT_LEVELS								6
+#define SWT_MAX_TICKS							0x3FFFFFFFU			//Longest timeout/period - deadlines are compared as signed 32-bit differences
+
+/*
+ * Timer callback - called from the compare interrupt (SWT_IRQHandling) with the context the timer was started with
+ */
+
+typedef void (*SWT_Callback_t)(void *pContext);
+
+/*
+ * This is one software timer - owned by the caller (static or global), linked into the wheel while it is running
+ *
+ * NOTE: Slots are doubly linked lists, so starting and cancelling a timer never walks a list
+ */
+
+typedef struct SWT_Timer
+{
+	struct SWT_Timer 	*pNext;
+	struct SWT_Timer 	*pPrev;									/* NULL for the first timer of a slot */
+	uint32_t 			Expires;								/* Deadline (timer count) */
+	uint32_t 			Period;									/* Ticks between two callbacks, 0 for a one-shot timer */
+	SWT_Callback_t 		pCallback;
+	void 				*pContext;
+	uint8_t 			Level;									/* Slot the timer is linked into */
+	uint8_t 			Slot;
+	__vo uint8_t 		Active;									/* 1 while linked into the wheel */
+}SWT_Timer_t;
+
+/*
+ * This is the software timer wheel configuration settings structure
+ */
+
+typedef struct
+{
+	TIM2_5_RegDef_t 	*pTIMx;									/* 32-bit timer (TIM2/TIM5) - can be shared with other compare channel users */
+	uint8_t 			SWT_Channel;							/* Compare channel owned by the wheel (@TIM_CHANNEL_x macros) */
+	uint32_t 			SWT_TickFreq;							/* Timer count frequency in Hz - the unit of every timeout */
+}SWT_Config_t;
+
+/*
+ * This is the handle structure for a software timer wheel
+ *
+ * NOTE: Tickless - the compare channel is set to the next deadline (or the next time a slot of a higher level has to be
+ * 		 spread over the levels below it), never to a fixed rate. The counter itself is the time base
+ */
+
+typedef struct
+{
+	SWT_Config_t 		SWT_Config;
+	uint32_t 			Now;									/* Timer count the wheel has been processed up to */
+	uint64_t 			Pending[SWT_LEVELS];					/* Bit n set - slot n of the level is not empty */
+	SWT_Timer_t 		*pSlots[SWT_LEVELS][SWT_SLOTS];
+	uint8_t 			InIRQ;									/* Set while SWT_IRQHandling runs callbacks */
+	__vo uint32_t 		Fired;									/* Callbacks run */
+	__vo uint32_t 		Cascades;								/* Timers moved down a level */
+	__vo uint32_t 		MaxLateness;							/* Longest time between a deadline and its callback (ticks) */
+}SWT_Handle_t;
+
+/*
+ * @SWT_Status
+ * Possible return values of SWT_Start / SWT_Cancel
+ */
+
+#define SWT_OK									0
+#define SWT_ERROR_RANGE							1					/* Timeout 0 or above SWT_MAX_TICKS, or period above SWT_MAX_TICKS */
+#define SWT_INACTIVE							2					/* Cancel: timer was not running (already fired or never started) */
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Wheel initialization
+ */
+void SWT_Init(SWT_Handle_t *pSWTHandle);
+
+/*
+ * Timer start/cancel - any context (thread mode, ISRs, timer callbacks)
+ */
+uint8_t SWT_Start(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer, uint32_t Ticks, uint32_t Period, SWT_Callback_t pCallback, void *pContext);
+uint8_t SWT_Cancel(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer);
+
+/*
+ * IRQ handling - called from the IRQ handler of the wheel's timer
+ */
+void SWT_IRQHandling(SWT_Handle_t *pSWTHandle);
+
+/*
+ * Other wheel APIs
+ */
+static inline uint32_t SWT_GetTime(SWT_Handle_t *pSWTHandle)
+{
+	return pSWTHandle->SWT_Config.pTIMx->CNT;
+}
+
+#endif /* INC_STM32F407VG_SW_TIMER_H_ */
@@ -0,0 +1,101 @@
+/*
+ * stm32f407vg_telemetry.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_TELEMETRY_H_
+#define INC_STM32F407VG_TELEMETRY_H_
+
+#include "stm32f407vg.h"
+
+/*
+ * Binary telemetry frame - built by TLM_EncodeFrame, checked and unpacked by TLM_DecodeFrame (also used by host/tlm_decode)
+ *
+ * 		| Type (1) | Sequence (2) | Timestamp (4) | Payload (0 to TLM_MAX_PAYLOAD_LEN) | CRC-16 (2) |
+ *
+ * 		Multi-byte fields are little endian. CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) covers every byte before it.
+ * 		The frame is then COBS encoded, so it holds no 0x00, and ends with a single 0x00 - a receiver that starts
+ * 		mid-stream (or loses bytes) resynchronises on the next 0x00. Sequence counts every frame encoded, so a gap on
+ * 		the receiving side is the number of frames lost (i.e., dropped by a full transmit buffer)
+ */
+
+/*
+ * Build configurable items
+ */
+#ifndef TLM_MAX_PAYLOAD_LEN
+#define TLM_MAX_PAYLOAD_LEN						32						//Largest record a frame carries
+#endif
+
+#define TLM_HEADER_LEN							7						//Type, Sequence, Timestamp
+#define TLM_CRC_LEN								2
+#define TLM_MAX_RAW_LEN							( TLM_HEADER_LEN + TLM_MAX_PAYLOAD_LEN + TLM_CRC_LEN )
+
+#if ( TLM_MAX_RAW_LEN > 254 )
+#error "TLM_MAX_PAYLOAD_LEN must keep a frame within one COBS block (254 bytes)"
+#endif
+
+#define TLM_MAX_FRAME_LEN						( TLM_MAX_RAW_LEN + 2 )		//Encoded: one COBS code byte and the 0x00 delimiter on top
+
+/*
+ * This is the handle structure of one telemetry stream (one sequence counter)
+ */
+
+typedef struct
+{
+	uint16_t 		Sequence;									/* Sequence number of the next frame */
+}TLM_Handle_t;
+
+/*
+ * This is a decoded telemetry frame
+ */
+
+typedef struct
+{
+	uint8_t 		Type;										/* Record type - defined by the application */
+	uint16_t 		Sequence;
+	uint32_t 		Timestamp;									/* Time base of the sender (us for the water quality application) */
+	uint8_t 		PayloadLen;
+	uint8_t 		Payload[TLM_MAX_PAYLOAD_LEN];
+}TLM_Frame_t;
+
+/*
+ * @TLM_Status
+ * Possible return values of TLM_DecodeFrame
+ */
+
+#define TLM_OK									0
+#define TLM_ERROR_COBS							1					/* Bad COBS code byte, or a 0x00 inside the frame */
+#define TLM_ERROR_LEN							2					/* Shorter than header and CRC, or payload too long */
+#define TLM_ERROR_CRC							3
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Stream initialization
+ */
+void TLM_Init(TLM_Handle_t *pTLMHandle);
+
+/*
+ * Sender side - the encoded frame is sent as is (i.e., USART_LOG_Write)
+ */
+uint16_t TLM_EncodeFrame(TLM_Handle_t *pTLMHandle, uint8_t Type, uint32_t Timestamp, const void *pPayload, uint8_t PayloadLen, uint8_t *pFrame);
+
+/*
+ * Receiver side - pFrame holds the bytes between two 0x00 delimiters
+ */
+uint8_t TLM_DecodeFrame(const uint8_t *pFrame, uint16_t Len, TLM_Frame_t *pDecoded);
+
+/*
+ * Other telemetry APIs
+ */
+uint16_t TLM_CRC16(const uint8_t *pData, uint32_t Len);
+
+#endif /* INC_STM32F407VG_TELEMETRY_H_ */
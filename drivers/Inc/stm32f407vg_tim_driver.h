@@ -15,6 +15,67 @@
  */
 
 #define TIM_FLAG_UIF							( 1 << TIM2_5_SR_UIF )
+#define TIM_FLAG_CC1IF							( 1 << TIM2_5_SR_CC1IF )
+#define TIM_FLAG_CC2IF							( 1 << TIM2_5_SR_CC2IF )
+#define TIM_FLAG_CC3IF							( 1 << TIM2_5_SR_CC3IF )
+#define TIM_FLAG_CC4IF							( 1 << TIM2_5_SR_CC4IF )
+
+/*
+ * TIM capture/compare channel definitions
+ */
+#define TIM_CHANNEL_1							1
+#define TIM_CHANNEL_2							2
+#define TIM_CHANNEL_3							3
+#define TIM_CHANNEL_4							4
+
+/*
+ * @TIM_MasterMode
+ * TIM master mode selection - what is sent on TRGO to slave peripherals (i.e., ADC external trigger)
+ */
+#define TIM_TRGO_RESET							0
+#define TIM_TRGO_ENABLE							1
+#define TIM_TRGO_UPDATE							2
+#define TIM_TRGO_COMPARE_PULSE					3
+#define TIM_TRGO_OC1REF							4
+#define TIM_TRGO_OC2REF							5
+#define TIM_TRGO_OC3REF							6
+#define TIM_TRGO_OC4REF							7
+
+/*
+ * @TIM_Unit
+ * Time unit of the integer period APIs (TIM2_5_ComputePeriod, TIM2_5_SetPeriodIT)
+ */
+#define TIM_UNIT_NS								0
+#define TIM_UNIT_US								1
+#define TIM_UNIT_MS								2
+
+/*
+ * @TIM_Status
+ * Possible return values of the integer period APIs
+ */
+#define TIM_OK									0
+#define TIM_ERROR_RANGE							1					/* Period shorter than 2 timer clocks, longer than PSC x ARR can count, or invalid unit */
+
+/*
+ * Counter limits - TIM2/TIM5 have 32-bit counters, TIM3/TIM4 16-bit ones. All pre-scalers are 16-bit
+ */
+#define TIM_MAX_PSC								0xFFFFU
+#define TIM_MAX_ARR_16BIT						0xFFFFU
+#define TIM_MAX_ARR_32BIT						0xFFFFFFFFU
+
+/*
+ * This is a timer period turned into a pre-scaler / auto-reload pair - computed once (TIM2_5_ComputePeriod) and applied
+ * with a few register writes (TIM2_5_DelayPeriod)
+ */
+
+typedef struct
+{
+	uint32_t 		Period;										/* Requested period in Unit */
+	uint8_t 		Unit;										/* Possible values from @TIM_Unit */
+	uint32_t 		TimClk;										/* APB1 timer clock the pair was computed for - re-computed on a mismatch */
+	uint16_t 		PSC;										/* Counter clock = TimClk / ( PSC + 1 ) */
+	uint32_t 		ARR;										/* Period = ( PSC + 1 ) * ( ARR + 1 ) timer clocks - 0 if the period is out of range */
+}TIM_Period_t;
 
 
 
@@ -28,6 +89,7 @@
  */
 void TIM_PeriClockControl(TIM2_5_RegDef_t *pTIMx, uint8_t EnOrDi);
 void TIM2_5_SetDelayInit(TIM2_5_RegDef_t *pTIMx);
+void TIM2_5_SetFreeRunningInit(TIM2_5_RegDef_t *pTIMx, uint32_t TickFreq);
 
 /*
  * Peripheral control
@@ -38,6 +100,24 @@ void TIM2_5_Delay(TIM2_5_RegDef_t *pTIMx, float MicroSeconds);
 
 void TIM2_5_SetIT(TIM2_5_RegDef_t *pTIMx, float freq);
 
+/*
+ * Integer period time bases (pre-scaler aware, TIM2-TIM5) - out of range periods return TIM_ERROR_RANGE
+ */
+uint8_t TIM2_5_ComputePeriod(TIM2_5_RegDef_t *pTIMx, uint32_t Period, uint8_t Unit, TIM_Period_t *pPeriod);
+uint8_t TIM2_5_SetPeriodIT(TIM2_5_RegDef_t *pTIMx, uint32_t Period, uint8_t Unit);
+void TIM2_5_DelayPeriod(TIM2_5_RegDef_t *pTIMx, TIM_Period_t *pPeriod);
+
+/*
+ * Output compare (free-running time base)
+ */
+void TIM2_5_SetCompareIT(TIM2_5_RegDef_t *pTIMx, uint8_t Channel, uint32_t CompareVal);
+void TIM2_5_DisableCompareIT(TIM2_5_RegDef_t *pTIMx, uint8_t Channel);
+
+/*
+ * Trigger output (hardware pacing of other peripherals)
+ */
+void TIM2_5_MasterModeConfig(TIM2_5_RegDef_t *pTIMx, uint8_t MasterMode);
+
 /*
  * IRQ configuration and ISR handling
  */
@@ -37,6 +37,7 @@ typedef struct
 	uint32_t 		TxLen;										/* Transmit buffer length */
 	uint8_t 		TxBusyState;								/* Communication protocol transmission state. Used to track what is currently requested by the user */
 	uint8_t 		RxBusyState;								/* Communication protocol reception state. Used to track what is currently requested by the user */
+	DMA_Handle_t 	*pDMATxHandle;								/* DMA stream for USART_SendDataIT (NULL for TxE interrupts) - see RM table 42 for the USARTx_TX stream/channel */
 
 }USART_Handle_t;
 
@@ -49,6 +50,7 @@ typedef struct
 #define USART_MODE_ONLY_TX 						0
 #define USART_MODE_ONLY_RX 						1
 #define USART_MODE_TXRX  						2
+#define USART_MODE_HALF_DUPLEX					3					/* TX pin only (HDSEL) - Tx and Rx share the line, every byte sent is also received */
 
 /*
  *@USART_Baud
@@ -137,6 +139,7 @@ typedef struct
 #define USART_ERROR_FE  							4
 #define USART_ERROR_NE  							5
 #define USART_ERROR_ORE  							6
+#define USART_ERROR_DMA  							7					/* Tx DMA transfer or direct mode error - transmission has been abandoned */
 
 
 /******************************************************************************************
@@ -169,11 +172,13 @@ uint8_t USART_ReceiveDataIT(USART_Handle_t *pUSARTHandle, uint8_t *pRxBuffer, ui
 void USART_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi);
 void USART_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
 void USART_IRQHandling(USART_Handle_t *pHandle);
+void USART_DMA_TxIRQHandling(USART_Handle_t *pUSARTHandle);
 
 /*
  * Other Peripheral Control APIs
  */
 void USART_PeripheralControl(USART_RegDef_t *pUSARTx, uint8_t EnOrDi);
+void USART_SetBaud(USART_Handle_t *pUSARTHandle, uint32_t Baud);
 uint8_t USART_GetFlagStatus(USART_RegDef_t *pUSARTx , uint32_t FlagName);
 void USART_ClearFlag(USART_RegDef_t *pUSARTx, uint16_t StatusFlagName);
 
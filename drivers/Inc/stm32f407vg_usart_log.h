@@ -0,0 +1,92 @@
+/*
+ * stm32f407vg_usart_log.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_USART_LOG_H_
+#define INC_STM32F407VG_USART_LOG_H_
+
+#include "stm32f407vg.h"
+
+/*
+ * Build configurable items
+ */
+#ifndef USART_LOG_BUFFER_SIZE
+#define USART_LOG_BUFFER_SIZE					1024					//Bytes waiting to be sent - power of two (~90ms of text at 115200 baud)
+#endif
+
+#if ( ( USART_LOG_BUFFER_SIZE & ( USART_LOG_BUFFER_SIZE - 1 ) ) != 0 ) || ( USART_LOG_BUFFER_SIZE > 0x8000 )
+#error "USART_LOG_BUFFER_SIZE must be a power of two no larger than 32kB - one DMA transfer (NDTR) has to cover the whole buffer"
+#endif
+
+/*
+ * This is the handle structure for a log channel drained by USART Tx DMA
+ *
+ * NOTE: Head and Tail count bytes ever written / ever sent and are masked with USART_LOG_BUFFER_SIZE - 1 on use.
+ * 		 Bytes from Tail to Tail + InFlight are being read by the DMA stream and are not reused until it is done
+ */
+
+typedef struct
+{
+	USART_Handle_t 		*pUSARTHandle;							/* USART the log is sent on (already initialized with USART_Init, pDMATxHandle set) */
+	uint8_t 			Policy;									/* Possible values from @USART_LOG_Policy - what a write does when the buffer is full */
+	uint8_t 			Buffer[USART_LOG_BUFFER_SIZE];
+	__vo uint32_t 		Head;									/* Bytes ever written */
+	__vo uint32_t 		Tail;									/* Bytes ever sent (or abandoned) */
+	__vo uint16_t 		InFlight;								/* Bytes of the DMA transfer in progress (0 when the USART is idle) */
+	__vo uint16_t 		HighWater;								/* Highest fill level seen by a write */
+	__vo uint32_t 		Dropped;								/* Bytes discarded because the buffer was full */
+	__vo uint32_t 		Errors;									/* Bytes abandoned because of a DMA error */
+}USART_LOG_Handle_t;
+
+/*
+ * @USART_LOG_Policy
+ * Macros for what happens to a write that does not fit in the buffer
+ *
+ * NOTE: BLOCK only waits in thread mode with interrupts enabled - from an ISR (or with PRIMASK set) it drops like DROP
+ */
+
+#define USART_LOG_POLICY_DROP					0					/* Whole write is discarded - never waits (a line is never cut in half) */
+#define USART_LOG_POLICY_BLOCK					1					/* Caller waits for the DMA to free space */
+
+/*
+ * @USART_LOG_Status
+ * Possible return values of USART_LOG_Write
+ */
+
+#define USART_LOG_WRITTEN						0
+#define USART_LOG_DROPPED						1
+
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by this driver
+ * 							For more information about the APIs check the function definitions
+ **********************************************************************************************************************/
+
+/*
+ * Log initialization - the stdout log is the one _write (printf) feeds
+ */
+void USART_LOG_Init(USART_LOG_Handle_t *pLogHandle, USART_Handle_t *pUSARTHandle, uint8_t Policy);
+void USART_LOG_SetStdout(USART_LOG_Handle_t *pLogHandle);
+USART_LOG_Handle_t *USART_LOG_GetStdout(void);
+
+/*
+ * Write - safe to call from any ISR or thread mode
+ */
+uint8_t USART_LOG_Write(USART_LOG_Handle_t *pLogHandle, const uint8_t *pData, uint32_t Len);
+
+/*
+ * Event handling - call from USART_ApplicationEventCallBack
+ */
+void USART_LOG_EventHandling(USART_LOG_Handle_t *pLogHandle, uint8_t AppEvent);
+
+/*
+ * Other log APIs
+ */
+uint16_t USART_LOG_GetCount(USART_LOG_Handle_t *pLogHandle);
+
+#endif /* INC_STM32F407VG_USART_LOG_H_ */
@@ -11,6 +11,14 @@
 static void ADC_SampleTimeInit(ADC_Handle_t *pADCHandle);
 static void ADC_tStabDelay(void);
 static void ADC_HandleRead(ADC_Handle_t *pADCHandle);
+static void ADC_DMAStart(ADC_Handle_t *pADCHandle, uint16_t *pBuffer, uint16_t Length, uint8_t DMAMode);
+static void ADC_BurstRearm(ADC_Handle_t *pADCHandle);
+static void ADC_MultiInit(ADC_Handle_t *pADCHandle);
+static uint8_t ADC_GetNumOfADCs(ADC_Handle_t *pADCHandle);
+static ADC_RegDef_t *ADC_GetGroupADC(ADC_Handle_t *pADCHandle, uint8_t Index);
+static uint8_t ADC_GetMultiDMAMode(ADC_Handle_t *pADCHandle);
+static void ADC_GroupOnOffControl(ADC_Handle_t *pADCHandle, uint8_t EnOrDi);
+static void ADC_DMAStreamStart(ADC_Handle_t *pADCHandle);
 
 /********************************************************/
 
@@ -118,6 +126,8 @@ void ADC_PeripheralOnOffControl(ADC_RegDef_t *pADCx, uint8_t EnOrDi)
 */
 uint8_t ADC_GetFlagStatus(ADC_RegDef_t *pADCx, uint32_t FlagName)
 {
+	SIM_POLL();
+
 	if(	pADCx->SR & FlagName ) return FLAG_SET;
 	else return FLAG_RESET;
 }
@@ -178,7 +188,7 @@ void ADC_ClearFlag(ADC_RegDef_t *pADCx, uint32_t FlagName)
 
  	 * @retval 		- none
 
- 	 * @Note		- none
+ 	 * @Note		- With a multi ADC mode configured (ADC1 handle), the slave handles in pSlaveHandle are initialized too
 
 */
 void ADC_Init(ADC_Handle_t *pADCHandle)
@@ -239,18 +249,13 @@ void ADC_Init(ADC_Handle_t *pADCHandle)
 
 	// 5. Configure ADC sequence length and order
 
-		//a. Configure sequence conversion length
-		tempreg = 0;
-		tempreg = ( pADCHandle->ADC_Config.ADC_Seq_Len << ADC_SQR1_L_3_0 );
-
-		if( ( pADCHandle->ADC_Config.ADC_Seq_Len ) > 15)
+		//a. Check sequence conversion length (written into SQR1 L along with the order)
+		if( ( pADCHandle->ADC_Config.ADC_Seq_Len ) > 16 || ( pADCHandle->ADC_Config.ADC_Seq_Len ) == 0 )
 		{
 			//Cannot have a sequence of regular ADC conversions longer than 16 - See RM 13.3.3. If invalid number, enter into an infinite loop.
 			while(1);
 		}
 
-		pADCHandle->pADCx->SQR1 |= tempreg;
-
 		//b. Configure channel conversion sequence
 
 		ADC_SequenceInit(pADCHandle);
@@ -274,6 +279,23 @@ void ADC_Init(ADC_Handle_t *pADCHandle)
 	//8. Enable overrun detection (interrupts enabled in ADC_ConvertIT API)
 	//This also configures the EOC status bit to be set after each conversion and not just at the end of the sequence
 	pADCHandle->pADCx->CR2 |= ( 1 << ADC_CR2_EOCS );
+
+	//9. Configure external trigger of regular group - conversions then start on the trigger edge instead of SWSTART
+	pADCHandle->pADCx->CR2 &= ~( ( 0xF << ADC_CR2_EXTSEL_3_0 ) | ( 0x3 << ADC_CR2_EXTEN_1_0 ) );
+
+	if( pADCHandle->ADC_Config.ADC_ExtTrigEdge != ADC_EXT_TRIG_DISABLE )
+	{
+		tempreg = 0;
+		tempreg |= ( ( pADCHandle->ADC_Config.ADC_ExtTrigSource & 0xF ) << ADC_CR2_EXTSEL_3_0 );
+		tempreg |= ( ( pADCHandle->ADC_Config.ADC_ExtTrigEdge & 0x3 ) << ADC_CR2_EXTEN_1_0 );
+		pADCHandle->pADCx->CR2 |= tempreg;
+	}
+
+	//10. Configure multi ADC mode - ADC2/ADC3 then follow the trigger of ADC1
+	if( pADCHandle->ADC_Config.ADC_MultiMode != ADC_MULTI_INDEPENDENT )
+	{
+		ADC_MultiInit(pADCHandle);
+	}
 }
 
 
@@ -287,7 +309,8 @@ void ADC_Init(ADC_Handle_t *pADCHandle)
 
  	 * @retval 		- none
 
- 	 * @Note		- ADC interface reset is common to all ADCs - all ADC's peripheral registers will be reset
+ 	 * @Note		- ADC interface reset is common to all ADCs - all ADC's peripheral registers will be reset, ADC_CCR
+ 	 * 				- included (back to independent mode)
 
 */
 void ADC_DeInit(void)
@@ -393,17 +416,17 @@ void ADC_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
 		if(IRQNumber <= 31)
 		{
 			//configure ICER0 register in processor //0 to 31
-			*NVIC_ICER0 |= ( 1 << IRQNumber );
+			*NVIC_ICER0 = ( 1 << IRQNumber );
 		}
 		else if(IRQNumber > 31 && IRQNumber <= 63)
 		{
 			//configure ICER1 register in processor //32 to 63
-			*NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
 		}
 		else if(IRQNumber > 63 && IRQNumber <= 95)
 		{
 			//configure ICER2 register in processor //64 to 95
-			*NVIC_ICER2 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
 		}
 	}
 }
@@ -554,7 +577,11 @@ void ADC_IRQHandling(ADC_Handle_t *pADCHandle)
 		//2. Check if the interrupt was triggered by "analog watch dog threshold" flag
 
 		//2.1 Behavior of an analog watch dog threshold event defined by user
-		ADC_HandleRead(pADCHandle);
+		//In DMA mode (own or ADC_CDR) the data register belongs to the DMA stream - the application can still look at DR in the callback
+		if( !( pADCHandle->pADCx->CR2 & ( 1 << ADC_CR2_DMA ) ) && !( ADCCOMMON->CCR & ( 0x3 << ADC_CCR_DMA_1_0 ) ) )
+		{
+			ADC_HandleRead(pADCHandle);
+		}
 
 		ADC_ApplicationEventCallBack(pADCHandle, ADC_EVENT_AWD);
 	}
@@ -597,6 +624,193 @@ void ADC_IRQHandling(ADC_Handle_t *pADCHandle)
 }
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_StartDMA
+
+ 	 * @brief  		- API that configures the ADC for scan mode and has a DMA stream copy every conversion of the
+ 	 * 				- sequence into a circular user buffer
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle to use
+ 	 * @param 		- pBuffer : user buffer the DMA stream writes converted values into (in sequence order, wraps around).
+ 	 * 				- 4-byte aligned in multi ADC DMA mode 2
+ 	 * @param 		- Length : number of 16 bit items in pBuffer - must be a multiple of the scan length (ADC_GetScanLen)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Caller fills pDMAHandle->pDMAx, StreamNumber and DMA_Config.DMA_Channel (ADC1: DMA2 stream 0 or 4, channel 0)
+ 	 * 				- the rest of the stream configuration is done here.
+ 	 * 				- In a multi ADC mode the stream reads ADC_CDR, so every item of a scan is in pBuffer (ADC_GetScanChannel)
+ 	 * 				- A Length of 2 * sequence length makes ADC_EVENT_DMA_HALF_CMPLT and ADC_EVENT_DMA_CMPLT each mark one
+ 	 * 				- complete sequence: the application processes one half while the stream fills the other.
+ 	 * 				- Sequences are started by the external trigger if one is configured, otherwise call ADC_StartADC for each one.
+ 	 * 				- The DMA stream and ADC stay armed between sequences
+
+*/
+void ADC_StartDMA(ADC_Handle_t *pADCHandle, uint16_t *pBuffer, uint16_t Length)
+{
+	if( ( pADCHandle->pDMAHandle == NULL ) || ( Length == 0 ) || ( Length % ADC_GetScanLen(pADCHandle) ) ||
+		( ( ADC_GetMultiDMAMode(pADCHandle) == 2 ) && ( ( Length % 2 ) || ( (uint32_t) pBuffer % 4 ) ) ) )
+	{
+		//No DMA stream, a buffer that would split a sequence across the wrap, half a CDR word or CDR words to a misaligned
+		//address (word transfers in direct mode). If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//1. One sequence per trigger
+	for( uint8_t i = 0; i < ADC_GetNumOfADCs(pADCHandle); i++ )
+	{
+		ADC_GetGroupADC(pADCHandle, i)->CR2 &= ~( 1 << ADC_CR2_CONT );
+	}
+
+	//2. Circular stream - keeps filling the buffer trigger after trigger
+	ADC_DMAStart(pADCHandle, pBuffer, Length, DMA_MODE_CIRCULAR);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_StartBurstDMA
+
+ 	 * @brief  		- API that makes every trigger convert the sequence back to back until a user buffer is full
+ 	 * 				- (continuous scan into a normal-mode DMA stream)
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle to use
+ 	 * @param 		- pBuffer : user buffer the DMA stream writes the burst into (in sequence order, sequence after sequence).
+ 	 * 				- 4-byte aligned in multi ADC DMA mode 2
+ 	 * @param 		- Length : number of 16 bit items in pBuffer - must be a multiple of the scan length (ADC_GetScanLen)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Same DMA handle requirements and buffer layout as ADC_StartDMA.
+ 	 * 				- Once the buffer is full the ADC is turned off (aborting the extra conversion already under way),
+ 	 * 				- ADC_EVENT_DMA_CMPLT is raised and the stream and ADC are re-armed for the next trigger - the buffer
+ 	 * 				- must be consumed inside the callback
+
+*/
+void ADC_StartBurstDMA(ADC_Handle_t *pADCHandle, uint16_t *pBuffer, uint16_t Length)
+{
+	if( ( pADCHandle->pDMAHandle == NULL ) || ( Length == 0 ) || ( Length % ADC_GetScanLen(pADCHandle) ) ||
+		( ( ADC_GetMultiDMAMode(pADCHandle) == 2 ) && ( ( Length % 2 ) || ( (uint32_t) pBuffer % 4 ) ) ) )
+	{
+		//No DMA stream, a buffer that would split a sequence, half a CDR word or CDR words to a misaligned address. If invalid,
+		//enter into an infinite loop.
+		while(1);
+	}
+
+	//1. Keep converting the sequence after the trigger - stopped by turning off the ADCs at the end of the burst
+	for( uint8_t i = 0; i < ADC_GetNumOfADCs(pADCHandle); i++ )
+	{
+		ADC_GetGroupADC(pADCHandle, i)->CR2 |= ( 1 << ADC_CR2_CONT );
+	}
+
+	//2. Normal stream - one buffer per trigger
+	ADC_DMAStart(pADCHandle, pBuffer, Length, DMA_MODE_NORMAL);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_StopDMA
+
+ 	 * @brief  		- API that stops the DMA stream of an ADC and takes the ADC out of DMA mode
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle in use
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void ADC_StopDMA(ADC_Handle_t *pADCHandle)
+{
+	ADC_RegDef_t *pADCx;
+
+	//1. Stop requests from ADC (or ADC_CDR) first, then the stream
+	for( uint8_t i = 0; i < ADC_GetNumOfADCs(pADCHandle); i++ )
+	{
+		pADCx = ADC_GetGroupADC(pADCHandle, i);
+
+		pADCx->CR2 &= ~( 1 << ADC_CR2_CONT );
+		pADCx->CR2 &= ~( 1 << ADC_CR2_DMA );
+		pADCx->CR2 &= ~( 1 << ADC_CR2_DDS );
+
+		//2. Disable interrupts
+		pADCx->CR1 &= ~( 1 << ADC_CR1_AWDIE );
+		pADCx->CR1 &= ~( 1 << ADC_CR1_OVRIE );
+	}
+
+	ADCCOMMON->CCR &= ~( ( 0x3 << ADC_CCR_DMA_1_0 ) | ( 1 << ADC_CCR_DDS ) );
+
+	DMA_StopTransfer(pADCHandle->pDMAHandle);
+
+	//3. Reset handle structure
+	pADCHandle->pADC_DataBuffer = NULL;
+	pADCHandle->ADC_SeqLen = 0;
+
+	//4. Turn off ADC (and slaves)
+	ADC_GroupOnOffControl(pADCHandle, DISABLE);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_DMA_IRQHandling
+
+ 	 * @brief  		- API that handles interrupts generated by the DMA stream of an ADC started with ADC_StartDMA.
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle in use
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call from the DMA stream IRQ handler (ADC1: DMA2_Stream0_IRQHandler). Events are reported through
+ 	 * 				- ADC_ApplicationEventCallBack so the application only implements one callback for the ADC
+
+*/
+void ADC_DMA_IRQHandling(ADC_Handle_t *pADCHandle)
+{
+	DMA_Handle_t *pDMAHandle = pADCHandle->pDMAHandle;
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TEIF) || DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_DMEIF) )
+	{
+		//1. Transfer or direct mode error - stream is disabled by hardware, buffer content can no longer be trusted
+		DMA_ClearFlag(pDMAHandle, ( DMA_FLAG_TEIF | DMA_FLAG_DMEIF ) );
+		ADC_ApplicationEventCallBack(pADCHandle, ADC_ERROR_DMA);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_HTIF) )
+	{
+		//2. First half of the buffer is filled - sequence is done, so clear STRT for the next ADC_StartADC
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_HTIF);
+		ADC_ClearFlag(pADCHandle->pADCx, ADC_FLAG_STRT);
+
+		ADC_ApplicationEventCallBack(pADCHandle, ADC_EVENT_DMA_HALF_CMPLT);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TCIF) )
+	{
+		//3. Second half of the buffer is filled - stream wraps back to the start of the buffer by itself
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_TCIF);
+		ADC_ClearFlag(pADCHandle->pADCx, ADC_FLAG_STRT);
+
+		if( pDMAHandle->DMA_Config.DMA_Mode == DMA_MODE_NORMAL )
+		{
+			//3.1 End of a burst (ADC_StartBurstDMA) - stream was disabled by hardware, stop the continuous conversions
+			ADC_GroupOnOffControl(pADCHandle, DISABLE);
+
+			ADC_ApplicationEventCallBack(pADCHandle, ADC_EVENT_DMA_CMPLT);
+
+			//3.2 Buffer has been consumed by the application - get ready for the next trigger
+			ADC_BurstRearm(pADCHandle);
+		}
+		else
+		{
+			ADC_ApplicationEventCallBack(pADCHandle, ADC_EVENT_DMA_CMPLT);
+		}
+	}
+}
+
+
 /*********************** Function Documentation ***************************************
  *
  	 * @fn			- ADC_StartADC
@@ -608,15 +822,19 @@ void ADC_IRQHandling(ADC_Handle_t *pADCHandle)
  	 * @retval 		- none
 
  	 * @Note		- API only starts conversion of regular channels, not injected ones
+ 	 * 				- With an external trigger configured (ADC_ExtTrigEdge), this only turns the ADC on and arms it for the trigger
+ 	 * 				- In a multi ADC mode the slaves are turned on too and start with ADC1
 
 */
 void ADC_StartADC(ADC_Handle_t *pADCHandle)
 {
-	uint8_t temp = ( pADCHandle->pADCx->CR2 & ( 1 << ADC_CR2_ADON ) );
+	ADC_GroupOnOffControl(pADCHandle, ENABLE);
+
+	// If an external trigger is configured, hardware starts every conversion - ADC only needs to be on
 
-	if( !temp )
+	if( pADCHandle->pADCx->CR2 & ( 0x3 << ADC_CR2_EXTEN_1_0 ) )
 	{
-		ADC_PeripheralOnOffControl(pADCHandle->pADCx, ENABLE);
+		return;
 	}
 
 	// Set ADC to start converting - if already converting, issue an application event
@@ -633,6 +851,53 @@ void ADC_StartADC(ADC_Handle_t *pADCHandle)
 }
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_GetScanLen
+
+ 	 * @brief  		- API that returns the number of conversions one trigger writes into a DMA buffer
+
+ 	 * @param 		- *pADCHandle : contains ADC peripheral base address in MCU memory as well as configuration values
+
+ 	 * @retval 		- sequence length times the number of ADCs converting it (1 independent, 2 dual, 3 triple)
+
+ 	 * @Note		- none
+
+*/
+uint8_t ADC_GetScanLen(ADC_Handle_t *pADCHandle)
+{
+	return ( pADCHandle->ADC_Config.ADC_Seq_Len * ADC_GetNumOfADCs(pADCHandle) );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_GetScanChannel
+
+ 	 * @brief  		- API that returns the channel converted into a given item of a scan in a DMA buffer
+
+ 	 * @param 		- *pADCHandle : contains ADC peripheral base address in MCU memory as well as configuration values
+ 	 * @param 		- Index : item of the scan (0 to ADC_GetScanLen - 1)
+
+ 	 * @retval 		- @ADC_Channels value
+
+ 	 * @Note		- Multi ADC items go rank by rank, ADC1 first: | ADC1 rank 1 | ADC2 rank 1 | (ADC3 rank 1) | ADC1 rank 2 | ...
+
+*/
+uint8_t ADC_GetScanChannel(ADC_Handle_t *pADCHandle, uint8_t Index)
+{
+	uint8_t NumOfADCs = ADC_GetNumOfADCs(pADCHandle);
+	ADC_Handle_t *pOwner = pADCHandle;
+
+	if( Index % NumOfADCs )
+	{
+		pOwner = pADCHandle->pSlaveHandle[( Index % NumOfADCs ) - 1];
+	}
+
+	return pOwner->ADC_Config.ADC_Seq_Order[Index / NumOfADCs];
+}
+
+
 /*********************** Function Documentation ***************************************
  *
  	 * @fn			- ADC_ApplicationEventCallBack
@@ -683,6 +948,9 @@ void ADC_SequenceInit(ADC_Handle_t *pADCHandle)
 	uint8_t Sequence_Length = pADCHandle->ADC_Config.ADC_Seq_Len;
 	uint32_t temp = 0;
 
+	//Number of conversions in the sequence - L field holds length minus 1
+	pADCHandle->pADCx->SQR1 |= ( ( Sequence_Length - 1 ) << ADC_SQR1_L_3_0 );
+
 
 	while( Sequence_Length > 12 )
 	{
@@ -847,4 +1115,354 @@ static void ADC_HandleRead(ADC_Handle_t *pADCHandle)
 
 }
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_DMAStart
+
+ 	 * @brief  		- Helper API that configures the DMA stream of an ADC, puts the ADC (or the ADC group) in DMA scan mode and
+ 	 * 				- starts the stream
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle to use
+ 	 * @param 		- pBuffer : user buffer the DMA stream writes converted values into
+ 	 * @param 		- Length : number of 16 bit items in pBuffer
+ 	 * @param 		- DMAMode : DMA_MODE_CIRCULAR (ADC_StartDMA) or DMA_MODE_NORMAL (ADC_StartBurstDMA)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Multi ADC DMA mode 2 moves one ADC_CDR word (two results) per request - the stream then counts words
+
+*/
+static void ADC_DMAStart(ADC_Handle_t *pADCHandle, uint16_t *pBuffer, uint16_t Length, uint8_t DMAMode)
+{
+	uint8_t MultiDMAMode = ADC_GetMultiDMAMode(pADCHandle);
+	ADC_RegDef_t *pADCx;
+
+	//0. Keep track of user buffer and sequence length in the handle like ADC_EnableIT does
+	pADCHandle->pADC_DataBuffer = pBuffer;
+	pADCHandle->ADC_SeqLen = pADCHandle->ADC_Config.ADC_Seq_Len;
+	pADCHandle->ADC_DMALen = Length;
+
+	//1. Configure DMA stream: ADC data register (16 bits, fixed) or ADC_CDR (32 bits in DMA mode 2) to user buffer (incrementing)
+	DMA_Handle_t *pDMAHandle = pADCHandle->pDMAHandle;
+
+	pDMAHandle->DMA_Config.DMA_Direction = DMA_DIR_PERIPH_TO_MEM;
+	pDMAHandle->DMA_Config.DMA_Mode = DMAMode;
+	pDMAHandle->DMA_Config.DMA_PeriphDataSize = ( MultiDMAMode == 2 ) ? DMA_DATA_SIZE_WORD : DMA_DATA_SIZE_HALFWORD;
+	pDMAHandle->DMA_Config.DMA_MemDataSize = ( MultiDMAMode == 2 ) ? DMA_DATA_SIZE_WORD : DMA_DATA_SIZE_HALFWORD;
+	pDMAHandle->DMA_Config.DMA_PeriphInc = DMA_INC_DISABLE;
+	pDMAHandle->DMA_Config.DMA_MemInc = DMA_INC_ENABLE;
+	pDMAHandle->DMA_Config.DMA_Priority = DMA_PRIORITY_HIGH;
+	pDMAHandle->DMA_Config.DMA_FIFOMode = DMA_FIFO_DISABLE;
+
+	DMA_Init(pDMAHandle);
+
+	//2. Scan the whole sequence on every trigger, one DMA request per conversion (or per ADC_CDR item/word)
+	for( uint8_t i = 0; i < ADC_GetNumOfADCs(pADCHandle); i++ )
+	{
+		pADCx = ADC_GetGroupADC(pADCHandle, i);
+
+		if( pADCHandle->ADC_Config.ADC_Seq_Len > 1 )
+		{
+			pADCx->CR1 |= ( 1 << ADC_CR1_SCAN );
+		}
+
+		pADCx->CR1 &= ~( 1 << ADC_CR1_EOCIE );
+		pADCx->CR2 &= ~( 1 << ADC_CR2_EOCS );
+	}
+
+	//3. Keep issuing DMA requests after the last transfer (DDS) in circular mode - a burst stops at the last one
+	if( MultiDMAMode )
+	{
+		//Requests come from ADC_CDR once every ADC of the group has converted - not from the ADCs themselves
+		pADCHandle->pADCx->CR2 &= ~( ( 1 << ADC_CR2_DMA ) | ( 1 << ADC_CR2_DDS ) );
+
+		ADCCOMMON->CCR &= ~( ( 0x3 << ADC_CCR_DMA_1_0 ) | ( 1 << ADC_CCR_DDS ) );
+		ADCCOMMON->CCR |= ( MultiDMAMode << ADC_CCR_DMA_1_0 );
+
+		if( DMAMode == DMA_MODE_CIRCULAR )
+		{
+			ADCCOMMON->CCR |= ( 1 << ADC_CCR_DDS );
+		}
+	}
+	else
+	{
+		pADCHandle->pADCx->CR2 |= ( 1 << ADC_CR2_DMA );
+
+		if( DMAMode == DMA_MODE_CIRCULAR )
+		{
+			pADCHandle->pADCx->CR2 |= ( 1 << ADC_CR2_DDS );
+		}
+		else
+		{
+			pADCHandle->pADCx->CR2 &= ~( 1 << ADC_CR2_DDS );
+		}
+	}
+
+	//4. Start DMA stream before the first conversion so no data is missed
+	ADC_DMAStreamStart(pADCHandle);
+
+	//5. Enable watch dog and overrun interrupts - data itself is reported through ADC_DMA_IRQHandling
+	for( uint8_t i = 0; i < ADC_GetNumOfADCs(pADCHandle); i++ )
+	{
+		pADCx = ADC_GetGroupADC(pADCHandle, i);
+
+		pADCx->CR1 |= ( 1 << ADC_CR1_AWDIE );
+		pADCx->CR1 |= ( 1 << ADC_CR1_OVRIE );
+	}
+
+	//6. Make sure ADC is on - with an external trigger this is all that is needed for hardware-paced sequences
+	ADC_GroupOnOffControl(pADCHandle, ENABLE);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_BurstRearm
+
+ 	 * @brief  		- Helper API that reloads the DMA stream and turns the ADC back on after a burst
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle in use
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Turning the ADC off aborts the conversion that was under way and resets the sequencer, so the next
+ 	 * 				- trigger starts again at the first channel of the sequence
+
+*/
+static void ADC_BurstRearm(ADC_Handle_t *pADCHandle)
+{
+	uint8_t MultiDMAMode = ADC_GetMultiDMAMode(pADCHandle);
+
+	//1. Reset ADC DMA request logic (clear then set DMA bits) and any overrun raised by the aborted conversion
+	if( MultiDMAMode )
+	{
+		ADCCOMMON->CCR &= ~( 0x3 << ADC_CCR_DMA_1_0 );
+	}
+	else
+	{
+		pADCHandle->pADCx->CR2 &= ~( 1 << ADC_CR2_DMA );
+	}
+
+	for( uint8_t i = 0; i < ADC_GetNumOfADCs(pADCHandle); i++ )
+	{
+		ADC_ClearFlag(ADC_GetGroupADC(pADCHandle, i), ADC_FLAG_OVR);
+	}
+
+	if( MultiDMAMode )
+	{
+		ADCCOMMON->CCR |= ( MultiDMAMode << ADC_CCR_DMA_1_0 );
+	}
+	else
+	{
+		pADCHandle->pADCx->CR2 |= ( 1 << ADC_CR2_DMA );
+	}
+
+	//2. Reload the stream with the same buffer
+	ADC_DMAStreamStart(pADCHandle);
+
+	//3. Turn the ADC (and slaves) back on (waits tSTAB) - next trigger starts the next burst
+	ADC_GroupOnOffControl(pADCHandle, ENABLE);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_DMAStreamStart
+
+ 	 * @brief  		- Helper API that starts the DMA stream of an ADC on the handle's buffer
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as the DMA handle in use
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Source is the ADC data register, or ADC_CDR in a multi ADC mode (ADC_DMALen / 2 words in DMA mode 2)
+
+*/
+static void ADC_DMAStreamStart(ADC_Handle_t *pADCHandle)
+{
+	uint8_t MultiDMAMode = ADC_GetMultiDMAMode(pADCHandle);
+
+	if( MultiDMAMode )
+	{
+		DMA_StartTransfer(pADCHandle->pDMAHandle, (uint32_t) &( ADCCOMMON->CDR ), (uint32_t) pADCHandle->pADC_DataBuffer, ( MultiDMAMode == 2 ) ? ( pADCHandle->ADC_DMALen / 2 ) : pADCHandle->ADC_DMALen );
+	}
+	else
+	{
+		DMA_StartTransfer(pADCHandle->pDMAHandle, (uint32_t) &( pADCHandle->pADCx->DR ), (uint32_t) pADCHandle->pADC_DataBuffer, pADCHandle->ADC_DMALen);
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_MultiInit
+
+ 	 * @brief  		- Helper API that initializes the slaves of a multi ADC mode and writes the mode into ADC_CCR
+
+ 	 * @param 		- pADCHandle : ADC1 handle with ADC_MultiMode and pSlaveHandle filled in
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Slaves convert their own sequence on the ADC1 trigger - it must be as long as the ADC1 one, and the
+ 	 * 				- slaves must have no trigger of their own (see RM 13.9)
+
+*/
+static void ADC_MultiInit(ADC_Handle_t *pADCHandle)
+{
+	uint8_t NumOfADCs = ADC_GetNumOfADCs(pADCHandle);
+
+	//1. Check the group - only ADC1 can be the master
+	if( ( pADCHandle->pADCx != ADC1 ) || ( NumOfADCs == 1 ) || ( pADCHandle->ADC_Config.ADC_MultiDelay > 15 ) )
+	{
+		//Unsupported multi ADC mode. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	for( uint8_t i = 0; i < ( NumOfADCs - 1 ); i++ )
+	{
+		ADC_Handle_t *pSlave = pADCHandle->pSlaveHandle[i];
+
+		if( ( pSlave == NULL ) || ( pSlave->pADCx != ( ( i == 0 ) ? ADC2 : ADC3 ) ) || ( pSlave->ADC_Config.ADC_Seq_Len != pADCHandle->ADC_Config.ADC_Seq_Len )
+				|| ( pSlave->ADC_Config.ADC_ExtTrigEdge != ADC_EXT_TRIG_DISABLE ) || ( pSlave->ADC_Config.ADC_MultiMode != ADC_MULTI_INDEPENDENT ) )
+		{
+			//Missing slave, slave sequence of another length or a slave with its own trigger. If invalid, enter into an infinite loop.
+			while(1);
+		}
+
+		//2. Slaves are configured like independent ADCs
+		ADC_Init(pSlave);
+	}
+
+	//3. Select the mode (and the interleaved delay) - DMA mode is selected when a DMA stream is started
+	ADCCOMMON->CCR &= ~( ( 0x1F << ADC_CCR_MULTI_4_0 ) | ( 0xF << ADC_CCR_DELAY_3_0 ) | ( 0x3 << ADC_CCR_DMA_1_0 ) | ( 1 << ADC_CCR_DDS ) );
+	ADCCOMMON->CCR |= ( pADCHandle->ADC_Config.ADC_MultiDelay << ADC_CCR_DELAY_3_0 );
+	ADCCOMMON->CCR |= ( pADCHandle->ADC_Config.ADC_MultiMode << ADC_CCR_MULTI_4_0 );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_GetNumOfADCs
+
+ 	 * @brief  		- Helper API that returns how many ADCs convert on the trigger of an ADC handle
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as configuration values
+
+ 	 * @retval 		- 1 (independent), 2 (dual modes) or 3 (triple modes)
+
+ 	 * @Note		- none
+
+*/
+static uint8_t ADC_GetNumOfADCs(ADC_Handle_t *pADCHandle)
+{
+	switch( pADCHandle->ADC_Config.ADC_MultiMode )
+	{
+		case ADC_MULTI_DUAL_REG_SIMULT:
+		case ADC_MULTI_DUAL_INTERLEAVED:
+			return 2;
+
+		case ADC_MULTI_TRIPLE_REG_SIMULT:
+		case ADC_MULTI_TRIPLE_INTERLEAVED:
+			return 3;
+
+		default:
+			return 1;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_GetGroupADC
+
+ 	 * @brief  		- Helper API that returns one ADC of the group converting on the trigger of an ADC handle
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as configuration values
+ 	 * @param 		- Index : 0 for the handle's own ADC, 1 and 2 for the slaves
+
+ 	 * @retval 		- ADC peripheral base address
+
+ 	 * @Note		- none
+
+*/
+static ADC_RegDef_t *ADC_GetGroupADC(ADC_Handle_t *pADCHandle, uint8_t Index)
+{
+	if( Index == 0 )
+	{
+		return pADCHandle->pADCx;
+	}
+
+	return pADCHandle->pSlaveHandle[Index - 1]->pADCx;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_GetMultiDMAMode
+
+ 	 * @brief  		- Helper API that returns the ADC_CCR DMA mode a multi ADC mode is read with
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as configuration values
+
+ 	 * @retval 		- 0 (independent - ADC data register), 1 (ADC_CDR halfword per result) or 2 (ADC_CDR word per two results)
+
+ 	 * @Note		- Triple simultaneous needs mode 1: mode 2 would pair results of different trigger instants
+
+*/
+static uint8_t ADC_GetMultiDMAMode(ADC_Handle_t *pADCHandle)
+{
+	switch( pADCHandle->ADC_Config.ADC_MultiMode )
+	{
+		case ADC_MULTI_DUAL_REG_SIMULT:
+		case ADC_MULTI_DUAL_INTERLEAVED:
+		case ADC_MULTI_TRIPLE_INTERLEAVED:
+			return 2;
+
+		case ADC_MULTI_TRIPLE_REG_SIMULT:
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_GroupOnOffControl
+
+ 	 * @brief  		- Helper API that turns on or off an ADC and the slaves of its multi ADC mode
+
+ 	 * @param 		- pADCHandle : Contains ADC peripheral base address in MCU memory as well as configuration values
+ 	 * @param 		- EnOrDi : ENABLE (only ADCs that are off, slaves first) or DISABLE (ADC1 first - no new trigger)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+static void ADC_GroupOnOffControl(ADC_Handle_t *pADCHandle, uint8_t EnOrDi)
+{
+	uint8_t NumOfADCs = ADC_GetNumOfADCs(pADCHandle);
+	ADC_RegDef_t *pADCx;
+
+	for( uint8_t i = 0; i < NumOfADCs; i++ )
+	{
+		if( EnOrDi == ENABLE )
+		{
+			pADCx = ADC_GetGroupADC(pADCHandle, NumOfADCs - 1 - i);
+
+			if( !( pADCx->CR2 & ( 1 << ADC_CR2_ADON ) ) )
+			{
+				ADC_PeripheralOnOffControl(pADCx, ENABLE);
+			}
+		}
+		else
+		{
+			ADC_PeripheralOnOffControl(ADC_GetGroupADC(pADCHandle, i), DISABLE);
+		}
+	}
+}
+
+
 /*----------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,196 @@
+/*
+ * stm32f407vg_adc_oversampling.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_adc_oversampling.h"
+
+/*********** Driver-specific helper functions prototype section ***********/
+static void ADC_OVS_CycleCounterInit(void);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_OVS_Init
+
+ 	 * @brief  		- API that sizes the burst from the per-channel ratios and starts burst DMA acquisition on the ADC
+
+ 	 * @param 		- *pOVSHandle : contains ADC handle (already initialized with ADC_Init, DMA handle set) and ratios
+ 	 * @param 		- *pBurstBuffer : user buffer for the raw burst
+ 	 * @param 		- Length : number of 16 bit items in pBurstBuffer - must hold scan length * largest ratio
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Every trigger converts the whole sequence largest-ratio times back to back. Channels with a smaller
+ 	 * 				- ratio only use the first conversions of the burst.
+ 	 * 				- In a multi ADC mode every ADC of the group is a rank of its own (see ADC_GetScanChannel)
+
+*/
+void ADC_OVS_Init(ADC_OVS_Handle_t *pOVSHandle, uint16_t *pBurstBuffer, uint16_t Length)
+{
+	ADC_Handle_t *pADCHandle = pOVSHandle->pADCHandle;
+	uint8_t SeqLen = ADC_GetScanLen(pADCHandle);
+	uint8_t MaxRatio = ADC_OVS_RATIO_1;
+	uint8_t channel;
+
+	if( SeqLen > 16 )
+	{
+		//One result per rank of a scan - Result[] holds 16. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//1. Largest ratio of the channels in the sequence sets the burst length
+	for(uint8_t rank = 0; rank < SeqLen; rank++)
+	{
+		channel = ADC_GetScanChannel(pADCHandle, rank);
+
+		if( pOVSHandle->ADC_OVS_Config.ADC_OVS_Ratio[channel] > ADC_OVS_RATIO_256 )
+		{
+			//Accumulator is sized for at most 256 12 bit conversions. If invalid number, enter into an infinite loop.
+			while(1);
+		}
+
+		if( pOVSHandle->ADC_OVS_Config.ADC_OVS_Ratio[channel] > MaxRatio )
+		{
+			MaxRatio = pOVSHandle->ADC_OVS_Config.ADC_OVS_Ratio[channel];
+		}
+	}
+
+	pOVSHandle->BurstLen = ( 1 << MaxRatio );
+
+	if( Length < ( SeqLen * pOVSHandle->BurstLen ) )
+	{
+		//Buffer cannot hold a whole burst. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//2. Resolution and full scale of every rank - full scale is what a constant max code input decimates to
+	uint8_t AdcBits = 12 - ( 2 * pADCHandle->ADC_Config.ADC_Resolution );
+	uint8_t ratio, shift;
+
+	for(uint8_t rank = 0; rank < SeqLen; rank++)
+	{
+		channel = ADC_GetScanChannel(pADCHandle, rank);
+		ratio = pOVSHandle->ADC_OVS_Config.ADC_OVS_Ratio[channel];
+
+		if( pOVSHandle->ADC_OVS_Config.ADC_OVS_Mode[channel] == ADC_OVS_MODE_ENHANCE )
+		{
+			shift = ratio - ( ratio / 2 );
+		}
+		else
+		{
+			shift = ratio;
+		}
+
+		pOVSHandle->ResultBits[rank] = AdcBits + ratio - shift;
+		pOVSHandle->FullScale[rank] = ( ( ( 1UL << AdcBits ) - 1 ) << ratio ) >> shift;
+		pOVSHandle->Result[rank] = 0;
+		pOVSHandle->Cycles[rank] = 0;
+	}
+
+	pOVSHandle->pBurstBuffer = pBurstBuffer;
+
+	//3. Cycle counter for the per sample cost
+	ADC_OVS_CycleCounterInit();
+
+	//4. Start acquisition - one burst per trigger
+	ADC_StartBurstDMA(pADCHandle, pBurstBuffer, ( SeqLen * pOVSHandle->BurstLen ) );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_OVS_Decimate
+
+ 	 * @brief  		- API that accumulates the burst of every sequence rank and decimates it into Result[]
+
+ 	 * @param 		- *pOVSHandle : contains oversampling settings and the burst buffer
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call on ADC_EVENT_DMA_CMPLT - the buffer is re-armed for the next trigger as soon as the callback returns.
+ 	 * 				- Integer only: accumulate in 32 bits, round, then shift
+
+*/
+void ADC_OVS_Decimate(ADC_OVS_Handle_t *pOVSHandle)
+{
+	ADC_Handle_t *pADCHandle = pOVSHandle->pADCHandle;
+	uint8_t SeqLen = ADC_GetScanLen(pADCHandle);
+	uint8_t channel, ratio, shift;
+	uint16_t *pSample;
+	uint32_t Sum, Start;
+
+	for(uint8_t rank = 0; rank < SeqLen; rank++)
+	{
+		Start = *DWT_CYCCNT;
+
+		channel = ADC_GetScanChannel(pADCHandle, rank);
+		ratio = pOVSHandle->ADC_OVS_Config.ADC_OVS_Ratio[channel];
+
+		//1. Accumulate the rank's conversions - they are SeqLen apart in the burst
+		Sum = 0;
+		pSample = &( pOVSHandle->pBurstBuffer[rank] );
+
+		for(uint16_t i = ( 1 << ratio ); i > 0; i--)
+		{
+			Sum += *pSample;
+			pSample += SeqLen;
+		}
+
+		//2. Decimate - drop all accumulated bits (average) or keep half of them (enhance), rounding to nearest
+		if( pOVSHandle->ADC_OVS_Config.ADC_OVS_Mode[channel] == ADC_OVS_MODE_ENHANCE )
+		{
+			shift = ratio - ( ratio / 2 );
+		}
+		else
+		{
+			shift = ratio;
+		}
+
+		if( shift )
+		{
+			Sum = ( Sum + ( 1UL << ( shift - 1 ) ) ) >> shift;
+		}
+
+		//2.1 Rounding can carry a max code input past full scale
+		if( Sum > pOVSHandle->FullScale[rank] )
+		{
+			Sum = pOVSHandle->FullScale[rank];
+		}
+
+		pOVSHandle->Result[rank] = Sum;
+		pOVSHandle->Cycles[rank] = *DWT_CYCCNT - Start;
+	}
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- ADC_OVS_CycleCounterInit
+
+ 	 * @brief  		- Helper API that turns on the DWT cycle counter of the Cortex-M4
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Counter is free running at the core clock and is only ever read as a difference
+
+*/
+static void ADC_OVS_CycleCounterInit(void)
+{
+	*DEMCR |= ( 1 << DEMCR_TRCENA );
+	*DWT_CTRL |= ( 1 << DWT_CTRL_CYCCNTENA );
+}
+
+/*----------------------------------------------------------------------------------------------------*/
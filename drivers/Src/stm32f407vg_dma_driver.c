@@ -0,0 +1,526 @@
+/*
+ * stm32f407vg_dma_driver.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+//Include the MCU header (not the DMA header directly) so the DMA types are defined before the driver headers that embed them
+#include "stm32f407vg.h"
+
+/*********** Driver-specific helper functions prototype section ***********/
+static DMA_Stream_RegDef_t* DMA_GetStream(DMA_Handle_t *pDMAHandle);
+static uint8_t DMA_GetFlagShift(uint8_t StreamNumber);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_PeriClockControl
+
+ 	 * @brief  		- enables or disables the clock of a DMA controller
+
+ 	 * @param 		- *pDMAx : DMA controller base address in MCU memory
+ 	 * @param  		- EnOrDi : macros to enable or disable the clock (ENABLE or DISABLE macros are in MCU specific header file)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void DMA_PeriClockControl(DMA_RegDef_t *pDMAx, uint8_t EnOrDi)
+{
+	if( EnOrDi == ENABLE )
+	{
+		if( (uint32_t) pDMAx == DMA1_BASE_ADDR )
+		{
+			DMA1_PCLK_EN();
+		}
+		else if ( (uint32_t) pDMAx == DMA2_BASE_ADDR )
+		{
+			DMA2_PCLK_EN();
+		}
+		else
+			;
+	}
+	else
+	{
+		if( (uint32_t) pDMAx == DMA1_BASE_ADDR )
+		{
+			DMA1_PCLK_DI();
+		}
+		else if ( (uint32_t) pDMAx == DMA2_BASE_ADDR )
+		{
+			DMA2_PCLK_DI();
+		}
+		else
+			;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_Init
+
+ 	 * @brief  		- API that initializes one stream of a DMA controller with programmer-defined values from the DMA_Config_t structure
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Stream is left disabled - transfers are started with DMA_StartTransfer
+
+*/
+void DMA_Init(DMA_Handle_t *pDMAHandle)
+{
+	if( pDMAHandle->StreamNumber > 7 )
+	{
+		//Each DMA controller only has 8 streams - See RM 10.3.2. If invalid number, enter into an infinite loop.
+		while(1);
+	}
+
+	DMA_Stream_RegDef_t *pStream = DMA_GetStream(pDMAHandle);
+
+	// 0. Turn on peripheral clock
+	DMA_PeriClockControl(pDMAHandle->pDMAx, ENABLE);
+
+	// 1. Stream must be disabled (EN reads back 0) before any of its registers can be written
+	pStream->CR &= ~( 1 << DMA_SxCR_EN );
+
+	while( pStream->CR & ( 1 << DMA_SxCR_EN ) )
+		;
+
+	DMA_ClearFlag(pDMAHandle, DMA_FLAG_ALL);
+
+	// 2. Configure stream control register
+	uint32_t tempreg = 0;
+
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_Channel << DMA_SxCR_CHSEL_2_0 );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_Priority << DMA_SxCR_PL_1_0 );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_MemDataSize << DMA_SxCR_MSIZE_1_0 );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_PeriphDataSize << DMA_SxCR_PSIZE_1_0 );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_MemInc << DMA_SxCR_MINC );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_PeriphInc << DMA_SxCR_PINC );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_Mode << DMA_SxCR_CIRC );
+	tempreg |= ( pDMAHandle->DMA_Config.DMA_Direction << DMA_SxCR_DIR_1_0 );
+
+	pStream->CR = tempreg;
+
+	// 3. Configure FIFO - direct mode when FIFO is disabled (PSIZE = MSIZE is then required by hardware)
+	tempreg = 0;
+
+	if( pDMAHandle->DMA_Config.DMA_FIFOMode == DMA_FIFO_ENABLE )
+	{
+		tempreg |= ( 1 << DMA_SxFCR_DMDIS );
+		tempreg |= ( pDMAHandle->DMA_Config.DMA_FIFOThreshold << DMA_SxFCR_FTH_1_0 );
+	}
+
+	pStream->FCR = tempreg;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_DeInit
+
+ 	 * @brief  		- API that writes reset values into all of a DMA controller's registers
+
+ 	 * @param 		- *pDMAx : DMA controller base address in MCU memory
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- All 8 streams of the controller are reset
+
+*/
+void DMA_DeInit(DMA_RegDef_t *pDMAx)
+{
+	if( (uint32_t) pDMAx == DMA1_BASE_ADDR )
+	{
+		DMA1_REG_RESET();
+	}
+	else if ( (uint32_t) pDMAx == DMA2_BASE_ADDR )
+	{
+		DMA2_REG_RESET();
+	}
+	else
+		;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_StartTransfer
+
+ 	 * @brief  		- API that loads addresses and data count into a stream, enables its interrupts and starts it
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+ 	 * @param 		- PeriphAddr : peripheral register address (source address in memory to memory mode)
+ 	 * @param 		- MemAddr : memory buffer address (destination address in memory to memory mode)
+ 	 * @param 		- Length : number of data items (of peripheral data size) to transfer
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Half transfer interrupt is only enabled in circular mode, where it lets the application work on
+ 	 * 				- one half of the buffer while the stream fills the other
+
+*/
+void DMA_StartTransfer(DMA_Handle_t *pDMAHandle, uint32_t PeriphAddr, uint32_t MemAddr, uint16_t Length)
+{
+	DMA_Stream_RegDef_t *pStream = DMA_GetStream(pDMAHandle);
+
+	// 1. Make sure stream is disabled and no stale flags are left from the previous transfer
+	pStream->CR &= ~( 1 << DMA_SxCR_EN );
+
+	while( pStream->CR & ( 1 << DMA_SxCR_EN ) )
+		;
+
+	DMA_ClearFlag(pDMAHandle, DMA_FLAG_ALL);
+
+	// 2. Load addresses and number of data items
+	pStream->PAR = PeriphAddr;
+	pStream->M0AR = MemAddr;
+	pStream->NDTR = Length;
+
+	// 3. Enable transfer complete and error interrupts
+	pStream->CR |= ( 1 << DMA_SxCR_TCIE );
+	pStream->CR |= ( 1 << DMA_SxCR_TEIE );
+	pStream->CR |= ( 1 << DMA_SxCR_DMEIE );
+
+	if( pDMAHandle->DMA_Config.DMA_Mode == DMA_MODE_CIRCULAR )
+	{
+		pStream->CR |= ( 1 << DMA_SxCR_HTIE );
+	}
+
+	if( pDMAHandle->DMA_Config.DMA_FIFOMode == DMA_FIFO_ENABLE )
+	{
+		pStream->FCR |= ( 1 << DMA_SxFCR_FEIE );
+	}
+
+	// 4. Start stream
+	pStream->CR |= ( 1 << DMA_SxCR_EN );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_StopTransfer
+
+ 	 * @brief  		- API that disables a stream and its interrupts
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Waits for the current data item to finish (EN reads back 0)
+
+*/
+void DMA_StopTransfer(DMA_Handle_t *pDMAHandle)
+{
+	DMA_Stream_RegDef_t *pStream = DMA_GetStream(pDMAHandle);
+
+	pStream->CR &= ~( ( 1 << DMA_SxCR_TCIE ) | ( 1 << DMA_SxCR_HTIE ) | ( 1 << DMA_SxCR_TEIE ) | ( 1 << DMA_SxCR_DMEIE ) );
+	pStream->FCR &= ~( 1 << DMA_SxFCR_FEIE );
+
+	pStream->CR &= ~( 1 << DMA_SxCR_EN );
+
+	while( pStream->CR & ( 1 << DMA_SxCR_EN ) )
+		;
+
+	DMA_ClearFlag(pDMAHandle, DMA_FLAG_ALL);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_GetCurrDataCounter
+
+ 	 * @brief  		- API that returns the number of data items the stream still has to transfer
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+
+ 	 * @retval 		- NDTR value of the stream
+
+ 	 * @Note		- In circular mode this can be used to find the current write position in the buffer
+
+*/
+uint16_t DMA_GetCurrDataCounter(DMA_Handle_t *pDMAHandle)
+{
+	return (uint16_t) DMA_GetStream(pDMAHandle)->NDTR;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_GetFlagStatus
+
+ 	 * @brief  		- API that returns that value of a specific flag of a stream in the DMA interrupt status registers
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+ 	 * @param 		- FlagName : Name of the desired flag you want to check the status of
+
+ 	 * @retval 		- data that is read from flag - can only be either 1 or 0 (set or reset)
+
+ 	 * @Note		- none
+
+*/
+uint8_t DMA_GetFlagStatus(DMA_Handle_t *pDMAHandle, uint32_t FlagName)
+{
+	SIM_POLL();
+
+	uint32_t ISR;
+
+	if( pDMAHandle->StreamNumber < 4 )
+	{
+		ISR = pDMAHandle->pDMAx->LISR;
+	}
+	else
+	{
+		ISR = pDMAHandle->pDMAx->HISR;
+	}
+
+	if( ISR & ( FlagName << DMA_GetFlagShift(pDMAHandle->StreamNumber) ) ) return FLAG_SET;
+	else return FLAG_RESET;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_ClearFlag
+
+ 	 * @brief  		- Helper API that clears one or more flags of a stream
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+ 	 * @param 		- FlagName : Name of the desired flag(s) you want to clear
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- IFCR registers are write 1 to clear, so only the requested flags are affected
+
+*/
+void DMA_ClearFlag(DMA_Handle_t *pDMAHandle, uint32_t FlagName)
+{
+	if( pDMAHandle->StreamNumber < 4 )
+	{
+		pDMAHandle->pDMAx->LIFCR = ( FlagName << DMA_GetFlagShift(pDMAHandle->StreamNumber) );
+	}
+	else
+	{
+		pDMAHandle->pDMAx->HIFCR = ( FlagName << DMA_GetFlagShift(pDMAHandle->StreamNumber) );
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_IRQInterruptConfig
+
+ 	 * @brief  		- API that configures interrupts generated by a DMA stream. This function handles the configurations needed for interrupts on the processor side
+ 	 * 				- Refer to processor guide here for more details: https://www.engr.scu.edu/~dlewis/book3/docs/Cortex-M4_Devices_Generic_User_Guide.pdf
+
+ 	 * @param 		- IRQNumber : Number associated with the peripheral's exception handler in the NVIC vector table
+ 	 * @param 		- EnOrDi : macros to enable or disable the IRQ (ENABLE or DISABLE macros in MCU specific header file
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void DMA_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		if(IRQNumber <= 31)
+		{
+			//configure ISER0 register in processor //0 to 31
+			*NVIC_ISER0 |= ( 1 << IRQNumber );
+		}
+		else if(IRQNumber > 31 && IRQNumber <= 63)
+		{
+			//configure ISER1 register in processor //32 to 63
+			*NVIC_ISER1 |= ( 1 << (IRQNumber % 32) );
+		}
+		else if(IRQNumber > 63 && IRQNumber <= 95)
+		{
+			//configure ISER2 register in processor //64 to 95
+			*NVIC_ISER2 |= ( 1 << (IRQNumber % 32) );
+		}
+	}
+	else
+	{
+		if(IRQNumber <= 31)
+		{
+			//configure ICER0 register in processor //0 to 31
+			*NVIC_ICER0 = ( 1 << IRQNumber );
+		}
+		else if(IRQNumber > 31 && IRQNumber <= 63)
+		{
+			//configure ICER1 register in processor //32 to 63
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
+		}
+		else if(IRQNumber > 63 && IRQNumber <= 95)
+		{
+			//configure ICER2 register in processor //64 to 95
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+	 * @fn			- DMA_IRQPriorityConfig
+
+	 * @brief  		- API that configures the priority level of a given IRQ (DMA stream interrupt).
+
+	 * @param 		- IRQPriority : Value that contains priority level of interrupt as compared to other interrupts. Similar to DMA_IRQInterruptConfig, this is also handled on the processor side in Cortex-M4 internal peripheral registers
+	 * @param		- IRQNumber : Number associated with the peripheral's exception handler in the NVIC vector table
+
+	 * @retval 		- none
+
+	 * @Note		- none
+
+*/
+void DMA_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
+{
+	//1. Find out which IPR register the IRQ is in
+	uint8_t Offset = IRQNumber / 4;
+
+	//2. Clear and write by shifting the priority value into the correct position
+	uint8_t temp = (IRQNumber % 4) * 8;
+
+	uint8_t shiftAmount = temp + ( 8 - NO_PR_BITS_IMPLEMENTED );
+	*(NVIC_IPR_BASE_ADDR + (Offset) ) &= ~( 0xFF << shiftAmount );														//Clear the existing priority level
+	*(NVIC_IPR_BASE_ADDR + (Offset) ) |= ( IRQPriority << shiftAmount );												//Write the desired priority level
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_IRQHandling
+
+ 	 * @brief  		- API that handles interrupts generated by a DMA stream.
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Errors are reported before transfer events so the application never consumes data from a failed transfer
+
+*/
+void DMA_IRQHandling(DMA_Handle_t *pDMAHandle)
+{
+	DMA_Stream_RegDef_t *pStream = DMA_GetStream(pDMAHandle);
+
+	//Temporary variables to make sure interrupts are enabled
+	uint32_t temp1 = ( pStream->CR & ( 1 << DMA_SxCR_TEIE ) );
+	uint32_t temp2 = ( pStream->CR & ( 1 << DMA_SxCR_DMEIE ) );
+	uint32_t temp3 = ( pStream->FCR & ( 1 << DMA_SxFCR_FEIE ) );
+	uint32_t temp4 = ( pStream->CR & ( 1 << DMA_SxCR_HTIE ) );
+	uint32_t temp5 = ( pStream->CR & ( 1 << DMA_SxCR_TCIE ) );
+
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TEIF) && temp1 )
+	{
+		//1. Transfer error - hardware has already disabled the stream
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_TEIF);
+		DMA_ApplicationEventCallBack(pDMAHandle, DMA_ERROR_TE);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_DMEIF) && temp2 )
+	{
+		//2. Direct mode error
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_DMEIF);
+		DMA_ApplicationEventCallBack(pDMAHandle, DMA_ERROR_DME);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_FEIF) && temp3 )
+	{
+		//3. FIFO error
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_FEIF);
+		DMA_ApplicationEventCallBack(pDMAHandle, DMA_ERROR_FE);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_HTIF) && temp4 )
+	{
+		//4. First half of the buffer is filled
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_HTIF);
+		DMA_ApplicationEventCallBack(pDMAHandle, DMA_EVENT_HALF_CMPLT);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TCIF) && temp5 )
+	{
+		//5. Whole buffer is filled - in normal mode the stream has been disabled by hardware
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_TCIF);
+		DMA_ApplicationEventCallBack(pDMAHandle, DMA_EVENT_CMPLT);
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_ApplicationEventCallBack
+
+ 	 * @brief  		- API that takes specific course of action if an event has happened
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+ 	 * @param 		- AppEvent : argument containing the specific event or condition that has occurred
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Weak driver implementation can be overwritten by user for their own purposes
+
+*/
+__weak void DMA_ApplicationEventCallBack(DMA_Handle_t *pDMAHandle, uint8_t AppEvent)
+{
+	//This is a weak implementation. The application may overwrite this function.
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_GetStream
+
+ 	 * @brief  		- Helper API that returns the register block of the stream used by a handle
+
+ 	 * @param 		- *pDMAHandle : contains DMA controller base address, stream number and configuration values
+
+ 	 * @retval 		- address of the stream registers
+
+ 	 * @Note		- none
+
+*/
+static DMA_Stream_RegDef_t* DMA_GetStream(DMA_Handle_t *pDMAHandle)
+{
+	return &( pDMAHandle->pDMAx->STREAM[pDMAHandle->StreamNumber] );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- DMA_GetFlagShift
+
+ 	 * @brief  		- Helper API that returns the bit position of a stream's flag group in LISR/HISR (and LIFCR/HIFCR)
+
+ 	 * @param 		- StreamNumber : stream of the DMA controller (0-7)
+
+ 	 * @retval 		- shift amount to apply to the DMA_FLAG_xxx macros
+
+ 	 * @Note		- Flag groups of streams 0-3 (LISR) and 4-7 (HISR) are at bits 0, 6, 16 and 22 - see RM 10.5.1
+
+*/
+static uint8_t DMA_GetFlagShift(uint8_t StreamNumber)
+{
+	static const uint8_t FlagShift[4] = { 0, 6, 16, 22 };
+
+	return FlagShift[StreamNumber % 4];
+}
+
+/*----------------------------------------------------------------------------------------------------*/
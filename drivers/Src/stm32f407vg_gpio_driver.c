@@ -311,6 +311,8 @@ void GPIO_DeInit(GPIO_RegDef_t *pGPIOx)
 */
 uint8_t GPIO_ReadFromInputPin(GPIO_RegDef_t *pGPIOx, uint8_t pinNumber)
 {
+	SIM_POLL();
+
 	uint8_t value;
 	value = (uint8_t) ( (pGPIOx -> IDR >> pinNumber) & 0x00000001 ); //right shifting the pin we want to read so that it becomes the LSB; then we mask the rest of the register values
 
@@ -450,17 +452,17 @@ void GPIO_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
 		if(IRQNumber <= 31)
 		{
 			//configure ICER0 register in processor //0 to 31
-			*NVIC_ICER0 |= ( 1 << IRQNumber );
+			*NVIC_ICER0 = ( 1 << IRQNumber );
 		}
 		else if(IRQNumber > 31 && IRQNumber <= 63)
 		{
 			//configure ICER1 register in processor //32 to 63
-			*NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
 		}
 		else if(IRQNumber > 63 && IRQNumber <= 95)
 		{
 			//configure ICER2 register in processor //64 to 95
-			*NVIC_ICER2 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
 		}
 	}
 }
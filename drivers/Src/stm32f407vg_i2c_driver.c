@@ -6,15 +6,21 @@
  */
 
 #include "stm32f407vg.h"
+#include "stm32f407vg_profiler.h"
+
+PROF_SITE_DEFINE(I2C_EV_IRQHandling);
 
 //helper functions
-// static uint32_t RCC_GetPLLOutputClk(void); //not implemented since we don't use PLL clock
+static void I2C_SetClockTiming(I2C_Handle_t *pI2CHandle);
+static void I2C_ClockChangeHandler(void *pContext);
 static void I2C_ExecuteAddressPhaseWrite(I2C_Handle_t *pI2CHandle, uint8_t SlaveAddr);
 static void I2C_ExecuteAddressPhaseRead(I2C_Handle_t *pI2CHandle, uint8_t SlaveAddr);
 static void I2C_ClearAddrFlag(I2C_Handle_t *pI2CHandle);
 static void I2C_ClearStopfFlag(I2C_Handle_t *pI2CHandle);
 static void I2C_MasterHandleRxNEInterrupt(I2C_Handle_t *pI2CHandle);
 static void I2C_MasterHandleTxEInterrupt(I2C_Handle_t *pI2CHandle);
+static void I2C_DMAStreamInit(DMA_Handle_t *pDMAHandle, uint8_t Direction);
+static void I2C_CloseDMA(I2C_Handle_t *pI2CHandle, DMA_Handle_t *pDMAHandle);
 
 void I2C_CloseSendData(I2C_Handle_t *pI2CHandle);
 void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle);
@@ -108,12 +114,6 @@ void I2C_Init(I2C_Handle_t *pI2CHandle)
 	pI2CHandle->pI2Cx->CR1 |= tempreg;
 
 
-	//Configure the FREQ field used in - used by hardware to set correctly execute data setup and hold times to be compliant with I2C communication specifications
-	tempreg = 0;
-	tempreg |= (( RCC_GetPCLK1Val() / 1000000U ) << I2C_CR2_FREQ ); //FREQ[5:0] config bits in I2C_CR2 are in multiples of 1MHz
-	pI2CHandle->pI2Cx->CR2 |= tempreg;
-
-
 	// Configure the device address (applicable only when device is slave)
 	tempreg = 0;
 	tempreg |= ( pI2CHandle->I2C_Config.I2C_DeviceAddress << I2C_OAR1_ADD7_1 );
@@ -125,60 +125,10 @@ void I2C_Init(I2C_Handle_t *pI2CHandle)
 	// Configure the mode (standard or fast)
 
 
-	// Configure the SCL speed and duty cycle
-
-		//CCR calculations
-	uint32_t desired_SCL = 0;
-	uint16_t ccr_val;
-	uint8_t duty_val;
-
-	desired_SCL = pI2CHandle->I2C_Config.I2C_SCLSpeed;
-	duty_val = pI2CHandle->I2C_Config.I2C_FMDutyCycle;
-
-	if(desired_SCL <= I2C_SCL_SPEED_SM) //standard mode (I2C SCL < 100kHz)
-	{
-		pI2CHandle->pI2Cx->CCR &= ~( 1 << I2C_CCR_FAST_SLOW );	//configure mode bit field in CCR
-		ccr_val = ( RCC_GetPCLK1Val() / ( 2 * desired_SCL ) );
-	}
-	else 								//fast mode ( 100kHz < I2C SCL < 400kHz)
-	{
-		pI2CHandle->pI2Cx->CCR |= ( 1 << I2C_CCR_FAST_SLOW );	//configure mode bit field in CCR
-
-		if( duty_val == 0 ) 	//Fm mode t_low/t_high = 2
-		{
-			ccr_val = ( RCC_GetPCLK1Val() / ( 3 * desired_SCL ) );
-		}
-		else 					//Fm mode t_low/t_high = 16/9
-		{
-			ccr_val = ( RCC_GetPCLK1Val() / ( 25 * desired_SCL ) );
-		}
-	}
-
-	ccr_val = ( ccr_val & 0xFFF ); //only last 12 btis are valid
-	tempreg = 0;
-	tempreg = ( duty_val << I2C_CCR_DUTY ) | ( ccr_val << I2C_CCR_CCR ); //mode already configured above, just need duty value and CCR value configured
-	pI2CHandle->pI2Cx->CCR |= tempreg;
-
-
-
-	//Configure the rise time of I2C pins
-	tempreg = 0;
-	double t_rise;
-	double Tpclk1 = (double) ( 1.0 / RCC_GetPCLK1Val());
-
-	desired_SCL = pI2CHandle->I2C_Config.I2C_SCLSpeed;
-	if(desired_SCL <= I2C_SCL_SPEED_SM) //standard mode (I2C SCL < 100kHz)
-	{
-		t_rise = ( 1000.0 / 1000000000.0 );
-	}
-	else 								//fast mode ( 100kHz < I2C SCL < 400kHz
-	{
-		t_rise = ( 300.0 / 1000000000.0 );
-	}
-
-	tempreg = ( t_rise / Tpclk1 ) + 1;
-	pI2CHandle->pI2Cx->TRISE |= (tempreg & 0x3F );
+	// Configure the SCL speed, duty cycle and rise time - re-calculated whenever the APB1 clock changes
+	I2C_SetClockTiming(pI2CHandle);
 
+	RCC_RegisterClockCallback(I2C_ClockChangeHandler, pI2CHandle);
 }
 
 
@@ -534,6 +484,123 @@ uint8_t I2C_MasterReceiveDataIT(I2C_Handle_t *pI2CHandle, uint8_t *pRxBuffer, ui
 }
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_MasterSendDataDMA
+
+ 	 * @brief  		- API that configures a device as an I2C master and sends data to a slave, with DMA moving the data bytes
+
+ 	 * @param 		- *pI2CHandle : contains I2C peripheral base address in MCU memory and the Tx DMA stream (pDMATxHandle)
+ 	 * @param 		- *pTxBuffer : pointer to Tx buffer of user data - must stay valid until I2C_EV_TX_COMPLETE
+ 	 * @param 		- Len : Length of user data in bytes (1 to 65535)
+ 	 * @param 		- SlaveAddr : Address of slave device that the master wants to send data to
+ 	 * @param 		- Sr : Sr = repeated start. If set, the API will generate a repeated start instead of releasing the bus and ending communication
+
+ 	 * @retval 		- state : Indicates to the rest of the program that the I2C is busy in Tx and no further data should try to be transmitted
+
+ 	 * @Note		- This function call is non-blocking. Interrupts per frame do not depend on Len: SB, ADDR, DMA transfer
+ 	 * 				- complete and BTF. The Tx stream's IRQ handler must call I2C_DMA_TxIRQHandling
+*/
+uint8_t I2C_MasterSendDataDMA(I2C_Handle_t *pI2CHandle, uint8_t *pTxBuffer, uint32_t Len, uint8_t SlaveAddr, uint8_t Sr)
+{
+	uint8_t state = pI2CHandle->RxTxState;
+
+	if( ( pI2CHandle->pDMATxHandle == NULL ) || ( Len == 0 ) || ( Len > 0xFFFF ) )
+	{
+		//No DMA stream or a length NDTR cannot hold. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//1. Check to make sure the interface isn't already busy in Tx-ing or Rx-ing something else.
+	if( ( state != I2C_BUSY_IN_TX ) && ( state != I2C_BUSY_IN_RX ) )
+	{
+		//2. Update the global handle structure. TxLen is only cleared by the DMA transfer complete interrupt, so BTF can't close the frame early
+		pI2CHandle->RxTxState = I2C_BUSY_IN_TX;
+		pI2CHandle->Slave_Address = SlaveAddr;
+		pI2CHandle->Sr = Sr;
+		pI2CHandle->TxLen = Len;
+		pI2CHandle->pTxBuffer = pTxBuffer;
+
+		//3. Arm the stream (memory to DR) before DMA requests are enabled - first request comes once the address is acknowledged
+		I2C_DMAStreamInit(pI2CHandle->pDMATxHandle, DMA_DIR_MEM_TO_PERIPH);
+		DMA_StartTransfer(pI2CHandle->pDMATxHandle, (uint32_t) &( pI2CHandle->pI2Cx->DR ), (uint32_t) pTxBuffer, (uint16_t) Len);
+
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_DMAEN );
+
+		//4. Generate a start condition - SB and ADDR are still handled by the event interrupt
+		I2C_GenerateCondition(pI2CHandle, START);
+
+		//5. Event and error interrupts only - TxE is served by DMA, so ITBUFEN stays off
+		pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITBUFEN );
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITEVTEN );
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITERREN );
+	}
+
+	return state;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_MasterReceiveDataDMA
+
+ 	 * @brief  		- API that configures a device as an I2C master and receives data from a slave, with DMA moving the data bytes
+
+ 	 * @param 		- *pI2CHandle : contains I2C peripheral base address in MCU memory and the Rx DMA stream (pDMARxHandle)
+ 	 * @param 		- *pRxBuffer : pointer to Rx buffer of user data
+ 	 * @param 		- Len : Length of user receive data the master expects in bytes (1 to 65535)
+ 	 * @param 		- SlaveAddr : Address of slave device that the master wants to receive data from
+ 	 * @param 		- Sr : Sr = repeated start. If set, the API will generate a repeated start instead of releasing the bus and ending communication
+
+ 	 * @retval 		- state : Indicates to the rest of the program that the I2C is busy in Rx and no further data should try to be received
+
+ 	 * @Note		- This function call is non-blocking. LAST is set so the hardware NACKs the byte of the DMA's last transfer
+ 	 * 				- (a single byte is NACKed in the ADDR event instead). STOP is generated in I2C_DMA_RxIRQHandling
+*/
+uint8_t I2C_MasterReceiveDataDMA(I2C_Handle_t *pI2CHandle, uint8_t *pRxBuffer, uint32_t Len, uint8_t SlaveAddr, uint8_t Sr)
+{
+	uint8_t state = pI2CHandle->RxTxState;
+
+	if( ( pI2CHandle->pDMARxHandle == NULL ) || ( Len == 0 ) || ( Len > 0xFFFF ) )
+	{
+		//No DMA stream or a length NDTR cannot hold. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//1. Check to make sure the interface isn't already busy in Tx-ing or Rx-ing something else.
+	if( ( state != I2C_BUSY_IN_TX ) && ( state != I2C_BUSY_IN_RX ) )
+	{
+		//2. Update the global handle structure - RxSize is used by the ADDR event to NACK a single byte
+		pI2CHandle->RxTxState = I2C_BUSY_IN_RX;
+		pI2CHandle->Slave_Address = SlaveAddr;
+		pI2CHandle->Sr = Sr;
+		pI2CHandle->RxLen = Len;
+		pI2CHandle->RxSize = Len;
+		pI2CHandle->pRxBuffer = pRxBuffer;
+
+		//3. ACK every byte but the last one - hardware NACKs the byte of the DMA's last transfer when LAST is set (RM 27.3.7)
+		pI2CHandle->pI2Cx->CR1 |= ( 1 << I2C_CR1_ACK );
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_LAST );
+
+		//4. Arm the stream (DR to memory) and enable DMA requests
+		I2C_DMAStreamInit(pI2CHandle->pDMARxHandle, DMA_DIR_PERIPH_TO_MEM);
+		DMA_StartTransfer(pI2CHandle->pDMARxHandle, (uint32_t) &( pI2CHandle->pI2Cx->DR ), (uint32_t) pRxBuffer, (uint16_t) Len);
+
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_DMAEN );
+
+		//5. Generate a start condition - SB and ADDR are still handled by the event interrupt
+		I2C_GenerateCondition(pI2CHandle, START);
+
+		//6. Event and error interrupts only - RxNE is served by DMA, so ITBUFEN stays off
+		pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITBUFEN );
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITEVTEN );
+		pI2CHandle->pI2Cx->CR2 |= ( 1 << I2C_CR2_ITERREN );
+	}
+
+	return state;
+}
+
+
 /*********************** Function Documentation ***************************************
  *
  	 * @fn			- I2C_IRQInterruptConfig
@@ -574,17 +641,17 @@ void I2C_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
 		if(IRQNumber <= 31)
 		{
 			//configure ICER0 register in processor //0 to 31
-			*NVIC_ICER0 |= ( 1 << IRQNumber );
+			*NVIC_ICER0 = ( 1 << IRQNumber );
 		}
 		else if(IRQNumber > 31 && IRQNumber <= 63)
 		{
 			//configure ICER1 register in processor //32 to 63
-			*NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
 		}
 		else if(IRQNumber > 63 && IRQNumber <= 95)
 		{
 			//configure ICER2 register in processor //64 to 95
-			*NVIC_ICER2 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
 		}
 	}
 }
@@ -639,6 +706,8 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 {
 	//Interrupt handling for both master and slave mode of a device
 
+	PROF_ENTER(I2C_EV_IRQHandling);
+
 	uint32_t temp1 = pI2CHandle->pI2Cx->CR2 & ( 1 << I2C_CR2_ITEVTEN );
 	uint32_t temp2 = pI2CHandle->pI2Cx->CR2 & ( 1 << I2C_CR2_ITBUFEN );
 
@@ -714,6 +783,12 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 
 		if( pI2CHandle->RxTxState == I2C_BUSY_IN_TX )
 		{
+			//DMA transfer : every byte has been handed over once NDTR is 0, even if the stream's transfer complete interrupt is still pending
+			if( ( pI2CHandle->pI2Cx->CR2 & ( 1 << I2C_CR2_DMAEN ) ) && ( DMA_GetCurrDataCounter(pI2CHandle->pDMATxHandle) == 0 ) )
+			{
+				pI2CHandle->TxLen = 0;
+			}
+
 			uint8_t TxE_set = I2C_GetFlagStatus(pI2CHandle->pI2Cx, I2C_FLAG_TXE );
 			uint8_t BTF_set = I2C_GetFlagStatus(pI2CHandle->pI2Cx, I2C_FLAG_BTF );
 
@@ -777,6 +852,7 @@ void I2C_EV_IRQHandling(I2C_Handle_t *pI2CHandle)
 
 	}
 
+	PROF_EXIT(I2C_EV_IRQHandling);
 }
 
 
@@ -866,6 +942,90 @@ void I2C_ER_IRQHandling(I2C_Handle_t *pI2CHandle)
 }
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_DMA_TxIRQHandling
+
+ 	 * @brief  		- API that handles the interrupt of the DMA stream used by I2C_MasterSendDataDMA
+
+ 	 * @param 		- *pI2CHandle : contains I2C peripheral base address in MCU memory and the Tx DMA stream
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call from the Tx stream's IRQ handler. Transfer complete only means the last byte is in DR - the frame
+ 	 * 				- is closed (STOP, I2C_EV_TX_COMPLETE) by the BTF event once it has left the shift register
+*/
+void I2C_DMA_TxIRQHandling(I2C_Handle_t *pI2CHandle)
+{
+	DMA_Handle_t *pDMAHandle = pI2CHandle->pDMATxHandle;
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TEIF) || DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_DMEIF) )
+	{
+		//1. Transfer or direct mode error - stream is disabled by hardware, release the bus
+		DMA_ClearFlag(pDMAHandle, ( DMA_FLAG_TEIF | DMA_FLAG_DMEIF ) );
+
+		I2C_GenerateCondition(pI2CHandle, STOP);
+		I2C_CloseSendData(pI2CHandle);
+
+		I2C_ApplicationEventCallBack(pI2CHandle, I2C_ERROR_DMA);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TCIF) )
+	{
+		//2. Every byte has been handed to the peripheral - stop DMA requests and let the BTF event close the frame
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_TCIF);
+
+		pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_DMAEN );
+		pI2CHandle->TxLen = 0;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_DMA_RxIRQHandling
+
+ 	 * @brief  		- API that handles the interrupt of the DMA stream used by I2C_MasterReceiveDataDMA
+
+ 	 * @param 		- *pI2CHandle : contains I2C peripheral base address in MCU memory and the Rx DMA stream
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call from the Rx stream's IRQ handler. Generates the STOP (unless Sr is set) and raises I2C_EV_RX_COMPLETE
+*/
+void I2C_DMA_RxIRQHandling(I2C_Handle_t *pI2CHandle)
+{
+	DMA_Handle_t *pDMAHandle = pI2CHandle->pDMARxHandle;
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TEIF) || DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_DMEIF) )
+	{
+		//1. Transfer or direct mode error - stream is disabled by hardware, release the bus
+		DMA_ClearFlag(pDMAHandle, ( DMA_FLAG_TEIF | DMA_FLAG_DMEIF ) );
+
+		I2C_GenerateCondition(pI2CHandle, STOP);
+		I2C_CloseReceiveData(pI2CHandle);
+
+		I2C_ApplicationEventCallBack(pI2CHandle, I2C_ERROR_DMA);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TCIF) )
+	{
+		//2. Last byte is in the buffer and has been NACKed - end the transfer
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_TCIF);
+
+		if( pI2CHandle->Sr == I2C_DISABLE_SR )
+		{
+			I2C_GenerateCondition(pI2CHandle, STOP);
+		}
+
+		pI2CHandle->RxLen = 0;
+		I2C_CloseReceiveData(pI2CHandle);
+
+		I2C_ApplicationEventCallBack(pI2CHandle, I2C_EV_RX_COMPLETE);
+	}
+}
+
+
 
 
 /*********************** Function Documentation ***************************************
@@ -912,6 +1072,8 @@ void I2C_PeripheralControl(I2C_RegDef_t *pI2Cx, uint8_t EnOrDi)
 */
 uint8_t I2C_GetFlagStatus(I2C_RegDef_t *pI2Cx, uint32_t FlagName)
 {
+	SIM_POLL();
+
 	if(	pI2Cx->SR1 & FlagName ) return FLAG_SET;
 	else return FLAG_RESET;
 }
@@ -945,6 +1107,63 @@ void I2C_GenerateCondition(I2C_Handle_t *pI2CHandle, uint8_t StartOrStop)
 }
 
 
+static void I2C_SetClockTiming(I2C_Handle_t *pI2CHandle)
+{
+	//Everything that depends on PCLK1 - FREQ, CCR and TRISE (fields are rewritten, not OR-ed, so this can run again after a clock change)
+	uint32_t pclk1 = RCC_GetPCLK1Val();
+	uint32_t pclk1_mhz = pclk1 / 1000000U;
+	uint32_t desired_SCL = pI2CHandle->I2C_Config.I2C_SCLSpeed;
+	uint8_t duty_val = pI2CHandle->I2C_Config.I2C_FMDutyCycle;
+	uint16_t ccr_val;
+	uint32_t t_rise_ns;
+	uint32_t tempreg;
+
+	//1. FREQ field - used by hardware to set correctly execute data setup and hold times (in multiples of 1MHz)
+	tempreg = pI2CHandle->pI2Cx->CR2 & ~( 0x3F << I2C_CR2_FREQ );
+	pI2CHandle->pI2Cx->CR2 = tempreg | ( ( pclk1_mhz & 0x3F ) << I2C_CR2_FREQ );
+
+	//2. CCR calculations
+	if(desired_SCL <= I2C_SCL_SPEED_SM) //standard mode (I2C SCL < 100kHz)
+	{
+		tempreg = 0;
+		ccr_val = ( pclk1 / ( 2 * desired_SCL ) );
+		t_rise_ns = 1000;
+	}
+	else 								//fast mode ( 100kHz < I2C SCL < 400kHz)
+	{
+		tempreg = ( 1 << I2C_CCR_FAST_SLOW ) | ( duty_val << I2C_CCR_DUTY );
+
+		if( duty_val == 0 ) 	//Fm mode t_low/t_high = 2
+		{
+			ccr_val = ( pclk1 / ( 3 * desired_SCL ) );
+		}
+		else 					//Fm mode t_low/t_high = 16/9
+		{
+			ccr_val = ( pclk1 / ( 25 * desired_SCL ) );
+		}
+
+		t_rise_ns = 300;
+	}
+
+	pI2CHandle->pI2Cx->CCR = tempreg | ( ( ccr_val & 0xFFF ) << I2C_CCR_CCR ); //only last 12 btis are valid
+
+	//3. TRISE = ( max. rise time / Tpclk1 ) + 1 = ( max. rise time in ns * PCLK1 in MHz / 1000 ) + 1 - integer math, exact for whole MHz clocks
+	pI2CHandle->pI2Cx->TRISE = ( ( ( t_rise_ns * pclk1_mhz ) / 1000 ) + 1 ) & 0x3F;
+}
+
+
+static void I2C_ClockChangeHandler(void *pContext)
+{
+	//Registered by I2C_Init. CCR and TRISE can only be written with the peripheral disabled - the bus should be idle
+	I2C_Handle_t *pI2CHandle = (I2C_Handle_t *) pContext;
+	uint32_t pe = pI2CHandle->pI2Cx->CR1 & ( 1 << I2C_CR1_PE );
+
+	pI2CHandle->pI2Cx->CR1 &= ~( 1 << I2C_CR1_PE );
+	I2C_SetClockTiming(pI2CHandle);
+	pI2CHandle->pI2Cx->CR1 |= pe;
+}
+
+
 static void I2C_ExecuteAddressPhaseWrite(I2C_Handle_t *pI2CHandle, uint8_t SlaveAddr)
 {
 	uint8_t AddressPhasePacket_Write = ( ( SlaveAddr << 1 ) & ~( 0x1 << 0 ) );
@@ -1058,6 +1277,35 @@ static void I2C_MasterHandleTxEInterrupt(I2C_Handle_t *pI2CHandle)
 	}
 }
 
+
+static void I2C_DMAStreamInit(DMA_Handle_t *pDMAHandle, uint8_t Direction)
+{
+	//One byte per DMA request, buffer side incrementing, DR fixed. Direct mode - I2C requests are single bytes
+	pDMAHandle->DMA_Config.DMA_Direction = Direction;
+	pDMAHandle->DMA_Config.DMA_Mode = DMA_MODE_NORMAL;
+	pDMAHandle->DMA_Config.DMA_PeriphDataSize = DMA_DATA_SIZE_BYTE;
+	pDMAHandle->DMA_Config.DMA_MemDataSize = DMA_DATA_SIZE_BYTE;
+	pDMAHandle->DMA_Config.DMA_PeriphInc = DMA_INC_DISABLE;
+	pDMAHandle->DMA_Config.DMA_MemInc = DMA_INC_ENABLE;
+	pDMAHandle->DMA_Config.DMA_FIFOMode = DMA_FIFO_DISABLE;
+
+	DMA_Init(pDMAHandle);
+}
+
+
+static void I2C_CloseDMA(I2C_Handle_t *pI2CHandle, DMA_Handle_t *pDMAHandle)
+{
+	if( pI2CHandle->pI2Cx->CR2 & ( ( 1 << I2C_CR2_DMAEN ) | ( 1 << I2C_CR2_LAST ) ) )
+	{
+		pI2CHandle->pI2Cx->CR2 &= ~( ( 1 << I2C_CR2_DMAEN ) | ( 1 << I2C_CR2_LAST ) );
+
+		if( pDMAHandle != NULL )
+		{
+			DMA_StopTransfer(pDMAHandle);
+		}
+	}
+}
+
 void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle)
 {
 	//Disable interrupts
@@ -1065,6 +1313,9 @@ void I2C_CloseReceiveData(I2C_Handle_t *pI2CHandle)
 
 	pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITBUFEN );
 
+	//Stop the DMA stream if the transfer was started with I2C_MasterReceiveDataDMA
+	I2C_CloseDMA(pI2CHandle, pI2CHandle->pDMARxHandle);
+
 	//Reset handle structure in preparation for future data
 	pI2CHandle->RxLen = 0;
 	pI2CHandle->RxSize = 0;
@@ -1087,6 +1338,9 @@ void I2C_CloseSendData(I2C_Handle_t *pI2CHandle)
 
 	pI2CHandle->pI2Cx->CR2 &= ~( 1 << I2C_CR2_ITBUFEN );
 
+	//Stop the DMA stream if the transfer was started with I2C_MasterSendDataDMA (i.e., closed early on an error)
+	I2C_CloseDMA(pI2CHandle, pI2CHandle->pDMATxHandle);
+
 	//Reset handle structure in preparation for future data
 	pI2CHandle->TxLen = 0;
 	pI2CHandle->pTxBuffer = NULL;
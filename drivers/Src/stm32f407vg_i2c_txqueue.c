@@ -0,0 +1,283 @@
+/*
+ * stm32f407vg_i2c_txqueue.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_i2c_txqueue.h"
+
+/*********** Driver-specific helper functions prototype section ***********/
+static void I2C_TXQ_StartNext(I2C_TXQ_Handle_t *pTXQHandle);
+static void I2C_TXQ_Pop(I2C_TXQ_Handle_t *pTXQHandle);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_TXQ_Init
+
+ 	 * @brief  		- API that empties the queue and gets the I2C peripheral ready for interrupt driven master transmissions
+
+ 	 * @param 		- *pTXQHandle : queue handle
+ 	 * @param 		- *pI2CHandle : I2C peripheral handle, already initialized with I2C_Init
+ 	 * @param 		- Policy : @I2C_TXQ_Policy - what enqueue does when the queue is full
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The peripheral stays enabled - frames start back to back from the event interrupt.
+ 	 * 				- The I2Cx EV and ER IRQs must be enabled, with their handlers calling I2C_EV_IRQHandling / I2C_ER_IRQHandling
+
+*/
+void I2C_TXQ_Init(I2C_TXQ_Handle_t *pTXQHandle, I2C_Handle_t *pI2CHandle, uint8_t Policy)
+{
+	if( Policy > I2C_TXQ_POLICY_DROP_NEWEST )
+	{
+		//Invalid policy. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	memset(pTXQHandle, 0, sizeof(*pTXQHandle));
+
+	pTXQHandle->pI2CHandle = pI2CHandle;
+	pTXQHandle->Policy = Policy;
+
+	I2C_PeripheralControl(pI2CHandle->pI2Cx, ENABLE);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_TXQ_Enqueue
+
+ 	 * @brief  		- API that copies a frame into the queue and starts it on the bus if the bus is idle
+
+ 	 * @param 		- *pTXQHandle : queue handle
+ 	 * @param 		- SlaveAddr : 7 bit address of the slave
+ 	 * @param 		- *pData : bytes to send after the address
+ 	 * @param 		- Len : number of bytes (1 to I2C_TXQ_MAX_FRAME_LEN)
+
+ 	 * @retval 		- @I2C_TXQ_Status
+
+ 	 * @Note		- Never waits on the bus, so it can be called from an ISR of any priority. The queue is updated with
+ 	 * 				- interrupts masked for a few instructions (copy of at most I2C_TXQ_MAX_FRAME_LEN bytes)
+
+*/
+uint8_t I2C_TXQ_Enqueue(I2C_TXQ_Handle_t *pTXQHandle, uint8_t SlaveAddr, uint8_t *pData, uint8_t Len)
+{
+	uint8_t Status = I2C_TXQ_QUEUED;
+	uint8_t Slot;
+	uint32_t primask;
+
+	if( ( Len == 0 ) || ( Len > I2C_TXQ_MAX_FRAME_LEN ) )
+	{
+		return I2C_TXQ_INVALID_LEN;
+	}
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	//1. Pick the slot - full queue is resolved by the policy. Frames[Tail] is never reused while it is on the bus
+	if( pTXQHandle->Count < I2C_TXQ_DEPTH )
+	{
+		Slot = pTXQHandle->Head;
+		pTXQHandle->Head = ( pTXQHandle->Head + 1 ) % I2C_TXQ_DEPTH;
+		pTXQHandle->Count++;
+	}
+	else if( pTXQHandle->Policy == I2C_TXQ_POLICY_COALESCE )
+	{
+		//Overwrite the newest waiting frame in place
+		Slot = ( pTXQHandle->Head + I2C_TXQ_DEPTH - 1 ) % I2C_TXQ_DEPTH;
+		pTXQHandle->Coalesced++;
+		Status = I2C_TXQ_COALESCED;
+	}
+	else if( pTXQHandle->Policy == I2C_TXQ_POLICY_DROP_OLDEST )
+	{
+		//Oldest waiting frame is the one after the frame on the bus (or the tail itself when the bus is idle)
+		uint8_t Oldest = pTXQHandle->InFlight ? ( ( pTXQHandle->Tail + 1 ) % I2C_TXQ_DEPTH ) : pTXQHandle->Tail;
+
+		//Shift the waiting frames after it down by one and append at the end - keeps the queue in send order
+		for(uint8_t i = Oldest; ( ( i + 1 ) % I2C_TXQ_DEPTH ) != pTXQHandle->Head; i = ( i + 1 ) % I2C_TXQ_DEPTH )
+		{
+			pTXQHandle->Frames[i] = pTXQHandle->Frames[( i + 1 ) % I2C_TXQ_DEPTH];
+		}
+
+		Slot = ( pTXQHandle->Head + I2C_TXQ_DEPTH - 1 ) % I2C_TXQ_DEPTH;
+		pTXQHandle->Dropped++;
+		Status = I2C_TXQ_DROPPED_OLDEST;
+	}
+	else
+	{
+		pTXQHandle->Dropped++;
+		CRITICAL_SECTION_EXIT(primask);
+
+		return I2C_TXQ_DROPPED_NEWEST;
+	}
+
+	//2. Copy the frame - the caller's buffer can be reused right away
+	memcpy(pTXQHandle->Frames[Slot].Data, pData, Len);
+	pTXQHandle->Frames[Slot].Len = Len;
+	pTXQHandle->Frames[Slot].SlaveAddr = SlaveAddr;
+
+	//3. Kick the bus if nothing is being sent - otherwise the transfer complete event starts it
+	if( !pTXQHandle->InFlight )
+	{
+		I2C_TXQ_StartNext(pTXQHandle);
+	}
+
+	CRITICAL_SECTION_EXIT(primask);
+
+	return Status;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_TXQ_EventHandling
+
+ 	 * @brief  		- API that retires the frame on the bus and starts the next one
+
+ 	 * @param 		- *pTXQHandle : queue handle
+ 	 * @param 		- AppEvent : event passed to I2C_ApplicationEventCallBack
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call from I2C_ApplicationEventCallBack for the queue's peripheral. A frame hitting a bus error
+ 	 * 				- (NACK, arbitration lost, bus error, ...) is abandoned and counted in Errors - it is not retried
+
+*/
+void I2C_TXQ_EventHandling(I2C_TXQ_Handle_t *pTXQHandle, uint8_t AppEvent)
+{
+	I2C_Handle_t *pI2CHandle = pTXQHandle->pI2CHandle;
+	uint32_t primask;
+
+	if( !pTXQHandle->InFlight )
+	{
+		//Event does not belong to a queued transmission (i.e., slave mode events)
+		return;
+	}
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	if( AppEvent == I2C_EV_TX_COMPLETE )
+	{
+		//Driver already generated the STOP condition and closed the transfer
+		pTXQHandle->Sent++;
+		I2C_TXQ_Pop(pTXQHandle);
+		I2C_TXQ_StartNext(pTXQHandle);
+	}
+	else if( AppEvent == I2C_ERROR_DMA )
+	{
+		//Driver already released the bus and closed the transfer
+		pTXQHandle->Errors++;
+		I2C_TXQ_Pop(pTXQHandle);
+		I2C_TXQ_StartNext(pTXQHandle);
+	}
+	else if( ( AppEvent == I2C_ERROR_AF ) || ( AppEvent == I2C_ERROR_BERR ) || ( AppEvent == I2C_ERROR_ARLO ) ||
+			 ( AppEvent == I2C_ERROR_OVR ) || ( AppEvent == I2C_ERROR_TIMEOUT ) )
+	{
+		//Release the bus if still master (not after arbitration lost - hardware already switched to slave mode)
+		if( pI2CHandle->pI2Cx->SR2 & ( 1 << I2C_SR2_MSL ) )
+		{
+			I2C_GenerateCondition(pI2CHandle, STOP);
+		}
+
+		I2C_CloseSendData(pI2CHandle);
+
+		pTXQHandle->Errors++;
+		I2C_TXQ_Pop(pTXQHandle);
+		I2C_TXQ_StartNext(pTXQHandle);
+	}
+
+	CRITICAL_SECTION_EXIT(primask);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_TXQ_GetCount
+
+ 	 * @brief  		- API that returns the number of frames not yet sent (including the one on the bus)
+
+ 	 * @param 		- *pTXQHandle : queue handle
+
+ 	 * @retval 		- frames in the queue
+
+ 	 * @Note		- none
+
+*/
+uint8_t I2C_TXQ_GetCount(I2C_TXQ_Handle_t *pTXQHandle)
+{
+	return pTXQHandle->Count;
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_TXQ_StartNext
+
+ 	 * @brief  		- Helper API that starts the oldest frame on the bus, if there is one
+
+ 	 * @param 		- *pTXQHandle : queue handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called with interrupts masked. Frame data stays in the queue until the transfer is over, so the
+ 	 * 				- DMA stream (or the driver's TxE interrupt) reads it straight from Frames[Tail]
+
+*/
+static void I2C_TXQ_StartNext(I2C_TXQ_Handle_t *pTXQHandle)
+{
+	I2C_TXQ_Frame_t *pFrame = &pTXQHandle->Frames[pTXQHandle->Tail];
+
+	uint8_t state;
+
+	if( pTXQHandle->Count == 0 )
+	{
+		return;
+	}
+
+	//DMA moves the data bytes if the I2C handle has a Tx stream, otherwise one TxE interrupt per byte
+	if( pTXQHandle->pI2CHandle->pDMATxHandle != NULL )
+	{
+		state = I2C_MasterSendDataDMA(pTXQHandle->pI2CHandle, pFrame->Data, pFrame->Len, pFrame->SlaveAddr, I2C_DISABLE_SR);
+	}
+	else
+	{
+		state = I2C_MasterSendDataIT(pTXQHandle->pI2CHandle, pFrame->Data, pFrame->Len, pFrame->SlaveAddr, I2C_DISABLE_SR);
+	}
+
+	if( state == I2C_READY )
+	{
+		pTXQHandle->InFlight = 1;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- I2C_TXQ_Pop
+
+ 	 * @brief  		- Helper API that removes the frame at the tail of the queue
+
+ 	 * @param 		- *pTXQHandle : queue handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called with interrupts masked
+
+*/
+static void I2C_TXQ_Pop(I2C_TXQ_Handle_t *pTXQHandle)
+{
+	pTXQHandle->Tail = ( pTXQHandle->Tail + 1 ) % I2C_TXQ_DEPTH;
+	pTXQHandle->Count--;
+	pTXQHandle->InFlight = 0;
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,279 @@
+/*
+ * stm32f407vg_profiler.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include <stdarg.h>
+#include "stm32f407vg_profiler.h"
+
+#define PROF_CALIBRATION_RUNS					8
+#define PROF_LINE_LEN							96
+
+static PROF_Site_t *pSiteList = NULL;							//Sites that have run at least once, newest first
+static uint32_t Overhead = 0;									//Cost of an empty ENTER/EXIT pair, taken off every run
+
+/*********** Driver-specific helper functions prototype section ***********/
+static uint8_t PROF_GetBin(uint32_t Elapsed);
+static void PROF_Print(USART_Handle_t *pUSARTHandle, const char *pFormat, ...);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PROF_Init
+
+ 	 * @brief  		- API that turns on the DWT cycle counter and measures the cost of the time base itself
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call once before the first PROF_ENTER. Statistics of sites that already ran are cleared
+
+*/
+void PROF_Init(void)
+{
+	uint32_t Start, Elapsed;
+
+#ifndef STM32F407VG_HOST_SIM
+	//1. Cycle counter - free running at the core clock, only ever read as a difference
+	*DEMCR |= ( 1 << DEMCR_TRCENA );
+	*DWT_CTRL |= ( 1 << DWT_CTRL_CYCCNTENA );
+#endif
+
+	//2. Shortest back to back read of the time base - what an empty site would report
+	Overhead = 0xFFFFFFFF;
+
+	for(uint8_t i = 0; i < PROF_CALIBRATION_RUNS; i++)
+	{
+		Start = PROF_Now();
+		Elapsed = PROF_Now() - Start;
+
+		if( Elapsed < Overhead )
+		{
+			Overhead = Elapsed;
+		}
+	}
+
+	PROF_Reset();
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PROF_Record
+
+ 	 * @brief  		- API that adds one run to the statistics of a site (called by PROF_EXIT)
+
+ 	 * @param 		- *pSite : site the run belongs to
+ 	 * @param 		- Elapsed : run time in PROF_UNITS, time base overhead included
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Only the context that owns the site updates it - only linking a new site into the report list
+ 	 * 				- needs interrupts off
+
+*/
+void PROF_Record(PROF_Site_t *pSite, uint32_t Elapsed)
+{
+	uint32_t primask;
+
+	//1. Time base overhead is not part of the site
+	Elapsed = ( Elapsed > Overhead ) ? ( Elapsed - Overhead ) : 0;
+
+	//2. Statistics
+	pSite->Count++;
+	pSite->Total += Elapsed;
+
+	if( Elapsed < pSite->Min )
+	{
+		pSite->Min = Elapsed;
+	}
+
+	if( Elapsed > pSite->Max )
+	{
+		pSite->Max = Elapsed;
+	}
+
+	pSite->Hist[PROF_GetBin(Elapsed)]++;
+
+	//3. First run of the site - add it to the report
+	if( !pSite->Registered )
+	{
+		CRITICAL_SECTION_ENTER(primask);
+
+		pSite->pNext = pSiteList;
+		pSiteList = pSite;
+		pSite->Registered = 1;
+
+		CRITICAL_SECTION_EXIT(primask);
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PROF_Reset
+
+ 	 * @brief  		- API that clears the statistics of every site (sites stay in the report)
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void PROF_Reset(void)
+{
+	uint32_t primask;
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	for(PROF_Site_t *pSite = pSiteList; pSite != NULL; pSite = pSite->pNext)
+	{
+		pSite->Count = 0;
+		pSite->Total = 0;
+		pSite->Min = 0xFFFFFFFF;
+		pSite->Max = 0;
+		memset(pSite->Hist, 0, sizeof(pSite->Hist));
+	}
+
+	CRITICAL_SECTION_EXIT(primask);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PROF_Dump
+
+ 	 * @brief  		- API that prints min/max/mean and the non-empty histogram bins of every site
+
+ 	 * @param 		- *pUSARTHandle : USART the report is sent on (blocking), or NULL for printf (USART log channel / host stdout)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Each site is copied with interrupts off and printed from the copy - a site updated while the report
+ 	 * 				- is being sent is reported as it was when its turn came
+
+*/
+void PROF_Dump(USART_Handle_t *pUSARTHandle)
+{
+	PROF_Site_t Snapshot;
+	uint32_t primask;
+
+	PROF_Print(pUSARTHandle, "Profile (%s, %lu per ENTER/EXIT already removed):\r\n", PROF_UNITS, (unsigned long) Overhead);
+
+	for(PROF_Site_t *pSite = pSiteList; pSite != NULL; pSite = pSite->pNext)
+	{
+		//1. Consistent copy of the site
+		CRITICAL_SECTION_ENTER(primask);
+		Snapshot = *pSite;
+		CRITICAL_SECTION_EXIT(primask);
+
+		if( !Snapshot.Count )
+		{
+			continue;
+		}
+
+		//2. Summary line, then one line per non-empty bin
+		PROF_Print(pUSARTHandle, "  %-36s n=%lu min=%lu max=%lu mean=%lu\r\n", Snapshot.Name, (unsigned long) Snapshot.Count,
+				(unsigned long) Snapshot.Min, (unsigned long) Snapshot.Max, (unsigned long) ( Snapshot.Total / Snapshot.Count ));
+
+		for(uint8_t bin = 0; bin < PROF_HIST_BINS; bin++)
+		{
+			if( !Snapshot.Hist[bin] )
+			{
+				continue;
+			}
+
+			uint32_t Low = ( bin == 0 ) ? 0 : ( 1UL << ( bin - 1 ) );
+
+			if( bin == ( PROF_HIST_BINS - 1 ) )
+			{
+				PROF_Print(pUSARTHandle, "      >= %-10lu %lu\r\n", (unsigned long) Low, (unsigned long) Snapshot.Hist[bin]);
+			}
+			else
+			{
+				PROF_Print(pUSARTHandle, "      <  %-10lu %lu\r\n", (unsigned long) ( 1UL << bin ), (unsigned long) Snapshot.Hist[bin]);
+			}
+		}
+	}
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PROF_GetBin
+
+ 	 * @brief  		- Helper API that returns the log2 histogram bin of a run
+
+ 	 * @param 		- Elapsed : run time
+
+ 	 * @retval 		- 0 for 0, n for 2^(n-1) <= Elapsed < 2^n, clamped to the last bin
+
+ 	 * @Note		- Number of significant bits - one CLZ instruction on the Cortex-M4
+
+*/
+static uint8_t PROF_GetBin(uint32_t Elapsed)
+{
+	uint8_t bin = ( Elapsed == 0 ) ? 0 : ( 32 - __builtin_clz(Elapsed) );
+
+	return ( bin < PROF_HIST_BINS ) ? bin : ( PROF_HIST_BINS - 1 );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PROF_Print
+
+ 	 * @brief  		- Helper API that formats one report line and sends it on the USART or to printf
+
+ 	 * @param 		- *pUSARTHandle : USART handle or NULL
+ 	 * @param 		- *pFormat : printf format
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Lines are cut at PROF_LINE_LEN
+
+*/
+static void PROF_Print(USART_Handle_t *pUSARTHandle, const char *pFormat, ...)
+{
+	char Line[PROF_LINE_LEN];
+	va_list args;
+	int Len;
+
+	va_start(args, pFormat);
+	Len = vsnprintf(Line, sizeof(Line), pFormat, args);
+	va_end(args);
+
+	if( Len < 0 )
+	{
+		return;
+	}
+
+	if( Len >= (int) sizeof(Line) )
+	{
+		Len = sizeof(Line) - 1;
+	}
+
+	if( pUSARTHandle == NULL )
+	{
+		printf("%s", Line);
+	}
+	else
+	{
+		USART_SendData(pUSARTHandle, (uint8_t *) Line, (uint32_t) Len);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,691 @@
+/*
+ * stm32f407vg_pwr_driver.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_pwr_driver.h"
+
+#define PWR_RTC_PREDIV_A						1						//RTC count = 2 LSI cycles (~62us) - 0 is not allowed
+#define PWR_RTC_COUNT_CYCLES					( PWR_RTC_PREDIV_A + 1 )
+#define PWR_RTC_PREDIV_S						( ( PWR_LSI_NOMINAL_FREQ / PWR_RTC_COUNT_CYCLES ) - 1 )		//~1Hz calendar
+#define PWR_RTC_DAY_COUNTS						( 86400UL * ( PWR_RTC_PREDIV_S + 1 ) )						//Counts before TR rolls over
+#define PWR_RTC_WUCKSEL_DIV16					0						//Wakeup timer clock RTCCLK / 16
+#define PWR_WUT_CYCLES							16						//LSI cycles per wakeup timer count
+#define PWR_WUT_MAX_COUNTS						0x10000U				//~32s at 32kHz - a longer idle period wakes up and goes back to STOP
+#define PWR_LSI_CAL_COUNTS						512						//RTC counts the LSI is measured over (~32ms)
+#define PWR_RTCSEL_LSI							2
+#define PWR_EXTI_LINE_RTC_WKUP					22
+#define PWR_NO_EVENT							0xFFFFFFFFFFFFFFFFULL
+
+#define RTC_WPR_KEY1							0xCA
+#define RTC_WPR_KEY2							0x53
+#define RTC_WPR_LOCK							0xFF
+
+/*********** Driver-specific helper functions prototype section ***********/
+static uint32_t PWR_GetTickFreq(TIM2_5_RegDef_t *pTIMx);
+static uint32_t PWR_RTCGetCount(void);
+static uint32_t PWR_RTCCountDiff(uint32_t From, uint32_t To);
+static uint64_t PWR_GetIdleBudget(PWR_Handle_t *pPWRHandle, uint32_t *pCount, uint64_t *pDist);
+static uint32_t PWR_EnterStop(PWR_Handle_t *pPWRHandle, uint64_t Usecs, const uint32_t *pCount, const uint64_t *pDist);
+static void PWR_RTCSetWakeup(uint32_t Counts);
+static void PWR_RTCStopWakeup(void);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_Init
+
+ 	 * @brief  		- API that clocks the RTC from the LSI, routes its wakeup timer to EXTI line 22, makes deep sleep STOP and
+ 	 * 				- measures the LSI against the time base
+
+ 	 * @param 		- *pPWRHandle : handle with PWR_Config filled in
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- pTIMx[0] must already be running free (TIM2_5_SetFreeRunningInit). Masks interrupts for ~32ms (PWR_CalibrateLSI)
+ 	 * 				- The RTC wakeup interrupt still has to be enabled in the NVIC (PWR_IRQInterruptConfig, IRQ_NO_RTC_WKUP)
+ 	 * 				- and its handler has to call PWR_RTCWakeupIRQHandling
+
+*/
+void PWR_Init(PWR_Handle_t *pPWRHandle)
+{
+	PWR_Config_t *pConfig = &pPWRHandle->PWR_Config;
+	TIM2_5_RegDef_t *pClock = pConfig->pTIMx[0];
+
+	//0. 32-bit time base counting through its whole range, and a clock tree to restore if STOP is allowed
+	if( ( ( pClock != TIM2 ) && ( pClock != TIM5 ) ) || ( pClock->ARR != MAX_UINT32_VAL ) || !( pClock->CR1 & ( 1 << TIM2_5_CR1_CEN ) ) ||
+		( pConfig->PWR_Mode > PWR_MODE_STOP ) || ( ( pConfig->PWR_Mode == PWR_MODE_STOP ) && ( pConfig->pRunClock == NULL ) ) ||
+		( pConfig->PWR_MinStopUsecs < ( pConfig->PWR_WakeupUsecs + 1000 ) ) )
+	{
+		//Invalid time base or STOP settings (STOP needs at least 1ms - one wakeup timer count at the slowest LSI). Enter into an infinite loop
+		while(1);
+	}
+
+	//1. Backup domain write access and the LSI
+	PWR_PCLK_EN();
+	PWR->CR |= ( 1 << PWR_CR_DBP );
+
+	RCC->CSR |= ( 1 << RCC_CSR_LSION );
+	while( !( RCC->CSR & ( 1 << RCC_CSR_LSIRDY ) ) )
+	{
+		SIM_POLL();
+	}
+
+	//2. RTC clocked by the LSI - the Discovery board has no 32.768kHz crystal. RTCSEL is only writable once after a backup domain reset
+	if( !( RCC->BDCR & ( 1 << RCC_BDCR_RTCEN ) ) )
+	{
+		RCC->BDCR = ( RCC->BDCR & ~( 0x3 << RCC_BDCR_RTCSEL_1_0 ) ) | ( PWR_RTCSEL_LSI << RCC_BDCR_RTCSEL_1_0 ) | ( 1 << RCC_BDCR_RTCEN );
+	}
+
+	//3. Sub-second counter in LSI cycle pairs, calendar at ~1Hz. Shadow registers bypassed, so the count can be read right after STOP
+	RTC->WPR = RTC_WPR_KEY1;
+	RTC->WPR = RTC_WPR_KEY2;
+
+	RTC->ISR |= ( 1 << RTC_ISR_INIT );
+	while( !( RTC->ISR & ( 1 << RTC_ISR_INITF ) ) )
+	{
+		SIM_POLL();
+	}
+
+	RTC->PRER = ( PWR_RTC_PREDIV_S << RTC_PRER_PREDIV_S_14_0 );				//Two separate writes (see RM 26.6.5)
+	RTC->PRER |= ( PWR_RTC_PREDIV_A << RTC_PRER_PREDIV_A_6_0 );
+	RTC->TR = 0;
+	RTC->CR = ( 1 << RTC_CR_BYPSHAD );
+
+	RTC->ISR &= ~( 1 << RTC_ISR_INIT );
+	RTC->WPR = RTC_WPR_LOCK;
+
+	//4. Wakeup timer flag is EXTI line 22 (rising edge) - the only line still clocked in STOP besides the GPIO lines
+	EXTI->IMR |= ( 1 << PWR_EXTI_LINE_RTC_WKUP );
+	EXTI->RTSR |= ( 1 << PWR_EXTI_LINE_RTC_WKUP );
+
+	//5. Deep sleep is STOP (not Standby), regulator in low power mode and flash powered down
+	PWR->CR &= ~( 1 << PWR_CR_PDDS );
+	PWR->CR |= ( 1 << PWR_CR_LPDS ) | ( 1 << PWR_CR_FPDS );
+	*SCB_SCR &= ~( 1 << SCB_SCR_SLEEPDEEP );
+
+	//6. LSI against the time base, then start counting time from here
+	memset(pPWRHandle->Ticks, 0, sizeof(pPWRHandle->Ticks));
+	memset(pPWRHandle->Entries, 0, sizeof(pPWRHandle->Entries));
+	pPWRHandle->StopVetoes = 0;
+	pPWRHandle->LateWakeups = 0;
+
+	PWR_CalibrateLSI(pPWRHandle);
+
+	pPWRHandle->LastStamp = pClock->CNT;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_CalibrateLSI
+
+ 	 * @brief  		- API that measures the LSI frequency in pTIMx[0] ticks over PWR_LSI_CAL_COUNTS RTC counts
+
+ 	 * @param 		- *pPWRHandle : handle of an initialized idle manager
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The LSI moves with temperature and supply (17kHz - 47kHz over the device range) - call again when
+ 	 * 				- either changes. Interrupts are masked while it runs (~32ms), so nothing delays the edges it times
+
+*/
+void PWR_CalibrateLSI(PWR_Handle_t *pPWRHandle)
+{
+	TIM2_5_RegDef_t *pClock = pPWRHandle->PWR_Config.pTIMx[0];
+	uint32_t primask, Start, Count, Ticks;
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	//1. Start on an RTC count edge
+	Start = PWR_RTCGetCount();
+
+	while( ( Count = PWR_RTCGetCount() ) == Start )
+	{
+		SIM_POLL();
+	}
+
+	Ticks = pClock->CNT;
+
+	//2. Same edge PWR_LSI_CAL_COUNTS counts later
+	while( PWR_RTCCountDiff(Count, PWR_RTCGetCount()) < PWR_LSI_CAL_COUNTS )
+	{
+		SIM_POLL();
+	}
+
+	Ticks = pClock->CNT - Ticks;
+
+	CRITICAL_SECTION_EXIT(primask);
+
+	pPWRHandle->LSIFreq = (uint32_t) ( ( (uint64_t) PWR_LSI_CAL_COUNTS * PWR_RTC_COUNT_CYCLES * PWR_GetTickFreq(pClock) + ( Ticks / 2 ) ) / Ticks );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_Idle
+
+ 	 * @brief  		- API that waits for the next interrupt in the deepest state the schedule allows and accounts the time spent
+
+ 	 * @param 		- *pPWRHandle : handle of an initialized idle manager
+
+ 	 * @retval 		- @PWR_State entered (PWR_STATE_RUN if it was not called the right way)
+
+ 	 * @Note		- Call from thread mode with interrupts masked, right after finding there is no work left. An interrupt
+ 	 * 				- that comes in after that still ends the wait - its ISR runs when the caller unmasks interrupts, after
+ 	 * 				- the clocks and the timer counts have been restored
+ 	 * 				- STOP is used when the next update/compare interrupt of the configured timers is PWR_MinStopUsecs or more
+ 	 * 				- away and PWR_ApplicationStopAllowed agrees. The RTC wakes the core PWR_WakeupUsecs before that event,
+ 	 * 				- and the timers, stopped with their clocks, are moved forward by the time the RTC measured
+
+*/
+uint8_t PWR_Idle(PWR_Handle_t *pPWRHandle)
+{
+	PWR_Config_t *pConfig = &pPWRHandle->PWR_Config;
+	TIM2_5_RegDef_t *pClock = pConfig->pTIMx[0];
+	uint32_t Count[PWR_MAX_TIMERS];
+	uint64_t Dist[PWR_MAX_TIMERS];
+	uint32_t Start, End;
+	uint8_t State = PWR_STATE_SLEEP;
+
+	//0. A wait with interrupts enabled could miss the interrupt that brings the work, one in an ISR would block every lower priority
+	if( CPU_IN_HANDLER_MODE() || !CPU_IRQ_MASKED() )
+	{
+		return PWR_STATE_RUN;
+	}
+
+	//1. Run time since the last idle period
+	Start = pClock->CNT;
+	pPWRHandle->Ticks[PWR_STATE_RUN] += (uint32_t) ( Start - pPWRHandle->LastStamp );
+
+	//2. STOP only if the next scheduled event leaves enough time and no transfer needs the bus clocks
+	uint64_t Budget = PWR_GetIdleBudget(pPWRHandle, Count, Dist);
+
+	if( ( pConfig->PWR_Mode == PWR_MODE_STOP ) && ( Budget >= pConfig->PWR_MinStopUsecs ) )
+	{
+		if( PWR_ApplicationStopAllowed(pPWRHandle) )
+		{
+			State = PWR_STATE_STOP;
+		}
+		else
+		{
+			pPWRHandle->StopVetoes++;
+		}
+	}
+
+	//3. Wait
+	if( State == PWR_STATE_STOP )
+	{
+		End = PWR_EnterStop(pPWRHandle, Budget - pConfig->PWR_WakeupUsecs, Count, Dist);
+	}
+	else
+	{
+		CPU_WAIT_FOR_INTERRUPT();
+		End = pClock->CNT;
+	}
+
+	//4. Time in the state just left
+	pPWRHandle->Ticks[State] += (uint32_t) ( End - Start );
+	pPWRHandle->Entries[State]++;
+	pPWRHandle->LastStamp = End;
+
+	return State;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_IRQInterruptConfig
+
+ 	 * @brief  		- API that configures the RTC wakeup interrupt on the processor side
+ 	 * 				- Refer to processor guide here for more details: https://www.engr.scu.edu/~dlewis/book3/docs/Cortex-M4_Devices_Generic_User_Guide.pdf
+
+ 	 * @param 		- IRQNumber : Number associated with the peripheral's exception handler in the NVIC vector table (IRQ_NO_RTC_WKUP)
+ 	 * @param 		- EnOrDi : macros to enable or disable the IRQ (ENABLE or DISABLE macros in MCU specific header file)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Only an interrupt enabled in the NVIC ends WFI - the wakeup timer can't end STOP without it
+
+*/
+void PWR_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		if(IRQNumber <= 31)
+		{
+			//configure ISER0 register in processor //0 to 31
+			*NVIC_ISER0 |= ( 1 << IRQNumber );
+		}
+		else if(IRQNumber > 31 && IRQNumber <= 63)
+		{
+			//configure ISER1 register in processor //32 to 63
+			*NVIC_ISER1 |= ( 1 << (IRQNumber % 32) );
+		}
+		else if(IRQNumber > 63 && IRQNumber <= 95)
+		{
+			//configure ISER2 register in processor //64 to 95
+			*NVIC_ISER2 |= ( 1 << (IRQNumber % 32) );
+		}
+	}
+	else
+	{
+		if(IRQNumber <= 31)
+		{
+			//configure ICER0 register in processor //0 to 31
+			*NVIC_ICER0 = ( 1 << IRQNumber );
+		}
+		else if(IRQNumber > 31 && IRQNumber <= 63)
+		{
+			//configure ICER1 register in processor //32 to 63
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
+		}
+		else if(IRQNumber > 63 && IRQNumber <= 95)
+		{
+			//configure ICER2 register in processor //64 to 95
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+	 * @fn			- PWR_IRQPriorityConfig
+
+	 * @brief  		- API that configures the priority level of a given IRQ (RTC wakeup interrupt).
+
+	 * @param		- IRQNumber : Number associated with the peripheral's exception handler in the NVIC vector table
+	 * @param 		- IRQPriority : Value that contains priority level of interrupt as compared to other interrupts
+
+	 * @retval 		- none
+
+	 * @Note		- none
+
+*/
+void PWR_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
+{
+	//1. Find out which IPR register the IRQ is in
+	uint8_t Offset = IRQNumber / 4;
+
+	//2. Clear and write by shifting the priority value into the correct position (only the upper 4 bits of each byte are implemented)
+	uint8_t shiftAmount = ( (IRQNumber % 4) * 8 ) + ( 8 - NO_PR_BITS_IMPLEMENTED );
+
+	*(NVIC_IPR_BASE_ADDR + (Offset) ) &= ~( 0xFF << shiftAmount );
+	*(NVIC_IPR_BASE_ADDR + (Offset) ) |= ( IRQPriority << shiftAmount );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_RTCWakeupIRQHandling
+
+ 	 * @brief  		- API that clears the RTC wakeup flag and its EXTI line (called from RTC_WKUP_IRQHandler)
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- PWR_Idle already stops the wakeup timer and clears its flags when STOP ends - the ISR that follows
+ 	 * 				- usually finds nothing left to do
+
+*/
+void PWR_RTCWakeupIRQHandling(void)
+{
+	//RTC_ISR flags are not write protected
+	RTC->ISR &= ~( 1 << RTC_ISR_WUTF );
+	EXTI->PR = ( 1 << PWR_EXTI_LINE_RTC_WKUP );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_GetStateUsecs
+
+ 	 * @brief  		- API that returns the time spent in a power state since PWR_Init
+
+ 	 * @param 		- *pPWRHandle : handle of an initialized idle manager
+ 	 * @param 		- State : possible values from @PWR_State
+
+ 	 * @retval 		- microseconds (at the current pTIMx[0] tick rate)
+
+ 	 * @Note		- Run time is only brought up to date by PWR_Idle
+
+*/
+uint64_t PWR_GetStateUsecs(PWR_Handle_t *pPWRHandle, uint8_t State)
+{
+	if( State > PWR_STATE_STOP )
+	{
+		return 0;
+	}
+
+	return ( pPWRHandle->Ticks[State] * 1000000ULL ) / PWR_GetTickFreq(pPWRHandle->PWR_Config.pTIMx[0]);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_ApplicationStopAllowed
+
+ 	 * @brief  		- Application callback asked before every STOP - peripheral clocks are gated in STOP, so a DMA transfer,
+ 	 * 				- a byte on a bus or a conversion under way would be frozen until the next wake up
+
+ 	 * @param 		- *pPWRHandle : handle of the idle manager
+
+ 	 * @retval 		- 1 if STOP is allowed, 0 to Sleep instead
+
+ 	 * @Note		- Called with interrupts masked. Weak implementation - always allows STOP
+
+*/
+__weak uint8_t PWR_ApplicationStopAllowed(PWR_Handle_t *pPWRHandle)
+{
+	return 1;
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_GetTickFreq
+
+ 	 * @brief  		- Helper API that returns the count frequency of a timer
+
+ 	 * @param 		- *pTIMx : TIM2-TIM5 base address
+
+ 	 * @retval 		- Hz
+
+ 	 * @Note		- From the pre-scaler in PSC, which is what the counter uses outside of the update that loads it
+
+*/
+static uint32_t PWR_GetTickFreq(TIM2_5_RegDef_t *pTIMx)
+{
+	return RCC_GetTIMCLK1Val() / ( pTIMx->PSC + 1 );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_RTCGetCount
+
+ 	 * @brief  		- Helper API that returns the RTC time of day in counts (PWR_RTC_COUNT_CYCLES LSI cycles)
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- 0 to PWR_RTC_DAY_COUNTS - 1
+
+ 	 * @Note		- SSR and TR are read straight from the counters (BYPSHAD) - SSR is read again to catch a second going by
+
+*/
+static uint32_t PWR_RTCGetCount(void)
+{
+	uint32_t ssr, tr, Seconds;
+
+	do
+	{
+		ssr = RTC->SSR;
+		tr = RTC->TR;
+	}while( ssr != RTC->SSR );
+
+	Seconds = ( ( ( tr >> RTC_TR_HT_1_0 ) & 0x3 ) * 10 + ( ( tr >> RTC_TR_HU_3_0 ) & 0xF ) ) * 3600 +
+			  ( ( ( tr >> RTC_TR_MNT_2_0 ) & 0x7 ) * 10 + ( ( tr >> RTC_TR_MNU_3_0 ) & 0xF ) ) * 60 +
+			  ( ( ( tr >> RTC_TR_ST_2_0 ) & 0x7 ) * 10 + ( ( tr >> RTC_TR_SU_3_0 ) & 0xF ) );
+
+	//SSR counts down from PREDIV_S
+	return ( Seconds * ( PWR_RTC_PREDIV_S + 1 ) ) + ( PWR_RTC_PREDIV_S - ( ssr & 0xFFFF ) );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_RTCCountDiff
+
+ 	 * @brief  		- Helper API that returns the RTC counts from one reading to a later one, across midnight
+
+ 	 * @param 		- From : earlier PWR_RTCGetCount
+ 	 * @param 		- To : later PWR_RTCGetCount
+
+ 	 * @retval 		- counts
+
+ 	 * @Note		- none
+
+*/
+static uint32_t PWR_RTCCountDiff(uint32_t From, uint32_t To)
+{
+	return ( To >= From ) ? ( To - From ) : ( To + PWR_RTC_DAY_COUNTS - From );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_GetIdleBudget
+
+ 	 * @brief  		- Helper API that finds how long the configured timers leave before their next interrupt (or TRGO update)
+
+ 	 * @param 		- *pPWRHandle : handle of the idle manager
+ 	 * @param 		- *pCount : filled with the count of each timer the distances are from
+ 	 * @param 		- *pDist : filled with the ticks to each timer's next event, 0 if it has none
+
+ 	 * @retval 		- microseconds to the nearest event, 0 if one is already pending, PWR_NO_EVENT if there is none
+
+ 	 * @Note		- Update events count when UIE is set or TRGO sends them to another peripheral (ADC trigger)
+
+*/
+static uint64_t PWR_GetIdleBudget(PWR_Handle_t *pPWRHandle, uint32_t *pCount, uint64_t *pDist)
+{
+	uint64_t Budget = PWR_NO_EVENT;
+
+	for(uint8_t i = 0; i < PWR_MAX_TIMERS; i++)
+	{
+		TIM2_5_RegDef_t *pTIMx = pPWRHandle->PWR_Config.pTIMx[i];
+
+		pDist[i] = 0;
+
+		if( ( pTIMx == NULL ) || !( pTIMx->CR1 & ( 1 << TIM2_5_CR1_CEN ) ) )
+		{
+			continue;
+		}
+
+		uint32_t dier = pTIMx->DIER;
+		uint32_t cnt = pTIMx->CNT;
+		uint64_t Period = (uint64_t) pTIMx->ARR + 1;
+		uint64_t Next = PWR_NO_EVENT;
+
+		pCount[i] = cnt;
+
+		//1. Flag already waiting for its ISR - no time to sleep at all
+		if( pTIMx->SR & dier & 0x1F )
+		{
+			return 0;
+		}
+
+		//2. Roll over
+		if( ( dier & ( 1 << TIM2_5_DIER_UIE ) ) || ( ( ( pTIMx->CR2 >> TIM2_5_CR2_MMS_2_0 ) & 0x7 ) == TIM_TRGO_UPDATE ) )
+		{
+			Next = Period - cnt;
+		}
+
+		//3. Compare channels
+		for(uint8_t ch = 0; ch < 4; ch++)
+		{
+			uint32_t ccr = ( &pTIMx->CCR1 )[ch];
+
+			if( !( dier & ( 1 << ( TIM2_5_DIER_CC1IE + ch ) ) ) || ( ccr >= Period ) )
+			{
+				continue;
+			}
+
+			uint64_t d = ( (uint64_t) ccr + Period - cnt ) % Period;
+
+			if( d == 0 )
+			{
+				d = Period;
+			}
+
+			if( d < Next )
+			{
+				Next = d;
+			}
+		}
+
+		if( Next == PWR_NO_EVENT )
+		{
+			continue;
+		}
+
+		pDist[i] = Next;
+
+		uint64_t Usecs = ( Next * 1000000ULL ) / PWR_GetTickFreq(pTIMx);
+
+		if( Usecs < Budget )
+		{
+			Budget = Usecs;
+		}
+	}
+
+	return Budget;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_EnterStop
+
+ 	 * @brief  		- Helper API that stays in STOP until the RTC wakes the core (or an EXTI line does), restores the clock tree
+ 	 * 				- and moves the timers forward by the time they were stopped
+
+ 	 * @param 		- *pPWRHandle : handle of the idle manager
+ 	 * @param 		- Usecs : time to stay in STOP
+ 	 * @param 		- *pCount : timer counts when the distances were measured
+ 	 * @param 		- *pDist : ticks from those counts to each timer's next event (0 - none)
+
+ 	 * @retval 		- pTIMx[0] count once everything is back
+
+ 	 * @Note		- A timer never goes past its next event - if STOP lasted longer the event fires one tick after the wake up
+ 	 * 				- (counted in LateWakeups)
+
+*/
+static uint32_t PWR_EnterStop(PWR_Handle_t *pPWRHandle, uint64_t Usecs, const uint32_t *pCount, const uint64_t *pDist)
+{
+	PWR_Config_t *pConfig = &pPWRHandle->PWR_Config;
+	uint64_t Counts = ( Usecs * pPWRHandle->LSIFreq ) / ( 1000000ULL * PWR_WUT_CYCLES );
+	uint8_t Late = 0;
+
+	//1. Wakeup timer - no event at all still wakes up every PWR_WUT_MAX_COUNTS to stay in step with the RTC count range
+	if( Counts > PWR_WUT_MAX_COUNTS )
+	{
+		Counts = PWR_WUT_MAX_COUNTS;
+	}
+
+	PWR_RTCSetWakeup( ( Counts > 0 ) ? (uint32_t) Counts : 1 );
+
+	//2. STOP - the time base is the RTC from here until the clocks are back
+	uint32_t RTCStart = PWR_RTCGetCount();
+
+	*SCB_SCR |= ( 1 << SCB_SCR_SLEEPDEEP );
+	CPU_WAIT_FOR_INTERRUPT();
+	*SCB_SCR &= ~( 1 << SCB_SCR_SLEEPDEEP );
+
+	//3. Core runs from the HSI after STOP - PLL and bus prescalers back through the RCC driver (no clock change seen by the drivers)
+	RCC_ClockConfig(pConfig->pRunClock);
+	PWR_RTCStopWakeup();
+
+	uint64_t Cycles = (uint64_t) PWR_RTCCountDiff(RTCStart, PWR_RTCGetCount()) * PWR_RTC_COUNT_CYCLES;
+
+	//4. Timers forward by the time since their counts were taken, never past their next event
+	for(uint8_t i = 0; i < PWR_MAX_TIMERS; i++)
+	{
+		TIM2_5_RegDef_t *pTIMx = pConfig->pTIMx[i];
+
+		if( ( pTIMx == NULL ) || !( pTIMx->CR1 & ( 1 << TIM2_5_CR1_CEN ) ) )
+		{
+			continue;
+		}
+
+		uint64_t Period = (uint64_t) pTIMx->ARR + 1;
+		uint64_t Advance = ( Cycles * PWR_GetTickFreq(pTIMx) ) / pPWRHandle->LSIFreq;
+
+		if( pDist[i] && ( Advance >= pDist[i] ) )
+		{
+			Advance = pDist[i] - 1;
+			Late = 1;
+		}
+
+		pTIMx->CNT = (uint32_t) ( ( pCount[i] + Advance ) % Period );
+	}
+
+	if( Late )
+	{
+		pPWRHandle->LateWakeups++;
+	}
+
+	return pConfig->pTIMx[0]->CNT;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_RTCSetWakeup
+
+ 	 * @brief  		- Helper API that starts the RTC wakeup timer with its interrupt
+
+ 	 * @param 		- Counts : wakeup timer counts (PWR_WUT_CYCLES LSI cycles each), 1 to PWR_WUT_MAX_COUNTS
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- WUTR can only be written while the wakeup timer is stopped and WUTWF is set
+
+*/
+static void PWR_RTCSetWakeup(uint32_t Counts)
+{
+	RTC->WPR = RTC_WPR_KEY1;
+	RTC->WPR = RTC_WPR_KEY2;
+
+	RTC->CR &= ~( 1 << RTC_CR_WUTE );
+	while( !( RTC->ISR & ( 1 << RTC_ISR_WUTWF ) ) )
+	{
+		SIM_POLL();
+	}
+
+	RTC->WUTR = Counts - 1;
+	RTC->ISR &= ~( 1 << RTC_ISR_WUTF );
+	RTC->CR = ( RTC->CR & ~( 0x7 << RTC_CR_WUCKSEL_2_0 ) ) | ( PWR_RTC_WUCKSEL_DIV16 << RTC_CR_WUCKSEL_2_0 ) | ( 1 << RTC_CR_WUTIE ) | ( 1 << RTC_CR_WUTE );
+
+	RTC->WPR = RTC_WPR_LOCK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- PWR_RTCStopWakeup
+
+ 	 * @brief  		- Helper API that stops the RTC wakeup timer and clears what it left pending
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The NVIC keeps its own pending bit - RTC_WKUP_IRQHandler may still run once
+
+*/
+static void PWR_RTCStopWakeup(void)
+{
+	RTC->WPR = RTC_WPR_KEY1;
+	RTC->WPR = RTC_WPR_KEY2;
+
+	RTC->CR &= ~( ( 1 << RTC_CR_WUTE ) | ( 1 << RTC_CR_WUTIE ) );
+
+	RTC->WPR = RTC_WPR_LOCK;
+
+	PWR_RTCWakeupIRQHandling();
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -7,77 +7,445 @@
 
 #include "stm32f407vg.h"
 
+/*
+ * Registered clock change callbacks (free slots have a NULL pCallback)
+ */
+typedef struct
+{
+	RCC_ClockCallback_t 	pCallback;
+	void 					*pContext;
+}RCC_ClockCallbackSlot_t;
+
+static RCC_Clocks_t RCC_Clocks;									//Bus clocks as of the last RCC_UpdateClockState
+static uint8_t RCC_ClocksValid = 0;								//RCC_Clocks decoded at least once
+static RCC_ClockCallbackSlot_t RCC_Callbacks[RCC_MAX_CLOCK_CALLBACKS];
+
+/*********** Driver-specific helper functions prototype section ***********/
+static uint16_t RCC_GetAHBPrescaler(uint8_t HPRE);
+static uint8_t RCC_GetAPBPrescaler(uint8_t PPRE);
+static void RCC_SetFlashLatency(uint8_t Latency);
+
+/********************************************************/
+
+
 
 
 /*********************** Function Documentation ***************************************
  *
- 	 * @fn			- RCC_GetPCLK1Val
+ 	 * @fn			- RCC_ClockConfig
 
- 	 * @brief  		- Returns the value (in Hz) of the frequency that the APB1 bus is currently operating at
+ 	 * @brief  		- API that switches the system clock to the HSI, the HSE or the main PLL and sets the AHB/APB prescalers,
+ 	 * 				- the flash wait states and the ART accelerator (prefetch, instruction cache, data cache)
+
+ 	 * @param 		- *pRCCConfig : clock tree configuration
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Best called before any peripheral is initialized. Drivers read the bus clocks when they are
+ 	 * 				- initialized (baud rates, I2C timing, timer pre-scalers) and the ones already initialized are told about
+ 	 * 				- the change through their clock callbacks - their transfers should be idle. Wait states are raised before the clock goes up and
+ 	 * 				- lowered after it comes down, so the flash is never read with too few of them. Assumes a 2.7V - 3.6V
+ 	 * 				- supply. An invalid configuration enters into an infinite loop
+
+*/
+void RCC_ClockConfig(RCC_Config_t *pRCCConfig)
+{
+	uint32_t SysClk, HClk, SrcClk;
+	uint8_t Latency, OldLatency;
+
+	//1. Work out the new clock tree and check it against the limits of the device
+	if( pRCCConfig->RCC_ClkSource == RCC_CLK_SRC_HSI )
+	{
+		SysClk = RCC_HSI_FREQ;
+	}
+	else if( pRCCConfig->RCC_ClkSource == RCC_CLK_SRC_HSE )
+	{
+		SysClk = RCC_HSE_FREQ;
+	}
+	else if( pRCCConfig->RCC_ClkSource == RCC_CLK_SRC_PLL )
+	{
+		SrcClk = ( pRCCConfig->RCC_PLLSource == RCC_PLL_SRC_HSE ) ? RCC_HSE_FREQ : RCC_HSI_FREQ;
+
+		uint32_t VCOIn = SrcClk / pRCCConfig->RCC_PLL_M;
+		uint32_t VCOOut = VCOIn * pRCCConfig->RCC_PLL_N;
+
+		if( ( pRCCConfig->RCC_PLL_M < 2 ) || ( pRCCConfig->RCC_PLL_M > 63 ) || ( pRCCConfig->RCC_PLL_N < 50 ) || ( pRCCConfig->RCC_PLL_N > 432 ) ||
+			( pRCCConfig->RCC_PLL_P < 2 ) || ( pRCCConfig->RCC_PLL_P > 8 ) || ( pRCCConfig->RCC_PLL_P & 1 ) ||
+			( pRCCConfig->RCC_PLL_Q < 2 ) || ( pRCCConfig->RCC_PLL_Q > 15 ) ||
+			( VCOIn < 1000000U ) || ( VCOIn > 2000000U ) || ( VCOOut < 100000000U ) || ( VCOOut > 432000000U ) ||
+			( ( VCOOut / pRCCConfig->RCC_PLL_Q ) > 48000000U ) )
+		{
+			//PLL out of its operating range. Enter into an infinite loop
+			while(1);
+		}
+
+		SysClk = VCOOut / pRCCConfig->RCC_PLL_P;
+	}
+	else
+	{
+		//Invalid clock source. Enter into an infinite loop
+		while(1);
+	}
+
+	if( ( pRCCConfig->RCC_AHBPrescaler > RCC_AHB_DIV_512 ) || ( ( pRCCConfig->RCC_AHBPrescaler != RCC_AHB_DIV_1 ) && ( pRCCConfig->RCC_AHBPrescaler < RCC_AHB_DIV_2 ) ) ||
+		( pRCCConfig->RCC_APB1Prescaler > RCC_APB_DIV_16 ) || ( ( pRCCConfig->RCC_APB1Prescaler != RCC_APB_DIV_1 ) && ( pRCCConfig->RCC_APB1Prescaler < RCC_APB_DIV_2 ) ) ||
+		( pRCCConfig->RCC_APB2Prescaler > RCC_APB_DIV_16 ) || ( ( pRCCConfig->RCC_APB2Prescaler != RCC_APB_DIV_1 ) && ( pRCCConfig->RCC_APB2Prescaler < RCC_APB_DIV_2 ) ) )
+	{
+		//Invalid prescaler code. Enter into an infinite loop
+		while(1);
+	}
+
+	HClk = SysClk / RCC_GetAHBPrescaler(pRCCConfig->RCC_AHBPrescaler);
+
+	if( ( SysClk > RCC_MAX_SYSCLK_FREQ ) ||
+		( ( HClk / RCC_GetAPBPrescaler(pRCCConfig->RCC_APB1Prescaler) ) > RCC_MAX_PCLK1_FREQ ) ||
+		( ( HClk / RCC_GetAPBPrescaler(pRCCConfig->RCC_APB2Prescaler) ) > RCC_MAX_PCLK2_FREQ ) )
+	{
+		//Bus clock above its maximum. Enter into an infinite loop
+		while(1);
+	}
+
+	//2. More wait states before the clock goes up
+	Latency = (uint8_t) ( ( HClk - 1 ) / RCC_FLASH_WS_FREQ );
+	OldLatency = (uint8_t) ( ( FLASH->ACR >> FLASH_ACR_LATENCY_2_0 ) & 0x7 );
+
+	if( Latency > OldLatency )
+	{
+		RCC_SetFlashLatency(Latency);
+	}
+
+	//3. Run from the HSI while the PLL is (re)configured - it can't be touched while it clocks the core
+	RCC->CR |= ( 1 << RCC_CR_HSION );
+	while( !( RCC->CR & ( 1 << RCC_CR_HSIRDY ) ) )
+	{
+		SIM_POLL();
+	}
+
+	if( ( ( RCC->CFGR >> RCC_CFGR_SWS_1_0 ) & 0x3 ) == RCC_CLK_SRC_PLL )
+	{
+		RCC->CFGR &= ~( 0x3 << RCC_CFGR_SW_1_0 );
+		while( ( ( RCC->CFGR >> RCC_CFGR_SWS_1_0 ) & 0x3 ) != RCC_CLK_SRC_HSI )
+		{
+			SIM_POLL();
+		}
+	}
+
+	//4. Start the HSE if the new clock is derived from it
+	if( ( pRCCConfig->RCC_ClkSource == RCC_CLK_SRC_HSE ) ||
+		( ( pRCCConfig->RCC_ClkSource == RCC_CLK_SRC_PLL ) && ( pRCCConfig->RCC_PLLSource == RCC_PLL_SRC_HSE ) ) )
+	{
+		RCC->CR |= ( 1 << RCC_CR_HSEON );
+		while( !( RCC->CR & ( 1 << RCC_CR_HSERDY ) ) )
+		{
+			SIM_POLL();
+		}
+	}
+
+	//5. Main PLL - stop it, program M/N/P/Q and the source, start it again
+	if( pRCCConfig->RCC_ClkSource == RCC_CLK_SRC_PLL )
+	{
+		RCC->CR &= ~( 1 << RCC_CR_PLLON );
+		while( RCC->CR & ( 1 << RCC_CR_PLLRDY ) )
+		{
+			SIM_POLL();
+		}
+
+		RCC->PLLCFGR = ( pRCCConfig->RCC_PLL_M << RCC_PLLCFGR_PLLM_5_0 ) | ( pRCCConfig->RCC_PLL_N << RCC_PLLCFGR_PLLN_8_0 ) |
+					   ( ( ( pRCCConfig->RCC_PLL_P / 2 ) - 1 ) << RCC_PLLCFGR_PLLP_1_0 ) | ( pRCCConfig->RCC_PLLSource << RCC_PLLCFGR_PLLSRC ) |
+					   ( pRCCConfig->RCC_PLL_Q << RCC_PLLCFGR_PLLQ_3_0 );
+
+		RCC->CR |= ( 1 << RCC_CR_PLLON );
+		while( !( RCC->CR & ( 1 << RCC_CR_PLLRDY ) ) )
+		{
+			SIM_POLL();
+		}
+	}
+
+	//6. APB buses at the slowest setting while the core clock changes, AHB at its final value
+	uint32_t tempreg = RCC->CFGR;
+
+	tempreg &= ~( ( 0xF << RCC_CFGR_HPRE_3_0 ) | ( 0x7 << RCC_CFGR_PPRE1_2_0 ) | ( 0x7 << RCC_CFGR_PPRE2_2_0 ) );
+	tempreg |= ( pRCCConfig->RCC_AHBPrescaler << RCC_CFGR_HPRE_3_0 ) | ( RCC_APB_DIV_16 << RCC_CFGR_PPRE1_2_0 ) | ( RCC_APB_DIV_16 << RCC_CFGR_PPRE2_2_0 );
+	RCC->CFGR = tempreg;
+
+	//7. Switch the system clock
+	RCC->CFGR = ( RCC->CFGR & ~( 0x3 << RCC_CFGR_SW_1_0 ) ) | ( pRCCConfig->RCC_ClkSource << RCC_CFGR_SW_1_0 );
+	while( ( ( RCC->CFGR >> RCC_CFGR_SWS_1_0 ) & 0x3 ) != pRCCConfig->RCC_ClkSource )
+	{
+		SIM_POLL();
+	}
+
+	//8. Final APB prescalers
+	tempreg = RCC->CFGR;
+	tempreg &= ~( ( 0x7 << RCC_CFGR_PPRE1_2_0 ) | ( 0x7 << RCC_CFGR_PPRE2_2_0 ) );
+	tempreg |= ( pRCCConfig->RCC_APB1Prescaler << RCC_CFGR_PPRE1_2_0 ) | ( pRCCConfig->RCC_APB2Prescaler << RCC_CFGR_PPRE2_2_0 );
+	RCC->CFGR = tempreg;
+
+	//9. Fewer wait states once the clock has come down
+	if( Latency < OldLatency )
+	{
+		RCC_SetFlashLatency(Latency);
+	}
+
+	//10. ART accelerator - the caches may only be reset while they are disabled
+	FLASH->ACR &= ~( ( 1 << FLASH_ACR_PRFTEN ) | ( 1 << FLASH_ACR_ICEN ) | ( 1 << FLASH_ACR_DCEN ) );
+
+	if( pRCCConfig->RCC_FlashART == ENABLE )
+	{
+		FLASH->ACR |= ( 1 << FLASH_ACR_ICRST ) | ( 1 << FLASH_ACR_DCRST );
+		FLASH->ACR &= ~( ( 1 << FLASH_ACR_ICRST ) | ( 1 << FLASH_ACR_DCRST ) );
+		FLASH->ACR |= ( 1 << FLASH_ACR_PRFTEN ) | ( 1 << FLASH_ACR_ICEN ) | ( 1 << FLASH_ACR_DCEN );
+	}
+
+	//11. New bus clocks into the cache - drivers registered for clock changes recompute their settings
+	RCC_UpdateClockState();
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetPLLOutputClk
+
+ 	 * @brief  		- Returns the value (in Hz) of the main PLL system clock output (PLLCLK)
 
  	 * @param 		- none
  	 *
- 	 * @retval 		- pclk1 : Value in Hz of the operating frequency of the APB1 bus
+ 	 * @retval 		- PLLCLK in Hz, 0 if the PLL configuration is invalid
 
- 	 * @Note		- none
+ 	 * @Note		- PLLCLK = ( PLL source / M ) * N / P
 
 */
-uint32_t RCC_GetPCLK1Val(void)
+uint32_t RCC_GetPLLOutputClk(void)
+{
+	uint32_t pllcfgr = RCC->PLLCFGR;
+	uint32_t SrcClk = ( pllcfgr & ( 1 << RCC_PLLCFGR_PLLSRC ) ) ? RCC_HSE_FREQ : RCC_HSI_FREQ;
+	uint8_t M = ( ( pllcfgr >> RCC_PLLCFGR_PLLM_5_0 ) & 0x3F );
+	uint16_t N = ( ( pllcfgr >> RCC_PLLCFGR_PLLN_8_0 ) & 0x1FF );
+	uint8_t P = 2 * ( ( ( pllcfgr >> RCC_PLLCFGR_PLLP_1_0 ) & 0x3 ) + 1 );
+
+	if( M < 2 )
+	{
+		return 0;
+	}
+
+	return ( ( SrcClk / M ) * N ) / P;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_UpdateClockState
+
+ 	 * @brief  		- API that decodes the bus clocks from the RCC registers into the cache and, if any of them changed,
+ 	 * 				- calls every registered clock callback
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called by RCC_ClockConfig. Call it after changing RCC_CFGR/RCC_PLLCFGR without RCC_ClockConfig.
+ 	 * 				- Thread mode only - ISRs may read the cache (RCC_GetXXXVal) while it is being updated
+
+*/
+void RCC_UpdateClockState(void)
 {
-	uint32_t SystemClk, pclk1;
-	uint8_t clksrc = (( RCC->CFGR >> 2 ) & 0x3);
+	RCC_Clocks_t Clocks;
+	uint8_t cfgr_hpre = (uint8_t) (( RCC->CFGR >> RCC_CFGR_HPRE_3_0 ) & 0xF);
+	uint8_t cfgr_ppre1 = (uint8_t) (( RCC->CFGR >> RCC_CFGR_PPRE1_2_0 ) & 0x7);
+	uint8_t cfgr_ppre2 = (uint8_t) (( RCC->CFGR >> RCC_CFGR_PPRE2_2_0 ) & 0x7);
+	uint8_t clksrc = (uint8_t) (( RCC->CFGR >> RCC_CFGR_SWS_1_0 ) & 0x3);
 
-	//determine system clock speed
+	//1. Determine system clock speed
 
-	if( clksrc == 0 ) //HSI oscillator used as the system clock
+	if( clksrc == RCC_CLK_SRC_HSI ) //HSI oscillator used as the system clock
 	{
-		SystemClk = 16000000;
+		Clocks.SysClk = RCC_HSI_FREQ;
 	}
-	else if( clksrc == 1 ) //HSE oscillator used as the system clock
+	else if( clksrc == RCC_CLK_SRC_HSE ) //HSE oscillator used as the system clock
 	{
-		SystemClk = 8000000;
+		Clocks.SysClk = RCC_HSE_FREQ;
 	}
-	else if( clksrc == 2 ) //PLL oscillator used as the system clock
+	else if( clksrc == RCC_CLK_SRC_PLL ) //PLL oscillator used as the system clock
 	{
-		//SystemClk = RCC_GetPLLOutputClk();
+		Clocks.SysClk = RCC_GetPLLOutputClk();
 	}
 	else
-		SystemClk = 0;
+		Clocks.SysClk = 0;
 
-	//Calculate APB1 speed based off of system clock speed
+	//2. Bus clocks off of the system clock - timers run at twice their bus clock when it is divided
+	Clocks.HClk = Clocks.SysClk / RCC_GetAHBPrescaler(cfgr_hpre);
+	Clocks.PClk1 = Clocks.HClk / RCC_GetAPBPrescaler(cfgr_ppre1);
+	Clocks.PClk2 = Clocks.HClk / RCC_GetAPBPrescaler(cfgr_ppre2);
+	Clocks.TimClk1 = ( cfgr_ppre1 < RCC_APB_DIV_2 ) ? Clocks.PClk1 : ( 2 * Clocks.PClk1 );
+	Clocks.TimClk2 = ( cfgr_ppre2 < RCC_APB_DIV_2 ) ? Clocks.PClk2 : ( 2 * Clocks.PClk2 );
 
-	//1. Get AHB Prescaler value
-	uint16_t AHBPrescaler = 1;
-	uint8_t temp = (( RCC->CFGR >> 4 ) & 0xF);
+	//3. Publish, then tell the drivers that computed settings from the old values
+	if( RCC_ClocksValid && ( memcmp(&Clocks, &RCC_Clocks, sizeof(Clocks)) == 0 ) )
+	{
+		return;
+	}
 
-	if( temp >= 8 )
+	RCC_Clocks = Clocks;
+	RCC_ClocksValid = 1;
+
+	for(uint8_t i = 0; i < RCC_MAX_CLOCK_CALLBACKS; i++)
 	{
-		AHBPrescaler = 2;
-		for( uint8_t i = 9; i <= temp; i++ ) //refer to bits 7:4 in RCC_CFGR for why this exists
+		if( RCC_Callbacks[i].pCallback != NULL )
 		{
-			AHBPrescaler *= 2;
+			RCC_Callbacks[i].pCallback(RCC_Callbacks[i].pContext);
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetClocks
+
+ 	 * @brief  		- API that returns the cached bus clocks
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- pointer to the cache - valid until the next clock tree change
+
+ 	 * @Note		- The first call decodes the registers (i.e., when RCC_ClockConfig was never called)
+
+*/
+const RCC_Clocks_t *RCC_GetClocks(void)
+{
+	if( !RCC_ClocksValid )
+	{
+		RCC_UpdateClockState();
+	}
+
+	return &RCC_Clocks;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_RegisterClockCallback
+
+ 	 * @brief  		- API that registers a function to be called after every bus clock change
+
+ 	 * @param 		- pCallback : function to call
+ 	 * @param 		- *pContext : argument it is called with (i.e., the driver handle)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Registering the same callback and context again does nothing, so a driver can register from its
+ 	 * 				- Init API. More than RCC_MAX_CLOCK_CALLBACKS registrations enter into an infinite loop
+
+*/
+void RCC_RegisterClockCallback(RCC_ClockCallback_t pCallback, void *pContext)
+{
+	int8_t FreeSlot = -1;
+
+	for(uint8_t i = 0; i < RCC_MAX_CLOCK_CALLBACKS; i++)
+	{
+		if( ( RCC_Callbacks[i].pCallback == pCallback ) && ( RCC_Callbacks[i].pContext == pContext ) )
+		{
+			return;
 		}
+
+		if( ( RCC_Callbacks[i].pCallback == NULL ) && ( FreeSlot < 0 ) )
+		{
+			FreeSlot = i;
+		}
+	}
+
+	if( FreeSlot < 0 )
+	{
+		//No room left - raise RCC_MAX_CLOCK_CALLBACKS. Enter into an infinite loop
+		while(1);
 	}
 
-	//2. Get the  APB1 prescaler
-	uint8_t APB1Prescaler = 1;
-	temp = (( RCC->CFGR >> 10 ) & 0x7);
+	RCC_Callbacks[FreeSlot].pContext = pContext;
+	RCC_Callbacks[FreeSlot].pCallback = pCallback;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_UnregisterClockCallback
+
+ 	 * @brief  		- API that removes a callback registered with RCC_RegisterClockCallback
+
+ 	 * @param 		- pCallback : function registered
+ 	 * @param 		- *pContext : context it was registered with
 
-	if( temp >= 4 )
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void RCC_UnregisterClockCallback(RCC_ClockCallback_t pCallback, void *pContext)
+{
+	for(uint8_t i = 0; i < RCC_MAX_CLOCK_CALLBACKS; i++)
 	{
-		APB1Prescaler = 2;
-		for( uint8_t i = 5; i <= temp; i++ ) //refer to bits 12:10 in RCC_CFGR for why this exists
+		if( ( RCC_Callbacks[i].pCallback == pCallback ) && ( RCC_Callbacks[i].pContext == pContext ) )
 		{
-			APB1Prescaler *= 2;
+			RCC_Callbacks[i].pCallback = NULL;
+			RCC_Callbacks[i].pContext = NULL;
 		}
 	}
+}
 
 
-	//Have everything needed for calculating APB1 bus clock speed that APB2 peripherals are hanging off of
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetSysClkVal
 
-	pclk1 = ( (SystemClk / AHBPrescaler) / APB1Prescaler );
+ 	 * @brief  		- Returns the value (in Hz) of the system clock (SYSCLK)
 
-	return pclk1;
+ 	 * @param 		- none
+ 	 *
+ 	 * @retval 		- SYSCLK in Hz
+
+ 	 * @Note		- Read from the switch status (SWS), not the requested switch position
+
+*/
+uint32_t RCC_GetSysClkVal(void)
+{
+	return RCC_GetClocks()->SysClk;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetHCLKVal
+
+ 	 * @brief  		- Returns the value (in Hz) of the frequency that the AHB bus (and the core) is currently operating at
+
+ 	 * @param 		- none
+ 	 *
+ 	 * @retval 		- HCLK in Hz
+
+ 	 * @Note		- none
+
+*/
+uint32_t RCC_GetHCLKVal(void)
+{
+	return RCC_GetClocks()->HClk;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetPCLK1Val
+
+ 	 * @brief  		- Returns the value (in Hz) of the frequency that the APB1 bus is currently operating at
+
+ 	 * @param 		- none
+ 	 *
+ 	 * @retval 		- pclk1 : Value in Hz of the operating frequency of the APB1 bus
+
+ 	 * @Note		- none
+
+*/
+uint32_t RCC_GetPCLK1Val(void)
+{
+	return RCC_GetClocks()->PClk1;
 }
 
 
@@ -90,66 +458,145 @@ uint32_t RCC_GetPCLK1Val(void)
 
  	 * @param 		- none
  	 *
- 	 * @retval 		- pclk1 : Value in Hz of the operating frequency of the APB2 bus
+ 	 * @retval 		- pclk2 : Value in Hz of the operating frequency of the APB2 bus
 
  	 * @Note		- none
 
 */
 uint32_t RCC_GetPCLK2Val(void)
 {
-	uint32_t SystemClk, pclk2;
-	uint8_t clksrc = (( RCC->CFGR >> 2 ) & 0x3);
+	return RCC_GetClocks()->PClk2;
+}
 
-	//determine system clock speed
 
-	if( clksrc == 0 ) //HSI oscillator used as the system clock
-	{
-		SystemClk = 16000000;
-	}
-	else if( clksrc == 1 ) //HSE oscillator used as the system clock
-	{
-		SystemClk = 8000000;
-	}
-	else if( clksrc == 2 ) //PLL oscillator used as the system clock
-	{
-		//SystemClk = RCC_GetPLLOutputClk();
-	}
-	else
-		SystemClk = 0;
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetTIMCLK1Val
+
+ 	 * @brief  		- Returns the value (in Hz) of the clock of the timers on the APB1 bus (TIM2-7, TIM12-14)
+
+ 	 * @param 		- none
+ 	 *
+ 	 * @retval 		- Timer clock in Hz
+
+ 	 * @Note		- PCLK1 if the APB1 prescaler is 1, 2 x PCLK1 otherwise (see RM 6.2)
+
+*/
+uint32_t RCC_GetTIMCLK1Val(void)
+{
+	return RCC_GetClocks()->TimClk1;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetTIMCLK2Val
+
+ 	 * @brief  		- Returns the value (in Hz) of the clock of the timers on the APB2 bus (TIM1, TIM8-11)
+
+ 	 * @param 		- none
+ 	 *
+ 	 * @retval 		- Timer clock in Hz
+
+ 	 * @Note		- PCLK2 if the APB2 prescaler is 1, 2 x PCLK2 otherwise (see RM 6.2)
+
+*/
+uint32_t RCC_GetTIMCLK2Val(void)
+{
+	return RCC_GetClocks()->TimClk2;
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetAHBPrescaler
+
+ 	 * @brief  		- Helper API that turns the HPRE bits of RCC_CFGR into a division factor
 
-	//Calculate APB2 speed based off of system clock speed
+ 	 * @param 		- HPRE : @RCC_AHBPrescaler code
 
-	//1. Get AHB Prescaler value
+ 	 * @retval 		- 1 to 512
+
+ 	 * @Note		- none
+
+*/
+static uint16_t RCC_GetAHBPrescaler(uint8_t HPRE)
+{
 	uint16_t AHBPrescaler = 1;
-	uint8_t temp = (( RCC->CFGR >> 4 ) & 0xF);
 
-	if( temp >= 8 )
+	if( HPRE >= 8 )
 	{
 		AHBPrescaler = 2;
-		for( uint8_t i = 9; i <= temp; i++ ) //refer to bits 7:4 in RCC_CFGR for why this exists
+		for( uint8_t i = 9; i <= HPRE; i++ ) //refer to bits 7:4 in RCC_CFGR for why this exists
+		{
+			AHBPrescaler *= 2;
+		}
+
+		if( HPRE >= 12 ) //there is no divide by 32
 		{
 			AHBPrescaler *= 2;
 		}
 	}
 
-	//2. Get the  APB2 prescaler
-	uint8_t APB2Prescaler = 1;
-	temp = (( RCC->CFGR >> 13 ) & 0x7);
+	return AHBPrescaler;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_GetAPBPrescaler
+
+ 	 * @brief  		- Helper API that turns the PPRE1/PPRE2 bits of RCC_CFGR into a division factor
+
+ 	 * @param 		- PPRE : @RCC_APBPrescaler code
+
+ 	 * @retval 		- 1 to 16
 
-	if( temp >= 4 )
+ 	 * @Note		- none
+
+*/
+static uint8_t RCC_GetAPBPrescaler(uint8_t PPRE)
+{
+	uint8_t APBPrescaler = 1;
+
+	if( PPRE >= 4 )
 	{
-		APB2Prescaler = 2;
-		for( uint8_t i = 5; i <= temp; i++ ) //refer to bits 12:10 in RCC_CFGR for why this exists
+		APBPrescaler = 2;
+		for( uint8_t i = 5; i <= PPRE; i++ ) //refer to bits 12:10 and 15:13 in RCC_CFGR for why this exists
 		{
-			APB2Prescaler *= 2;
+			APBPrescaler *= 2;
 		}
 	}
 
+	return APBPrescaler;
+}
+
 
-	//Have everything needed for calculating APB2 bus clock speed that APB2 peripherals are hanging off of
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RCC_SetFlashLatency
 
-	pclk2 = ( (SystemClk / AHBPrescaler) / APB2Prescaler );
+ 	 * @brief  		- Helper API that programs the flash wait states and waits until the new value is in use
 
-	return pclk2;
+ 	 * @param 		- Latency : wait states (0-7)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The RM asks for LATENCY to be read back before the clock is changed
+
+*/
+static void RCC_SetFlashLatency(uint8_t Latency)
+{
+	FLASH->ACR = ( FLASH->ACR & ~( 0x7 << FLASH_ACR_LATENCY_2_0 ) ) | ( Latency << FLASH_ACR_LATENCY_2_0 );
+
+	while( ( ( FLASH->ACR >> FLASH_ACR_LATENCY_2_0 ) & 0x7 ) != Latency )
+	{
+		SIM_POLL();
+	}
 }
 
+/*----------------------------------------------------------------------------------------------------*/
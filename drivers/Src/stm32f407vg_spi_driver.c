@@ -182,6 +182,8 @@ void SPI_DeInit(SPI_RegDef_t *pSPIx)
 */
 uint8_t SPI_GetFlagStatus(SPI_RegDef_t *pSPIx, uint32_t FlagName)
 {
+	SIM_POLL();
+
 	if(	pSPIx->SR & FlagName ) return FLAG_SET;
 	else return FLAG_RESET;
 }
@@ -386,17 +388,17 @@ void SPI_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
 		if(IRQNumber <= 31)
 		{
 			//configure ICER0 register in processor //0 to 31
-			*NVIC_ICER0 |= ( 1 << IRQNumber );
+			*NVIC_ICER0 = ( 1 << IRQNumber );
 		}
 		else if(IRQNumber > 31 && IRQNumber <= 63)
 		{
 			//configure ICER1 register in processor //32 to 63
-			*NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
 		}
 		else if(IRQNumber > 63 && IRQNumber <= 95)
 		{
 			//configure ICER2 register in processor //64 to 95
-			*NVIC_ICER2 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
 		}
 	}
 }
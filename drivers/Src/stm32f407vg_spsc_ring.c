@@ -0,0 +1,139 @@
+/*
+ * stm32f407vg_spsc_ring.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_spsc_ring.h"
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RING_Init
+
+ 	 * @brief  		- API that empties the ring and clears its counters
+
+ 	 * @param 		- *pRingHandle : ring handle
+ 	 * @param 		- *pBuffer : user buffer of Capacity * ItemSize bytes
+ 	 * @param 		- ItemSize : bytes per record
+ 	 * @param 		- Capacity : number of records - power of two
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call before the producer can run (i.e., before its IRQ is enabled)
+
+*/
+void RING_Init(RING_Handle_t *pRingHandle, void *pBuffer, uint16_t ItemSize, uint16_t Capacity)
+{
+	if( ( pBuffer == NULL ) || ( ItemSize == 0 ) || ( Capacity == 0 ) || ( Capacity & ( Capacity - 1 ) ) )
+	{
+		//Indexes are masked, not divided - capacity has to be a power of two. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	memset(pRingHandle, 0, sizeof(*pRingHandle));
+
+	pRingHandle->pBuffer = (uint8_t *) pBuffer;
+	pRingHandle->ItemSize = ItemSize;
+	pRingHandle->Capacity = Capacity;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RING_Put
+
+ 	 * @brief  		- API that copies a record into the ring (producer side)
+
+ 	 * @param 		- *pRingHandle : ring handle
+ 	 * @param 		- *pItem : record of ItemSize bytes
+
+ 	 * @retval 		- @RING_Status
+
+ 	 * @Note		- A full ring drops the new record - records already waiting are never touched by the producer
+
+*/
+uint8_t RING_Put(RING_Handle_t *pRingHandle, const void *pItem)
+{
+	uint32_t Head = pRingHandle->Head;
+	uint32_t Count = Head - pRingHandle->Tail;
+
+	if( Count >= pRingHandle->Capacity )
+	{
+		pRingHandle->Overflows++;
+		return RING_FULL;
+	}
+
+	//1. Fill the slot, then publish it - the consumer must never see the new Head before the record
+	memcpy(&pRingHandle->pBuffer[( Head & ( pRingHandle->Capacity - 1 ) ) * pRingHandle->ItemSize], pItem, pRingHandle->ItemSize);
+
+	MEMORY_BARRIER();
+
+	pRingHandle->Head = Head + 1;
+
+	//2. Fill level statistics
+	if( ( Count + 1 ) > pRingHandle->HighWater )
+	{
+		pRingHandle->HighWater = Count + 1;
+	}
+
+	return RING_OK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RING_Get
+
+ 	 * @brief  		- API that copies the oldest record out of the ring (consumer side)
+
+ 	 * @param 		- *pRingHandle : ring handle
+ 	 * @param 		- *pItem : destination of ItemSize bytes
+
+ 	 * @retval 		- @RING_Status
+
+ 	 * @Note		- none
+
+*/
+uint8_t RING_Get(RING_Handle_t *pRingHandle, void *pItem)
+{
+	uint32_t Tail = pRingHandle->Tail;
+
+	if( pRingHandle->Head == Tail )
+	{
+		return RING_EMPTY;
+	}
+
+	//1. Read the slot only after seeing the Head that published it, then hand the slot back to the producer
+	MEMORY_BARRIER();
+
+	memcpy(pItem, &pRingHandle->pBuffer[( Tail & ( pRingHandle->Capacity - 1 ) ) * pRingHandle->ItemSize], pRingHandle->ItemSize);
+
+	MEMORY_BARRIER();
+
+	pRingHandle->Tail = Tail + 1;
+
+	return RING_OK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- RING_GetCount
+
+ 	 * @brief  		- API that returns the number of records waiting in the ring
+
+ 	 * @param 		- *pRingHandle : ring handle
+
+ 	 * @retval 		- 0 to Capacity
+
+ 	 * @Note		- Snapshot - may already be out of date when it returns if called from neither side
+
+*/
+uint16_t RING_GetCount(RING_Handle_t *pRingHandle)
+{
+	return (uint16_t) ( pRingHandle->Head - pRingHandle->Tail );
+}
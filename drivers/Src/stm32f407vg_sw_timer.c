@@ -0,0 +1,483 @@
+/*
+ * stm32f407vg_sw_timer.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_sw_timer.h"
+
+/*********** Driver-specific helper functions prototype section ***********/
+static void SWT_Link(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer);
+static void SWT_Unlink(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer);
+static uint8_t SWT_NextEvent(SWT_Handle_t *pSWTHandle, uint32_t *pDelta);
+static void SWT_Cascade(SWT_Handle_t *pSWTHandle);
+static void SWT_Expire(SWT_Handle_t *pSWTHandle, uint32_t *pPrimask);
+static void SWT_Program(SWT_Handle_t *pSWTHandle);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Init
+
+ 	 * @brief  		- API that empties the wheel and starts the free-running counter it runs on
+
+ 	 * @param 		- *pSWTHandle : wheel handle, SWT_Config filled in
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The timer may be shared with other compare channel users (i.e., the DS18B20 on TIM5) as long as they
+ 	 * 				- count at the same frequency - call before any of them arms a compare event
+
+*/
+void SWT_Init(SWT_Handle_t *pSWTHandle)
+{
+	SWT_Config_t Config = pSWTHandle->SWT_Config;
+
+	if( ( ( Config.pTIMx != TIM2 ) && ( Config.pTIMx != TIM5 ) ) || ( Config.SWT_Channel < TIM_CHANNEL_1 ) ||
+		( Config.SWT_Channel > TIM_CHANNEL_4 ) || ( Config.SWT_TickFreq == 0 ) )
+	{
+		//Deadlines are absolute 32-bit counts - only the 32-bit timers can be used. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	//1. Empty wheel
+	memset(pSWTHandle, 0, sizeof(*pSWTHandle));
+	pSWTHandle->SWT_Config = Config;
+
+	//2. Time base - nothing armed until the first timer is started
+	TIM2_5_SetFreeRunningInit(Config.pTIMx, Config.SWT_TickFreq);
+	TIM2_5_DisableCompareIT(Config.pTIMx, Config.SWT_Channel);
+
+	pSWTHandle->Now = SWT_GetTime(pSWTHandle);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Start
+
+ 	 * @brief  		- API that (re)starts a one-shot or periodic software timer
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+ 	 * @param 		- *pTimer : timer - re-armed if it is already running
+ 	 * @param 		- Ticks : time to the first callback (1 to SWT_MAX_TICKS)
+ 	 * @param 		- Period : time between the following callbacks, 0 for a one-shot timer
+ 	 * @param 		- pCallback : function called from SWT_IRQHandling
+ 	 * @param 		- *pContext : passed to pCallback
+
+ 	 * @retval 		- @SWT_Status
+
+ 	 * @Note		- O(1): the timer is linked into the slot of its deadline and the compare channel is moved if it is now
+ 	 * 				- the first one. A periodic timer keeps its phase - callbacks that were missed are skipped, not bunched
+
+*/
+uint8_t SWT_Start(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer, uint32_t Ticks, uint32_t Period, SWT_Callback_t pCallback, void *pContext)
+{
+	uint32_t primask;
+
+	if( ( Ticks == 0 ) || ( Ticks > SWT_MAX_TICKS ) || ( Period > SWT_MAX_TICKS ) || ( pCallback == NULL ) )
+	{
+		return SWT_ERROR_RANGE;
+	}
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	if( pTimer->Active )
+	{
+		SWT_Unlink(pSWTHandle, pTimer);
+	}
+
+	//1. Nothing keeps an empty wheel up to date - catch it up before it is used to place the new deadline
+	uint8_t Empty = 1;
+
+	for(uint8_t Level = 0; Level < SWT_LEVELS; Level++)
+	{
+		if( pSWTHandle->Pending[Level] )
+		{
+			Empty = 0;
+			break;
+		}
+	}
+
+	if( Empty )
+	{
+		pSWTHandle->Now = SWT_GetTime(pSWTHandle);
+	}
+
+	//2. Link the timer
+	pTimer->Expires = SWT_GetTime(pSWTHandle) + Ticks;
+	pTimer->Period = Period;
+	pTimer->pCallback = pCallback;
+	pTimer->pContext = pContext;
+
+	SWT_Link(pSWTHandle, pTimer);
+
+	//3. Move the compare channel - from a callback SWT_IRQHandling does it once all timers due have run
+	if( !pSWTHandle->InIRQ )
+	{
+		SWT_Program(pSWTHandle);
+	}
+
+	CRITICAL_SECTION_EXIT(primask);
+
+	return SWT_OK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Cancel
+
+ 	 * @brief  		- API that stops a software timer
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+ 	 * @param 		- *pTimer : timer
+
+ 	 * @retval 		- @SWT_Status
+
+ 	 * @Note		- O(1). The compare channel is left as it is - if it was set for this timer, the interrupt finds nothing
+ 	 * 				- due and moves it to the next deadline
+
+*/
+uint8_t SWT_Cancel(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer)
+{
+	uint32_t primask;
+	uint8_t Status = SWT_INACTIVE;
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	if( pTimer->Active )
+	{
+		SWT_Unlink(pSWTHandle, pTimer);
+		Status = SWT_OK;
+	}
+
+	CRITICAL_SECTION_EXIT(primask);
+
+	return Status;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_IRQHandling
+
+ 	 * @brief  		- API that runs the callbacks of every timer due, then sets the compare channel to the next deadline
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Ignores other events of the timer, so the IRQ can be shared with other users of the time base
+ 	 * 				- Callbacks run at the priority of the timer IRQ with interrupts enabled - keep them short
+
+*/
+void SWT_IRQHandling(SWT_Handle_t *pSWTHandle)
+{
+	TIM2_5_RegDef_t *pTIMx = pSWTHandle->SWT_Config.pTIMx;
+	uint8_t FlagPos = pSWTHandle->SWT_Config.SWT_Channel;
+	uint32_t primask, Delta, Elapsed;
+
+	if( !( pTIMx->DIER & ( 1 << FlagPos ) ) || !TIM2_5_GetFlagStatus(pTIMx, ( 1 << FlagPos ) ) )
+	{
+		return;
+	}
+
+	TIM2_5_ClearFlag(pTIMx, ( 1 << FlagPos ) );
+
+	CRITICAL_SECTION_ENTER(primask);
+	pSWTHandle->InIRQ = 1;
+
+	while( SWT_NextEvent(pSWTHandle, &Delta) )
+	{
+		//1. Next event still ahead - bring the wheel up to the count and wait for it
+		Elapsed = SWT_GetTime(pSWTHandle) - pSWTHandle->Now;
+
+		if( Delta > Elapsed )
+		{
+			pSWTHandle->Now += Elapsed;
+			break;
+		}
+
+		//2. Step to the event - spread the higher level slots reached, then run the timers due
+		pSWTHandle->Now += Delta;
+
+		SWT_Cascade(pSWTHandle);
+		SWT_Expire(pSWTHandle, &primask);
+	}
+
+	pSWTHandle->InIRQ = 0;
+	SWT_Program(pSWTHandle);
+
+	CRITICAL_SECTION_EXIT(primask);
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Link
+
+ 	 * @brief  		- Helper API that adds a timer to the slot of its deadline
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+ 	 * @param 		- *pTimer : timer, Expires set
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The level is set by the highest bit in which the deadline and Now differ, so a timer only moves down
+ 	 * 				- a level when Now reaches its slot. Deadlines already passed go to the current level 0 slot
+
+*/
+static void SWT_Link(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer)
+{
+	uint32_t Diff = pTimer->Expires ^ pSWTHandle->Now;
+	uint8_t Level = 0;
+	uint8_t Slot;
+
+	if( (int32_t) ( pTimer->Expires - pSWTHandle->Now ) <= 0 )
+	{
+		Slot = pSWTHandle->Now & ( SWT_SLOTS - 1 );
+	}
+	else
+	{
+		Level = ( 31 - __builtin_clz(Diff) ) / SWT_LEVEL_BITS;
+		Slot = ( pTimer->Expires >> ( Level * SWT_LEVEL_BITS ) ) & ( SWT_SLOTS - 1 );
+	}
+
+	pTimer->Level = Level;
+	pTimer->Slot = Slot;
+	pTimer->pPrev = NULL;
+	pTimer->pNext = pSWTHandle->pSlots[Level][Slot];
+
+	if( pTimer->pNext != NULL )
+	{
+		pTimer->pNext->pPrev = pTimer;
+	}
+
+	pSWTHandle->pSlots[Level][Slot] = pTimer;
+	pSWTHandle->Pending[Level] |= ( 1ULL << Slot );
+	pTimer->Active = 1;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Unlink
+
+ 	 * @brief  		- Helper API that takes a timer out of its slot
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+ 	 * @param 		- *pTimer : running timer
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+static void SWT_Unlink(SWT_Handle_t *pSWTHandle, SWT_Timer_t *pTimer)
+{
+	if( pTimer->pPrev != NULL )
+	{
+		pTimer->pPrev->pNext = pTimer->pNext;
+	}
+	else
+	{
+		pSWTHandle->pSlots[pTimer->Level][pTimer->Slot] = pTimer->pNext;
+
+		if( pTimer->pNext == NULL )
+		{
+			pSWTHandle->Pending[pTimer->Level] &= ~( 1ULL << pTimer->Slot );
+		}
+	}
+
+	if( pTimer->pNext != NULL )
+	{
+		pTimer->pNext->pPrev = pTimer->pPrev;
+	}
+
+	pTimer->pNext = NULL;
+	pTimer->pPrev = NULL;
+	pTimer->Active = 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_NextEvent
+
+ 	 * @brief  		- Helper API that finds the next time the wheel has work to do - a level 0 slot with timers due, or a
+ 	 * 				- higher level slot to spread over the levels below it
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+ 	 * @param 		- *pDelta : ticks from Now to the event
+
+ 	 * @retval 		- 1 if the wheel holds a timer, 0 if it is empty
+
+ 	 * @Note		- One bit scan per level, whatever the number of timers
+
+*/
+static uint8_t SWT_NextEvent(SWT_Handle_t *pSWTHandle, uint32_t *pDelta)
+{
+	uint32_t Now = pSWTHandle->Now;
+	uint8_t Found = 0;
+
+	for(uint8_t Level = 0; Level < SWT_LEVELS; Level++)
+	{
+		uint64_t Bits = pSWTHandle->Pending[Level];
+
+		if( !Bits )
+		{
+			continue;
+		}
+
+		//1. First slot from the current one on (level 0), or after it (higher levels - the current one was already spread)
+		uint8_t Shift = Level * SWT_LEVEL_BITS;
+		uint8_t Index = ( Now >> Shift ) & ( SWT_SLOTS - 1 );
+		uint64_t Ahead = Bits & ~( ( Level ? ( 2ULL << Index ) : ( 1ULL << Index ) ) - 1 );
+		uint8_t Slot = __builtin_ctzll( Ahead ? Ahead : Bits );
+
+		//2. Start of that slot - a slot behind the current one is only found on the top level, reached when the count wraps
+		uint32_t Base = ( ( Shift + SWT_LEVEL_BITS ) < 32 ) ? ( Now & ~( ( 1UL << ( Shift + SWT_LEVEL_BITS ) ) - 1 ) ) : 0;
+		uint32_t Delta = ( Base + ( (uint32_t) Slot << Shift ) ) - Now;
+
+		if( !Found || ( Delta < *pDelta ) )
+		{
+			*pDelta = Delta;
+			Found = 1;
+		}
+	}
+
+	return Found;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Cascade
+
+ 	 * @brief  		- Helper API that spreads the higher level slots Now has just reached over the levels below them
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Top level first, so a timer can fall through several levels at once
+
+*/
+static void SWT_Cascade(SWT_Handle_t *pSWTHandle)
+{
+	uint32_t Now = pSWTHandle->Now;
+
+	for(uint8_t Level = SWT_LEVELS - 1; Level > 0; Level--)
+	{
+		uint8_t Shift = Level * SWT_LEVEL_BITS;
+		uint8_t Slot = ( Now >> Shift ) & ( SWT_SLOTS - 1 );
+		SWT_Timer_t *pTimer;
+
+		if( Now & ( ( 1UL << Shift ) - 1 ) )
+		{
+			continue;
+		}
+
+		while( ( pTimer = pSWTHandle->pSlots[Level][Slot] ) != NULL )
+		{
+			SWT_Unlink(pSWTHandle, pTimer);
+			SWT_Link(pSWTHandle, pTimer);
+			pSWTHandle->Cascades++;
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Expire
+
+ 	 * @brief  		- Helper API that runs the timers of the current level 0 slot
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+ 	 * @param 		- *pPrimask : interrupt mask saved by SWT_IRQHandling - restored around each callback
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- A periodic timer is linked again before its callback, so the callback can cancel it
+
+*/
+static void SWT_Expire(SWT_Handle_t *pSWTHandle, uint32_t *pPrimask)
+{
+	uint8_t Slot = pSWTHandle->Now & ( SWT_SLOTS - 1 );
+	SWT_Timer_t *pTimer;
+
+	while( ( pTimer = pSWTHandle->pSlots[0][Slot] ) != NULL )
+	{
+		SWT_Callback_t pCallback = pTimer->pCallback;
+		void *pContext = pTimer->pContext;
+		uint32_t Lateness = SWT_GetTime(pSWTHandle) - pTimer->Expires;
+
+		SWT_Unlink(pSWTHandle, pTimer);
+
+		if( (int32_t) Lateness > (int32_t) pSWTHandle->MaxLateness )
+		{
+			pSWTHandle->MaxLateness = Lateness;
+		}
+
+		//1. Next deadline of a periodic timer - whole periods already passed are skipped
+		if( pTimer->Period )
+		{
+			pTimer->Expires += pTimer->Period;
+
+			if( (int32_t) ( pTimer->Expires - pSWTHandle->Now ) <= 0 )
+			{
+				pTimer->Expires += ( ( ( pSWTHandle->Now - pTimer->Expires ) / pTimer->Period ) + 1 ) * pTimer->Period;
+			}
+
+			SWT_Link(pSWTHandle, pTimer);
+		}
+
+		pSWTHandle->Fired++;
+
+		//2. Callback with interrupts as they were on IRQ entry - it may start or cancel timers (this one included)
+		CRITICAL_SECTION_EXIT(*pPrimask);
+		pCallback(pContext);
+		CRITICAL_SECTION_ENTER(*pPrimask);
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SWT_Program
+
+ 	 * @brief  		- Helper API that sets the compare channel to the next event, or turns it off if the wheel is empty
+
+ 	 * @param 		- *pSWTHandle : wheel handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- An event that is already due by the time it is written is raised in software (TIM2_5_SetCompareIT)
+
+*/
+static void SWT_Program(SWT_Handle_t *pSWTHandle)
+{
+	uint32_t Delta;
+
+	if( SWT_NextEvent(pSWTHandle, &Delta) )
+	{
+		TIM2_5_SetCompareIT(pSWTHandle->SWT_Config.pTIMx, pSWTHandle->SWT_Config.SWT_Channel, pSWTHandle->Now + Delta);
+	}
+	else
+	{
+		TIM2_5_DisableCompareIT(pSWTHandle->SWT_Config.pTIMx, pSWTHandle->SWT_Config.SWT_Channel);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,317 @@
+/*
+ * stm32f407vg_telemetry.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_telemetry.h"
+
+/*
+ * CRC-16/CCITT-FALSE, one byte per lookup - 512 bytes of flash instead of 8 shifts per byte
+ */
+static const uint16_t CRC16Table[256] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/*********** Driver-specific helper functions prototype section ***********/
+static uint16_t TLM_COBSEncode(const uint8_t *pIn, uint16_t Len, uint8_t *pOut);
+static uint16_t TLM_COBSDecode(const uint8_t *pIn, uint16_t Len, uint8_t *pOut);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TLM_Init
+
+ 	 * @brief  		- API that restarts the sequence counter of a telemetry stream
+
+ 	 * @param 		- *pTLMHandle : telemetry stream handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void TLM_Init(TLM_Handle_t *pTLMHandle)
+{
+	memset(pTLMHandle, 0, sizeof(*pTLMHandle));
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TLM_EncodeFrame
+
+ 	 * @brief  		- API that builds one COBS framed, CRC protected record ready to be sent
+
+ 	 * @param 		- *pTLMHandle : telemetry stream handle
+ 	 * @param 		- Type : record type
+ 	 * @param 		- Timestamp : time the record refers to
+ 	 * @param 		- *pPayload : record (fixed layout, little endian)
+ 	 * @param 		- PayloadLen : record size (0 to TLM_MAX_PAYLOAD_LEN)
+ 	 * @param 		- *pFrame : destination of at least TLM_MAX_FRAME_LEN bytes
+
+ 	 * @retval 		- bytes in pFrame (0x00 delimiter included), 0 if the record is too long
+
+ 	 * @Note		- Sequence advances even if the caller then fails to send the frame - the receiver counts the gap.
+ 	 * 				- One stream is encoded from one context (or with interrupts masked)
+
+*/
+uint16_t TLM_EncodeFrame(TLM_Handle_t *pTLMHandle, uint8_t Type, uint32_t Timestamp, const void *pPayload, uint8_t PayloadLen, uint8_t *pFrame)
+{
+	uint8_t Raw[TLM_MAX_RAW_LEN];
+	uint16_t RawLen;
+	uint16_t CRC;
+	uint16_t FrameLen;
+
+	if( PayloadLen > TLM_MAX_PAYLOAD_LEN )
+	{
+		return 0;
+	}
+
+	//1. Header, little endian whatever the CPU
+	Raw[0] = Type;
+	Raw[1] = (uint8_t) ( pTLMHandle->Sequence & 0xFF );
+	Raw[2] = (uint8_t) ( pTLMHandle->Sequence >> 8 );
+	Raw[3] = (uint8_t) ( Timestamp & 0xFF );
+	Raw[4] = (uint8_t) ( ( Timestamp >> 8 ) & 0xFF );
+	Raw[5] = (uint8_t) ( ( Timestamp >> 16 ) & 0xFF );
+	Raw[6] = (uint8_t) ( Timestamp >> 24 );
+
+	pTLMHandle->Sequence++;
+
+	//2. Record, then the CRC of everything before it
+	memcpy(&Raw[TLM_HEADER_LEN], pPayload, PayloadLen);
+	RawLen = TLM_HEADER_LEN + PayloadLen;
+
+	CRC = TLM_CRC16(Raw, RawLen);
+	Raw[RawLen++] = (uint8_t) ( CRC & 0xFF );
+	Raw[RawLen++] = (uint8_t) ( CRC >> 8 );
+
+	//3. COBS - no 0x00 left in the frame, so the delimiter can't be confused with data
+	FrameLen = TLM_COBSEncode(Raw, RawLen, pFrame);
+	pFrame[FrameLen++] = 0x00;
+
+	return FrameLen;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TLM_DecodeFrame
+
+ 	 * @brief  		- API that checks and unpacks one received frame
+
+ 	 * @param 		- *pFrame : bytes received between two 0x00 delimiters (delimiters not included)
+ 	 * @param 		- Len : number of bytes
+ 	 * @param 		- *pDecoded : decoded frame
+
+ 	 * @retval 		- @TLM_Status
+
+ 	 * @Note		- pDecoded is only valid when TLM_OK is returned
+
+*/
+uint8_t TLM_DecodeFrame(const uint8_t *pFrame, uint16_t Len, TLM_Frame_t *pDecoded)
+{
+	uint8_t Raw[TLM_MAX_RAW_LEN];
+	uint16_t RawLen;
+	uint16_t CRC;
+
+	//1. A frame can't decode to more than it holds - longer ones are rejected before touching Raw
+	if( ( Len == 0 ) || ( Len > ( TLM_MAX_RAW_LEN + 1 ) ) )
+	{
+		return TLM_ERROR_LEN;
+	}
+
+	RawLen = TLM_COBSDecode(pFrame, Len, Raw);
+
+	if( RawLen == 0xFFFF )
+	{
+		return TLM_ERROR_COBS;
+	}
+
+	if( RawLen < ( TLM_HEADER_LEN + TLM_CRC_LEN ) )
+	{
+		return TLM_ERROR_LEN;
+	}
+
+	//2. CRC of everything but the CRC itself
+	RawLen -= TLM_CRC_LEN;
+	CRC = (uint16_t) Raw[RawLen] | ( (uint16_t) Raw[RawLen + 1] << 8 );
+
+	if( CRC != TLM_CRC16(Raw, RawLen) )
+	{
+		return TLM_ERROR_CRC;
+	}
+
+	//3. Unpack
+	pDecoded->Type = Raw[0];
+	pDecoded->Sequence = (uint16_t) Raw[1] | ( (uint16_t) Raw[2] << 8 );
+	pDecoded->Timestamp = (uint32_t) Raw[3] | ( (uint32_t) Raw[4] << 8 ) | ( (uint32_t) Raw[5] << 16 ) | ( (uint32_t) Raw[6] << 24 );
+	pDecoded->PayloadLen = (uint8_t) ( RawLen - TLM_HEADER_LEN );
+	memcpy(pDecoded->Payload, &Raw[TLM_HEADER_LEN], pDecoded->PayloadLen);
+
+	return TLM_OK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TLM_CRC16
+
+ 	 * @brief  		- API that computes the CRC-16/CCITT-FALSE of a buffer
+
+ 	 * @param 		- *pData : bytes
+ 	 * @param 		- Len : number of bytes
+
+ 	 * @retval 		- CRC (0x29B1 for "123456789")
+
+ 	 * @Note		- none
+
+*/
+uint16_t TLM_CRC16(const uint8_t *pData, uint32_t Len)
+{
+	uint16_t CRC = 0xFFFF;
+
+	while( Len-- )
+	{
+		CRC = (uint16_t) ( CRC << 8 ) ^ CRC16Table[( ( CRC >> 8 ) ^ *pData++ ) & 0xFF];
+	}
+
+	return CRC;
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TLM_COBSEncode
+
+ 	 * @brief  		- Helper API that COBS encodes a buffer of at most 254 bytes
+
+ 	 * @param 		- *pIn : bytes to encode
+ 	 * @param 		- Len : number of bytes (254 at most - one block, so no 0xFF code is ever needed)
+ 	 * @param 		- *pOut : destination of Len + 1 bytes
+
+ 	 * @retval 		- bytes written to pOut (Len + 1)
+
+ 	 * @Note		- Every 0x00 is replaced by the distance to the next one - the first byte is the distance to the first
+
+*/
+static uint16_t TLM_COBSEncode(const uint8_t *pIn, uint16_t Len, uint8_t *pOut)
+{
+	uint16_t CodeIndex = 0;
+	uint16_t OutIndex = 1;
+	uint8_t Code = 1;
+
+	for(uint16_t i = 0; i < Len; i++)
+	{
+		if( pIn[i] == 0x00 )
+		{
+			//Close the current block - its code byte is the distance to this zero
+			pOut[CodeIndex] = Code;
+			CodeIndex = OutIndex++;
+			Code = 1;
+		}
+		else
+		{
+			pOut[OutIndex++] = pIn[i];
+			Code++;
+		}
+	}
+
+	pOut[CodeIndex] = Code;
+
+	return OutIndex;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TLM_COBSDecode
+
+ 	 * @brief  		- Helper API that undoes TLM_COBSEncode
+
+ 	 * @param 		- *pIn : encoded bytes (no delimiter)
+ 	 * @param 		- Len : number of bytes
+ 	 * @param 		- *pOut : destination of Len - 1 bytes
+
+ 	 * @retval 		- bytes written to pOut, 0xFFFF if pIn is not a valid encoding
+
+ 	 * @Note		- none
+
+*/
+static uint16_t TLM_COBSDecode(const uint8_t *pIn, uint16_t Len, uint8_t *pOut)
+{
+	uint16_t InIndex = 0;
+	uint16_t OutIndex = 0;
+
+	while( InIndex < Len )
+	{
+		uint8_t Code = pIn[InIndex++];
+
+		if( ( Code == 0x00 ) || ( ( InIndex + Code - 1 ) > Len ) )
+		{
+			return 0xFFFF;
+		}
+
+		for(uint8_t i = 1; i < Code; i++)
+		{
+			if( pIn[InIndex] == 0x00 )
+			{
+				return 0xFFFF;
+			}
+
+			pOut[OutIndex++] = pIn[InIndex++];
+		}
+
+		//Every block but the last one stood for a zero (blocks are never 0xFF long - see TLM_COBSEncode)
+		if( InIndex < Len )
+		{
+			pOut[OutIndex++] = 0x00;
+		}
+	}
+
+	return OutIndex;
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -7,7 +7,27 @@
 
 #include "stm32f407vg_tim_driver.h"
 
-uint32_t APB1;
+#define TIM_NUM_INSTANCES						4						//TIM2, TIM3, TIM4, TIM5
+
+/*
+ * Time base each timer was last set up with (0 if not used) - re-applied when the APB1 timer clock changes
+ */
+static float TIM_ITFreq[TIM_NUM_INSTANCES];						//TIM2_5_SetIT interrupt frequency
+static uint32_t TIM_TickFreq[TIM_NUM_INSTANCES];				//TIM2_5_SetFreeRunningInit counter frequency
+static TIM_Period_t TIM_ITPeriod[TIM_NUM_INSTANCES];			//TIM2_5_SetPeriodIT interrupt period
+
+/*
+ * Timer clocks per period unit
+ */
+static const uint32_t TIM_UnitDiv[] = { 1000000000U, 1000000U, 1000U };
+
+/*********** Driver-specific helper functions prototype section ***********/
+static uint8_t TIM_GetIndex(TIM2_5_RegDef_t *pTIMx);
+static uint32_t TIM_GetMaxARR(TIM2_5_RegDef_t *pTIMx);
+static void TIM2_5_ApplyPeriod(TIM2_5_RegDef_t *pTIMx, TIM_Period_t *pPeriod);
+static void TIM2_5_ClockChangeHandler(void *pContext);
+
+/********************************************************/
 
 
 /*********************** Function Documentation ***************************************
@@ -32,6 +52,14 @@ void TIM_PeriClockControl(TIM2_5_RegDef_t *pTIMx, uint8_t EnOrDi)
 		{
 			TIM2_PCLK_EN();
 		}
+		else if( (uint32_t) pTIMx == TIM3_BASE_ADDR )
+		{
+			TIM3_PCLK_EN();
+		}
+		else if( (uint32_t) pTIMx == TIM4_BASE_ADDR )
+		{
+			TIM4_PCLK_EN();
+		}
 		else if( (uint32_t) pTIMx == TIM5_BASE_ADDR )
 		{
 			TIM5_PCLK_EN();
@@ -43,6 +71,14 @@ void TIM_PeriClockControl(TIM2_5_RegDef_t *pTIMx, uint8_t EnOrDi)
 		{
 			TIM2_PCLK_DI();
 		}
+		else if( (uint32_t) pTIMx == TIM3_BASE_ADDR )
+		{
+			TIM3_PCLK_DI();
+		}
+		else if( (uint32_t) pTIMx == TIM4_BASE_ADDR )
+		{
+			TIM4_PCLK_DI();
+		}
 		else if( (uint32_t) pTIMx == TIM5_BASE_ADDR )
 		{
 			TIM5_PCLK_DI();
@@ -77,9 +113,6 @@ void TIM2_5_SetDelayInit(TIM2_5_RegDef_t *pTIMx)
 
 	//3. Enable pre-loading of ARR register
 	pTIMx->CR1 &= ~( 1 << TIM2_5_CR1_ARPE );
-
-	//Update global APB1 value every time TIM is initialized
-	APB1 = RCC_GetPCLK1Val();
 }
 
 
@@ -98,6 +131,8 @@ void TIM2_5_SetDelayInit(TIM2_5_RegDef_t *pTIMx)
 */
 uint8_t TIM2_5_GetFlagStatus(TIM2_5_RegDef_t *pTIMx, uint8_t FlagName)
 {
+	SIM_POLL();
+
 	if(	pTIMx->SR & FlagName ) return FLAG_SET;
 	else return FLAG_RESET;
 }
@@ -139,7 +174,7 @@ void TIM2_5_ClearFlag(TIM2_5_RegDef_t *pTIMx, uint8_t FlagName)
 */
 void TIM2_5_Delay(TIM2_5_RegDef_t *pTIMx, float MicroSeconds)
 {
-	//At 16*10^6Hz for TIM timer counter, that translates to 1 increment per 0.0625 microseconds
+	//At 16*10^6Hz for TIM timer counter, that translates to 1 increment per 0.0625 microseconds (84MHz at 168MHz SYSCLK: 0.0119 microseconds)
 	//To translate user argument to TIM roll over register value, need to use simple proportion
 	//Set auto-reload register value (this is the value at which the counter will generate an interrupt and automatically roll over)
 
@@ -147,7 +182,7 @@ void TIM2_5_Delay(TIM2_5_RegDef_t *pTIMx, float MicroSeconds)
 	pTIMx->ARR = RESET;
 	pTIMx->CNT = RESET;
 
-	double RollOverVal = ( ( ( (double) APB1 ) / 1000000 ) * MicroSeconds );
+	float RollOverVal = ( ( ( (float) RCC_GetTIMCLK1Val() ) / 1000000.0f ) * MicroSeconds );
 
 	//2. Write value into ARR register
 	pTIMx->ARR = ( uint32_t ) RollOverVal;
@@ -202,15 +237,15 @@ void TIM2_5_SetIT(TIM2_5_RegDef_t *pTIMx, float freq)
 	//4. Set auto-reload register value (this is the value at which the counter will generate an interrupt and automatically roll over)
 
 	//4.1 Calculate ARR value
-	uint32_t APB1 = RCC_GetPCLK1Val();
-	double RollOverVal = ( ( (double) APB1 ) / freq );		//This has the effect of speeding up or slowing down the rate at which interrupts are generated by the counter overflowing
+	uint32_t APB1 = RCC_GetTIMCLK1Val();
+	float RollOverVal = ( ( (float) APB1 ) / freq );		//This has the effect of speeding up or slowing down the rate at which interrupts are generated by the counter overflowing
 
 
-	//4.2 Check to make sure uint32_t value is valid
-	if( RollOverVal > MAX_UINT32_VAL )
+	//4.2 Check to make sure uint32_t value is valid (MAX_UINT32_VAL rounds up to 2^32 as a float)
+	if( RollOverVal >= (float) MAX_UINT32_VAL )
 	{
 		while(1);	//hang-up program if user requested an invalid number
-		//For APB1 = 16MHz, Freq should not be smaller than 0.00372529
+		//For APB1 = 16MHz, Freq should not be smaller than 0.00372529 (0.01955777 for an 84MHz APB1 timer clock)
 	}
 
 
@@ -218,6 +253,12 @@ void TIM2_5_SetIT(TIM2_5_RegDef_t *pTIMx, float freq)
 	uint32_t temp = RollOverVal;
 	pTIMx->ARR = temp;
 
+	//4.4 Keep the frequency (not the ARR value) - the ARR value is re-calculated when the APB1 timer clock changes
+	TIM_ITFreq[TIM_GetIndex(pTIMx)] = freq;
+	TIM_TickFreq[TIM_GetIndex(pTIMx)] = 0;
+	TIM_ITPeriod[TIM_GetIndex(pTIMx)].Period = 0;
+	RCC_RegisterClockCallback(TIM2_5_ClockChangeHandler, pTIMx);
+
 	//5. Enable the counter to begin counting
 	pTIMx->CR1 |= ( 1 << TIM2_5_CR1_CEN );
 
@@ -226,6 +267,306 @@ void TIM2_5_SetIT(TIM2_5_RegDef_t *pTIMx, float freq)
 
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_SetFreeRunningInit
+
+ 	 * @brief  		- This API configures a timer as a free-running up-counter that increments at TickFreq and rolls over at its
+ 	 * 				- full 32-bit range. The counter is used as a time base for output compare events
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+ 	 * @param  		- TickFreq : Desired counter increment frequency in Hz (i.e., 1000000 for 1 tick per microsecond)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- TickFreq must divide the APB1 timer clock evenly for exact timing
+ 	 * 				- Only TIM2 and TIM5 have a 32-bit counter
+*/
+void TIM2_5_SetFreeRunningInit(TIM2_5_RegDef_t *pTIMx, uint32_t TickFreq)
+{
+	//0. Turn on TIM peripheral
+	TIM_PeriClockControl(pTIMx, ENABLE);
+
+	//1. Stop the counter while the time base is changed
+	pTIMx->CR1 &= ~( 1 << TIM2_5_CR1_CEN );
+
+	//2. Enable update events, disable pre-loading of ARR register
+	pTIMx->CR1 &= ~( ( 1 << TIM2_5_CR1_UDIS ) | ( 1 << TIM2_5_CR1_URS ) | ( 1 << TIM2_5_CR1_ARPE ) );
+
+	//3. Pre-scale the timer clock down to the requested tick frequency and let the counter use its full range
+	pTIMx->PSC = ( RCC_GetTIMCLK1Val() / TickFreq ) - 1;
+	pTIMx->ARR = MAX_UINT32_VAL;
+
+	//4. Generate an update event to latch the pre-scaler (it is buffered), then clear the flag it leaves behind
+	pTIMx->EGR = ( 1 << TIM2_5_EGR_UG );
+	TIM2_5_ClearFlag(pTIMx, TIM_FLAG_UIF);
+
+	//5. Enable the counter to begin counting
+	pTIMx->CR1 |= ( 1 << TIM2_5_CR1_CEN );
+
+	//6. Keep the tick frequency - the pre-scaler is re-calculated when the APB1 timer clock changes
+	TIM_TickFreq[TIM_GetIndex(pTIMx)] = TickFreq;
+	TIM_ITFreq[TIM_GetIndex(pTIMx)] = 0;
+	TIM_ITPeriod[TIM_GetIndex(pTIMx)].Period = 0;
+	RCC_RegisterClockCallback(TIM2_5_ClockChangeHandler, pTIMx);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_ComputePeriod
+
+ 	 * @brief  		- This API turns an integer period into the pre-scaler / auto-reload pair that produces it on a timer, using
+ 	 * 				- the smallest pre-scaler (finest resolution) the counter width allows
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory (TIM2-TIM5, sets the counter width)
+ 	 * @param  		- Period : Desired period in Unit
+ 	 * @param  		- Unit : Possible values from @TIM_Unit
+ 	 * @param  		- *pPeriod : Filled in with the request, the APB1 timer clock and the PSC/ARR pair
+
+ 	 * @retval 		- @TIM_Status
+
+ 	 * @Note		- Integer only - the period is rounded to the nearest counter clock. On an error pPeriod->ARR is 0
+ 	 * 				- Longest period: 65536 x 2^16 timer clocks on TIM3/TIM4 (51.1s at 84MHz), 65536 x 2^32 on TIM2/TIM5
+
+*/
+uint8_t TIM2_5_ComputePeriod(TIM2_5_RegDef_t *pTIMx, uint32_t Period, uint8_t Unit, TIM_Period_t *pPeriod)
+{
+	uint64_t Ticks, Prescaler, Count;
+	uint64_t MaxCount = (uint64_t) TIM_GetMaxARR(pTIMx) + 1;
+
+	pPeriod->Period = Period;
+	pPeriod->Unit = Unit;
+	pPeriod->TimClk = RCC_GetTIMCLK1Val();
+	pPeriod->PSC = 0;
+	pPeriod->ARR = 0;
+
+	if( Unit > TIM_UNIT_MS )
+	{
+		return TIM_ERROR_RANGE;
+	}
+
+	//1. Period in timer clocks (rounded) - a counter needs at least 2 clocks per period (ARR of 0 stops it)
+	Ticks = ( ( (uint64_t) pPeriod->TimClk * Period ) + ( TIM_UnitDiv[Unit] / 2 ) ) / TIM_UnitDiv[Unit];
+
+	if( Ticks < 2 )
+	{
+		return TIM_ERROR_RANGE;
+	}
+
+	//2. Smallest pre-scaler that brings the count within the counter range
+	Prescaler = ( Ticks + MaxCount - 1 ) / MaxCount;
+
+	if( Prescaler > ( (uint64_t) TIM_MAX_PSC + 1 ) )
+	{
+		return TIM_ERROR_RANGE;
+	}
+
+	//3. Counter clocks per period (rounded, kept within the counter range)
+	Count = ( Ticks + ( Prescaler / 2 ) ) / Prescaler;
+
+	if( Count > MaxCount )
+	{
+		Count = MaxCount;
+	}
+	else if( Count < 2 )
+	{
+		Count = 2;
+	}
+
+	pPeriod->PSC = (uint16_t) ( Prescaler - 1 );
+	pPeriod->ARR = (uint32_t) ( Count - 1 );
+
+	return TIM_OK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_SetPeriodIT
+
+ 	 * @brief  		- This API generates an update interrupt every Period, with the pre-scaler and auto-reload value worked out
+ 	 * 				- in integer math
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory (TIM2-TIM5)
+ 	 * @param  		- Period : Desired interrupt period in Unit
+ 	 * @param  		- Unit : Possible values from @TIM_Unit
+
+ 	 * @retval 		- @TIM_Status - the timer is left untouched on an error
+
+ 	 * @Note		- Integer replacement of TIM2_5_SetIT. The period is re-applied when the APB1 timer clock changes
+
+*/
+uint8_t TIM2_5_SetPeriodIT(TIM2_5_RegDef_t *pTIMx, uint32_t Period, uint8_t Unit)
+{
+	TIM_Period_t PeriodCfg;
+	uint8_t Index = TIM_GetIndex(pTIMx);
+
+	//1. Work out the pre-scaler / auto-reload pair first - nothing is touched if the period can't be made
+	if( TIM2_5_ComputePeriod(pTIMx, Period, Unit, &PeriodCfg) != TIM_OK )
+	{
+		return TIM_ERROR_RANGE;
+	}
+
+	//2. Turn on TIM peripheral, stop the counter while the time base is changed
+	TIM_PeriClockControl(pTIMx, ENABLE);
+
+	pTIMx->CR1 &= ~( ( 1 << TIM2_5_CR1_CEN ) | ( 1 << TIM2_5_CR1_UDIS ) | ( 1 << TIM2_5_CR1_ARPE ) );
+
+	//3. Load the time base (restarts the counter from 0 without raising an interrupt)
+	TIM2_5_ApplyPeriod(pTIMx, &PeriodCfg);
+
+	//4. Keep the period (not the register values) - the pair is re-calculated when the APB1 timer clock changes
+	TIM_ITPeriod[Index] = PeriodCfg;
+	TIM_ITFreq[Index] = 0;
+	TIM_TickFreq[Index] = 0;
+	RCC_RegisterClockCallback(TIM2_5_ClockChangeHandler, pTIMx);
+
+	//5. Enable update interrupts and the counter
+	pTIMx->DIER |= ( 1 << TIM2_5_DIER_UIE );
+	pTIMx->CR1 |= ( 1 << TIM2_5_CR1_CEN );
+
+	return TIM_OK;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_DelayPeriod
+
+ 	 * @brief  		- This API blocks for a period worked out beforehand with TIM2_5_ComputePeriod
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory (TIM2-TIM5, turned on with TIM2_5_SetDelayInit)
+ 	 * @param  		- *pPeriod : Pre-scaler / auto-reload pair from TIM2_5_ComputePeriod
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Integer replacement of TIM2_5_Delay - no math on the call, only the register writes. A pair computed for
+ 	 * 				- another APB1 timer clock is re-computed (once, the result is kept in pPeriod)
+ 	 * 				- Returns at once if pPeriod holds no valid pair
+
+*/
+void TIM2_5_DelayPeriod(TIM2_5_RegDef_t *pTIMx, TIM_Period_t *pPeriod)
+{
+	//1. Pair made for another timer clock - bring it up to date
+	if( pPeriod->TimClk != RCC_GetTIMCLK1Val() )
+	{
+		TIM2_5_ComputePeriod(pTIMx, pPeriod->Period, pPeriod->Unit, pPeriod);
+	}
+
+	if( !pPeriod->ARR )
+	{
+		return;
+	}
+
+	//2. Load the time base with the counter stopped
+	pTIMx->CR1 &= ~( 1 << TIM2_5_CR1_CEN );
+	TIM2_5_ApplyPeriod(pTIMx, pPeriod);
+
+	//3. Count one period
+	pTIMx->CR1 |= ( 1 << TIM2_5_CR1_CEN );
+
+	while( !TIM2_5_GetFlagStatus(pTIMx,TIM_FLAG_UIF) )
+		;
+
+	//4. Stop the counter and clear the roll over flag
+	pTIMx->CR1 &= ~( 1 << TIM2_5_CR1_CEN );
+	TIM2_5_ClearFlag(pTIMx,TIM_FLAG_UIF);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_SetCompareIT
+
+ 	 * @brief  		- This API arms a capture/compare channel so that an interrupt is generated when the counter reaches CompareVal
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+ 	 * @param  		- Channel : Capture/compare channel (@TIM_CHANNEL_x macros)
+ 	 * @param  		- CompareVal : Absolute counter value at which the interrupt should fire (i.e., pTIMx->CNT + ticks)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Timer must already be running (see TIM2_5_SetFreeRunningInit). The channel is left in frozen output mode, so the pin is not affected
+ 	 * 				- If CompareVal has already elapsed by the time it is written, the event is generated immediately in software
+*/
+void TIM2_5_SetCompareIT(TIM2_5_RegDef_t *pTIMx, uint8_t Channel, uint32_t CompareVal)
+{
+	uint8_t FlagPos = Channel;		//CCxIF, CCxIE and CCxG share the same bit position in SR, DIER and EGR
+
+	//1. Load the compare value
+	if( Channel == TIM_CHANNEL_1 )
+	{
+		pTIMx->CCR1 = CompareVal;
+	}
+	else if( Channel == TIM_CHANNEL_2 )
+	{
+		pTIMx->CCR2 = CompareVal;
+	}
+	else if( Channel == TIM_CHANNEL_3 )
+	{
+		pTIMx->CCR3 = CompareVal;
+	}
+	else if( Channel == TIM_CHANNEL_4 )
+	{
+		pTIMx->CCR4 = CompareVal;
+	}
+
+	//2. Clear any stale match and enable the channel interrupt
+	TIM2_5_ClearFlag(pTIMx, ( 1 << FlagPos ) );
+	pTIMx->DIER |= ( 1 << FlagPos );
+
+	//3. Counter may have already passed the compare value (short delays at slow clocks) - don't wait a full roll over for it
+	if( ( pTIMx->CNT - CompareVal ) < ( MAX_UINT32_VAL / 2 ) )
+	{
+		pTIMx->EGR = ( 1 << FlagPos );
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_DisableCompareIT
+
+ 	 * @brief  		- This API disables the interrupt of a capture/compare channel and clears its pending flag
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+ 	 * @param  		- Channel : Capture/compare channel (@TIM_CHANNEL_x macros)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+*/
+void TIM2_5_DisableCompareIT(TIM2_5_RegDef_t *pTIMx, uint8_t Channel)
+{
+	pTIMx->DIER &= ~( 1 << Channel );
+	TIM2_5_ClearFlag(pTIMx, ( 1 << Channel ) );
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_MasterModeConfig
+
+ 	 * @brief  		- This API selects the event a timer sends on its trigger output (TRGO)
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+ 	 * @param  		- MasterMode : TRGO source (@TIM_MasterMode macros)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- With TIM_TRGO_UPDATE, every counter roll over of a timer set up by TIM2_5_SetIT also starts a conversion
+ 	 * 				- on an ADC whose external trigger is that timer's TRGO - no CPU involvement, no software jitter
+*/
+void TIM2_5_MasterModeConfig(TIM2_5_RegDef_t *pTIMx, uint8_t MasterMode)
+{
+	TIM_PeriClockControl(pTIMx, ENABLE);
+
+	pTIMx->CR2 &= ~( 0x7 << TIM2_5_CR2_MMS_2_0 );
+	pTIMx->CR2 |= ( ( MasterMode & 0x7 ) << TIM2_5_CR2_MMS_2_0 );
+}
+
+
 /*********************** Function Documentation ***************************************
  *
  	 * @fn			- TIM2_5_IRQInterruptConfig
@@ -266,17 +607,17 @@ void TIM2_5_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
 		if(IRQNumber <= 31)
 		{
 			//configure ICER0 register in processor //0 to 31
-			*NVIC_ICER0 |= ( 1 << IRQNumber );
+			*NVIC_ICER0 = ( 1 << IRQNumber );
 		}
 		else if(IRQNumber > 31 && IRQNumber <= 63)
 		{
 			//configure ICER1 register in processor //32 to 63
-			*NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
 		}
 		else if(IRQNumber > 63 && IRQNumber <= 95)
 		{
 			//configure ICER2 register in processor //64 to 95
-			*NVIC_ICER2 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
 		}
 	}
 }
@@ -334,3 +675,129 @@ void TIM2_5_IRQHandling(TIM2_5_RegDef_t *pTIMx)
 	TIM2_5_ClearFlag(pTIMx, TIM_FLAG_UIF);
 }
 
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM_GetIndex
+
+ 	 * @brief  		- Helper API that returns the slot of a timer in the time base tables
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+
+ 	 * @retval 		- 0 for TIM2, 1 for TIM3, 2 for TIM4, 3 for TIM5
+
+ 	 * @Note		- none
+
+*/
+static uint8_t TIM_GetIndex(TIM2_5_RegDef_t *pTIMx)
+{
+	if( pTIMx == TIM3 ) return 1;
+	else if( pTIMx == TIM4 ) return 2;
+	else if( pTIMx == TIM5 ) return 3;
+	else return 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM_GetMaxARR
+
+ 	 * @brief  		- Helper API that returns the largest auto-reload value of a timer
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+
+ 	 * @retval 		- TIM_MAX_ARR_32BIT for TIM2/TIM5, TIM_MAX_ARR_16BIT for TIM3/TIM4
+
+ 	 * @Note		- none
+
+*/
+static uint32_t TIM_GetMaxARR(TIM2_5_RegDef_t *pTIMx)
+{
+	return ( ( pTIMx == TIM3 ) || ( pTIMx == TIM4 ) ) ? TIM_MAX_ARR_16BIT : TIM_MAX_ARR_32BIT;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_ApplyPeriod
+
+ 	 * @brief  		- Helper API that loads a pre-scaler / auto-reload pair and restarts the counter from 0
+
+ 	 * @param 		- *pTIMx : TIM peripheral base address in MCU memory
+ 	 * @param  		- *pPeriod : Pre-scaler / auto-reload pair
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The pre-scaler is buffered - it is latched with an update event, generated with URS set so that it doesn't
+ 	 * 				- raise UIF (or the update interrupt). URS is left set: only counter roll overs set UIF on this timer
+
+*/
+static void TIM2_5_ApplyPeriod(TIM2_5_RegDef_t *pTIMx, TIM_Period_t *pPeriod)
+{
+	pTIMx->CR1 |= ( 1 << TIM2_5_CR1_URS );
+	pTIMx->PSC = pPeriod->PSC;
+	pTIMx->ARR = pPeriod->ARR;
+	pTIMx->EGR = ( 1 << TIM2_5_EGR_UG );
+	TIM2_5_ClearFlag(pTIMx, TIM_FLAG_UIF);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- TIM2_5_ClockChangeHandler
+
+ 	 * @brief  		- Helper API registered with the RCC driver that re-applies the time base of a timer after the APB1 timer
+ 	 * 				- clock changed
+
+ 	 * @param 		- *pContext : TIM peripheral base address it was registered with
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The new pre-scaler of a free-running timer is loaded with an update event, which restarts the counter
+ 	 * 				- from 0. The count is written back right after it, so compare events armed against it (1-wire time
+ 	 * 				- slots, software timers) stay valid - only the ticks of the change itself are lost
+
+*/
+static void TIM2_5_ClockChangeHandler(void *pContext)
+{
+	TIM2_5_RegDef_t *pTIMx = (TIM2_5_RegDef_t *) pContext;
+	uint8_t Index = TIM_GetIndex(pTIMx);
+	uint32_t TimClk = RCC_GetTIMCLK1Val();
+
+	if( TIM_TickFreq[Index] )
+	{
+		//1. Free-running time base - new pre-scaler, latched without raising UIF, then the count carries on where it was
+		uint32_t Count = pTIMx->CNT;
+
+		pTIMx->PSC = ( TimClk / TIM_TickFreq[Index] ) - 1;
+		pTIMx->CR1 |= ( 1 << TIM2_5_CR1_URS );
+		pTIMx->EGR = ( 1 << TIM2_5_EGR_UG );
+		SIM_POLL();												//Simulator applies EGR on its next step - the count must be written after it
+		pTIMx->CNT = Count;
+		pTIMx->CR1 &= ~( 1 << TIM2_5_CR1_URS );
+	}
+	else if( TIM_ITPeriod[Index].Period )
+	{
+		//2. Integer periodic interrupt - new pre-scaler / auto-reload pair, restarts the period
+		if( TIM2_5_ComputePeriod(pTIMx, TIM_ITPeriod[Index].Period, TIM_ITPeriod[Index].Unit, &TIM_ITPeriod[Index]) == TIM_OK )
+		{
+			TIM2_5_ApplyPeriod(pTIMx, &TIM_ITPeriod[Index]);
+		}
+	}
+	else if( TIM_ITFreq[Index] > 0.0f )
+	{
+		//3. Periodic interrupt - new roll over value (not pre-loaded, takes effect at once)
+		pTIMx->ARR = (uint32_t) ( ( (float) TimClk ) / TIM_ITFreq[Index] );
+
+		if( pTIMx->CNT >= pTIMx->ARR )
+		{
+			pTIMx->CNT = 0;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------*/
@@ -10,6 +10,8 @@
 /* helper function declarations */
 
 static void USART_SetBaudRate(USART_Handle_t *pUSARTHandle);
+static void USART_ClockChangeHandler(void *pContext);
+static void USART_DMAStreamInit(DMA_Handle_t *pDMAHandle);
 
 
 /*
@@ -120,7 +122,7 @@ void USART_Init(USART_Handle_t *pUSARTHandle)
 	{
 		tempreg |= ( 1 << USART_CR1_RE );
 	}
-	else if( pUSARTHandle->USART_Config.USART_Mode == USART_MODE_TXRX )
+	else if( ( pUSARTHandle->USART_Config.USART_Mode == USART_MODE_TXRX ) || ( pUSARTHandle->USART_Config.USART_Mode == USART_MODE_HALF_DUPLEX ) )
 	{
 		tempreg |= ( ( 1 << USART_CR1_TE ) | ( 1 << USART_CR1_RE ) );
 	}
@@ -172,11 +174,20 @@ void USART_Init(USART_Handle_t *pUSARTHandle)
 		tempreg |= ( ( 1 << USART_CR3_CTSE ) | ( 1 << USART_CR3_RTSE ) );
 	}
 
+	//7. Half-duplex - receiver is connected to the TX pin internally (RX pin is free for other uses)
+	if( pUSARTHandle->USART_Config.USART_Mode == USART_MODE_HALF_DUPLEX )
+	{
+		tempreg |= ( 1 << USART_CR3_HDSEL );
+	}
+
 	pUSARTHandle->pUSARTx->CR3 |= tempreg;
 
 
 	/* --------configuration of Baud rate-------- */
 	USART_SetBaudRate(pUSARTHandle);
+
+	//8. Re-calculate the baud rate whenever the bus clock changes
+	RCC_RegisterClockCallback(USART_ClockChangeHandler, pUSARTHandle);
 }
 
 
@@ -372,6 +383,8 @@ void USART_ReceiveData(USART_Handle_t *pUSARTHandle, uint8_t *pRxBuffer, uint32_
  	 * @retval 		- txstate : current state of USART transmission (ongoing or clear?)
 
  	 * @Note		- This function call is non-blocking
+ 	 * 				- If the handle has a Tx DMA stream (pDMATxHandle), the bytes are moved by DMA (USART_CR3_DMAT) instead of
+ 	 * 				- one TxE interrupt each - Len is then limited to 0xFFFF and the stream's IRQ handler must call USART_DMA_TxIRQHandling
 */
 uint8_t USART_SendDataIT(USART_Handle_t *pUSARTHandle,uint8_t *pTxBuffer, uint32_t Len)
 {
@@ -383,6 +396,26 @@ uint8_t USART_SendDataIT(USART_Handle_t *pUSARTHandle,uint8_t *pTxBuffer, uint32
 		pUSARTHandle->pTxBuffer = pTxBuffer;
 		pUSARTHandle->TxBusyState = USART_BUSY_IN_TX;
 
+		if( pUSARTHandle->pDMATxHandle != NULL )
+		{
+			if( ( Len == 0 ) || ( Len > 0xFFFF ) )
+			{
+				//A length NDTR cannot hold. If invalid, enter into an infinite loop.
+				while(1);
+			}
+
+			//1. TC is only looked at once DMA has handed over the last byte - clear what the previous transmission left
+			USART_ClearFlag(pUSARTHandle->pUSARTx, USART_SR_TC);
+
+			//2. Arm the stream (memory to DR), then let TxE raise DMA requests. TxLen is only cleared by the DMA transfer complete interrupt
+			USART_DMAStreamInit(pUSARTHandle->pDMATxHandle);
+			DMA_StartTransfer(pUSARTHandle->pDMATxHandle, (uint32_t) &( pUSARTHandle->pUSARTx->DR ), (uint32_t) pTxBuffer, (uint16_t) Len);
+
+			pUSARTHandle->pUSARTx->CR3 |= ( 1 << USART_CR3_DMAT );
+
+			return txstate;
+		}
+
 		//Enable interrupt for TxE
 		pUSARTHandle->pUSARTx->CR1 |= ( 1 << USART_CR1_TXEIE );
 
@@ -469,17 +502,17 @@ void USART_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnOrDi)
 		if(IRQNumber <= 31)
 		{
 			//configure ICER0 register in processor //0 to 31
-			*NVIC_ICER0 |= ( 1 << IRQNumber );
+			*NVIC_ICER0 = ( 1 << IRQNumber );
 		}
 		else if(IRQNumber > 31 && IRQNumber <= 63)
 		{
 			//configure ICER1 register in processor //32 to 63
-			*NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER1 = ( 1 << (IRQNumber % 32) );
 		}
 		else if(IRQNumber > 63 && IRQNumber <= 95)
 		{
 			//configure ICER2 register in processor //64 to 95
-			*NVIC_ICER2 |= ( 1 << (IRQNumber % 32) );
+			*NVIC_ICER2 = ( 1 << (IRQNumber % 32) );
 		}
 	}
 }
@@ -842,6 +875,49 @@ void USART_IRQHandling(USART_Handle_t *pUSARTHandle)
 
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_DMA_TxIRQHandling
+
+ 	 * @brief  		- API that handles the interrupt of the DMA stream used by USART_SendDataIT
+
+ 	 * @param 		- *pUSARTHandle : contains USART peripheral base address in MCU memory and the Tx DMA stream
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call from the Tx stream's IRQ handler. Transfer complete only means the last byte is in DR - the
+ 	 * 				- transmission is closed (USART_EVENT_TX_COMPLETE) by the TC interrupt once it has left the shift register
+*/
+void USART_DMA_TxIRQHandling(USART_Handle_t *pUSARTHandle)
+{
+	DMA_Handle_t *pDMAHandle = pUSARTHandle->pDMATxHandle;
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TEIF) || DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_DMEIF) )
+	{
+		//1. Transfer or direct mode error - stream is disabled by hardware, abandon the transmission
+		DMA_ClearFlag(pDMAHandle, ( DMA_FLAG_TEIF | DMA_FLAG_DMEIF ) );
+
+		pUSARTHandle->pUSARTx->CR3 &= ~( 1 << USART_CR3_DMAT );
+		pUSARTHandle->TxBusyState = USART_READY;
+		pUSARTHandle->TxLen = 0;
+		pUSARTHandle->pTxBuffer = NULL;
+
+		USART_ApplicationEventCallBack(pUSARTHandle, USART_ERROR_DMA);
+	}
+
+	if( DMA_GetFlagStatus(pDMAHandle, DMA_FLAG_TCIF) )
+	{
+		//2. Every byte has been handed to the peripheral - stop DMA requests and let the TC interrupt close the transmission
+		DMA_ClearFlag(pDMAHandle, DMA_FLAG_TCIF);
+
+		pUSARTHandle->pUSARTx->CR3 &= ~( 1 << USART_CR3_DMAT );
+		pUSARTHandle->TxLen = 0;
+
+		pUSARTHandle->pUSARTx->CR1 |= ( 1 << USART_CR1_TCIE );
+	}
+}
+
+
 /*********************** Function Documentation ***************************************
  *
  	 * @fn			- USART_PeripheralControl
@@ -872,6 +948,29 @@ void USART_PeripheralControl(USART_RegDef_t *pUSARTx, uint8_t EnOrDi)
 }
 
 
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_SetBaud
+
+ 	 * @brief  		- API that changes the baud rate of an initialized USART peripheral
+
+ 	 * @param 		- *pUSARTHandle : contains USART peripheral base address in MCU memory
+ 	 * @param 		- Baud : new baud rate - possible values from @USART_Baud, or any other rate the bus clock can make
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Only call with the line idle (TC set, nothing being received) - a frame under way is garbled.
+ 	 * 				- The new rate is kept across bus clock changes like the one USART_Init was called with
+
+*/
+void USART_SetBaud(USART_Handle_t *pUSARTHandle, uint32_t Baud)
+{
+	pUSARTHandle->USART_Config.USART_Baud = Baud;
+
+	USART_SetBaudRate(pUSARTHandle);
+}
+
+
 /*********************** Function Documentation ***************************************
  *
  	 * @fn			- USART_GetFlagStatus
@@ -889,6 +988,8 @@ void USART_PeripheralControl(USART_RegDef_t *pUSARTx, uint8_t EnOrDi)
 */
 uint8_t USART_GetFlagStatus(USART_RegDef_t *pUSARTx , uint32_t FlagName)
 {
+	SIM_POLL();
+
 	if( pUSARTx->SR & FlagName ) return FLAG_SET;
 	else return FLAG_RESET;
 }
@@ -1046,3 +1147,37 @@ static void USART_SetBaudRate(USART_Handle_t *pUSARTHandle)
 	pUSARTHandle->pUSARTx->BRR = temp;
 }
 
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_ClockChangeHandler
+
+ 	 * @brief  		- Helper function registered with the RCC driver that re-calculates USART_BRR after a bus clock change
+
+ 	 * @param 		- *pContext : USART handle it was registered with by USART_Init
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- A frame on the line while the clock changes is lost either way
+
+*/
+static void USART_ClockChangeHandler(void *pContext)
+{
+	USART_SetBaudRate( (USART_Handle_t *) pContext );
+}
+
+
+
+static void USART_DMAStreamInit(DMA_Handle_t *pDMAHandle)
+{
+	//One byte per DMA request, buffer side incrementing, DR fixed. Direct mode - TxE requests are single bytes
+	pDMAHandle->DMA_Config.DMA_Direction = DMA_DIR_MEM_TO_PERIPH;
+	pDMAHandle->DMA_Config.DMA_Mode = DMA_MODE_NORMAL;
+	pDMAHandle->DMA_Config.DMA_PeriphDataSize = DMA_DATA_SIZE_BYTE;
+	pDMAHandle->DMA_Config.DMA_MemDataSize = DMA_DATA_SIZE_BYTE;
+	pDMAHandle->DMA_Config.DMA_PeriphInc = DMA_INC_DISABLE;
+	pDMAHandle->DMA_Config.DMA_MemInc = DMA_INC_ENABLE;
+	pDMAHandle->DMA_Config.DMA_FIFOMode = DMA_FIFO_DISABLE;
+
+	DMA_Init(pDMAHandle);
+}
@@ -0,0 +1,326 @@
+/*
+ * stm32f407vg_usart_log.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include "stm32f407vg_usart_log.h"
+
+static USART_LOG_Handle_t *pStdoutLog = NULL;					//Log fed by _write (printf), NULL until USART_LOG_SetStdout
+
+/*********** Driver-specific helper functions prototype section ***********/
+static void USART_LOG_Copy(USART_LOG_Handle_t *pLogHandle, const uint8_t *pData, uint32_t Len);
+static void USART_LOG_StartNext(USART_LOG_Handle_t *pLogHandle);
+
+/********************************************************/
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_Init
+
+ 	 * @brief  		- API that empties the log and enables the USART it is sent on
+
+ 	 * @param 		- *pLogHandle : log handle
+ 	 * @param 		- *pUSARTHandle : USART peripheral handle, already initialized with USART_Init and with pDMATxHandle set
+ 	 * @param 		- Policy : @USART_LOG_Policy - what a write does when the buffer is full
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The USARTx IRQ and the Tx DMA stream IRQ must be enabled, with their handlers calling USART_IRQHandling /
+ 	 * 				- USART_DMA_TxIRQHandling. Give them a priority below the sampling ISRs - they only move text
+
+*/
+void USART_LOG_Init(USART_LOG_Handle_t *pLogHandle, USART_Handle_t *pUSARTHandle, uint8_t Policy)
+{
+	if( ( Policy > USART_LOG_POLICY_BLOCK ) || ( pUSARTHandle->pDMATxHandle == NULL ) )
+	{
+		//Invalid policy, or no DMA stream to drain the buffer with. If invalid, enter into an infinite loop.
+		while(1);
+	}
+
+	memset(pLogHandle, 0, sizeof(*pLogHandle));
+
+	pLogHandle->pUSARTHandle = pUSARTHandle;
+	pLogHandle->Policy = Policy;
+
+	USART_PeripheralControl(pUSARTHandle->pUSARTx, ENABLE);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_SetStdout
+
+ 	 * @brief  		- API that selects the log printf (_write in syscalls.c) writes to
+
+ 	 * @param 		- *pLogHandle : log handle, already initialized with USART_LOG_Init (NULL discards stdout)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void USART_LOG_SetStdout(USART_LOG_Handle_t *pLogHandle)
+{
+	pStdoutLog = pLogHandle;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_GetStdout
+
+ 	 * @brief  		- API that returns the log printf writes to
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- log handle, or NULL if none has been selected
+
+ 	 * @Note		- none
+
+*/
+USART_LOG_Handle_t *USART_LOG_GetStdout(void)
+{
+	return pStdoutLog;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_Write
+
+ 	 * @brief  		- API that copies bytes into the log and starts the DMA if the USART is idle
+
+ 	 * @param 		- *pLogHandle : log handle
+ 	 * @param 		- *pData : bytes to send
+ 	 * @param 		- Len : number of bytes
+
+ 	 * @retval 		- @USART_LOG_Status
+
+ 	 * @Note		- DROP (and BLOCK from an ISR): the write goes in whole or is counted in Dropped - it never waits, so it
+ 	 * 				- can be called from an ISR of any priority. The buffer is updated with interrupts masked for the copy only
+ 	 * 				- BLOCK from thread mode: the write is copied as space frees up - ISR writes may land in between
+
+*/
+uint8_t USART_LOG_Write(USART_LOG_Handle_t *pLogHandle, const uint8_t *pData, uint32_t Len)
+{
+	uint32_t primask;
+	uint32_t Free;
+
+	if( Len == 0 )
+	{
+		return USART_LOG_WRITTEN;
+	}
+
+	//1. Caller allowed to wait - take whatever room there is, the USART / DMA interrupts make more
+	if( ( pLogHandle->Policy == USART_LOG_POLICY_BLOCK ) && !CPU_IN_HANDLER_MODE() && !CPU_IRQ_MASKED() )
+	{
+		while( Len > 0 )
+		{
+			CRITICAL_SECTION_ENTER(primask);
+
+			Free = USART_LOG_BUFFER_SIZE - ( pLogHandle->Head - pLogHandle->Tail );
+
+			if( Free > Len )
+			{
+				Free = Len;
+			}
+
+			USART_LOG_Copy(pLogHandle, pData, Free);
+
+			CRITICAL_SECTION_EXIT(primask);
+
+			pData += Free;
+			Len -= Free;
+
+			if( Len > 0 )
+			{
+				//Buffer full - wait for the DMA to free some space
+				SIM_POLL();
+			}
+		}
+
+		return USART_LOG_WRITTEN;
+	}
+
+	//2. Everyone else - all or nothing, so the log never holds half a line
+	CRITICAL_SECTION_ENTER(primask);
+
+	Free = USART_LOG_BUFFER_SIZE - ( pLogHandle->Head - pLogHandle->Tail );
+
+	if( Len > Free )
+	{
+		pLogHandle->Dropped += Len;
+		CRITICAL_SECTION_EXIT(primask);
+
+		return USART_LOG_DROPPED;
+	}
+
+	USART_LOG_Copy(pLogHandle, pData, Len);
+
+	CRITICAL_SECTION_EXIT(primask);
+
+	return USART_LOG_WRITTEN;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_EventHandling
+
+ 	 * @brief  		- API that retires the bytes the DMA has sent and starts the next transfer
+
+ 	 * @param 		- *pLogHandle : log handle
+ 	 * @param 		- AppEvent : event passed to USART_ApplicationEventCallBack
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Call from USART_ApplicationEventCallBack for the log's USART. Bytes hit by a DMA error are abandoned
+ 	 * 				- and counted in Errors - they are not retried
+
+*/
+void USART_LOG_EventHandling(USART_LOG_Handle_t *pLogHandle, uint8_t AppEvent)
+{
+	uint32_t primask;
+
+	if( !pLogHandle->InFlight )
+	{
+		//Event does not belong to a log transfer (i.e., reception events)
+		return;
+	}
+
+	CRITICAL_SECTION_ENTER(primask);
+
+	if( ( AppEvent == USART_EVENT_TX_COMPLETE ) || ( AppEvent == USART_ERROR_DMA ) )
+	{
+		//Driver already closed the transmission - the bytes can be reused
+		if( AppEvent == USART_ERROR_DMA )
+		{
+			pLogHandle->Errors += pLogHandle->InFlight;
+		}
+
+		pLogHandle->Tail += pLogHandle->InFlight;
+		pLogHandle->InFlight = 0;
+
+		USART_LOG_StartNext(pLogHandle);
+	}
+
+	CRITICAL_SECTION_EXIT(primask);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_GetCount
+
+ 	 * @brief  		- API that returns the number of bytes not yet sent (including the ones the DMA is sending)
+
+ 	 * @param 		- *pLogHandle : log handle
+
+ 	 * @retval 		- bytes in the log
+
+ 	 * @Note		- none
+
+*/
+uint16_t USART_LOG_GetCount(USART_LOG_Handle_t *pLogHandle)
+{
+	return (uint16_t) ( pLogHandle->Head - pLogHandle->Tail );
+}
+
+
+
+/*-------------------- Driver-specific helper functions definition section --------------------*/
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_Copy
+
+ 	 * @brief  		- Helper API that appends bytes at the head of the buffer and kicks the DMA if the USART is idle
+
+ 	 * @param 		- *pLogHandle : log handle
+ 	 * @param 		- *pData : bytes to append
+ 	 * @param 		- Len : number of bytes - no more than the free space
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called with interrupts masked
+
+*/
+static void USART_LOG_Copy(USART_LOG_Handle_t *pLogHandle, const uint8_t *pData, uint32_t Len)
+{
+	uint32_t Offset = pLogHandle->Head & ( USART_LOG_BUFFER_SIZE - 1 );
+	uint32_t First = USART_LOG_BUFFER_SIZE - Offset;
+	uint32_t Count;
+
+	if( Len == 0 )
+	{
+		return;
+	}
+
+	//1. Up to the end of the buffer, then the rest from the start
+	if( First > Len )
+	{
+		First = Len;
+	}
+
+	memcpy(&pLogHandle->Buffer[Offset], pData, First);
+	memcpy(pLogHandle->Buffer, &pData[First], Len - First);
+
+	pLogHandle->Head += Len;
+
+	//2. Fill level statistics
+	Count = pLogHandle->Head - pLogHandle->Tail;
+
+	if( Count > pLogHandle->HighWater )
+	{
+		pLogHandle->HighWater = (uint16_t) Count;
+	}
+
+	//3. Kick the USART if nothing is being sent - otherwise the transmission complete event starts it
+	if( !pLogHandle->InFlight )
+	{
+		USART_LOG_StartNext(pLogHandle);
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- USART_LOG_StartNext
+
+ 	 * @brief  		- Helper API that hands the oldest unsent bytes to the USART Tx DMA, if there are any
+
+ 	 * @param 		- *pLogHandle : log handle
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called with interrupts masked. One transfer never wraps - bytes past the end of the buffer go in the next one
+
+*/
+static void USART_LOG_StartNext(USART_LOG_Handle_t *pLogHandle)
+{
+	uint32_t Count = pLogHandle->Head - pLogHandle->Tail;
+	uint32_t Offset = pLogHandle->Tail & ( USART_LOG_BUFFER_SIZE - 1 );
+
+	if( Count == 0 )
+	{
+		return;
+	}
+
+	if( Count > ( USART_LOG_BUFFER_SIZE - Offset ) )
+	{
+		Count = USART_LOG_BUFFER_SIZE - Offset;
+	}
+
+	if( USART_SendDataIT(pLogHandle->pUSARTHandle, &pLogHandle->Buffer[Offset], Count) == USART_READY )
+	{
+		pLogHandle->InFlight = (uint16_t) Count;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------*/
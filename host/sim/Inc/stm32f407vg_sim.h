@@ -0,0 +1,101 @@
+/*
+ * stm32f407vg_sim.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_SIM_H_
+#define INC_STM32F407VG_SIM_H_
+
+/*
+ * Host simulator of the STM32F407VG peripherals used by the drivers
+ *
+ * 		The drivers are built unchanged against the register file in stm32f407vg_sim_regs.h. Time advances in steps of
+ * 		SIM_USECS_PER_STEP and every step runs small behavioural models of the peripherals on top of the plain memory:
+ *
+ * 		- RCC		: ready flags follow their enable bits, SWS follows SW. Timers, DWT and the ADC are clocked at the rates the
+ * 					  clock tree (SWS, PLLCFGR, HPRE/PPRE1/PPRE2) gives - 16MHz HSI on all buses out of reset
+ * 		- GPIO		: BSRR, IDR from ODR (outputs, open-drain wired-AND) or the external pin level set with SIM_GPIOSetInput
+ * 		- TIM2-TIM5	: prescaler, CNT, ARR roll over (UIF), compare (CCxIF), EGR and TRGO (update) to the ADC. TIM3/TIM4
+ * 					  have 16-bit counters
+ * 		- ADC1-3	: SWSTART or external trigger, regular sequence (single/scan/continuous), EOC/STRT/AWD, DMA requests.
+ * 					  Conversion time follows ADCPRE and SMPRx. Input counts are set with SIM_ADCSetInput. Multi ADC modes
+ * 					  (CCR MULTI): the ADC1 trigger starts the slaves too, ADC_CDR requests (DMA mode 1/2) once every ADC
+ * 					  has converted. Interleaved modes convert at the same instant - their delay is shorter than a step
+ * 		- DMA1/DMA2	: peripheral to memory and memory to peripheral requests, memory to memory, NDTR, circular, HTIF/TCIF, IFCR
+ * 		- I2C1-3	: master START/SB, address/ADDR (or AF with SIM_I2CSetNack), TXE/BTF, RXNE, STOP. Bytes are logged per frame
+ * 		- USARTx	: TXE/TC always set, bytes written to DR are logged
+ * 		- NVIC		: ISER/ICER/IPR - pending and enabled IRQs are dispatched to the application's xxx_IRQHandler functions
+ * 		- RTC		: clocked by the LSI (SIM_LSI_FREQ) - INIT/INITF, PRER, SSR and TR (24h BCD), wakeup timer (WUTR, WUCKSEL
+ * 					  0-3, WUTE/WUTWF/WUTF). EXTI line 22 (RTC_WKUP_IRQHandler) follows WUTF
+ * 		- WFI		: Sleep runs every model until an enabled IRQ is pending. STOP (SLEEPDEEP) only advances time and the RTC,
+ * 					  then wakes up on the HSI with the HSE and the PLLs off
+ * 		- DWT		: CYCCNT counts HCLK cycles once enabled
+ * 		- 1-wire	: open-drain bus with virtual DS18B20 devices on a GPIO pin (stm32f407vg_sim_onewire.h)
+ *
+ * 		Models run from SIM_Step and from SIM_Poll, which the drivers call (through SIM_POLL()) while they wait on a flag.
+ * 		ISRs run to completion, one call per pending IRQ per step in NVIC priority order, and are never nested. Inside an
+ * 		ISR a poll only advances time (timers, DWT, GPIO) - the rest of the peripherals wait for the ISR to return.
+ *
+ * 		NOTE: Register writes can not be trapped, so write-only/self-clearing bits (START, STOP, SWSTART, EGR, BSRR, IFCR,
+ * 			  ICER) take effect on the next step, and EXTI_PR is a level (set while its source flag is). Reads can not be
+ * 			  trapped either: ADDR clears itself one step after it is set, EOC of the ADC is cleared when the next
+ * 			  conversion starts, and DR of I2C/USART holds SIM_DR_EMPTY until the driver writes a byte into it
+ */
+
+#include "stm32f407vg.h"
+
+#define SIM_USECS_PER_STEP						1
+#define SIM_LSI_FREQ							31000U					//Simulated LSI - off the nominal 32kHz, like a real one
+
+#define SIM_DR_EMPTY							0xFFFFFFFFU				//DR content the models read as "nothing written"
+
+#define SIM_I2C_MAX_FRAMES						16						//Frames kept per I2C peripheral (oldest are overwritten)
+#define SIM_I2C_MAX_FRAME_LEN					32
+#define SIM_USART_LOG_LEN						1024					//Bytes kept per USART peripheral (oldest are overwritten)
+
+/*
+ * This is a frame seen on the bus of a simulated I2C master (START ... STOP, or a repeated START)
+ */
+
+typedef struct
+{
+	uint8_t 		Address;									/* Address byte (7 bit address << 1 | R/W) */
+	uint8_t 		Nacked;										/* 1 if the address was not acknowledged */
+	uint8_t 		Len;										/* Number of bytes sent (write) or received (read) after the address */
+	uint8_t 		Data[SIM_I2C_MAX_FRAME_LEN];				/* Bytes after the address */
+}SIM_I2CFrame_t;
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by the simulator
+ **********************************************************************************************************************/
+
+/*
+ * Reset and time
+ */
+void SIM_Reset(void);
+void SIM_Step(void);
+void SIM_RunUsecs(uint32_t MicroSeconds);
+uint64_t SIM_GetTimeUsecs(void);
+
+/*
+ * Stimulus
+ */
+void SIM_GPIOSetInput(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber, uint8_t Level);
+void SIM_ADCSetInput(uint8_t Channel, uint16_t Counts);
+void SIM_I2CSetNack(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr);
+void SIM_I2CSetRxData(I2C_RegDef_t *pI2Cx, const uint8_t *pData, uint8_t Len);
+
+/*
+ * Observation
+ */
+uint32_t SIM_I2CGetFrameCount(I2C_RegDef_t *pI2Cx);
+const SIM_I2CFrame_t *SIM_I2CGetFrame(I2C_RegDef_t *pI2Cx, uint32_t Index);
+uint32_t SIM_USARTGetTxCount(USART_RegDef_t *pUSARTx);
+uint8_t SIM_USARTGetTxByte(USART_RegDef_t *pUSARTx, uint32_t Index);
+uint32_t SIM_GetIRQCount(uint8_t IRQNumber);
+
+#endif /* INC_STM32F407VG_SIM_H_ */
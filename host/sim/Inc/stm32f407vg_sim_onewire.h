@@ -0,0 +1,137 @@
+/*
+ * stm32f407vg_sim_onewire.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_SIM_ONEWIRE_H_
+#define INC_STM32F407VG_SIM_ONEWIRE_H_
+
+/*
+ * Host model of an open-drain 1-wire bus with virtual DS18B20 devices - part of the simulator in stm32f407vg_sim.c
+ *
+ * 		The bus hangs off one GPIO pin (SIM_OneWireAttach). Every free-running step the model looks at what the master
+ * 		does with the pin (output mode with ODR 0 pulls the bus low, anything else releases it), runs each device and
+ * 		drives the external level of the pin with the wired-AND of the devices - the GPIO model adds the master's side.
+ * 		ds18b20_temp_sensor.c runs against it unchanged, blocking or interrupt driven.
+ *
+ * 		- Reset		: bus low for SIM_OW_RESET_DETECT_USECS or more. Devices answer SIM_OW_PRESENCE_WAIT_USECS after the
+ * 					  release with a SIM_OW_PRESENCE_USECS presence pulse
+ * 		- Slots		: a device writing a '0' holds the bus low for SIM_OW_TX_ZERO_USECS from the master's falling edge, a
+ * 					  device reading samples the bus SIM_OW_SAMPLE_USECS after it
+ * 		- ROM		: Read ROM, Match ROM, Skip ROM, Search ROM and Alarm Search (T >= TH or T <= TL after the last conversion)
+ * 		- Function	: Convert T (read slots return 0 until done), Read / Write / Copy Scratchpad, Recall E2, Read Power
+ * 					  Supply. The temperature register follows the configured resolution - undefined low bits read 1
+ *
+ * 		The master side is checked against the data sheet timing (reset and presence phase, tLOW0 / tLOW1, tSLOT) and
+ * 		every reset starts a transaction that is logged with its latency - reset pulse to the end of its last time slot.
+ * 		Bus utilization is the share of time spent inside transactions.
+ *
+ * 		NOTE: Only the GPIO transport is modelled - the simulated USARTs don't receive (DS18B20_TRANSPORT_USART gets no echo)
+ */
+
+#include "stm32f407vg.h"
+
+#define SIM_OW_MAX_DEVICES						8
+#define SIM_OW_LOG_LEN							64						//Transactions kept (oldest are overwritten)
+
+/*
+ * Device side timing (DS18B20 data sheet, typical values within the limits)
+ */
+#define SIM_OW_RESET_DETECT_USECS				440						//Bus low at least this long is a reset - less than tRSTL min. (480us)
+#define SIM_OW_PRESENCE_WAIT_USECS				30						//tPDHIGH: 15-60us
+#define SIM_OW_PRESENCE_USECS					120						//tPDLOW: 60-240us
+#define SIM_OW_SAMPLE_USECS						30						//Write slots are sampled 15-60us after the falling edge
+#define SIM_OW_TX_ZERO_USECS					30						//A '0' is held past tRDV (15us)
+#define SIM_OW_SHORT_ZERO_USECS					5						//SIM_OW_FAULT_SHORT_ZERO - released before the master samples
+#define SIM_OW_CONV_USECS						600000					//12-bit conversion - faster than tCONV max. (750ms), halved per bit less
+#define SIM_OW_COPY_USECS						2000					//E2 write (tWR max. 10ms)
+#define SIM_OW_RECALL_USECS						100
+#define SIM_OW_IDLE_USECS						600						//Bus released this long ends the transaction under way
+
+/*
+ * Master side timing checked by the model (DS18B20 data sheet)
+ */
+#define SIM_OW_MIN_RSTL_USECS					480						//Reset pulse
+#define SIM_OW_MIN_RSTH_USECS					480						//Master Rx phase - release to the first time slot
+#define SIM_OW_MAX_LOW1_USECS					15						//Write '1' / read slot initiation
+#define SIM_OW_MIN_LOW0_USECS					60						//Write '0'
+#define SIM_OW_MAX_LOW0_USECS					120
+#define SIM_OW_MIN_SLOT_USECS					61						//tSLOT (60us) plus tREC (1us) - falling edge to falling edge
+
+/*
+ * @SIM_OW_Fault
+ * Faults SIM_OneWireInjectFault can make a device show
+ */
+
+#define SIM_OW_FAULT_NO_PRESENCE				0						//Count resets are not answered - the device stays off the bus until the next one
+#define SIM_OW_FAULT_BIT_ERROR					1						//Count bytes sent (ROM code, scratch pad) have their LSB inverted
+#define SIM_OW_FAULT_SHORT_ZERO					2						//Count '0' bits sent are released after SIM_OW_SHORT_ZERO_USECS (timing violation)
+
+/*
+ * This is one transaction seen on the bus (reset pulse up to the next reset or an idle bus)
+ */
+
+typedef struct
+{
+	uint64_t 		StartUsecs;									/* Falling edge of the reset pulse */
+	uint32_t 		Usecs;										/* Reset pulse to the end of the last time slot */
+	uint16_t 		Slots;										/* Time slots after the reset */
+	uint8_t 		Presence;									/* 1 if a device answered the reset */
+	uint8_t 		Command[2];									/* First two bytes on the bus (a read slot counts as a '1') */
+}SIM_OWTransaction_t;
+
+/*
+ * Bus statistics since SIM_OneWireAttach / SIM_OneWireClearStats
+ */
+
+typedef struct
+{
+	uint64_t 		StartUsecs;									/* Start of the statistics period */
+	uint64_t 		BusyUsecs;									/* Time inside transactions */
+	uint32_t 		Transactions;
+	uint32_t 		NoPresence;									/* Resets nothing answered */
+	uint32_t 		Slots;
+	uint32_t 		MinUsecs;									/* Shortest / longest transaction */
+	uint32_t 		MaxUsecs;
+	uint32_t 		ResetViolations;							/* Reset pulse or master Rx phase too short */
+	uint32_t 		LowViolations;								/* Master low time neither a '1' / read (<= 15us) nor a '0' (60-120us) */
+	uint32_t 		SlotViolations;								/* Time slot plus recovery time too short */
+	uint32_t 		FaultsInjected;								/* Presence pulses withheld, bytes corrupted and zeros cut short */
+}SIM_OWStats_t;
+
+
+
+/**********************************************************************************************************************
+ * 									APIs supported by the 1-wire bus model
+ **********************************************************************************************************************/
+
+/*
+ * Set up
+ */
+void SIM_OneWireReset(void);
+void SIM_OneWireAttach(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber);
+uint8_t SIM_OneWireAddDevice(uint64_t Serial);
+
+/*
+ * Stimulus
+ */
+void SIM_OneWireSetTemperature(uint8_t Device, int16_t Raw);
+void SIM_OneWireInjectFault(uint8_t Device, uint8_t Fault, uint32_t Count);
+
+/*
+ * Observation
+ */
+const uint8_t *SIM_OneWireGetROM(uint8_t Device);
+const SIM_OWStats_t *SIM_OneWireGetStats(void);
+void SIM_OneWireClearStats(void);
+uint32_t SIM_OneWireGetTransactionCount(void);
+const SIM_OWTransaction_t *SIM_OneWireGetTransaction(uint32_t Index);
+
+/*
+ * Model - run by the simulator every free-running step, before the GPIO model
+ */
+void SIM_OneWireModel(void);
+
+#endif /* INC_STM32F407VG_SIM_ONEWIRE_H_ */
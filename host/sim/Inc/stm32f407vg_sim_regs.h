@@ -0,0 +1,49 @@
+/*
+ * stm32f407vg_sim_regs.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#ifndef INC_STM32F407VG_SIM_REGS_H_
+#define INC_STM32F407VG_SIM_REGS_H_
+
+/*
+ * Register file of the host simulator - only included by stm32f407vg.h when built with STM32F407VG_HOST_SIM
+ *
+ * NOTE: The drivers compare and store register addresses as uint32_t (i.e., (uint32_t) pADCx == ADC1_BASE_ADDR, DMA PAR/M0AR),
+ * 		 so the register file, like every DMA buffer, has to live below 4GB. host/Makefile links the simulator with -no-pie
+ */
+
+#include <stdint.h>
+
+#define SIM_PERIPH_REG_FILE_SIZE				0x26800U							//APB1 (0x40000000) up to the end of DMA2 (0x400267FF)
+#define SIM_CORE_REG_FILE_SIZE					0xF000U								//DWT (0xE0001000) up to the end of SCB (0xE000EFFF)
+
+extern uint32_t SIM_PeriphRegFile[SIM_PERIPH_REG_FILE_SIZE / 4];
+extern uint32_t SIM_CoreRegFile[SIM_CORE_REG_FILE_SIZE / 4];
+
+#define SIM_PERIPH_REG_FILE_ADDR				( (uint32_t) (uintptr_t) SIM_PeriphRegFile )
+#define SIM_CORE_REG_FILE_ADDR					( (uint32_t) (uintptr_t) SIM_CoreRegFile )
+
+/*
+ * Simulated PRIMASK - set by CRITICAL_SECTION_ENTER, no interrupt is dispatched while it is set
+ */
+extern volatile uint32_t SIM_PRIMASK;
+
+/*
+ * Set while the dispatcher runs an ISR - what IPSR would report on target (CPU_IN_HANDLER_MODE)
+ */
+extern volatile uint8_t SIM_InISR;
+
+/*
+ * Lets the behavioural models run while a driver polls a flag - see SIM_Poll in stm32f407vg_sim.c
+ */
+void SIM_Poll(void);
+
+/*
+ * WFI - runs the models until an enabled interrupt is pending (Sleep), or only the RTC until it wakes the core (STOP)
+ */
+void SIM_WaitForInterrupt(void);
+
+#endif /* INC_STM32F407VG_SIM_REGS_H_ */
@@ -0,0 +1,1945 @@
+/*
+ * stm32f407vg_sim.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32f407vg_sim.h"
+#include "stm32f407vg_sim_onewire.h"
+
+/*
+ * Register files the peripheral base addresses point into (see stm32f407vg_sim_regs.h)
+ */
+uint32_t SIM_PeriphRegFile[SIM_PERIPH_REG_FILE_SIZE / 4] __attribute__ ((aligned (1024)));
+uint32_t SIM_CoreRegFile[SIM_CORE_REG_FILE_SIZE / 4] __attribute__ ((aligned (1024)));
+
+volatile uint32_t SIM_PRIMASK;
+volatile uint8_t SIM_InISR;
+
+#define SIM_NUM_GPIO							9
+#define SIM_NUM_TIM								4
+#define SIM_NUM_ADC								3
+#define SIM_NUM_DMA								2
+#define SIM_NUM_I2C								3
+#define SIM_NUM_USART							6
+#define SIM_NUM_SPI								3
+#define SIM_NUM_IRQS							82
+
+#define SIM_NO_TRIG								0xFF					//Timer event that is not an ADC external trigger
+
+/*
+ * Clocks the models count in (see SIM_CyclesPerStep)
+ */
+#define SIM_CLK_HCLK							0						//Core (DWT)
+#define SIM_CLK_TIMCLK1							1						//APB1 timers (TIM2-TIM5)
+#define SIM_CLK_PCLK2							2						//APB2 (ADC)
+
+/*
+ * I2C master bus phases
+ */
+#define SIM_I2C_IDLE							0
+#define SIM_I2C_ADDRESS							1						//SB set, waiting for the address byte in DR
+#define SIM_I2C_ADDR_SET						2						//ADDR set, cleared on the next step
+#define SIM_I2C_TX								3
+#define SIM_I2C_RX								4
+
+#define SIM_EXTI_LINE_RTC_WKUP					22
+#define SIM_WFI_MAX_USECS						60000000ULL				//WFI with nothing to wake the core up is a hang on target
+
+typedef struct
+{
+	TIM2_5_RegDef_t *pTIMx;
+	uint32_t 		PscShadow;									/* Pre-scaler in use - PSC is only loaded on an update event */
+	uint32_t 		PscCount;									/* Timer clock cycles not yet turned into a counter tick */
+	uint32_t 		CntMask;									/* Counter width - 16-bit TIM3/TIM4 ignore the upper half of CNT/ARR/CCRx */
+	uint8_t 		TrgoSel;									/* ADC EXTSEL code of TRGO */
+	uint8_t 		CCSel[4];									/* ADC EXTSEL codes of the compare events */
+}SIM_TIMState_t;
+
+typedef struct
+{
+	ADC_RegDef_t 	*pADCx;
+	uint8_t 		Active;										/* Regular sequence being converted */
+	uint8_t 		SeqIndex;									/* Rank of the conversion under way */
+	uint32_t 		StepsLeft;									/* Steps until the conversion under way is done */
+	uint8_t 		DataReady;									/* Multi ADC mode: DR waiting for the rest of the group (ADC_CDR) */
+}SIM_ADCState_t;
+
+typedef struct
+{
+	uint8_t 		Active;										/* Transfer latched - started since EN was last seen set */
+	uint32_t 		Reload;										/* NDTR when the transfer was started */
+	uint32_t 		Index;										/* Items transferred */
+	uint32_t 		LastNDTR;									/* NDTR as last written by the model - anything else was written by software */
+}SIM_DMAStreamState_t;
+
+typedef struct
+{
+	I2C_RegDef_t 	*pI2Cx;
+	uint8_t 		Phase;
+	uint8_t 		ByteSent;									/* A data byte left the shift register since ADDR */
+	int16_t 		NackAddr;									/* 7 bit address that is not acknowledged, -1 for none */
+	uint8_t 		RxData[SIM_I2C_MAX_FRAME_LEN];
+	uint8_t 		RxLen;
+	uint8_t 		RxIndex;
+	SIM_I2CFrame_t 	Frames[SIM_I2C_MAX_FRAMES];
+	uint32_t 		FrameCount;
+}SIM_I2CState_t;
+
+typedef struct
+{
+	USART_RegDef_t 	*pUSARTx;
+	uint8_t 		Log[SIM_USART_LOG_LEN];
+	uint32_t 		Count;
+}SIM_USARTState_t;
+
+typedef struct
+{
+	uint32_t 		LSIPhase;									/* LSI cycles not yet run, in millionths of a cycle */
+	uint32_t 		AsyncCount;									/* Asynchronous pre-scaler count */
+	uint32_t 		WUTDiv;										/* RTCCLK cycles not yet turned into a wakeup timer count */
+	uint32_t 		WUTCount;									/* Wakeup timer down-counter */
+	uint8_t 		WUTELast;									/* WUTE as last seen - WUTR is loaded on its rising edge */
+}SIM_RTCState_t;
+
+typedef struct
+{
+	uint8_t 		IRQNumber;
+	void 			(*pHandler)(void);
+	uint8_t 		(*pIsPending)(uint8_t Instance);
+	uint8_t 		Instance;
+}SIM_IRQ_t;
+
+static uint64_t SIM_TimeUsecs;
+static uint32_t SIM_IRQCount[SIM_NUM_IRQS];
+
+static GPIO_RegDef_t *SIM_GPIO[SIM_NUM_GPIO];
+static uint16_t SIM_GPIOExtLevel[SIM_NUM_GPIO];
+static SIM_TIMState_t SIM_TIM[SIM_NUM_TIM];
+static SIM_ADCState_t SIM_ADC[SIM_NUM_ADC];
+static uint16_t SIM_ADCInput[19];
+static uint16_t SIM_ADCCDRLow;									//DMA mode 2: first result of an ADC_CDR word not complete yet
+static uint8_t SIM_ADCCDRLowValid;
+static DMA_RegDef_t *SIM_DMA[SIM_NUM_DMA];
+static SIM_DMAStreamState_t SIM_DMAStream[SIM_NUM_DMA][8];
+static SIM_I2CState_t SIM_I2C[SIM_NUM_I2C];
+static SIM_USARTState_t SIM_USART[SIM_NUM_USART];
+static SPI_RegDef_t *SIM_SPI[SIM_NUM_SPI];
+static SIM_RTCState_t SIM_RTC;
+
+/*
+ * Application ISRs - weak references, an IRQ without a handler in the application is never dispatched
+ */
+void RTC_WKUP_IRQHandler(void) __weak;
+void TIM2_IRQHandler(void) __weak;
+void TIM3_IRQHandler(void) __weak;
+void TIM4_IRQHandler(void) __weak;
+void TIM5_IRQHandler(void) __weak;
+void ADC_IRQHandler(void) __weak;
+void DMA1_Stream0_IRQHandler(void) __weak;
+void DMA1_Stream1_IRQHandler(void) __weak;
+void DMA1_Stream2_IRQHandler(void) __weak;
+void DMA1_Stream3_IRQHandler(void) __weak;
+void DMA1_Stream4_IRQHandler(void) __weak;
+void DMA1_Stream5_IRQHandler(void) __weak;
+void DMA1_Stream6_IRQHandler(void) __weak;
+void DMA1_Stream7_IRQHandler(void) __weak;
+void DMA2_Stream0_IRQHandler(void) __weak;
+void DMA2_Stream1_IRQHandler(void) __weak;
+void DMA2_Stream2_IRQHandler(void) __weak;
+void DMA2_Stream3_IRQHandler(void) __weak;
+void DMA2_Stream4_IRQHandler(void) __weak;
+void DMA2_Stream5_IRQHandler(void) __weak;
+void DMA2_Stream6_IRQHandler(void) __weak;
+void DMA2_Stream7_IRQHandler(void) __weak;
+void I2C1_EV_IRQHandler(void) __weak;
+void I2C1_ER_IRQHandler(void) __weak;
+void I2C2_EV_IRQHandler(void) __weak;
+void I2C2_ER_IRQHandler(void) __weak;
+void I2C3_EV_IRQHandler(void) __weak;
+void I2C3_ER_IRQHandler(void) __weak;
+void SPI1_IRQHandler(void) __weak;
+void SPI2_IRQHandler(void) __weak;
+void SPI3_IRQHandler(void) __weak;
+void USART1_IRQHandler(void) __weak;
+void USART2_IRQHandler(void) __weak;
+void USART3_IRQHandler(void) __weak;
+void UART4_IRQHandler(void) __weak;
+void UART5_IRQHandler(void) __weak;
+void USART6_IRQHandler(void) __weak;
+
+/*********** Simulator helper functions prototype section ***********/
+static void SIM_TickFreeRunning(void);
+static void SIM_RCCModel(void);
+static uint32_t SIM_CyclesPerStep(uint8_t Clock);
+static void SIM_NVICModel(void);
+static void SIM_RTCModel(void);
+static void SIM_RTCCycle(void);
+static uint8_t SIM_IRQPending(void);
+static void SIM_GPIOModel(uint8_t Instance);
+static void SIM_TIMModel(uint8_t Instance);
+static void SIM_TIMTrigger(uint8_t ExtSel);
+static void SIM_DMAModel(uint8_t Instance);
+static uint8_t SIM_DMARequest(uint32_t PeriphAddr);
+static uint8_t SIM_DMAIsArmed(uint32_t PeriphAddr);
+static void SIM_DMATransfer(uint8_t Instance, uint8_t Stream);
+static void SIM_ADCModel(uint8_t Instance);
+static void SIM_ADCStart(SIM_ADCState_t *pADC);
+static void SIM_ADCMultiModel(void);
+static uint8_t SIM_ADCMultiNumOfADCs(void);
+static uint8_t SIM_ADCSeqChannel(ADC_RegDef_t *pADCx, uint8_t Rank);
+static uint32_t SIM_ADCConversionSteps(ADC_RegDef_t *pADCx, uint8_t Channel);
+static void SIM_I2CModel(uint8_t Instance);
+static void SIM_I2CLogByte(SIM_I2CState_t *pI2C, uint8_t Byte);
+static void SIM_USARTModel(uint8_t Instance);
+static void SIM_DispatchIRQs(void);
+static uint8_t SIM_NVICIsEnabled(uint8_t IRQNumber);
+static uint8_t SIM_NVICGetPriority(uint8_t IRQNumber);
+static uint8_t SIM_EXTIIsPending(uint8_t Instance);
+static uint8_t SIM_TIMIsPending(uint8_t Instance);
+static uint8_t SIM_ADCIsPending(uint8_t Instance);
+static uint8_t SIM_DMAIsPending(uint8_t Instance);
+static uint8_t SIM_I2CEvIsPending(uint8_t Instance);
+static uint8_t SIM_I2CErIsPending(uint8_t Instance);
+static uint8_t SIM_SPIIsPending(uint8_t Instance);
+static uint8_t SIM_USARTIsPending(uint8_t Instance);
+
+/********************************************************/
+
+/*
+ * Vector table of the dispatcher - DMA instances are controller * 8 + stream, EXTI instances are the line
+ */
+static const SIM_IRQ_t SIM_IRQTable[] =
+{
+	{ IRQ_NO_RTC_WKUP,		RTC_WKUP_IRQHandler,		SIM_EXTIIsPending,		SIM_EXTI_LINE_RTC_WKUP },
+	{ IRQ_NO_DMA1_STREAM0,	DMA1_Stream0_IRQHandler,	SIM_DMAIsPending,		0 },
+	{ IRQ_NO_DMA1_STREAM1,	DMA1_Stream1_IRQHandler,	SIM_DMAIsPending,		1 },
+	{ IRQ_NO_DMA1_STREAM2,	DMA1_Stream2_IRQHandler,	SIM_DMAIsPending,		2 },
+	{ IRQ_NO_DMA1_STREAM3,	DMA1_Stream3_IRQHandler,	SIM_DMAIsPending,		3 },
+	{ IRQ_NO_DMA1_STREAM4,	DMA1_Stream4_IRQHandler,	SIM_DMAIsPending,		4 },
+	{ IRQ_NO_DMA1_STREAM5,	DMA1_Stream5_IRQHandler,	SIM_DMAIsPending,		5 },
+	{ IRQ_NO_DMA1_STREAM6,	DMA1_Stream6_IRQHandler,	SIM_DMAIsPending,		6 },
+	{ IRQ_NO_ADC,			ADC_IRQHandler,				SIM_ADCIsPending,		0 },
+	{ IRQ_NO_TIM2,			TIM2_IRQHandler,			SIM_TIMIsPending,		0 },
+	{ IRQ_NO_TIM3,			TIM3_IRQHandler,			SIM_TIMIsPending,		1 },
+	{ IRQ_NO_TIM4,			TIM4_IRQHandler,			SIM_TIMIsPending,		2 },
+	{ IRQ_NO_I2C1_EV,		I2C1_EV_IRQHandler,			SIM_I2CEvIsPending,		0 },
+	{ IRQ_NO_I2C1_ER,		I2C1_ER_IRQHandler,			SIM_I2CErIsPending,		0 },
+	{ IRQ_NO_I2C2_EV,		I2C2_EV_IRQHandler,			SIM_I2CEvIsPending,		1 },
+	{ IRQ_NO_I2C2_ER,		I2C2_ER_IRQHandler,			SIM_I2CErIsPending,		1 },
+	{ IRQ_NO_SPI1,			SPI1_IRQHandler,			SIM_SPIIsPending,		0 },
+	{ IRQ_NO_SPI2,			SPI2_IRQHandler,			SIM_SPIIsPending,		1 },
+	{ IRQ_NO_USART1,		USART1_IRQHandler,			SIM_USARTIsPending,		0 },
+	{ IRQ_NO_USART2,		USART2_IRQHandler,			SIM_USARTIsPending,		1 },
+	{ IRQ_NO_USART3,		USART3_IRQHandler,			SIM_USARTIsPending,		2 },
+	{ IRQ_NO_DMA1_STREAM7,	DMA1_Stream7_IRQHandler,	SIM_DMAIsPending,		7 },
+	{ IRQ_NO_TIM5,			TIM5_IRQHandler,			SIM_TIMIsPending,		3 },
+	{ IRQ_NO_SPI3,			SPI3_IRQHandler,			SIM_SPIIsPending,		2 },
+	{ IRQ_NO_UART4,			UART4_IRQHandler,			SIM_USARTIsPending,		3 },
+	{ IRQ_NO_UART5,			UART5_IRQHandler,			SIM_USARTIsPending,		4 },
+	{ IRQ_NO_DMA2_STREAM0,	DMA2_Stream0_IRQHandler,	SIM_DMAIsPending,		8 },
+	{ IRQ_NO_DMA2_STREAM1,	DMA2_Stream1_IRQHandler,	SIM_DMAIsPending,		9 },
+	{ IRQ_NO_DMA2_STREAM2,	DMA2_Stream2_IRQHandler,	SIM_DMAIsPending,		10 },
+	{ IRQ_NO_DMA2_STREAM3,	DMA2_Stream3_IRQHandler,	SIM_DMAIsPending,		11 },
+	{ IRQ_NO_DMA2_STREAM4,	DMA2_Stream4_IRQHandler,	SIM_DMAIsPending,		12 },
+	{ IRQ_NO_DMA2_STREAM5,	DMA2_Stream5_IRQHandler,	SIM_DMAIsPending,		13 },
+	{ IRQ_NO_DMA2_STREAM6,	DMA2_Stream6_IRQHandler,	SIM_DMAIsPending,		14 },
+	{ IRQ_NO_DMA2_STREAM7,	DMA2_Stream7_IRQHandler,	SIM_DMAIsPending,		15 },
+	{ IRQ_NO_USART6,		USART6_IRQHandler,			SIM_USARTIsPending,		5 },
+	{ IRQ_NO_I2C3_EV,		I2C3_EV_IRQHandler,			SIM_I2CEvIsPending,		2 },
+	{ IRQ_NO_I2C3_ER,		I2C3_ER_IRQHandler,			SIM_I2CErIsPending,		2 },
+};
+
+#define SIM_IRQ_TABLE_LEN						( sizeof(SIM_IRQTable) / sizeof(SIM_IRQTable[0]) )
+
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_Reset
+
+ 	 * @brief  		- API that puts every simulated register back to its reset value and clears all stimulus and logs
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Also runs before main, so the drivers always start from reset values
+
+*/
+__attribute__ ((constructor)) void SIM_Reset(void)
+{
+	//0. Drivers keep register addresses in uint32_t - the register file must be addressable with 32 bits
+	if( ( (uintptr_t) SIM_PeriphRegFile != SIM_PERIPH_REG_FILE_ADDR ) || ( (uintptr_t) SIM_CoreRegFile != SIM_CORE_REG_FILE_ADDR ) )
+	{
+		fprintf(stderr, "SIM: register file is above 4GB - link the simulator with -no-pie\n");
+		exit(1);
+	}
+
+	memset(SIM_PeriphRegFile, 0, sizeof(SIM_PeriphRegFile));
+	memset(SIM_CoreRegFile, 0, sizeof(SIM_CoreRegFile));
+
+	SIM_PRIMASK = 0;
+	SIM_TimeUsecs = 0;
+	SIM_InISR = 0;
+	memset(SIM_IRQCount, 0, sizeof(SIM_IRQCount));
+
+	//1. Peripheral instances
+	GPIO_RegDef_t *GPIOs[SIM_NUM_GPIO] = { GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG, GPIOH, GPIOI };
+	I2C_RegDef_t *I2Cs[SIM_NUM_I2C] = { I2C1, I2C2, I2C3 };
+	USART_RegDef_t *USARTs[SIM_NUM_USART] = { USART1, USART2, USART3, UART4, UART5, USART6 };
+
+	memcpy(SIM_GPIO, GPIOs, sizeof(SIM_GPIO));
+	memset(SIM_GPIOExtLevel, 0xFF, sizeof(SIM_GPIOExtLevel));		//Inputs read high - released lines with a pull up
+	SIM_OneWireReset();
+
+	memset(SIM_TIM, 0, sizeof(SIM_TIM));
+	SIM_TIM[0].pTIMx = TIM2;
+	SIM_TIM[0].CntMask = 0xFFFFFFFF;
+	SIM_TIM[0].TrgoSel = ADC_EXT_TRIG_TIM2_TRGO;
+	SIM_TIM[0].CCSel[0] = SIM_NO_TRIG;
+	SIM_TIM[0].CCSel[1] = ADC_EXT_TRIG_TIM2_CC2;
+	SIM_TIM[0].CCSel[2] = ADC_EXT_TRIG_TIM2_CC3;
+	SIM_TIM[0].CCSel[3] = ADC_EXT_TRIG_TIM2_CC4;
+	SIM_TIM[1].pTIMx = TIM3;
+	SIM_TIM[1].CntMask = 0xFFFF;
+	SIM_TIM[1].TrgoSel = ADC_EXT_TRIG_TIM3_TRGO;
+	SIM_TIM[1].CCSel[0] = ADC_EXT_TRIG_TIM3_CC1;
+	SIM_TIM[1].CCSel[1] = SIM_NO_TRIG;
+	SIM_TIM[1].CCSel[2] = SIM_NO_TRIG;
+	SIM_TIM[1].CCSel[3] = SIM_NO_TRIG;
+	SIM_TIM[2].pTIMx = TIM4;
+	SIM_TIM[2].CntMask = 0xFFFF;
+	SIM_TIM[2].TrgoSel = SIM_NO_TRIG;
+	SIM_TIM[2].CCSel[0] = SIM_NO_TRIG;
+	SIM_TIM[2].CCSel[1] = SIM_NO_TRIG;
+	SIM_TIM[2].CCSel[2] = SIM_NO_TRIG;
+	SIM_TIM[2].CCSel[3] = ADC_EXT_TRIG_TIM4_CC4;
+	SIM_TIM[3].pTIMx = TIM5;
+	SIM_TIM[3].CntMask = 0xFFFFFFFF;
+	SIM_TIM[3].TrgoSel = SIM_NO_TRIG;
+	SIM_TIM[3].CCSel[0] = ADC_EXT_TRIG_TIM5_CC1;
+	SIM_TIM[3].CCSel[1] = ADC_EXT_TRIG_TIM5_CC2;
+	SIM_TIM[3].CCSel[2] = ADC_EXT_TRIG_TIM5_CC3;
+	SIM_TIM[3].CCSel[3] = SIM_NO_TRIG;
+
+	memset(SIM_ADC, 0, sizeof(SIM_ADC));
+	SIM_ADC[0].pADCx = ADC1;
+	SIM_ADC[1].pADCx = ADC2;
+	SIM_ADC[2].pADCx = ADC3;
+	memset(SIM_ADCInput, 0, sizeof(SIM_ADCInput));
+	SIM_ADCCDRLowValid = 0;
+
+	SIM_DMA[0] = DMA1;
+	SIM_DMA[1] = DMA2;
+	memset(SIM_DMAStream, 0, sizeof(SIM_DMAStream));
+
+	memset(SIM_I2C, 0, sizeof(SIM_I2C));
+	for(uint8_t i = 0; i < SIM_NUM_I2C; i++)
+	{
+		SIM_I2C[i].pI2Cx = I2Cs[i];
+		SIM_I2C[i].NackAddr = -1;
+		SIM_I2C[i].pI2Cx->DR = SIM_DR_EMPTY;
+	}
+
+	memset(SIM_USART, 0, sizeof(SIM_USART));
+	for(uint8_t i = 0; i < SIM_NUM_USART; i++)
+	{
+		SIM_USART[i].pUSARTx = USARTs[i];
+		SIM_USART[i].pUSARTx->SR = ( 1 << USART_SR_TXE ) | ( 1 << USART_SR_TC );
+		SIM_USART[i].pUSARTx->DR = SIM_DR_EMPTY;
+	}
+
+	SIM_SPI[0] = SPI1;
+	SIM_SPI[1] = SPI2;
+	SIM_SPI[2] = SPI3;
+	for(uint8_t i = 0; i < SIM_NUM_SPI; i++)
+	{
+		SIM_SPI[i]->SR = ( 1 << SPI_SR_TXE );
+	}
+
+	memset(&SIM_RTC, 0, sizeof(SIM_RTC));
+
+	//2. Non-zero reset values (RM0090)
+	RCC->CR = 0x00000083;
+	RCC->PLLCFGR = 0x24003010;
+	RCC->AHB1ENR = 0x00100000;
+	RCC->CSR = 0x0E000000;
+
+	RTC->ISR = 0x00000007;
+	RTC->PRER = 0x007F00FF;
+	RTC->WUTR = 0x0000FFFF;
+
+	GPIOA->MODER = 0xA8000000;
+	GPIOA->OSPEEDR = 0x0C000000;
+	GPIOA->PUPDR = 0x64000000;
+	GPIOB->MODER = 0x00000280;
+	GPIOB->OSPEEDR = 0x000000C0;
+	GPIOB->PUPDR = 0x00000100;
+
+	for(uint8_t i = 0; i < SIM_NUM_GPIO; i++)
+	{
+		SIM_GPIOModel(i);
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_Step
+
+ 	 * @brief  		- API that advances simulated time by SIM_USECS_PER_STEP, runs every peripheral model once and dispatches
+ 	 * 				- the pending interrupts
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Each pending and enabled IRQ is dispatched at most once per step, highest NVIC priority first
+
+*/
+void SIM_Step(void)
+{
+	SIM_TickFreeRunning();
+
+	SIM_RCCModel();
+	SIM_NVICModel();
+
+	for(uint8_t i = 0; i < SIM_NUM_DMA; i++)
+	{
+		SIM_DMAModel(i);
+	}
+
+	for(uint8_t i = 0; i < SIM_NUM_ADC; i++)
+	{
+		SIM_ADCModel(i);
+	}
+
+	SIM_ADCMultiModel();
+
+	for(uint8_t i = 0; i < SIM_NUM_I2C; i++)
+	{
+		SIM_I2CModel(i);
+	}
+
+	for(uint8_t i = 0; i < SIM_NUM_USART; i++)
+	{
+		SIM_USARTModel(i);
+	}
+
+	if( !SIM_InISR )
+	{
+		SIM_DispatchIRQs();
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_Poll
+
+ 	 * @brief  		- API called by the drivers (SIM_POLL) every time they poll a flag or wait on a counter
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Thread mode: one full step. ISR: time only advances (timers, DWT, GPIO) - the other peripherals and
+ 	 * 				- the dispatcher wait for the ISR to return, like a peripheral interrupt can't preempt its own handler
+
+*/
+void SIM_Poll(void)
+{
+	if( SIM_InISR )
+	{
+		SIM_TickFreeRunning();
+	}
+	else
+	{
+		SIM_Step();
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_RunUsecs
+
+ 	 * @brief  		- API that steps the simulator for a number of microseconds
+
+ 	 * @param 		- MicroSeconds : simulated time to run
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void SIM_RunUsecs(uint32_t MicroSeconds)
+{
+	for(uint32_t t = 0; t < MicroSeconds; t += SIM_USECS_PER_STEP)
+	{
+		SIM_Step();
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_GetTimeUsecs
+
+ 	 * @brief  		- API that returns the simulated time since the last SIM_Reset
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- microseconds
+
+ 	 * @Note		- none
+
+*/
+uint64_t SIM_GetTimeUsecs(void)
+{
+	return SIM_TimeUsecs;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_GPIOSetInput
+
+ 	 * @brief  		- API that sets the level an external device drives on a pin
+
+ 	 * @param 		- *pGPIOx : GPIO port
+ 	 * @param 		- PinNumber : 0 - 15
+ 	 * @param 		- Level : 0 or 1 (1 is also a released open-drain line)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Open-drain outputs read back the wired-AND of ODR and this level
+
+*/
+void SIM_GPIOSetInput(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber, uint8_t Level)
+{
+	for(uint8_t i = 0; i < SIM_NUM_GPIO; i++)
+	{
+		if( SIM_GPIO[i] == pGPIOx )
+		{
+			if( Level )
+			{
+				SIM_GPIOExtLevel[i] |= ( 1 << PinNumber );
+			}
+			else
+			{
+				SIM_GPIOExtLevel[i] &= ~( 1 << PinNumber );
+			}
+
+			SIM_GPIOModel(i);
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_ADCSetInput
+
+ 	 * @brief  		- API that sets the 12 bit value every ADC converts on a channel
+
+ 	 * @param 		- Channel : ADC_IN0 - ADC_IN18
+ 	 * @param 		- Counts : 0 - 4095
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void SIM_ADCSetInput(uint8_t Channel, uint16_t Counts)
+{
+	if( Channel < 19 )
+	{
+		SIM_ADCInput[Channel] = ( Counts & 0xFFF );
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_I2CSetNack
+
+ 	 * @brief  		- API that makes a simulated I2C bus NACK one slave address (AF instead of ADDR)
+
+ 	 * @param 		- *pI2Cx : I2C peripheral
+ 	 * @param 		- SlaveAddr : 7 bit address, or -1 cast to uint8_t (0xFF) to acknowledge every address again
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- none
+
+*/
+void SIM_I2CSetNack(I2C_RegDef_t *pI2Cx, uint8_t SlaveAddr)
+{
+	for(uint8_t i = 0; i < SIM_NUM_I2C; i++)
+	{
+		if( SIM_I2C[i].pI2Cx == pI2Cx )
+		{
+			SIM_I2C[i].NackAddr = ( SlaveAddr > 0x7F ) ? -1 : SlaveAddr;
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_I2CSetRxData
+
+ 	 * @brief  		- API that loads the bytes a slave returns in the next master read frames
+
+ 	 * @param 		- *pI2Cx : I2C peripheral
+ 	 * @param 		- *pData : bytes (copied)
+ 	 * @param 		- Len : number of bytes, at most SIM_I2C_MAX_FRAME_LEN
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Every read frame starts at the first byte again. Bytes past Len read as 0xFF (released SDA)
+
+*/
+void SIM_I2CSetRxData(I2C_RegDef_t *pI2Cx, const uint8_t *pData, uint8_t Len)
+{
+	if( Len > SIM_I2C_MAX_FRAME_LEN )
+	{
+		Len = SIM_I2C_MAX_FRAME_LEN;
+	}
+
+	for(uint8_t i = 0; i < SIM_NUM_I2C; i++)
+	{
+		if( SIM_I2C[i].pI2Cx == pI2Cx )
+		{
+			memcpy(SIM_I2C[i].RxData, pData, Len);
+			SIM_I2C[i].RxLen = Len;
+		}
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_I2CGetFrameCount
+
+ 	 * @brief  		- API that returns how many frames a simulated I2C master has started since reset
+
+ 	 * @param 		- *pI2Cx : I2C peripheral
+
+ 	 * @retval 		- number of frames
+
+ 	 * @Note		- Only the last SIM_I2C_MAX_FRAMES can be read back with SIM_I2CGetFrame
+
+*/
+uint32_t SIM_I2CGetFrameCount(I2C_RegDef_t *pI2Cx)
+{
+	for(uint8_t i = 0; i < SIM_NUM_I2C; i++)
+	{
+		if( SIM_I2C[i].pI2Cx == pI2Cx )
+		{
+			return SIM_I2C[i].FrameCount;
+		}
+	}
+
+	return 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_I2CGetFrame
+
+ 	 * @brief  		- API that returns one logged frame of a simulated I2C master
+
+ 	 * @param 		- *pI2Cx : I2C peripheral
+ 	 * @param 		- Index : 0 for the first frame since reset
+
+ 	 * @retval 		- frame, or NULL if it was never sent or already overwritten
+
+ 	 * @Note		- The last frame may still be in progress
+
+*/
+const SIM_I2CFrame_t *SIM_I2CGetFrame(I2C_RegDef_t *pI2Cx, uint32_t Index)
+{
+	for(uint8_t i = 0; i < SIM_NUM_I2C; i++)
+	{
+		SIM_I2CState_t *pI2C = &SIM_I2C[i];
+
+		if( ( pI2C->pI2Cx == pI2Cx ) && ( Index < pI2C->FrameCount ) && ( ( pI2C->FrameCount - Index ) <= SIM_I2C_MAX_FRAMES ) )
+		{
+			return &pI2C->Frames[Index % SIM_I2C_MAX_FRAMES];
+		}
+	}
+
+	return NULL;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_USARTGetTxCount
+
+ 	 * @brief  		- API that returns how many bytes a simulated USART has transmitted since reset
+
+ 	 * @param 		- *pUSARTx : USART peripheral
+
+ 	 * @retval 		- number of bytes
+
+ 	 * @Note		- Only the last SIM_USART_LOG_LEN can be read back with SIM_USARTGetTxByte
+
+*/
+uint32_t SIM_USARTGetTxCount(USART_RegDef_t *pUSARTx)
+{
+	for(uint8_t i = 0; i < SIM_NUM_USART; i++)
+	{
+		if( SIM_USART[i].pUSARTx == pUSARTx )
+		{
+			return SIM_USART[i].Count;
+		}
+	}
+
+	return 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_USARTGetTxByte
+
+ 	 * @brief  		- API that returns one transmitted byte of a simulated USART
+
+ 	 * @param 		- *pUSARTx : USART peripheral
+ 	 * @param 		- Index : 0 for the first byte since reset
+
+ 	 * @retval 		- byte (0 if it was never sent or already overwritten)
+
+ 	 * @Note		- none
+
+*/
+uint8_t SIM_USARTGetTxByte(USART_RegDef_t *pUSARTx, uint32_t Index)
+{
+	for(uint8_t i = 0; i < SIM_NUM_USART; i++)
+	{
+		SIM_USARTState_t *pUSART = &SIM_USART[i];
+
+		if( ( pUSART->pUSARTx == pUSARTx ) && ( Index < pUSART->Count ) && ( ( pUSART->Count - Index ) <= SIM_USART_LOG_LEN ) )
+		{
+			return pUSART->Log[Index % SIM_USART_LOG_LEN];
+		}
+	}
+
+	return 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_GetIRQCount
+
+ 	 * @brief  		- API that returns how many times an IRQ handler has been dispatched since reset
+
+ 	 * @param 		- IRQNumber : IRQ_NO_x
+
+ 	 * @retval 		- number of calls
+
+ 	 * @Note		- none
+
+*/
+uint32_t SIM_GetIRQCount(uint8_t IRQNumber)
+{
+	return ( IRQNumber < SIM_NUM_IRQS ) ? SIM_IRQCount[IRQNumber] : 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_WaitForInterrupt
+
+ 	 * @brief  		- API behind CPU_WAIT_FOR_INTERRUPT - returns once an enabled interrupt is pending, whatever PRIMASK says
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Sleep (SLEEPDEEP clear): every model keeps running. STOP (SLEEPDEEP set, PDDS clear): only time and the
+ 	 * 				- RTC move on - timers, DWT, DMA, ADC and the buses are frozen - and the core wakes up on the HSI with the
+ 	 * 				- HSE and the PLLs off. Standby is not modelled
+ 	 * 				- Waiting more than SIM_WFI_MAX_USECS ends the simulation, like a core that never wakes up
+
+*/
+void SIM_WaitForInterrupt(void)
+{
+	uint8_t Stop = ( ( *SCB_SCR >> SCB_SCR_SLEEPDEEP ) & 0x1 );
+	uint64_t Limit = SIM_TimeUsecs + SIM_WFI_MAX_USECS;
+
+	if( Stop && ( PWR->CR & ( 1 << PWR_CR_PDDS ) ) )
+	{
+		fprintf(stderr, "SIM: Standby mode is not modelled\n");
+		exit(1);
+	}
+
+	while( !SIM_IRQPending() )
+	{
+		if( SIM_TimeUsecs >= Limit )
+		{
+			fprintf(stderr, "SIM: WFI with no interrupt to wake the core up\n");
+			exit(1);
+		}
+
+		if( Stop )
+		{
+			SIM_TimeUsecs += SIM_USECS_PER_STEP;
+			SIM_RTCModel();
+		}
+		else
+		{
+			SIM_Step();
+		}
+	}
+
+	if( Stop )
+	{
+		//HSI on and selected as system clock, HSE/PLL/PLLI2S off - prescalers keep their values (RM0090 5.3.4)
+		RCC->CR = ( RCC->CR & ~( ( 1 << 16 ) | ( 1 << 24 ) | ( 1 << 26 ) ) ) | ( 1 << 0 );
+		RCC->CFGR &= ~0x3;
+		SIM_RCCModel();
+	}
+}
+
+
+
+
+/*----------------------------------------------------------------------------------------------------*/
+//Helper functions
+
+static void SIM_TickFreeRunning(void)
+{
+	//Hardware that keeps running whatever the CPU does - also advanced while an ISR busy-waits
+	SIM_TimeUsecs += SIM_USECS_PER_STEP;
+
+	SIM_RTCModel();
+
+	for(uint8_t i = 0; i < SIM_NUM_TIM; i++)
+	{
+		SIM_TIMModel(i);
+	}
+
+	if( ( *DEMCR & ( 1 << DEMCR_TRCENA ) ) && ( *DWT_CTRL & ( 1 << DWT_CTRL_CYCCNTENA ) ) )
+	{
+		*DWT_CYCCNT += SIM_CyclesPerStep(SIM_CLK_HCLK);
+	}
+
+	SIM_OneWireModel();
+
+	for(uint8_t i = 0; i < SIM_NUM_GPIO; i++)
+	{
+		SIM_GPIOModel(i);
+	}
+}
+
+
+static void SIM_RCCModel(void)
+{
+	//Oscillators and PLLs are ready as soon as they are turned on, the system clock switch is immediate
+	uint32_t cr = RCC->CR;
+
+	cr &= ~( ( 1 << 1 ) | ( 1 << 17 ) | ( 1 << 25 ) | ( 1 << 27 ) );
+	cr |= ( ( cr & ( 1 << 0 ) ) << 1 ) | ( ( cr & ( 1 << 16 ) ) << 1 ) | ( ( cr & ( 1 << 24 ) ) << 1 ) | ( ( cr & ( 1 << 26 ) ) << 1 );
+	RCC->CR = cr;
+
+	RCC->CFGR = ( RCC->CFGR & ~( 0x3 << 2 ) ) | ( ( RCC->CFGR & 0x3 ) << 2 );
+
+	RCC->CSR = ( RCC->CSR & ~( 1 << RCC_CSR_LSIRDY ) ) | ( ( RCC->CSR & ( 1 << RCC_CSR_LSION ) ) << 1 );
+}
+
+
+static void SIM_RTCModel(void)
+{
+	//1. RTC clocked by the LSI (RTCSEL 2) - SIM_LSI_FREQ is off its nominal 32kHz, like a real LSI
+	if( ( RCC->CSR & ( 1 << RCC_CSR_LSIRDY ) ) && ( RCC->BDCR & ( 1 << RCC_BDCR_RTCEN ) ) && ( ( ( RCC->BDCR >> RCC_BDCR_RTCSEL_1_0 ) & 0x3 ) == 2 ) )
+	{
+		SIM_RTC.LSIPhase += SIM_LSI_FREQ * SIM_USECS_PER_STEP;
+
+		while( SIM_RTC.LSIPhase >= 1000000U )
+		{
+			SIM_RTC.LSIPhase -= 1000000U;
+			SIM_RTCCycle();
+		}
+	}
+
+	//2. EXTI line 22 follows WUTF - PR is write 1 to clear and writes can't be trapped, so it is a level here
+	if( ( RTC->ISR & ( 1 << RTC_ISR_WUTF ) ) && ( EXTI->RTSR & ( 1 << SIM_EXTI_LINE_RTC_WKUP ) ) )
+	{
+		EXTI->PR |= ( 1 << SIM_EXTI_LINE_RTC_WKUP );
+	}
+	else
+	{
+		EXTI->PR &= ~( 1 << SIM_EXTI_LINE_RTC_WKUP );
+	}
+}
+
+
+static void SIM_RTCCycle(void)
+{
+	//One RTCCLK cycle. Write protection (WPR) and the shadow registers are not modelled - reads always see the counters
+	uint32_t isr = RTC->ISR;
+	uint32_t cr = RTC->CR;
+	uint32_t prer = RTC->PRER;
+
+	//1. Initialization mode - calendar stopped, sub-second counter at PREDIV_S
+	isr = ( isr & ~( ( 1 << RTC_ISR_INITF ) | ( 1 << RTC_ISR_WUTWF ) ) ) | ( 1 << RTC_ISR_RSF );
+	isr |= ( ( isr >> RTC_ISR_INIT ) & 0x1 ) << RTC_ISR_INITF;
+	isr |= ( ( ~cr >> RTC_CR_WUTE ) & 0x1 ) << RTC_ISR_WUTWF;
+
+	if( isr & ( 1 << RTC_ISR_INIT ) )
+	{
+		SIM_RTC.AsyncCount = 0;
+		RTC->SSR = ( prer & 0x7FFF );
+	}
+	else if( ++SIM_RTC.AsyncCount > ( ( prer >> RTC_PRER_PREDIV_A_6_0 ) & 0x7F ) )
+	{
+		//2. Synchronous pre-scaler (SSR counts down), then one second in BCD up to 23:59:59
+		SIM_RTC.AsyncCount = 0;
+
+		if( RTC->SSR & 0xFFFF )
+		{
+			RTC->SSR = ( RTC->SSR & 0xFFFF ) - 1;
+		}
+		else
+		{
+			static const uint8_t Limit[6] = { 9, 5, 9, 5, 9, 2 };
+			static const uint8_t Shift[6] = { RTC_TR_SU_3_0, RTC_TR_ST_2_0, RTC_TR_MNU_3_0, RTC_TR_MNT_2_0, RTC_TR_HU_3_0, RTC_TR_HT_1_0 };
+			uint32_t tr = RTC->TR;
+
+			RTC->SSR = ( prer & 0x7FFF );
+
+			for(uint8_t d = 0; d < 6; d++)
+			{
+				uint32_t Digit = ( tr >> Shift[d] ) & 0xF;
+				uint8_t Max = ( ( d == 4 ) && ( ( ( tr >> RTC_TR_HT_1_0 ) & 0x3 ) == 2 ) ) ? 3 : Limit[d];
+
+				tr &= ~( 0xF << Shift[d] );
+
+				if( Digit < Max )
+				{
+					tr |= ( Digit + 1 ) << Shift[d];
+					break;
+				}
+			}
+
+			RTC->TR = tr;
+		}
+	}
+
+	//3. Wakeup timer - RTCCLK / 16, 8, 4 or 2 (WUCKSEL 0-3), WUTF every WUTR + 1 counts
+	if( cr & ( 1 << RTC_CR_WUTE ) )
+	{
+		if( !SIM_RTC.WUTELast )
+		{
+			SIM_RTC.WUTCount = ( RTC->WUTR & 0xFFFF );
+			SIM_RTC.WUTDiv = 0;
+		}
+
+		if( ++SIM_RTC.WUTDiv >= ( 16U >> ( ( cr >> RTC_CR_WUCKSEL_2_0 ) & 0x3 ) ) )
+		{
+			SIM_RTC.WUTDiv = 0;
+
+			if( SIM_RTC.WUTCount == 0 )
+			{
+				isr |= ( 1 << RTC_ISR_WUTF );
+				SIM_RTC.WUTCount = ( RTC->WUTR & 0xFFFF );
+			}
+			else
+			{
+				SIM_RTC.WUTCount--;
+			}
+		}
+	}
+
+	SIM_RTC.WUTELast = ( ( cr >> RTC_CR_WUTE ) & 0x1 );
+	RTC->ISR = isr;
+}
+
+
+static uint32_t SIM_CyclesPerStep(uint8_t Clock)
+{
+	//Decoded from the registers, independently of the RCC driver it is meant to check
+	static const uint16_t AHBDiv[16] = { 1, 1, 1, 1, 1, 1, 1, 1, 2, 4, 8, 16, 64, 128, 256, 512 };
+	static const uint8_t APBDiv[8] = { 1, 1, 1, 1, 2, 4, 8, 16 };
+
+	uint32_t cfgr = RCC->CFGR;
+	uint32_t pllcfgr = RCC->PLLCFGR;
+	uint64_t SysClk;
+
+	switch( ( cfgr >> 2 ) & 0x3 )
+	{
+		case 1:
+			SysClk = RCC_HSE_FREQ;
+			break;
+
+		case 2:
+		{
+			uint64_t Src = ( pllcfgr & ( 1 << 22 ) ) ? RCC_HSE_FREQ : RCC_HSI_FREQ;
+			uint32_t M = ( pllcfgr & 0x3F );
+
+			SysClk = M ? ( ( Src * ( ( pllcfgr >> 6 ) & 0x1FF ) ) / M / ( 2 * ( ( ( pllcfgr >> 16 ) & 0x3 ) + 1 ) ) ) : 0;
+			break;
+		}
+
+		default:
+			SysClk = RCC_HSI_FREQ;
+			break;
+	}
+
+	uint64_t HClk = SysClk / AHBDiv[( cfgr >> 4 ) & 0xF];
+	uint8_t PPRE1 = APBDiv[( cfgr >> 10 ) & 0x7];
+	uint8_t PPRE2 = APBDiv[( cfgr >> 13 ) & 0x7];
+	uint64_t Freq;
+
+	if( Clock == SIM_CLK_TIMCLK1 )
+	{
+		Freq = ( PPRE1 == 1 ) ? HClk : ( 2 * HClk / PPRE1 );
+	}
+	else if( Clock == SIM_CLK_PCLK2 )
+	{
+		Freq = HClk / PPRE2;
+	}
+	else
+	{
+		Freq = HClk;
+	}
+
+	return (uint32_t) ( ( Freq * SIM_USECS_PER_STEP ) / 1000000U );
+}
+
+
+static void SIM_NVICModel(void)
+{
+	//ICERx are write 1 to clear
+	for(uint8_t i = 0; i < 3; i++)
+	{
+		if( NVIC_ICER0[i] )
+		{
+			NVIC_ISER0[i] &= ~( NVIC_ICER0[i] );
+			NVIC_ICER0[i] = 0;
+		}
+	}
+}
+
+
+static void SIM_GPIOModel(uint8_t Instance)
+{
+	GPIO_RegDef_t *pGPIOx = SIM_GPIO[Instance];
+
+	//1. BSRR - set wins over reset
+	uint32_t bsrr = pGPIOx->BSRR;
+
+	if( bsrr )
+	{
+		pGPIOx->ODR &= ~( bsrr >> 16 );
+		pGPIOx->ODR |= ( bsrr & 0xFFFF );
+		pGPIOx->BSRR = 0;
+	}
+
+	//2. IDR - push-pull outputs read ODR, open-drain outputs the wired-AND with the external level, the rest the external level
+	uint16_t OutMask = 0;
+
+	for(uint8_t pin = 0; pin < 16; pin++)
+	{
+		if( ( ( pGPIOx->MODER >> ( 2 * pin ) ) & 0x3 ) == GPIO_MODE_OUT )
+		{
+			OutMask |= ( 1 << pin );
+		}
+	}
+
+	uint16_t OD = ( pGPIOx->OTYPER & 0xFFFF );
+	uint16_t ODR = ( pGPIOx->ODR & 0xFFFF );
+	uint16_t Ext = SIM_GPIOExtLevel[Instance];
+
+	pGPIOx->IDR = ( Ext & ~OutMask ) | ( ODR & OutMask & ~OD ) | ( ODR & Ext & OutMask & OD );
+}
+
+
+static void SIM_TIMModel(uint8_t Instance)
+{
+	SIM_TIMState_t *pTIM = &SIM_TIM[Instance];
+	TIM2_5_RegDef_t *pTIMx = pTIM->pTIMx;
+	uint8_t mms = ( ( pTIMx->CR2 >> TIM2_5_CR2_MMS_2_0 ) & 0x7 );
+
+	//0. Counter width - the upper half of a 16-bit timer's registers reads 0
+	if( pTIM->CntMask != 0xFFFFFFFF )
+	{
+		pTIMx->CNT &= pTIM->CntMask;
+		pTIMx->ARR &= pTIM->CntMask;
+
+		for(uint8_t ch = 0; ch < 4; ch++)
+		{
+			( &pTIMx->CCR1 )[ch] &= pTIM->CntMask;
+		}
+	}
+
+	//1. Software events (EGR) - UG re-initializes the counter and loads the pre-scaler, CCxG set CCxIF
+	uint32_t egr = pTIMx->EGR;
+
+	if( egr )
+	{
+		pTIMx->EGR = 0;
+
+		if( egr & ( 1 << TIM2_5_EGR_UG ) )
+		{
+			pTIMx->CNT = 0;
+			pTIM->PscShadow = pTIMx->PSC;
+			pTIM->PscCount = 0;
+
+			if( !( pTIMx->CR1 & ( 1 << TIM2_5_CR1_URS ) ) )
+			{
+				pTIMx->SR |= ( 1 << TIM2_5_SR_UIF );
+			}
+
+			if( mms == TIM_TRGO_RESET )
+			{
+				SIM_TIMTrigger(pTIM->TrgoSel);
+			}
+		}
+
+		pTIMx->SR |= ( egr & 0x1E );
+	}
+
+	if( !( pTIMx->CR1 & ( 1 << TIM2_5_CR1_CEN ) ) || ( pTIMx->ARR == 0 ) )
+	{
+		return;
+	}
+
+	//2. Timer clock through the pre-scaler
+	pTIM->PscCount += SIM_CyclesPerStep(SIM_CLK_TIMCLK1);
+
+	uint32_t ticks = pTIM->PscCount / ( pTIM->PscShadow + 1 );
+	pTIM->PscCount %= ( pTIM->PscShadow + 1 );
+
+	if( !ticks )
+	{
+		return;
+	}
+
+	uint64_t period = (uint64_t) pTIMx->ARR + 1;
+	uint32_t cnt = pTIMx->CNT;
+
+	//3. Compare events - counter goes through cnt + 1 ... cnt + ticks
+	for(uint8_t ch = 0; ch < 4; ch++)
+	{
+		uint32_t ccr = ( &pTIMx->CCR1 )[ch];
+
+		if( ccr >= period )
+		{
+			continue;
+		}
+
+		uint64_t dist = ( (uint64_t) ccr + period - cnt ) % period;
+
+		if( dist == 0 )
+		{
+			dist = period;
+		}
+
+		if( dist <= ticks )
+		{
+			pTIMx->SR |= ( 1 << ( TIM2_5_SR_CC1IF + ch ) );
+
+			if( ( mms == TIM_TRGO_OC1REF + ch ) || ( ( ch == 0 ) && ( mms == TIM_TRGO_COMPARE_PULSE ) ) )
+			{
+				SIM_TIMTrigger(pTIM->TrgoSel);
+			}
+
+			SIM_TIMTrigger(pTIM->CCSel[ch]);
+		}
+	}
+
+	//4. Roll over at ARR - update event
+	uint64_t next = (uint64_t) cnt + ticks;
+
+	if( next >= period )
+	{
+		pTIMx->CNT = (uint32_t) ( next % period );
+
+		if( !( pTIMx->CR1 & ( 1 << TIM2_5_CR1_UDIS ) ) )
+		{
+			pTIMx->SR |= ( 1 << TIM2_5_SR_UIF );
+			pTIM->PscShadow = pTIMx->PSC;
+
+			if( mms == TIM_TRGO_UPDATE )
+			{
+				SIM_TIMTrigger(pTIM->TrgoSel);
+			}
+		}
+	}
+	else
+	{
+		pTIMx->CNT = (uint32_t) next;
+	}
+}
+
+
+static void SIM_TIMTrigger(uint8_t ExtSel)
+{
+	//Timer event wired to the ADC external trigger inputs - any edge selection starts the regular sequence
+	if( ExtSel == SIM_NO_TRIG )
+	{
+		return;
+	}
+
+	for(uint8_t i = 0; i < SIM_NUM_ADC; i++)
+	{
+		ADC_RegDef_t *pADCx = SIM_ADC[i].pADCx;
+
+		if( ( pADCx->CR2 & ( 1 << ADC_CR2_ADON ) ) && ( ( pADCx->CR2 >> ADC_CR2_EXTEN_1_0 ) & 0x3 ) && ( ( ( pADCx->CR2 >> ADC_CR2_EXTSEL_3_0 ) & 0xF ) == ExtSel ) )
+		{
+			SIM_ADCStart(&SIM_ADC[i]);
+		}
+	}
+}
+
+
+static void SIM_DMAModel(uint8_t Instance)
+{
+	DMA_RegDef_t *pDMAx = SIM_DMA[Instance];
+
+	//1. Interrupt flag clear registers are write 1 to clear
+	pDMAx->LISR &= ~( pDMAx->LIFCR );
+	pDMAx->LIFCR = 0;
+	pDMAx->HISR &= ~( pDMAx->HIFCR );
+	pDMAx->HIFCR = 0;
+
+	//2. Latch streams that have been (re)started by software, run memory to memory streams
+	for(uint8_t st = 0; st < 8; st++)
+	{
+		DMA_Stream_RegDef_t *pStream = &pDMAx->STREAM[st];
+		SIM_DMAStreamState_t *pState = &SIM_DMAStream[Instance][st];
+
+		if( !( pStream->CR & ( 1 << DMA_SxCR_EN ) ) )
+		{
+			pState->Active = 0;
+			continue;
+		}
+
+		if( !pState->Active || ( pStream->NDTR != pState->LastNDTR ) )
+		{
+			pState->Active = 1;
+			pState->Reload = pStream->NDTR;
+			pState->LastNDTR = pStream->NDTR;
+			pState->Index = 0;
+		}
+
+		if( ( ( pStream->CR >> DMA_SxCR_DIR_1_0 ) & 0x3 ) == DMA_DIR_MEM_TO_MEM )
+		{
+			SIM_DMATransfer(Instance, st);
+		}
+	}
+}
+
+
+static uint8_t SIM_DMARequest(uint32_t PeriphAddr)
+{
+	//Peripheral request - served by the enabled stream pointed at the peripheral register (channel selection is not checked)
+	for(uint8_t i = 0; i < SIM_NUM_DMA; i++)
+	{
+		for(uint8_t st = 0; st < 8; st++)
+		{
+			DMA_Stream_RegDef_t *pStream = &SIM_DMA[i]->STREAM[st];
+
+			if( SIM_DMAStream[i][st].Active && ( pStream->CR & ( 1 << DMA_SxCR_EN ) ) && ( pStream->PAR == PeriphAddr )
+				&& ( ( ( pStream->CR >> DMA_SxCR_DIR_1_0 ) & 0x3 ) != DMA_DIR_MEM_TO_MEM ) )
+			{
+				SIM_DMATransfer(i, st);
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+static uint8_t SIM_DMAIsArmed(uint32_t PeriphAddr)
+{
+	//Enabled stream left for the requests of a peripheral register
+	for(uint8_t i = 0; i < SIM_NUM_DMA; i++)
+	{
+		for(uint8_t st = 0; st < 8; st++)
+		{
+			DMA_Stream_RegDef_t *pStream = &SIM_DMA[i]->STREAM[st];
+
+			if( ( pStream->CR & ( 1 << DMA_SxCR_EN ) ) && ( pStream->PAR == PeriphAddr ) && pStream->NDTR )
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+static void SIM_DMATransfer(uint8_t Instance, uint8_t Stream)
+{
+	static const uint8_t FlagShift[4] = { 0, 6, 16, 22 };
+
+	DMA_RegDef_t *pDMAx = SIM_DMA[Instance];
+	DMA_Stream_RegDef_t *pStream = &pDMAx->STREAM[Stream];
+	SIM_DMAStreamState_t *pState = &SIM_DMAStream[Instance][Stream];
+	__vo uint32_t *pISR = ( Stream < 4 ) ? &pDMAx->LISR : &pDMAx->HISR;
+	uint32_t cr = pStream->CR;
+
+	if( pStream->NDTR == 0 )
+	{
+		return;
+	}
+
+	//1. Move one data item
+	uint8_t psize = ( 1 << ( ( cr >> DMA_SxCR_PSIZE_1_0 ) & 0x3 ) );
+	uint8_t msize = ( 1 << ( ( cr >> DMA_SxCR_MSIZE_1_0 ) & 0x3 ) );
+	uint32_t paddr = pStream->PAR + ( ( cr & ( 1 << DMA_SxCR_PINC ) ) ? ( pState->Index * psize ) : 0 );
+	uint32_t maddr = pStream->M0AR + ( ( cr & ( 1 << DMA_SxCR_MINC ) ) ? ( pState->Index * msize ) : 0 );
+	uint8_t dir = ( ( cr >> DMA_SxCR_DIR_1_0 ) & 0x3 );
+
+	uint32_t src = ( dir == DMA_DIR_MEM_TO_PERIPH ) ? maddr : paddr;
+	uint32_t dst = ( dir == DMA_DIR_MEM_TO_PERIPH ) ? paddr : maddr;
+	uint8_t ssize = ( dir == DMA_DIR_MEM_TO_PERIPH ) ? msize : psize;
+	uint8_t dsize = ( dir == DMA_DIR_MEM_TO_PERIPH ) ? psize : msize;
+	uint32_t value = 0;
+
+	memcpy(&value, (void *) (uintptr_t) src, ssize);
+	memcpy((void *) (uintptr_t) dst, &value, dsize);
+
+	pState->Index++;
+	pStream->NDTR--;
+	pState->LastNDTR = pStream->NDTR;
+
+	//2. Half transfer and transfer complete
+	if( pStream->NDTR == ( pState->Reload / 2 ) )
+	{
+		*pISR |= ( ( 1 << DMA_ISR_HTIF ) << FlagShift[Stream % 4] );
+	}
+
+	if( pStream->NDTR == 0 )
+	{
+		*pISR |= ( ( 1 << DMA_ISR_TCIF ) << FlagShift[Stream % 4] );
+
+		if( cr & ( 1 << DMA_SxCR_CIRC ) )
+		{
+			pStream->NDTR = pState->Reload;
+			pState->LastNDTR = pState->Reload;
+			pState->Index = 0;
+		}
+		else
+		{
+			pStream->CR &= ~( 1 << DMA_SxCR_EN );
+			pState->Active = 0;
+		}
+	}
+}
+
+
+static void SIM_ADCModel(uint8_t Instance)
+{
+	SIM_ADCState_t *pADC = &SIM_ADC[Instance];
+	ADC_RegDef_t *pADCx = pADC->pADCx;
+
+	//1. Turning the ADC off aborts the conversion and resets the sequencer
+	if( !( pADCx->CR2 & ( 1 << ADC_CR2_ADON ) ) )
+	{
+		pADC->Active = 0;
+		pADCx->CR2 &= ~( 1 << ADC_CR2_SWSTART );
+		return;
+	}
+
+	if( pADCx->CR2 & ( 1 << ADC_CR2_SWSTART ) )
+	{
+		pADCx->CR2 &= ~( 1 << ADC_CR2_SWSTART );
+		SIM_ADCStart(pADC);
+	}
+
+	if( !pADC->Active || ( --pADC->StepsLeft ) )
+	{
+		return;
+	}
+
+	//2. Conversion done - resolution, alignment, analog watch dog
+	uint8_t Channel = SIM_ADCSeqChannel(pADCx, pADC->SeqIndex);
+	uint8_t res = ( ( pADCx->CR1 >> ADC_CR1_RES_1_0 ) & 0x3 );
+	uint16_t value = ( SIM_ADCInput[Channel] >> ( 2 * res ) );
+
+	if( ( pADCx->CR1 & ( 1 << ADC_CR1_AWDEN ) )
+		&& ( !( pADCx->CR1 & ( 1 << ADC_CR1_AWDSGL ) ) || ( ( pADCx->CR1 & 0x1F ) == Channel ) ) )
+	{
+		uint16_t Value12 = ( value << ( 2 * res ) );
+
+		if( ( Value12 > pADCx->HTR ) || ( Value12 < pADCx->LTR ) )
+		{
+			pADCx->SR |= ( 1 << ADC_SR_AWD );
+		}
+	}
+
+	if( pADCx->CR2 & ( 1 << ADC_CR2_ALIGN ) )
+	{
+		value = ( res == 3 ) ? ( value << 2 ) : ( value << ( 4 + 2 * res ) );
+	}
+
+	pADCx->DR = value;
+
+	//3. EOC after every conversion (EOCS) or at the end of the sequence
+	uint8_t Len = ( ( pADCx->SQR1 >> ADC_SQR1_L_3_0 ) & 0xF ) + 1;
+	uint8_t SeqEnd = ( !( pADCx->CR1 & ( 1 << ADC_CR1_SCAN ) ) || ( ( pADC->SeqIndex + 1 ) >= Len ) );
+
+	if( ( pADCx->CR2 & ( 1 << ADC_CR2_EOCS ) ) || SeqEnd )
+	{
+		pADCx->SR |= ( 1 << ADC_SR_EOC );
+	}
+
+	//4. DMA read of DR clears EOC. Without DDS there are no requests after the last transfer - the sequence is
+	//	 stopped there, which is what the DMA complete ISR does on target by turning the ADC off (and right back on)
+	if( pADCx->CR2 & ( 1 << ADC_CR2_DMA ) )
+	{
+		uint32_t DRAddr = (uint32_t) (uintptr_t) &pADCx->DR;
+
+		if( SIM_DMARequest(DRAddr) )
+		{
+			pADCx->SR &= ~( 1 << ADC_SR_EOC );
+		}
+		else if( pADCx->CR2 & ( 1 << ADC_CR2_DDS ) )
+		{
+			pADCx->SR |= ( 1 << ADC_SR_OVR );
+		}
+
+		if( !( pADCx->CR2 & ( 1 << ADC_CR2_DDS ) ) && !SIM_DMAIsArmed(DRAddr) )
+		{
+			pADC->Active = 0;
+			return;
+		}
+	}
+	else if( ( Instance < SIM_ADCMultiNumOfADCs() ) && ( ( ADCCOMMON->CCR >> ADC_CCR_DMA_1_0 ) & 0x3 ) )
+	{
+		//Multi ADC mode - read through ADC_CDR by SIM_ADCMultiModel once the whole group has converted
+		pADC->DataReady = 1;
+	}
+
+	//5. Next rank, next sequence (continuous) or done
+	if( SeqEnd )
+	{
+		pADC->SeqIndex = 0;
+
+		if( !( pADCx->CR2 & ( 1 << ADC_CR2_CONT ) ) )
+		{
+			pADC->Active = 0;
+			return;
+		}
+	}
+	else
+	{
+		pADC->SeqIndex++;
+	}
+
+	pADC->StepsLeft = SIM_ADCConversionSteps(pADCx, SIM_ADCSeqChannel(pADCx, pADC->SeqIndex));
+}
+
+
+static void SIM_ADCStart(SIM_ADCState_t *pADC)
+{
+	//Trigger is ignored while a regular sequence is being converted. Reads of DR can't be seen, so EOC is cleared here
+	if( pADC->Active )
+	{
+		return;
+	}
+
+	pADC->Active = 1;
+	pADC->SeqIndex = 0;
+	pADC->StepsLeft = SIM_ADCConversionSteps(pADC->pADCx, SIM_ADCSeqChannel(pADC->pADCx, 0));
+
+	pADC->DataReady = 0;
+
+	pADC->pADCx->SR &= ~( 1 << ADC_SR_EOC );
+	pADC->pADCx->SR |= ( 1 << ADC_SR_STRT );
+
+	//Multi ADC mode - the ADC1 trigger starts the slaves (already converting slaves ignore it like any trigger)
+	if( ( pADC == &SIM_ADC[0] ) && ( SIM_ADCMultiNumOfADCs() > 1 ) )
+	{
+		SIM_ADCCDRLowValid = 0;
+
+		for(uint8_t i = 1; i < SIM_ADCMultiNumOfADCs(); i++)
+		{
+			if( SIM_ADC[i].pADCx->CR2 & ( 1 << ADC_CR2_ADON ) )
+			{
+				SIM_ADCStart(&SIM_ADC[i]);
+			}
+		}
+	}
+}
+
+
+static void SIM_ADCMultiModel(void)
+{
+	uint8_t NumOfADCs = SIM_ADCMultiNumOfADCs();
+	uint8_t DMAMode = ( ( ADCCOMMON->CCR >> ADC_CCR_DMA_1_0 ) & 0x3 );
+	uint32_t CDRAddr = (uint32_t) (uintptr_t) &ADCCOMMON->CDR;
+	uint8_t Lost = 0;
+
+	if( ( NumOfADCs == 1 ) || !DMAMode )
+	{
+		return;
+	}
+
+	//1. ADC_CDR requests start once every ADC of the group has converted the rank
+	for(uint8_t i = 0; i < NumOfADCs; i++)
+	{
+		if( !SIM_ADC[i].DataReady )
+		{
+			return;
+		}
+	}
+
+	//2. Results go out ADC1 first - mode 1 one halfword each, mode 2 packed in pairs (second result in the upper half)
+	for(uint8_t i = 0; i < NumOfADCs; i++)
+	{
+		uint16_t Value = (uint16_t) SIM_ADC[i].pADCx->DR;
+
+		SIM_ADC[i].DataReady = 0;
+
+		if( DMAMode == 2 )
+		{
+			if( !SIM_ADCCDRLowValid )
+			{
+				SIM_ADCCDRLow = Value;
+				SIM_ADCCDRLowValid = 1;
+				continue;
+			}
+
+			ADCCOMMON->CDR = ( (uint32_t) Value << 16 ) | SIM_ADCCDRLow;
+			SIM_ADCCDRLowValid = 0;
+		}
+		else
+		{
+			ADCCOMMON->CDR = Value;
+		}
+
+		if( !SIM_DMARequest(CDRAddr) )
+		{
+			Lost = 1;
+		}
+	}
+
+	for(uint8_t i = 0; i < NumOfADCs; i++)
+	{
+		SIM_ADC[i].pADCx->SR &= ~( 1 << ADC_SR_EOC );
+	}
+
+	//3. Same end of requests as a single ADC - overrun with DDS, group stopped without it once the stream is done
+	if( Lost && ( ADCCOMMON->CCR & ( 1 << ADC_CCR_DDS ) ) )
+	{
+		ADC1->SR |= ( 1 << ADC_SR_OVR );
+	}
+
+	if( !( ADCCOMMON->CCR & ( 1 << ADC_CCR_DDS ) ) && !SIM_DMAIsArmed(CDRAddr) )
+	{
+		for(uint8_t i = 0; i < NumOfADCs; i++)
+		{
+			SIM_ADC[i].Active = 0;
+		}
+	}
+}
+
+
+static uint8_t SIM_ADCMultiNumOfADCs(void)
+{
+	//CCR MULTI: 0 independent, 0b0xxxx dual (ADC1, ADC2), 0b1xxxx triple (ADC1-ADC3)
+	uint8_t Multi = ( ( ADCCOMMON->CCR >> ADC_CCR_MULTI_4_0 ) & 0x1F );
+
+	if( !Multi )
+	{
+		return 1;
+	}
+
+	return ( Multi & 0x10 ) ? 3 : 2;
+}
+
+
+static uint8_t SIM_ADCSeqChannel(ADC_RegDef_t *pADCx, uint8_t Rank)
+{
+	//SQ1-6 in SQR3, SQ7-12 in SQR2, SQ13-16 in SQR1
+	uint32_t sqr = ( Rank < 6 ) ? pADCx->SQR3 : ( ( Rank < 12 ) ? pADCx->SQR2 : pADCx->SQR1 );
+	uint8_t Channel = ( ( sqr >> ( 5 * ( Rank % 6 ) ) ) & 0x1F );
+
+	return ( Channel < 19 ) ? Channel : 18;
+}
+
+
+static uint32_t SIM_ADCConversionSteps(ADC_RegDef_t *pADCx, uint8_t Channel)
+{
+	//(sampling time + 12) ADC clock cycles, ADC clock = PCLK2 / ADCPRE
+	static const uint16_t SampleCycles[8] = { 3, 15, 28, 56, 84, 112, 144, 480 };
+	uint32_t StepCycles = SIM_CyclesPerStep(SIM_CLK_PCLK2);
+
+	uint32_t smpr = ( Channel < 10 ) ? pADCx->SMPR2 : pADCx->SMPR1;
+	uint8_t smp = ( ( smpr >> ( 3 * ( Channel % 10 ) ) ) & 0x7 );
+	uint8_t div = 2 * ( ( ( ADCCOMMON->CCR >> ADC_CCR_ADCPRE_1_0 ) & 0x3 ) + 1 );
+	uint32_t cycles = ( SampleCycles[smp] + 12 ) * div;
+
+	return ( cycles + StepCycles - 1 ) / StepCycles;
+}
+
+
+static void SIM_I2CModel(uint8_t Instance)
+{
+	SIM_I2CState_t *pI2C = &SIM_I2C[Instance];
+	I2C_RegDef_t *pI2Cx = pI2C->pI2Cx;
+
+	if( !( pI2Cx->CR1 & ( 1 << I2C_CR1_PE ) ) )
+	{
+		pI2C->Phase = SIM_I2C_IDLE;
+		return;
+	}
+
+	//1. STOP then (repeated) START - both are cleared by hardware once generated
+	if( pI2Cx->CR1 & ( 1 << I2C_CR1_STOP ) )
+	{
+		pI2Cx->CR1 &= ~( 1 << I2C_CR1_STOP );
+		pI2Cx->SR1 &= ~( ( 1 << I2C_SR1_SB ) | ( 1 << I2C_SR1_ADDR ) | ( 1 << I2C_SR1_BTF ) | ( 1 << I2C_SR1_TXE ) | ( 1 << I2C_SR1_RXNE ) );
+		pI2Cx->SR2 &= ~( ( 1 << I2C_SR2_MSL ) | ( 1 << I2C_SR2_BUSY ) | ( 1 << I2C_SR2_TRA ) );
+		pI2Cx->DR = SIM_DR_EMPTY;
+		pI2C->Phase = SIM_I2C_IDLE;
+	}
+
+	if( pI2Cx->CR1 & ( 1 << I2C_CR1_START ) )
+	{
+		pI2Cx->CR1 &= ~( 1 << I2C_CR1_START );
+		pI2Cx->SR1 &= ~( ( 1 << I2C_SR1_ADDR ) | ( 1 << I2C_SR1_BTF ) | ( 1 << I2C_SR1_TXE ) | ( 1 << I2C_SR1_RXNE ) );
+		pI2Cx->SR1 |= ( 1 << I2C_SR1_SB );
+		pI2Cx->SR2 |= ( 1 << I2C_SR2_MSL ) | ( 1 << I2C_SR2_BUSY );
+		pI2Cx->DR = SIM_DR_EMPTY;
+		pI2C->Phase = SIM_I2C_ADDRESS;
+		return;
+	}
+
+	switch( pI2C->Phase )
+	{
+		case SIM_I2C_ADDRESS:
+		{
+			//2. Address byte written after SB - new frame, ACK (ADDR) or NACK (AF)
+			if( pI2Cx->DR == SIM_DR_EMPTY )
+			{
+				break;
+			}
+
+			uint8_t Address = ( pI2Cx->DR & 0xFF );
+			SIM_I2CFrame_t *pFrame = &pI2C->Frames[pI2C->FrameCount % SIM_I2C_MAX_FRAMES];
+
+			memset(pFrame, 0, sizeof(*pFrame));
+			pFrame->Address = Address;
+			pI2C->FrameCount++;
+
+			pI2Cx->DR = SIM_DR_EMPTY;
+			pI2Cx->SR1 &= ~( 1 << I2C_SR1_SB );
+
+			if( ( Address >> 1 ) == pI2C->NackAddr )
+			{
+				pFrame->Nacked = 1;
+				pI2Cx->SR1 |= ( 1 << I2C_SR1_AF );
+				pI2C->Phase = SIM_I2C_IDLE;
+				break;
+			}
+
+			pI2Cx->SR1 |= ( 1 << I2C_SR1_ADDR );
+
+			if( Address & 0x1 )
+			{
+				pI2Cx->SR2 &= ~( 1 << I2C_SR2_TRA );
+			}
+			else
+			{
+				pI2Cx->SR2 |= ( 1 << I2C_SR2_TRA );
+			}
+
+			pI2C->Phase = SIM_I2C_ADDR_SET;
+			break;
+		}
+
+		case SIM_I2C_ADDR_SET:
+		{
+			//3. ADDR has been seen by the driver (SR1 then SR2 read) - data phase
+			pI2Cx->SR1 &= ~( 1 << I2C_SR1_ADDR );
+			pI2C->ByteSent = 0;
+			pI2C->RxIndex = 0;
+
+			if( pI2Cx->SR2 & ( 1 << I2C_SR2_TRA ) )
+			{
+				pI2Cx->SR1 |= ( 1 << I2C_SR1_TXE );
+				pI2C->Phase = SIM_I2C_TX;
+			}
+			else
+			{
+				pI2C->Phase = SIM_I2C_RX;
+			}
+			break;
+		}
+
+		case SIM_I2C_TX:
+		{
+			//4. Byte in DR goes straight through the shift register - BTF once a byte went out and nothing follows it
+			if( ( pI2Cx->CR2 & ( 1 << I2C_CR2_DMAEN ) ) && ( pI2Cx->DR == SIM_DR_EMPTY ) )
+			{
+				SIM_DMARequest( (uint32_t) (uintptr_t) &pI2Cx->DR );
+			}
+
+			if( pI2Cx->DR != SIM_DR_EMPTY )
+			{
+				SIM_I2CLogByte(pI2C, (uint8_t) pI2Cx->DR);
+				pI2Cx->DR = SIM_DR_EMPTY;
+				pI2Cx->SR1 |= ( 1 << I2C_SR1_TXE );
+				pI2Cx->SR1 &= ~( 1 << I2C_SR1_BTF );
+				pI2C->ByteSent = 1;
+			}
+			else if( pI2C->ByteSent )
+			{
+				pI2Cx->SR1 |= ( 1 << I2C_SR1_BTF );
+			}
+			break;
+		}
+
+		case SIM_I2C_RX:
+		{
+			//5. A new byte every step - the driver reads DR once per RXNE it sees
+			uint8_t Byte = ( pI2C->RxIndex < pI2C->RxLen ) ? pI2C->RxData[pI2C->RxIndex] : 0xFF;
+
+			pI2C->RxIndex++;
+			SIM_I2CLogByte(pI2C, Byte);
+
+			pI2Cx->DR = Byte;
+			pI2Cx->SR1 |= ( 1 << I2C_SR1_RXNE );
+
+			if( ( pI2Cx->CR2 & ( 1 << I2C_CR2_DMAEN ) ) && SIM_DMARequest( (uint32_t) (uintptr_t) &pI2Cx->DR ) )
+			{
+				pI2Cx->SR1 &= ~( 1 << I2C_SR1_RXNE );
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+
+static void SIM_I2CLogByte(SIM_I2CState_t *pI2C, uint8_t Byte)
+{
+	SIM_I2CFrame_t *pFrame = &pI2C->Frames[( pI2C->FrameCount - 1 ) % SIM_I2C_MAX_FRAMES];
+
+	if( pI2C->FrameCount && ( pFrame->Len < SIM_I2C_MAX_FRAME_LEN ) )
+	{
+		pFrame->Data[pFrame->Len++] = Byte;
+	}
+}
+
+
+static void SIM_USARTModel(uint8_t Instance)
+{
+	SIM_USARTState_t *pUSART = &SIM_USART[Instance];
+	USART_RegDef_t *pUSARTx = pUSART->pUSARTx;
+
+	if( !( pUSARTx->CR1 & ( 1 << USART_CR1_UE ) ) || !( pUSARTx->CR1 & ( 1 << USART_CR1_TE ) ) )
+	{
+		return;
+	}
+
+	//Transmitter is infinitely fast - TXE and TC stay set, whatever is written to DR is logged
+	if( ( pUSARTx->CR3 & ( 1 << USART_CR3_DMAT ) ) && ( pUSARTx->DR == SIM_DR_EMPTY ) )
+	{
+		SIM_DMARequest( (uint32_t) (uintptr_t) &pUSARTx->DR );
+	}
+
+	if( pUSARTx->DR != SIM_DR_EMPTY )
+	{
+		pUSART->Log[pUSART->Count % SIM_USART_LOG_LEN] = (uint8_t) pUSARTx->DR;
+		pUSART->Count++;
+		pUSARTx->DR = SIM_DR_EMPTY;
+	}
+
+	pUSARTx->SR |= ( 1 << USART_SR_TXE ) | ( 1 << USART_SR_TC );
+}
+
+
+static void SIM_DispatchIRQs(void)
+{
+	if( SIM_PRIMASK )
+	{
+		return;
+	}
+
+	//1. Pending and enabled IRQs in priority order (lower value first, then lower IRQ number like the NVIC)
+	const SIM_IRQ_t *pPending[SIM_IRQ_TABLE_LEN];
+	uint8_t NumPending = 0;
+
+	for(uint8_t i = 0; i < SIM_IRQ_TABLE_LEN; i++)
+	{
+		const SIM_IRQ_t *pIRQ = &SIM_IRQTable[i];
+
+		if( pIRQ->pHandler && SIM_NVICIsEnabled(pIRQ->IRQNumber) && pIRQ->pIsPending(pIRQ->Instance) )
+		{
+			uint8_t j = NumPending++;
+
+			while( ( j > 0 ) && ( SIM_NVICGetPriority(pPending[j - 1]->IRQNumber) > SIM_NVICGetPriority(pIRQ->IRQNumber) ) )
+			{
+				pPending[j] = pPending[j - 1];
+				j--;
+			}
+
+			pPending[j] = pIRQ;
+		}
+	}
+
+	//2. Run each to completion - an earlier handler may already have dealt with the cause of a later one
+	for(uint8_t i = 0; i < NumPending; i++)
+	{
+		if( SIM_PRIMASK || !SIM_NVICIsEnabled(pPending[i]->IRQNumber) || !pPending[i]->pIsPending(pPending[i]->Instance) )
+		{
+			continue;
+		}
+
+		SIM_InISR = 1;
+		SIM_IRQCount[pPending[i]->IRQNumber]++;
+		pPending[i]->pHandler();
+		SIM_InISR = 0;
+	}
+}
+
+
+static uint8_t SIM_IRQPending(void)
+{
+	//What ends WFI - any enabled IRQ with a pending source, masked by PRIMASK or not
+	for(uint8_t i = 0; i < SIM_IRQ_TABLE_LEN; i++)
+	{
+		const SIM_IRQ_t *pIRQ = &SIM_IRQTable[i];
+
+		if( pIRQ->pHandler && SIM_NVICIsEnabled(pIRQ->IRQNumber) && pIRQ->pIsPending(pIRQ->Instance) )
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+static uint8_t SIM_NVICIsEnabled(uint8_t IRQNumber)
+{
+	return ( ( NVIC_ISER0[IRQNumber / 32] >> ( IRQNumber % 32 ) ) & 0x1 );
+}
+
+
+static uint8_t SIM_NVICGetPriority(uint8_t IRQNumber)
+{
+	uint8_t ipr = ( ( *( NVIC_IPR_BASE_ADDR + ( IRQNumber / 4 ) ) >> ( 8 * ( IRQNumber % 4 ) ) ) & 0xFF );
+
+	return ( ipr >> ( 8 - NO_PR_BITS_IMPLEMENTED ) );
+}
+
+
+static uint8_t SIM_EXTIIsPending(uint8_t Instance)
+{
+	return ( ( ( EXTI->PR & EXTI->IMR ) >> Instance ) & 0x1 );
+}
+
+
+static uint8_t SIM_TIMIsPending(uint8_t Instance)
+{
+	TIM2_5_RegDef_t *pTIMx = SIM_TIM[Instance].pTIMx;
+
+	return ( ( pTIMx->SR & pTIMx->DIER & 0x1F ) != 0 );
+}
+
+
+static uint8_t SIM_ADCIsPending(uint8_t Instance)
+{
+	//ADC1, ADC2 and ADC3 share one IRQ
+	(void) Instance;
+
+	for(uint8_t i = 0; i < SIM_NUM_ADC; i++)
+	{
+		ADC_RegDef_t *pADCx = SIM_ADC[i].pADCx;
+		uint32_t sr = pADCx->SR;
+		uint32_t cr1 = pADCx->CR1;
+
+		if( ( ( sr & ( 1 << ADC_SR_EOC ) ) && ( cr1 & ( 1 << ADC_CR1_EOCIE ) ) )
+			|| ( ( sr & ( 1 << ADC_SR_AWD ) ) && ( cr1 & ( 1 << ADC_CR1_AWDIE ) ) )
+			|| ( ( sr & ( 1 << ADC_SR_JEOC ) ) && ( cr1 & ( 1 << ADC_CR1_JEOCIE ) ) )
+			|| ( ( sr & ( 1 << ADC_SR_OVR ) ) && ( cr1 & ( 1 << ADC_CR1_OVRIE ) ) ) )
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+static uint8_t SIM_DMAIsPending(uint8_t Instance)
+{
+	static const uint8_t FlagShift[4] = { 0, 6, 16, 22 };
+
+	DMA_RegDef_t *pDMAx = SIM_DMA[Instance / 8];
+	uint8_t Stream = Instance % 8;
+	DMA_Stream_RegDef_t *pStream = &pDMAx->STREAM[Stream];
+	uint32_t isr = ( ( ( Stream < 4 ) ? pDMAx->LISR : pDMAx->HISR ) >> FlagShift[Stream % 4] );
+	uint32_t cr = pStream->CR;
+
+	return ( ( ( isr & ( 1 << DMA_ISR_TCIF ) ) && ( cr & ( 1 << DMA_SxCR_TCIE ) ) )
+			|| ( ( isr & ( 1 << DMA_ISR_HTIF ) ) && ( cr & ( 1 << DMA_SxCR_HTIE ) ) )
+			|| ( ( isr & ( 1 << DMA_ISR_TEIF ) ) && ( cr & ( 1 << DMA_SxCR_TEIE ) ) )
+			|| ( ( isr & ( 1 << DMA_ISR_DMEIF ) ) && ( cr & ( 1 << DMA_SxCR_DMEIE ) ) )
+			|| ( ( isr & ( 1 << DMA_ISR_FEIF ) ) && ( pStream->FCR & ( 1 << DMA_SxFCR_FEIE ) ) ) );
+}
+
+
+static uint8_t SIM_I2CEvIsPending(uint8_t Instance)
+{
+	I2C_RegDef_t *pI2Cx = SIM_I2C[Instance].pI2Cx;
+	uint32_t sr1 = pI2Cx->SR1;
+	uint32_t cr2 = pI2Cx->CR2;
+	uint32_t EvFlags = ( 1 << I2C_SR1_SB ) | ( 1 << I2C_SR1_ADDR ) | ( 1 << I2C_SR1_BTF ) | ( 1 << I2C_SR1_ADD10 ) | ( 1 << I2C_SR1_STOPF );
+	uint32_t BufFlags = ( 1 << I2C_SR1_TXE ) | ( 1 << I2C_SR1_RXNE );
+
+	return ( ( cr2 & ( 1 << I2C_CR2_ITEVTEN ) ) && ( ( sr1 & EvFlags ) || ( ( cr2 & ( 1 << I2C_CR2_ITBUFEN ) ) && ( sr1 & BufFlags ) ) ) );
+}
+
+
+static uint8_t SIM_I2CErIsPending(uint8_t Instance)
+{
+	I2C_RegDef_t *pI2Cx = SIM_I2C[Instance].pI2Cx;
+	uint32_t ErFlags = ( 1 << I2C_SR1_BERR ) | ( 1 << I2C_SR1_ARLO ) | ( 1 << I2C_SR1_AF ) | ( 1 << I2C_SR1_OVR ) | ( 1 << I2C_SR1_PECERR )
+					 | ( 1 << I2C_SR1_TIMEOUT ) | ( 1 << I2C_SR1_SMBALERT );
+
+	return ( ( pI2Cx->CR2 & ( 1 << I2C_CR2_ITERREN ) ) && ( pI2Cx->SR1 & ErFlags ) );
+}
+
+
+static uint8_t SIM_SPIIsPending(uint8_t Instance)
+{
+	SPI_RegDef_t *pSPIx = SIM_SPI[Instance];
+	uint32_t sr = pSPIx->SR;
+	uint32_t cr2 = pSPIx->CR[1];
+
+	return ( ( ( cr2 & ( 1 << SPI_CR2_TXEIE ) ) && ( sr & ( 1 << SPI_SR_TXE ) ) ) || ( ( cr2 & ( 1 << SPI_CR2_RXNEIE ) ) && ( sr & ( 1 << SPI_SR_RXNE ) ) ) );
+}
+
+
+static uint8_t SIM_USARTIsPending(uint8_t Instance)
+{
+	//TXE, TC, RXNE and IDLE share bit positions in SR and CR1 (TXEIE, TCIE, RXNEIE, IDLEIE)
+	USART_RegDef_t *pUSARTx = SIM_USART[Instance].pUSARTx;
+
+	return ( ( pUSARTx->SR & pUSARTx->CR1 & 0xF0 ) != 0 );
+}
@@ -0,0 +1,831 @@
+/*
+ * stm32f407vg_sim_onewire.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+#include <string.h>
+#include "stm32f407vg_sim.h"
+#include "stm32f407vg_sim_onewire.h"
+#include "ds18b20_temp_sensor.h"
+
+/*
+ * Device protocol states
+ */
+#define SIM_OW_STATE_IDLE						0						//Not selected - ignores the bus until the next reset
+#define SIM_OW_STATE_ROM_CMD					1						//Receiving the ROM command
+#define SIM_OW_STATE_MATCH						2						//Receiving the ROM code of a Match ROM
+#define SIM_OW_STATE_SEARCH						3						//ROM search triplets - bit, complement, then the branch taken
+#define SIM_OW_STATE_FUNC_CMD					4						//Receiving the function command
+#define SIM_OW_STATE_WRITE_SP					5						//Receiving TH, TL and configuration register
+#define SIM_OW_STATE_TX							6						//Sending TxBuffer
+#define SIM_OW_STATE_BUSY						7						//Read slots return 0 until the Convert T / Copy / Recall is done
+
+#define SIM_OW_FAMILY_CODE						0x28
+#define SIM_OW_NUM_FAULTS						3
+
+typedef struct
+{
+	uint8_t 		ROM[8];
+	uint8_t 		Scratchpad[9];
+	uint8_t 		E2[3];										/* TH, TL, configuration register */
+	int16_t 		Temperature;								/* 1/16 °C - what the next Convert T measures */
+	uint8_t 		Alarm;										/* Alarm condition of the last conversion */
+	uint8_t 		State;
+	uint8_t 		NextState;									/* State once TxBuffer is sent */
+	uint8_t 		BitCount;									/* Bits received / sent in the current state */
+	uint8_t 		RxBuffer[8];
+	uint8_t 		TxBuffer[9];
+	uint8_t 		TxLen;
+	uint8_t 		SearchBit;									/* ROM bit of the search triplet under way (0-63) */
+	uint8_t 		SearchSlot;									/* Slot of the triplet (0: bit, 1: complement, 2: branch) */
+	uint8_t 		BusyCmd;									/* Function command that completes at BusyUntil, 0 if none */
+	uint64_t 		BusyUntil;
+	uint64_t 		DriveFrom;									/* Bus held low from DriveFrom up to DriveUntil */
+	uint64_t 		DriveUntil;
+	uint64_t 		SampleAt;									/* Sample point of the write slot under way, 0 if none */
+	uint32_t 		Faults[SIM_OW_NUM_FAULTS];					/* Faults left to show (@SIM_OW_Fault) */
+}SIM_OWDevice_t;
+
+typedef struct
+{
+	GPIO_RegDef_t 	*pGPIOx;									/* NULL while no bus is attached */
+	uint8_t 		Pin;
+	uint8_t 		MasterLow;
+	uint8_t 		BusLow;
+	uint64_t 		MasterFall;									/* Master's last falling edge */
+	uint64_t 		LastRise;									/* Bus last released by everyone */
+	uint64_t 		RiseBeforeFall;								/* LastRise when the master last pulled low */
+	uint64_t 		ResetRise;									/* End of the last reset pulse */
+	uint64_t 		PhaseEnd;									/* End of the last time slot / master Rx phase */
+	uint8_t 		InTransaction;
+	SIM_OWTransaction_t Current;
+	SIM_OWTransaction_t Log[SIM_OW_LOG_LEN];
+	uint32_t 		LogCount;
+	SIM_OWStats_t 	Stats;
+}SIM_OWBus_t;
+
+static SIM_OWBus_t SIM_OWBus;
+static SIM_OWDevice_t SIM_OWDevices[SIM_OW_MAX_DEVICES];
+static uint8_t SIM_OWNumDevices;
+
+/*********** 1-wire model helper functions prototype section ***********/
+static void SIM_OWMasterFall(uint64_t Now);
+static void SIM_OWMasterRise(uint64_t Now);
+static void SIM_OWOpen(uint64_t Start);
+static void SIM_OWClose(uint64_t End);
+static uint8_t SIM_OWDeviceReset(SIM_OWDevice_t *pDev, uint64_t Now);
+static void SIM_OWDeviceSlot(SIM_OWDevice_t *pDev, uint64_t Now);
+static void SIM_OWDeviceSend(SIM_OWDevice_t *pDev, uint64_t Now, uint8_t Bit);
+static void SIM_OWDeviceReceive(SIM_OWDevice_t *pDev, uint64_t Now, uint8_t Bit);
+static void SIM_OWRomCommand(SIM_OWDevice_t *pDev, uint8_t Command);
+static void SIM_OWFunctionCommand(SIM_OWDevice_t *pDev, uint64_t Now, uint8_t Command);
+static void SIM_OWBusyDone(SIM_OWDevice_t *pDev);
+static void SIM_OWUpdateCRC(SIM_OWDevice_t *pDev);
+static uint8_t SIM_OWCRC8(const uint8_t *pData, uint8_t Len);
+
+/********************************************************/
+
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireReset
+
+ 	 * @brief  		- API that detaches the bus and removes every device
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Called by SIM_Reset
+
+*/
+void SIM_OneWireReset(void)
+{
+	memset(&SIM_OWBus, 0, sizeof(SIM_OWBus));
+	memset(SIM_OWDevices, 0, sizeof(SIM_OWDevices));
+	SIM_OWNumDevices = 0;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireAttach
+
+ 	 * @brief  		- API that hangs the 1-wire bus off a GPIO pin (4.7k pull up - the line reads high when released)
+
+ 	 * @param 		- *pGPIOx : GPIO port
+ 	 * @param 		- PinNumber : 0 - 15
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Clears the statistics and the transaction log
+
+*/
+void SIM_OneWireAttach(GPIO_RegDef_t *pGPIOx, uint8_t PinNumber)
+{
+	SIM_OWBus.pGPIOx = pGPIOx;
+	SIM_OWBus.Pin = PinNumber;
+	SIM_OWBus.MasterLow = 0;
+	SIM_OWBus.BusLow = 0;
+	SIM_OWBus.InTransaction = 0;
+	SIM_OWBus.LogCount = 0;
+	SIM_OWBus.LastRise = SIM_GetTimeUsecs();
+
+	SIM_OneWireClearStats();
+	SIM_GPIOSetInput(pGPIOx, PinNumber, 1);
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireAddDevice
+
+ 	 * @brief  		- API that connects a virtual DS18B20 to the bus
+
+ 	 * @param 		- Serial : 48-bit serial number of the ROM code (family code 0x28 and the CRC are added)
+
+ 	 * @retval 		- device index, 0xFF if SIM_OW_MAX_DEVICES are already connected
+
+ 	 * @Note		- Power-on state: 85°C in the temperature register, TH 75°C, TL 70°C, 12-bit resolution. Measures 25°C
+
+*/
+uint8_t SIM_OneWireAddDevice(uint64_t Serial)
+{
+	static const uint8_t PowerOn[9] = { 0x50, 0x05, 75, 70, 0x7F, 0xFF, 0x0C, 0x10, 0x00 };
+
+	if( SIM_OWNumDevices >= SIM_OW_MAX_DEVICES )
+	{
+		return 0xFF;
+	}
+
+	SIM_OWDevice_t *pDev = &SIM_OWDevices[SIM_OWNumDevices];
+
+	memset(pDev, 0, sizeof(*pDev));
+
+	pDev->ROM[0] = SIM_OW_FAMILY_CODE;
+
+	for(uint8_t i = 0; i < 6; i++)
+	{
+		pDev->ROM[i + 1] = ( Serial >> ( 8 * i ) ) & 0xFF;
+	}
+
+	pDev->ROM[7] = SIM_OWCRC8(pDev->ROM, 7);
+
+	memcpy(pDev->Scratchpad, PowerOn, sizeof(PowerOn));
+	memcpy(pDev->E2, &PowerOn[2], sizeof(pDev->E2));
+	SIM_OWUpdateCRC(pDev);
+
+	pDev->Temperature = 25 * 16;
+	pDev->State = SIM_OW_STATE_IDLE;
+
+	return SIM_OWNumDevices++;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireSetTemperature
+
+ 	 * @brief  		- API that sets the temperature a virtual DS18B20 measures on its next Convert T
+
+ 	 * @param 		- Device : index returned by SIM_OneWireAddDevice
+ 	 * @param 		- Raw : temperature in 1/16 °C (two's complement, i.e., -162 = -10.125°C)
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Truncated to the configured resolution when converted
+
+*/
+void SIM_OneWireSetTemperature(uint8_t Device, int16_t Raw)
+{
+	if( Device < SIM_OWNumDevices )
+	{
+		SIM_OWDevices[Device].Temperature = Raw;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireInjectFault
+
+ 	 * @brief  		- API that makes a virtual DS18B20 misbehave a number of times
+
+ 	 * @param 		- Device : index returned by SIM_OneWireAddDevice
+ 	 * @param 		- Fault : possible values from @SIM_OW_Fault
+ 	 * @param 		- Count : number of resets / bytes / bits affected, 0 to clear
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Every fault shown is counted in SIM_OWStats_t FaultsInjected
+
+*/
+void SIM_OneWireInjectFault(uint8_t Device, uint8_t Fault, uint32_t Count)
+{
+	if( ( Device < SIM_OWNumDevices ) && ( Fault < SIM_OW_NUM_FAULTS ) )
+	{
+		SIM_OWDevices[Device].Faults[Fault] = Count;
+	}
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireGetROM
+
+ 	 * @brief  		- API that returns the ROM code of a virtual DS18B20
+
+ 	 * @param 		- Device : index returned by SIM_OneWireAddDevice
+
+ 	 * @retval 		- 8 bytes in bus order (family code first, CRC last), NULL for an unknown device
+
+ 	 * @Note		- none
+
+*/
+const uint8_t *SIM_OneWireGetROM(uint8_t Device)
+{
+	return ( Device < SIM_OWNumDevices ) ? SIM_OWDevices[Device].ROM : NULL;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireGetStats
+
+ 	 * @brief  		- API that returns the bus statistics
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- statistics since the bus was attached or the last SIM_OneWireClearStats
+
+ 	 * @Note		- A transaction is only counted once it has ended. Utilization is BusyUsecs over the time since StartUsecs
+
+*/
+const SIM_OWStats_t *SIM_OneWireGetStats(void)
+{
+	return &SIM_OWBus.Stats;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireClearStats
+
+ 	 * @brief  		- API that starts a new statistics period
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- The transaction log is kept
+
+*/
+void SIM_OneWireClearStats(void)
+{
+	memset(&SIM_OWBus.Stats, 0, sizeof(SIM_OWBus.Stats));
+
+	SIM_OWBus.Stats.StartUsecs = SIM_GetTimeUsecs();
+	SIM_OWBus.Stats.MinUsecs = 0xFFFFFFFF;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireGetTransactionCount
+
+ 	 * @brief  		- API that returns how many transactions have ended since the bus was attached
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- number of transactions
+
+ 	 * @Note		- Only the last SIM_OW_LOG_LEN can be read back with SIM_OneWireGetTransaction
+
+*/
+uint32_t SIM_OneWireGetTransactionCount(void)
+{
+	return SIM_OWBus.LogCount;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireGetTransaction
+
+ 	 * @brief  		- API that returns one logged transaction
+
+ 	 * @param 		- Index : 0 for the first transaction since the bus was attached
+
+ 	 * @retval 		- transaction, or NULL if it has not ended yet or was already overwritten
+
+ 	 * @Note		- none
+
+*/
+const SIM_OWTransaction_t *SIM_OneWireGetTransaction(uint32_t Index)
+{
+	if( ( Index < SIM_OWBus.LogCount ) && ( ( SIM_OWBus.LogCount - Index ) <= SIM_OW_LOG_LEN ) )
+	{
+		return &SIM_OWBus.Log[Index % SIM_OW_LOG_LEN];
+	}
+
+	return NULL;
+}
+
+
+/*********************** Function Documentation ***************************************
+ *
+ 	 * @fn			- SIM_OneWireModel
+
+ 	 * @brief  		- Advances the bus and every device by one step
+
+ 	 * @param 		- none
+
+ 	 * @retval 		- none
+
+ 	 * @Note		- Run by the simulator every free-running step (also while an ISR busy-waits), before the GPIO model
+ 	 * 				- computes IDR - the master reads the level the devices drive in the same step
+
+*/
+void SIM_OneWireModel(void)
+{
+	GPIO_RegDef_t *pGPIOx = SIM_OWBus.pGPIOx;
+
+	if( pGPIOx == NULL )
+	{
+		return;
+	}
+
+	uint64_t Now = SIM_GetTimeUsecs();
+	uint8_t Pin = SIM_OWBus.Pin;
+	uint8_t DevicesLow = 0;
+
+	//1. Master pulls the bus low with the pin in output mode and ODR 0 (open drain), anything else releases it
+	uint8_t MasterLow = ( ( ( ( pGPIOx->MODER >> ( 2 * Pin ) ) & 0x3 ) == GPIO_MODE_OUT ) && !( pGPIOx->ODR & ( 1 << Pin ) ) );
+
+	if( MasterLow && !SIM_OWBus.MasterLow )
+	{
+		SIM_OWMasterFall(Now);
+	}
+	else if( !MasterLow && SIM_OWBus.MasterLow )
+	{
+		SIM_OWMasterRise(Now);
+	}
+
+	SIM_OWBus.MasterLow = MasterLow;
+
+	//2. Devices driving the bus (presence pulse, '0' bits) - conversions and E2 accesses run whatever the bus does
+	for(uint8_t d = 0; d < SIM_OWNumDevices; d++)
+	{
+		SIM_OWDevice_t *pDev = &SIM_OWDevices[d];
+
+		if( pDev->BusyCmd && ( Now >= pDev->BusyUntil ) )
+		{
+			SIM_OWBusyDone(pDev);
+		}
+
+		if( ( Now >= pDev->DriveFrom ) && ( Now < pDev->DriveUntil ) )
+		{
+			DevicesLow = 1;
+		}
+	}
+
+	//3. Devices reading a write slot sample the wired-AND
+	for(uint8_t d = 0; d < SIM_OWNumDevices; d++)
+	{
+		SIM_OWDevice_t *pDev = &SIM_OWDevices[d];
+
+		if( pDev->SampleAt && ( Now >= pDev->SampleAt ) )
+		{
+			pDev->SampleAt = 0;
+			SIM_OWDeviceReceive(pDev, Now, !( MasterLow || DevicesLow ) );
+		}
+	}
+
+	//4. Bus level - a transaction ends once the bus has been idle long enough
+	uint8_t BusLow = ( MasterLow || DevicesLow );
+
+	if( !BusLow && SIM_OWBus.BusLow )
+	{
+		SIM_OWBus.LastRise = Now;
+	}
+
+	SIM_OWBus.BusLow = BusLow;
+
+	if( SIM_OWBus.InTransaction && !BusLow && ( ( Now - SIM_OWBus.LastRise ) >= SIM_OW_IDLE_USECS ) &&
+		( Now >= ( SIM_OWBus.PhaseEnd + SIM_OW_IDLE_USECS ) ) )
+	{
+		SIM_OWClose( ( SIM_OWBus.PhaseEnd > SIM_OWBus.LastRise ) ? SIM_OWBus.PhaseEnd : SIM_OWBus.LastRise );
+	}
+
+	SIM_GPIOSetInput(pGPIOx, Pin, !DevicesLow);
+}
+
+
+
+/*----------------------------------------------------------------------------------------------------*/
+//Helper functions
+
+static void SIM_OWMasterFall(uint64_t Now)
+{
+	SIM_OWStats_t *pStats = &SIM_OWBus.Stats;
+
+	//1. Time slot or reset pulse (only known once it ends) - the previous one and the recovery time have to be over
+	if( SIM_OWBus.InTransaction )
+	{
+		if( SIM_OWBus.Current.Slots == 0 )
+		{
+			if( ( Now - SIM_OWBus.ResetRise ) < SIM_OW_MIN_RSTH_USECS )
+			{
+				pStats->ResetViolations++;
+			}
+		}
+		else if( ( Now - SIM_OWBus.MasterFall ) < SIM_OW_MIN_SLOT_USECS )
+		{
+			pStats->SlotViolations++;
+		}
+	}
+
+	SIM_OWBus.RiseBeforeFall = SIM_OWBus.LastRise;
+	SIM_OWBus.MasterFall = Now;
+
+	//2. Every device starts its side of the slot on the falling edge
+	for(uint8_t d = 0; d < SIM_OWNumDevices; d++)
+	{
+		SIM_OWDeviceSlot(&SIM_OWDevices[d], Now);
+	}
+}
+
+
+static void SIM_OWMasterRise(uint64_t Now)
+{
+	SIM_OWStats_t *pStats = &SIM_OWBus.Stats;
+	SIM_OWTransaction_t *pT = &SIM_OWBus.Current;
+	uint32_t Low = (uint32_t) ( Now - SIM_OWBus.MasterFall );
+
+	if( Low >= SIM_OW_RESET_DETECT_USECS )
+	{
+		//1. Reset pulse - ends the transaction before it and starts a new one. Devices answer with a presence pulse
+		uint8_t Presence = 0;
+
+		if( Low < SIM_OW_MIN_RSTL_USECS )
+		{
+			pStats->ResetViolations++;
+		}
+
+		if( SIM_OWBus.InTransaction )
+		{
+			uint64_t End = ( SIM_OWBus.PhaseEnd > SIM_OWBus.RiseBeforeFall ) ? SIM_OWBus.PhaseEnd : SIM_OWBus.RiseBeforeFall;
+
+			SIM_OWClose( ( End < SIM_OWBus.MasterFall ) ? End : SIM_OWBus.MasterFall );
+		}
+
+		SIM_OWOpen(SIM_OWBus.MasterFall);
+
+		for(uint8_t d = 0; d < SIM_OWNumDevices; d++)
+		{
+			Presence |= SIM_OWDeviceReset(&SIM_OWDevices[d], Now);
+		}
+
+		pT->Presence = Presence;
+		pStats->NoPresence += !Presence;
+
+		SIM_OWBus.ResetRise = Now;
+		SIM_OWBus.PhaseEnd = Now + SIM_OW_MIN_RSTH_USECS;
+		return;
+	}
+
+	//2. Time slot - the master's low time is a '1' / read slot or a '0', nothing in between
+	if( ( Low > SIM_OW_MAX_LOW1_USECS ) && ( ( Low < SIM_OW_MIN_LOW0_USECS ) || ( Low > SIM_OW_MAX_LOW0_USECS ) ) )
+	{
+		pStats->LowViolations++;
+	}
+
+	if( SIM_OWBus.InTransaction )
+	{
+		if( pT->Slots < ( 8 * sizeof(pT->Command) ) )
+		{
+			pT->Command[pT->Slots / 8] |= ( ( Low <= SIM_OW_MAX_LOW1_USECS ) << ( pT->Slots % 8 ) );
+		}
+
+		pT->Slots++;
+		pStats->Slots++;
+		SIM_OWBus.PhaseEnd = SIM_OWBus.MasterFall + SIM_OW_MIN_SLOT_USECS - 1;
+	}
+}
+
+
+static void SIM_OWOpen(uint64_t Start)
+{
+	memset(&SIM_OWBus.Current, 0, sizeof(SIM_OWBus.Current));
+
+	SIM_OWBus.Current.StartUsecs = Start;
+	SIM_OWBus.InTransaction = 1;
+}
+
+
+static void SIM_OWClose(uint64_t End)
+{
+	SIM_OWTransaction_t *pT = &SIM_OWBus.Current;
+	SIM_OWStats_t *pStats = &SIM_OWBus.Stats;
+
+	pT->Usecs = ( End > pT->StartUsecs ) ? (uint32_t) ( End - pT->StartUsecs ) : 0;
+
+	//Transactions started before the statistics were cleared are only logged
+	if( pT->StartUsecs >= pStats->StartUsecs )
+	{
+		pStats->Transactions++;
+		pStats->BusyUsecs += pT->Usecs;
+		pStats->MinUsecs = ( pT->Usecs < pStats->MinUsecs ) ? pT->Usecs : pStats->MinUsecs;
+		pStats->MaxUsecs = ( pT->Usecs > pStats->MaxUsecs ) ? pT->Usecs : pStats->MaxUsecs;
+	}
+
+	SIM_OWBus.Log[SIM_OWBus.LogCount % SIM_OW_LOG_LEN] = *pT;
+	SIM_OWBus.LogCount++;
+	SIM_OWBus.InTransaction = 0;
+}
+
+
+static uint8_t SIM_OWDeviceReset(SIM_OWDevice_t *pDev, uint64_t Now)
+{
+	pDev->SampleAt = 0;
+	pDev->BitCount = 0;
+	pDev->DriveUntil = 0;
+
+	if( pDev->Faults[SIM_OW_FAULT_NO_PRESENCE] )
+	{
+		pDev->Faults[SIM_OW_FAULT_NO_PRESENCE]--;
+		SIM_OWBus.Stats.FaultsInjected++;
+
+		pDev->State = SIM_OW_STATE_IDLE;
+		return 0;
+	}
+
+	//Presence pulse, then wait for the ROM command
+	pDev->DriveFrom = Now + SIM_OW_PRESENCE_WAIT_USECS;
+	pDev->DriveUntil = pDev->DriveFrom + SIM_OW_PRESENCE_USECS;
+	pDev->State = SIM_OW_STATE_ROM_CMD;
+
+	return 1;
+}
+
+
+static void SIM_OWDeviceSlot(SIM_OWDevice_t *pDev, uint64_t Now)
+{
+	uint8_t Bit;
+
+	switch( pDev->State )
+	{
+		case SIM_OW_STATE_ROM_CMD:
+		case SIM_OW_STATE_MATCH:
+		case SIM_OW_STATE_FUNC_CMD:
+		case SIM_OW_STATE_WRITE_SP:
+			pDev->SampleAt = Now + SIM_OW_SAMPLE_USECS;
+			break;
+
+		case SIM_OW_STATE_SEARCH:
+			if( pDev->SearchSlot < 2 )
+			{
+				Bit = ( pDev->ROM[pDev->SearchBit / 8] >> ( pDev->SearchBit % 8 ) ) & 0x1;
+				SIM_OWDeviceSend(pDev, Now, ( pDev->SearchSlot ) ? !Bit : Bit);
+				pDev->SearchSlot++;
+			}
+			else
+			{
+				pDev->SampleAt = Now + SIM_OW_SAMPLE_USECS;
+			}
+			break;
+
+		case SIM_OW_STATE_TX:
+			if( ( ( pDev->BitCount % 8 ) == 0 ) && pDev->Faults[SIM_OW_FAULT_BIT_ERROR] )
+			{
+				pDev->Faults[SIM_OW_FAULT_BIT_ERROR]--;
+				SIM_OWBus.Stats.FaultsInjected++;
+				pDev->TxBuffer[pDev->BitCount / 8] ^= 0x01;
+			}
+
+			Bit = ( pDev->TxBuffer[pDev->BitCount / 8] >> ( pDev->BitCount % 8 ) ) & 0x1;
+			SIM_OWDeviceSend(pDev, Now, Bit);
+
+			if( ++pDev->BitCount >= ( pDev->TxLen * 8 ) )
+			{
+				pDev->State = pDev->NextState;
+				pDev->BitCount = 0;
+			}
+			break;
+
+		case SIM_OW_STATE_BUSY:
+			SIM_OWDeviceSend(pDev, Now, ( pDev->BusyCmd == 0 ) );
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+static void SIM_OWDeviceSend(SIM_OWDevice_t *pDev, uint64_t Now, uint8_t Bit)
+{
+	//A '1' leaves the bus to the pull up, a '0' holds it low past the master's sample point (unless faulted)
+	if( Bit )
+	{
+		return;
+	}
+
+	pDev->DriveFrom = Now;
+	pDev->DriveUntil = Now + SIM_OW_TX_ZERO_USECS;
+
+	if( pDev->Faults[SIM_OW_FAULT_SHORT_ZERO] )
+	{
+		pDev->Faults[SIM_OW_FAULT_SHORT_ZERO]--;
+		SIM_OWBus.Stats.FaultsInjected++;
+		pDev->DriveUntil = Now + SIM_OW_SHORT_ZERO_USECS;
+	}
+}
+
+
+static void SIM_OWDeviceReceive(SIM_OWDevice_t *pDev, uint64_t Now, uint8_t Bit)
+{
+	uint8_t *pByte = &pDev->RxBuffer[pDev->BitCount / 8];
+
+	if( pDev->State == SIM_OW_STATE_SEARCH )
+	{
+		//Branch taken by the master - devices on the other one drop out until the next reset
+		if( Bit != ( ( pDev->ROM[pDev->SearchBit / 8] >> ( pDev->SearchBit % 8 ) ) & 0x1 ) )
+		{
+			pDev->State = SIM_OW_STATE_IDLE;
+		}
+		else if( ++pDev->SearchBit >= 64 )
+		{
+			pDev->State = SIM_OW_STATE_FUNC_CMD;
+		}
+
+		pDev->SearchSlot = 0;
+		return;
+	}
+
+	//Bits come in LSB first
+	if( ( pDev->BitCount % 8 ) == 0 )
+	{
+		*pByte = 0;
+	}
+
+	*pByte |= ( Bit << ( pDev->BitCount % 8 ) );
+	pDev->BitCount++;
+
+	if( ( pDev->State == SIM_OW_STATE_ROM_CMD ) && ( pDev->BitCount == 8 ) )
+	{
+		pDev->BitCount = 0;
+		SIM_OWRomCommand(pDev, pDev->RxBuffer[0]);
+	}
+	else if( ( pDev->State == SIM_OW_STATE_MATCH ) && ( pDev->BitCount == 64 ) )
+	{
+		pDev->BitCount = 0;
+		pDev->State = ( memcmp(pDev->RxBuffer, pDev->ROM, sizeof(pDev->ROM)) == 0 ) ? SIM_OW_STATE_FUNC_CMD : SIM_OW_STATE_IDLE;
+	}
+	else if( ( pDev->State == SIM_OW_STATE_FUNC_CMD ) && ( pDev->BitCount == 8 ) )
+	{
+		pDev->BitCount = 0;
+		SIM_OWFunctionCommand(pDev, Now, pDev->RxBuffer[0]);
+	}
+	else if( ( pDev->State == SIM_OW_STATE_WRITE_SP ) && ( pDev->BitCount == 24 ) )
+	{
+		//TH, TL and the resolution bits of the configuration register - the rest of it is fixed
+		pDev->BitCount = 0;
+		pDev->Scratchpad[2] = pDev->RxBuffer[0];
+		pDev->Scratchpad[3] = pDev->RxBuffer[1];
+		pDev->Scratchpad[4] = ( pDev->RxBuffer[2] & 0x60 ) | 0x1F;
+		SIM_OWUpdateCRC(pDev);
+
+		pDev->State = SIM_OW_STATE_IDLE;
+	}
+}
+
+
+static void SIM_OWRomCommand(SIM_OWDevice_t *pDev, uint8_t Command)
+{
+	pDev->SearchBit = 0;
+	pDev->SearchSlot = 0;
+
+	if( Command == MASTER_COMMAND_READ_ROM )
+	{
+		memcpy(pDev->TxBuffer, pDev->ROM, sizeof(pDev->ROM));
+		pDev->TxLen = sizeof(pDev->ROM);
+		pDev->NextState = SIM_OW_STATE_FUNC_CMD;
+		pDev->State = SIM_OW_STATE_TX;
+	}
+	else if( Command == MASTER_COMMAND_MATCH_ROM )
+	{
+		pDev->State = SIM_OW_STATE_MATCH;
+	}
+	else if( Command == MASTER_COMMAND_SKIP_ROM )
+	{
+		pDev->State = SIM_OW_STATE_FUNC_CMD;
+	}
+	else if( ( Command == MASTER_COMMAND_SEARCH_ROM ) || ( ( Command == MASTER_COMMAND_ALARM_SEARCH ) && pDev->Alarm ) )
+	{
+		pDev->State = SIM_OW_STATE_SEARCH;
+	}
+	else
+	{
+		pDev->State = SIM_OW_STATE_IDLE;
+	}
+}
+
+
+static void SIM_OWFunctionCommand(SIM_OWDevice_t *pDev, uint64_t Now, uint8_t Command)
+{
+	uint8_t Resolution = ( pDev->Scratchpad[4] >> 5 ) & 0x3;
+
+	pDev->State = SIM_OW_STATE_IDLE;
+
+	if( Command == MASTER_COMMAND_CONVERT_T )
+	{
+		pDev->BusyCmd = Command;
+		pDev->BusyUntil = Now + ( SIM_OW_CONV_USECS >> ( 3 - Resolution ) );
+		pDev->State = SIM_OW_STATE_BUSY;
+	}
+	else if( Command == MASTER_COMMAND_READ_SCRATCHPAD )
+	{
+		memcpy(pDev->TxBuffer, pDev->Scratchpad, sizeof(pDev->Scratchpad));
+		pDev->TxLen = sizeof(pDev->Scratchpad);
+		pDev->NextState = SIM_OW_STATE_IDLE;
+		pDev->State = SIM_OW_STATE_TX;
+	}
+	else if( Command == MASTER_COMMAND_WRITE_SCRATCHPAD )
+	{
+		pDev->State = SIM_OW_STATE_WRITE_SP;
+	}
+	else if( ( Command == MASTER_COMMAND_COPY_SCRATCHPAD ) || ( Command == MASTER_COMMAND_RECALL_E2 ) )
+	{
+		pDev->BusyCmd = Command;
+		pDev->BusyUntil = Now + ( ( Command == MASTER_COMMAND_COPY_SCRATCHPAD ) ? SIM_OW_COPY_USECS : SIM_OW_RECALL_USECS );
+		pDev->State = SIM_OW_STATE_BUSY;
+	}
+
+	//Read Power Supply: externally powered - read slots are left to the pull up, like every unknown command
+}
+
+
+static void SIM_OWBusyDone(SIM_OWDevice_t *pDev)
+{
+	if( pDev->BusyCmd == MASTER_COMMAND_CONVERT_T )
+	{
+		//Bits below the resolution are undefined - they read 1 so a reader that doesn't mask them is off
+		uint8_t Resolution = ( pDev->Scratchpad[4] >> 5 ) & 0x3;
+		uint16_t Undefined = ( 1 << ( 3 - Resolution ) ) - 1;
+		int16_t Raw = (int16_t) ( ( pDev->Temperature & ~Undefined ) | Undefined );
+		int8_t Degrees = (int8_t) ( Raw >> 4 );
+
+		pDev->Scratchpad[0] = Raw & 0xFF;
+		pDev->Scratchpad[1] = ( Raw >> 8 ) & 0xFF;
+		pDev->Alarm = ( ( Degrees >= (int8_t) pDev->Scratchpad[2] ) || ( Degrees <= (int8_t) pDev->Scratchpad[3] ) );
+	}
+	else if( pDev->BusyCmd == MASTER_COMMAND_COPY_SCRATCHPAD )
+	{
+		memcpy(pDev->E2, &pDev->Scratchpad[2], sizeof(pDev->E2));
+	}
+	else if( pDev->BusyCmd == MASTER_COMMAND_RECALL_E2 )
+	{
+		memcpy(&pDev->Scratchpad[2], pDev->E2, sizeof(pDev->E2));
+	}
+
+	SIM_OWUpdateCRC(pDev);
+	pDev->BusyCmd = 0;
+}
+
+
+static void SIM_OWUpdateCRC(SIM_OWDevice_t *pDev)
+{
+	pDev->Scratchpad[8] = SIM_OWCRC8(pDev->Scratchpad, 8);
+}
+
+
+static uint8_t SIM_OWCRC8(const uint8_t *pData, uint8_t Len)
+{
+	//Dallas/Maxim CRC-8 bit by bit (x^8 + x^5 + x^4 + 1, LSB first) - independent of the driver's table
+	uint8_t crc = 0;
+
+	while( Len-- )
+	{
+		uint8_t Byte = *pData++;
+
+		for(uint8_t i = 0; i < 8; i++)
+		{
+			uint8_t Mix = ( crc ^ Byte ) & 0x1;
+
+			crc >>= 1;
+
+			if( Mix )
+			{
+				crc ^= 0x8C;
+			}
+
+			Byte >>= 1;
+		}
+	}
+
+	return crc;
+}
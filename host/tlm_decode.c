@@ -0,0 +1,120 @@
+/*
+ * tlm_decode.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+/*
+ * Objective: Turn the binary telemetry stream of the water quality application (USART6, see stm32f407vg_telemetry.h)
+ * 			  into CSV for the logging PC
+ *
+ * 		tlm_decode [capture.bin]		- reads the capture (or stdin, i.e., straight from the serial port), CSV on stdout
+ *
+ * 		Frames are split on 0x00 and checked with the same TLM_DecodeFrame the MCU build has. Bad frames are skipped,
+ * 		sequence gaps are counted as lost frames. Totals are printed on stderr, the exit status is non-zero if any
+ * 		frame was bad or lost
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stm32f407vg_telemetry.h"
+#include "water_quality_sensors.h"
+
+typedef struct
+{
+	unsigned long 	Frames;
+	unsigned long 	Lost;
+	unsigned long 	Bad;
+	unsigned long 	Unknown;
+	int 			HaveSequence;
+	uint16_t 		NextSequence;
+}DecodeStats_t;
+
+static void PrintFrame(const TLM_Frame_t *pFrame, DecodeStats_t *pStats)
+{
+	WQ_TLM_Sample_t Sample;
+
+	//1. Sequence gap - frames dropped by the sender or lost on the wire (16 bit counter, wraps)
+	if( pStats->HaveSequence )
+	{
+		pStats->Lost += (uint16_t) ( pFrame->Sequence - pStats->NextSequence );
+	}
+
+	pStats->HaveSequence = 1;
+	pStats->NextSequence = pFrame->Sequence + 1;
+	pStats->Frames++;
+
+	//2. Record
+	if( ( pFrame->Type != WQ_TLM_RECORD_SAMPLE ) || ( pFrame->PayloadLen != sizeof(Sample) ) )
+	{
+		pStats->Unknown++;
+		return;
+	}
+
+	memcpy(&Sample, pFrame->Payload, sizeof(Sample));
+
+	printf("%u,%lu,%.2f,%d,%u,%u,%.1f\n", pFrame->Sequence, (unsigned long) pFrame->Timestamp, Sample.TemperatureCentiDeg / 100.0,
+			( Sample.Flags & WQ_TLM_FLAG_TEMP_VALID ) ? 1 : 0, Sample.TemperatureAgeMs, Sample.TDSppm, Sample.TurbidityTenths / 10.0);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *pIn = stdin;
+	uint8_t Buffer[TLM_MAX_FRAME_LEN];
+	uint16_t Len = 0;
+	int Overrun = 0;
+	int c;
+	TLM_Frame_t Frame;
+	DecodeStats_t Stats = {0};
+
+	if( ( argc > 1 ) && ( ( pIn = fopen(argv[1], "rb") ) == NULL ) )
+	{
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	printf("sequence,timestamp_us,temperature_c,temperature_valid,temperature_age_ms,tds_ppm,turbidity_pct\n");
+
+	while( ( c = fgetc(pIn) ) != EOF )
+	{
+		if( c != 0x00 )
+		{
+			//Longer than any frame - garbage (i.e., started mid-frame at a high baud mismatch), wait for the next delimiter
+			if( Len < sizeof(Buffer) )
+			{
+				Buffer[Len++] = (uint8_t) c;
+			}
+			else
+			{
+				Overrun = 1;
+			}
+
+			continue;
+		}
+
+		if( Len || Overrun )
+		{
+			if( !Overrun && ( TLM_DecodeFrame(Buffer, Len, &Frame) == TLM_OK ) )
+			{
+				PrintFrame(&Frame, &Stats);
+			}
+			else
+			{
+				Stats.Bad++;
+			}
+		}
+
+		Len = 0;
+		Overrun = 0;
+	}
+
+	if( pIn != stdin )
+	{
+		fclose(pIn);
+	}
+
+	fprintf(stderr, "%lu frames   %lu lost (sequence gaps)   %lu bad   %lu unknown records\n", Stats.Frames, Stats.Lost, Stats.Bad, Stats.Unknown);
+
+	return ( Stats.Bad || Stats.Lost ) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
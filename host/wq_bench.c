@@ -0,0 +1,146 @@
+/*
+ * wq_bench.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+/*
+ * Objective: Compare the fixed point and float water quality conversion pipelines on the host
+ *
+ * 		Sweeps every oversampled TDS/turbidity count and a range of DS18B20 temperatures through both pipelines and
+ * 		reports the largest difference of every output (in the units sent to the Arduino) and the average time per call.
+ *
+ * 		NOTE: Host timings only show the relative cost. On the Cortex-M4 the float pipeline runs on the single precision
+ * 			  FPU (VDIV.F32 alone is 14 cycles), built with WQ_USE_FIXED_POINT=0 it is the one to compare against on target
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "water_quality_sensors.h"
+
+#define BENCH_TDS_FULL_SCALE					16380					//14 bit enhanced TDS result (16x oversampling)
+#define BENCH_TURBIDITY_FULL_SCALE				4095					//12 bit averaged turbidity result
+#define BENCH_TEMP_MIN_RAW						( -10 * 16 )			//-10°C
+#define BENCH_TEMP_MAX_RAW						( 60 * 16 )				//60°C
+#define BENCH_TEMP_STEP_RAW						8						//0.5°C
+
+typedef void (*Pipeline_t)(const WQ_RawReadings_t *pRaw, WQ_Readings_t *pReadings);
+
+static uint64_t BenchNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	uint32_t lo, hi;
+	__asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+	return ( (uint64_t) hi << 32 ) | lo;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void BenchFillRaw(WQ_RawReadings_t *pRaw, uint32_t Counts, int16_t TempRaw)
+{
+	pRaw->TDSCounts = Counts;
+	pRaw->TDSFullScale = BENCH_TDS_FULL_SCALE;
+	pRaw->TurbidityCounts = Counts % ( BENCH_TURBIDITY_FULL_SCALE + 1 );
+	pRaw->TurbidityFullScale = BENCH_TURBIDITY_FULL_SCALE;
+	pRaw->TemperatureRaw = TempRaw;
+	pRaw->TemperatureValid = 1;
+}
+
+static double BenchTime(Pipeline_t Pipeline)
+{
+	WQ_RawReadings_t Raw;
+	WQ_Readings_t Readings;
+	volatile uint32_t Sink = 0;
+	uint64_t Calls = 0;
+	uint64_t Start = BenchNow();
+
+	for(int16_t t = BENCH_TEMP_MIN_RAW; t <= BENCH_TEMP_MAX_RAW; t += BENCH_TEMP_STEP_RAW)
+	{
+		for(uint32_t c = 0; c <= BENCH_TDS_FULL_SCALE; c++)
+		{
+			BenchFillRaw(&Raw, c, t);
+			Pipeline(&Raw, &Readings);
+			Sink += Readings.TDSppm;
+			Calls++;
+		}
+	}
+
+	return (double) ( BenchNow() - Start ) / Calls;
+}
+
+int main(void)
+{
+	WQ_RawReadings_t Raw;
+	WQ_Readings_t Fixed, Float;
+	int MaxTDSErr = 0, MaxTurbidityErr = 0, MaxTempErr = 0;
+	double MaxTDSRelErr = 0, RelErr;
+	int Failed = 0;
+	uint32_t WorstCounts = 0;
+	int16_t WorstTemp = 0;
+	uint64_t Points = 0;
+
+	//1. Error of the fixed point pipeline against the float pipeline over the whole input range
+	for(int16_t t = BENCH_TEMP_MIN_RAW; t <= BENCH_TEMP_MAX_RAW; t += BENCH_TEMP_STEP_RAW)
+	{
+		for(uint32_t c = 0; c <= BENCH_TDS_FULL_SCALE; c++)
+		{
+			BenchFillRaw(&Raw, c, t);
+			WQ_ProcessReadingsFixed(&Raw, &Fixed);
+			WQ_ProcessReadingsFloat(&Raw, &Float);
+			Points++;
+
+			int err = abs( (int) Fixed.TDSppm - (int) Float.TDSppm );
+			RelErr = ( Float.TDSppm >= 100 ) ? (double) err / Float.TDSppm : 0;
+			if( err > MaxTDSErr )
+			{
+				MaxTDSErr = err;
+				WorstCounts = c;
+				WorstTemp = t;
+			}
+			if( RelErr > MaxTDSRelErr )
+			{
+				MaxTDSRelErr = RelErr;
+			}
+
+			//TDS is off by the rounding of the Q16 constants: 1 LSB of the uncalibrated value (5.84 ppm) or 0.1%, whichever is larger
+			if( err > 6 && RelErr > 0.001 )
+			{
+				Failed = 1;
+			}
+
+			err = abs( (int) Fixed.TurbidityTenths - (int) Float.TurbidityTenths );
+			if( err > MaxTurbidityErr )
+			{
+				MaxTurbidityErr = err;
+			}
+
+			err = abs( (int) Fixed.TemperatureCentiDeg - (int) Float.TemperatureCentiDeg );
+			if( err > MaxTempErr )
+			{
+				MaxTempErr = err;
+			}
+		}
+	}
+
+	printf("Compared %llu input points\n", (unsigned long long) Points);
+	printf("Max error: TDS - %d ppm (counts %lu, %.2f°C), %.3f%% relative (>= 100 ppm)   Turbidity - %d tenths of %%   Temperature - %d hundredths of °C\n",
+			MaxTDSErr, (unsigned long) WorstCounts, WorstTemp / 16.0, MaxTDSRelErr * 100, MaxTurbidityErr, MaxTempErr);
+
+	//2. Cost per call
+#if defined(__x86_64__) || defined(__i386__)
+	const char *Unit = "TSC ticks";
+#else
+	const char *Unit = "ns";
+#endif
+	double FixedCost = BenchTime(WQ_ProcessReadingsFixed);
+	double FloatCost = BenchTime(WQ_ProcessReadingsFloat);
+
+	printf("Cost per call: fixed - %.1f %s   float - %.1f %s\n", FixedCost, Unit, FloatCost, Unit);
+
+	return ( Failed || MaxTurbidityErr > 1 || MaxTempErr > 1 ) ? 1 : 0;
+}
@@ -0,0 +1,787 @@
+/*
+ * wq_sim.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: butle
+ */
+
+/*
+ * Objective: Run the whole water quality application on the host against the simulated STM32F407VG (host/sim)
+ *
+ * 		The application (Src/FinalProjectSTMToArduino.c), the drivers and the BSP are built unchanged. Fixed TDS and
+ * 		turbidity voltages are applied to ADC_IN1/ADC_IN2 and the simulator runs until the application has sent a few
+ * 		frames to the Arduino on I2C1. Every frame is checked against WQ_ProcessReadings for the same counts.
+ * 		The printf log channel (USART3 Tx DMA) is checked by writing to it directly - printf is the host's stdout here.
+ * 		The readings left for the main loop are sent as binary telemetry (USART6) and decoded back. With an argument,
+ * 		the telemetry stream is also saved to that file (i.e., for host/tlm_decode). Last, the clock tree is switched from
+ * 		168MHz back to the HSI and the baud rates, I2C timing and timer time bases have to follow.
+ * 		The integer timer period API is checked on the 16-bit TIM3 at the HSI clock, and the software timer wheel on the
+ * 		1-wire time base (TIM5) it shares with the DS18B20. Last, the main loop idles in STOP between readings, woken by
+ * 		the RTC, and the readings have to keep their period. TDS and turbidity are sampled by ADC1 and ADC2 at the same
+ * 		instant (dual regular simultaneous) - a burst has to take the time of 16 conversions, not 32
+ * 		Two virtual DS18B20 probes answer on PA3 (host/sim 1-wire model) - they are found by the ROM search and read
+ * 		back, then shown a corrupted byte, zeros cut short and missing presence pulses. The master's bus timing is
+ * 		checked all along
+ *
+ * 		NOTE: The probes measure 25°C, so TDS is the same compensated or not. The temperature bytes of a frame are not
+ * 			  checked - they are 0 until the first conversion has been read
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stm32f407vg_sim.h"
+#include "stm32f407vg_sim_onewire.h"
+#include "water_quality_sensors.h"
+#include "ds18b20_temp_sensor.h"
+#include "stm32f407vg_profiler.h"
+#include "stm32f407vg_spsc_ring.h"
+#include "stm32f407vg_usart_log.h"
+#include "stm32f407vg_telemetry.h"
+#include "stm32f407vg_sw_timer.h"
+#include "stm32f407vg_pwr_driver.h"
+
+#define SIM_TDS_COUNTS							1500					//~1.21V on PA1
+#define SIM_TURBIDITY_COUNTS					1700					//~1.37V on PA2
+#define SIM_TDS_FULL_SCALE						16380					//16x enhanced to 14 bits (sum of 16 >> 2)
+#define SIM_TURBIDITY_FULL_SCALE				4095					//16x averaged
+#define SIM_FRAMES_TO_CHECK						3
+#define SIM_MAX_USECS							( 10 * 1000000U )		//TIM2 ticks at 0.75Hz - 3 frames take ~4s
+#define SIM_ARDUINO_ADDR						0x68
+#define SIM_FRAME_LEN							6
+#define SIM_LOG_MAX_STEPS						100000
+#define SIM_SYSCLK_FREQ							168000000U				//HSE 8MHz through the PLL (initialize_clocks)
+#define SIM_FLASH_LATENCY						5						//Wait states at 168MHz
+#define SIM_HSI_USART3_BRR						0x8B					//115200 baud off a 16MHz PCLK1 (8 + 11/16)
+#define SIM_HSI_USART6_BRR						0x23					//460800 baud off a 16MHz PCLK2 (2 + 3/16)
+#define SIM_HSI_TIM2_ARR						21333327				//1333333us off a 16MHz timer clock (PSC 0)
+#define SIM_TIM3_PERIOD_MS						1000					//Longer than the 16-bit TIM3 counter can count without a pre-scaler
+#define SIM_TIM3_PSC							244						//16MHz / 65536 rounded up, less 1
+#define SIM_TIM3_ARR							65305					//16000000 / 245 rounded, less 1
+#define SIM_TIM3_DELAY_US						250
+#define SIM_TIM3_TOO_SHORT_NS					50						//Less than 2 timer clocks at 16MHz
+#define SIM_TIM3_TOO_LONG_MS					300000					//More than 65536 x 65536 timer clocks at 16MHz
+#define SIM_SWT_ONESHOT_TICKS					1000					//Software timers count TIM5 ticks (1us)
+#define SIM_SWT_PERIOD_TICKS					300
+#define SIM_SWT_PERIODIC_RUNS					5						//Periodic timer cancels itself from its 5th callback
+#define SIM_SWT_FAR_TICKS						2000000					//Level 3 of the wheel - cascaded down 3 times
+#define SIM_SWT_MAX_LATE_TICKS					2
+#define SIM_SAMPLE_PERIOD_USECS					1333333					//TIM2 update period (SAMPLE_PERIOD_USECS)
+#define SIM_IDLE_SAMPLES						4						//Readings the idle main loop waits for
+#define SIM_IDLE_MAX_JITTER_USECS				1000					//Reading spacing error allowed across STOP periods
+#define SIM_IDLE_MIN_STOP_PERCENT				80						//Share of the idle loop spent in STOP
+#define SIM_LSI_MAX_ERROR_PPM					5000					//Measured against the 1-wire time base
+#define SIM_ADC_PAIRS							16						//TDS/turbidity pairs per burst (ADC_OVERSAMPLING_RATIO)
+#define SIM_ADC_BURST_MIN_USECS					375						//16 x (480 + 12) cycles of the 21MHz ADC clock
+#define SIM_ADC_BURST_MAX_USECS					500						//A 2 channel scan on one ADC takes 750us
+#define SIM_OW_PROBES							2
+#define SIM_OW_SERIAL_0							0x000001A2B3C4ULL
+#define SIM_OW_SERIAL_1							0x000002D5E6F7ULL
+#define SIM_OW_RAW_25C							400						//25°C in 1/16 °C
+#define SIM_OW_RAW_NEGATIVE						-162					//-10.125°C
+#define SIM_OW_CENTIDEG_25C						2500
+#define SIM_OW_READ_MAX_USECS					2000000					//Convert T (750ms at 12 bits) and every retry
+#define SIM_OW_MANY_FAULTS						100000
+#define SIM_OW_ALARM_HIGH_C						35						//Alarm thresholds the application writes after the search
+#define SIM_OW_ALARM_LOW_C						2
+#define SIM_OW_POWER_ON_HIGH_C					75						//TH/TL in E2 as shipped
+#define SIM_OW_POWER_ON_LOW_C					70
+
+extern void initialize_application(void);
+extern RING_Handle_t SampleRing;
+extern USART_LOG_Handle_t ConsoleLog;
+extern USART_LOG_Handle_t TelemetryLog;
+extern void SendSampleTelemetry(const void *pSample);
+extern SWT_Handle_t SoftTimers;
+extern SWT_Timer_t HeartbeatTimer;
+extern RCC_Config_t RunClockConfig;
+extern PWR_Handle_t PowerManager;
+extern DMA_Handle_t ADC1DMAHandle;
+extern uint16_t BufferADCValues[];
+extern uint8_t BufferProbeTemperatures[];
+extern __vo int16_t TemperatureRaw;
+extern __vo uint32_t TemperatureTimestamp;
+extern __vo uint32_t OneWireSearchErrors;
+
+static const char LogLine[] = "log check 0123456789\r\n";
+
+/*
+ * Software timer callback record
+ */
+typedef struct
+{
+	uint32_t 		Count;
+	uint32_t 		LastTime;
+	uint32_t 		Limit;										/* Cancel the timer from this callback on (0 - never) */
+	SWT_Timer_t 	*pTimer;
+}SimTimerLog_t;
+
+static void SimTimerCallback(void *pContext)
+{
+	SimTimerLog_t *pLog = (SimTimerLog_t *) pContext;
+
+	pLog->Count++;
+	pLog->LastTime = SWT_GetTime(&SoftTimers);
+
+	if( pLog->Limit && ( pLog->Count >= pLog->Limit ) )
+	{
+		SWT_Cancel(&SoftTimers, pLog->pTimer);
+	}
+}
+
+static uint8_t SimTimerLate(SimTimerLog_t *pLog, uint32_t Deadline)
+{
+	return ( ( pLog->LastTime - Deadline ) > SIM_SWT_MAX_LATE_TICKS );
+}
+static uint8_t LogOversize[USART_LOG_BUFFER_SIZE];
+
+static uint32_t SimCompleteFrames(void)
+{
+	uint32_t Complete = 0;
+
+	for(uint32_t i = 0; i < SIM_I2CGetFrameCount(I2C1); i++)
+	{
+		const SIM_I2CFrame_t *pFrame = SIM_I2CGetFrame(I2C1, i);
+
+		if( pFrame && ( pFrame->Len == SIM_FRAME_LEN ) )
+		{
+			Complete++;
+		}
+	}
+
+	return Complete;
+}
+
+static void SimDrainLog(USART_LOG_Handle_t *pLogHandle)
+{
+	for(uint32_t i = 0; ( i < SIM_LOG_MAX_STEPS ) && ( USART_LOG_GetCount(pLogHandle) || pLogHandle->InFlight ); i++)
+	{
+		SIM_Step();
+	}
+}
+
+static void SimProbeWait(void)
+{
+	uint64_t Start = SIM_GetTimeUsecs();
+
+	while( ( DS18B20_GetState() != DS18B20_READY ) && ( ( SIM_GetTimeUsecs() - Start ) < SIM_OW_READ_MAX_USECS ) )
+	{
+		SIM_Step();
+	}
+}
+
+static uint8_t SimProbeRead(void)
+{
+	//1 if the application got a new temperature (DS18B20_EVENT_TEMP_READY)
+	uint32_t Stamp = TemperatureTimestamp;
+
+	SimProbeWait();
+
+	if( DS18B20_MasterGetAllTemperaturesIT(BufferProbeTemperatures) != DS18B20_READY )
+	{
+		return 0;
+	}
+
+	SimProbeWait();
+
+	return ( TemperatureTimestamp != Stamp );
+}
+
+static uint8_t SimProbeModelIndex(uint8_t Probe)
+{
+	//Model device behind a probe of the driver's table (search order, not the order they were added in)
+	for(uint8_t d = 0; d < SIM_OW_PROBES; d++)
+	{
+		if( DS18B20_GetDeviceROM(Probe) && ( memcmp(DS18B20_GetDeviceROM(Probe), SIM_OneWireGetROM(d), 8) == 0 ) )
+		{
+			return d;
+		}
+	}
+
+	return 0xFF;
+}
+
+int main(int argc, char *argv[])
+{
+	WQ_RawReadings_t Raw = {0};
+	WQ_Readings_t Expected;
+	uint8_t ExpectedBytes[SIM_FRAME_LEN];
+	int Errors = 0;
+
+	//1. Sensor inputs and the readings they should turn into
+	SIM_Reset();
+	SIM_OneWireAttach(GPIOA, 3);
+	SIM_OneWireAddDevice(SIM_OW_SERIAL_0);
+	SIM_OneWireAddDevice(SIM_OW_SERIAL_1);
+	SIM_OneWireSetTemperature(0, SIM_OW_RAW_25C);
+	SIM_OneWireSetTemperature(1, SIM_OW_RAW_25C);
+	SIM_ADCSetInput(ADC_IN1, SIM_TDS_COUNTS);
+	SIM_ADCSetInput(ADC_IN2, SIM_TURBIDITY_COUNTS);
+
+	Raw.TDSCounts = 4 * SIM_TDS_COUNTS;
+	Raw.TDSFullScale = SIM_TDS_FULL_SCALE;
+	Raw.TurbidityCounts = SIM_TURBIDITY_COUNTS;
+	Raw.TurbidityFullScale = SIM_TURBIDITY_FULL_SCALE;
+	Raw.TemperatureValid = 0;
+
+	WQ_ProcessReadings(&Raw, &Expected);
+
+	ExpectedBytes[2] = ( Expected.TDSppm >> 8 ) & 0xFF;
+	ExpectedBytes[3] = Expected.TDSppm & 0xFF;
+	ExpectedBytes[4] = ( Expected.TurbidityTenths / 10 ) % 10;
+	ExpectedBytes[5] = Expected.TurbidityTenths % 10;
+
+	//2. Application init (main without its display loop), then run until enough frames reached the Arduino
+	initialize_application();
+
+	if( ( RCC_GetSysClkVal() != SIM_SYSCLK_FREQ ) || ( RCC_GetHCLKVal() != SIM_SYSCLK_FREQ ) || ( RCC_GetPCLK1Val() != SIM_SYSCLK_FREQ / 4 ) ||
+		( RCC_GetPCLK2Val() != SIM_SYSCLK_FREQ / 2 ) || ( RCC_GetTIMCLK1Val() != SIM_SYSCLK_FREQ / 2 ) ||
+		( ( FLASH->ACR & 0x7 ) != SIM_FLASH_LATENCY ) || !( FLASH->ACR & ( 1 << FLASH_ACR_PRFTEN ) ) )
+	{
+		printf("clocks: SYSCLK %lu  HCLK %lu  PCLK1 %lu  PCLK2 %lu  TIMCLK1 %lu  ACR 0x%03lX\n", (unsigned long) RCC_GetSysClkVal(),
+				(unsigned long) RCC_GetHCLKVal(), (unsigned long) RCC_GetPCLK1Val(), (unsigned long) RCC_GetPCLK2Val(),
+				(unsigned long) RCC_GetTIMCLK1Val(), (unsigned long) FLASH->ACR);
+		Errors++;
+	}
+
+	while( ( SimCompleteFrames() < SIM_FRAMES_TO_CHECK ) && ( SIM_GetTimeUsecs() < SIM_MAX_USECS ) )
+	{
+		SIM_Step();
+	}
+
+	//3. Check every frame sent
+	uint32_t Checked = 0;
+
+	for(uint32_t i = 0; i < SIM_I2CGetFrameCount(I2C1); i++)
+	{
+		const SIM_I2CFrame_t *pFrame = SIM_I2CGetFrame(I2C1, i);
+
+		if( !pFrame || ( pFrame->Len != SIM_FRAME_LEN ) )
+		{
+			continue;
+		}
+
+		printf("frame %lu: addr 0x%02X | 0x%02X | 0x%02X | 0x%02X | 0x%02X | 0x%02X | 0x%02X |\n", (unsigned long) i, pFrame->Address,
+				pFrame->Data[0], pFrame->Data[1], pFrame->Data[2], pFrame->Data[3], pFrame->Data[4], pFrame->Data[5]);
+
+		if( pFrame->Address != ( SIM_ARDUINO_ADDR << 1 ) )
+		{
+			printf("  address 0x%02X, expected 0x%02X\n", pFrame->Address, SIM_ARDUINO_ADDR << 1);
+			Errors++;
+		}
+
+		for(uint8_t b = 2; b < SIM_FRAME_LEN; b++)
+		{
+			if( pFrame->Data[b] != ExpectedBytes[b] )
+			{
+				printf("  byte %d is 0x%02X, expected 0x%02X\n", b, pFrame->Data[b], ExpectedBytes[b]);
+				Errors++;
+			}
+		}
+
+		Checked++;
+	}
+
+	printf("\nExpected TDS %uppm   turbidity %u.%u%%\n", Expected.TDSppm, Expected.TurbidityTenths / 10, Expected.TurbidityTenths % 10);
+	printf("%lu frames checked in %.2fs simulated   %lu TIM2   %lu TIM5   %lu DMA2 stream 0   %lu I2C1 event interrupts\n",
+			(unsigned long) Checked, SIM_GetTimeUsecs() / 1e6, (unsigned long) SIM_GetIRQCount(IRQ_NO_TIM2), (unsigned long) SIM_GetIRQCount(IRQ_NO_TIM5),
+			(unsigned long) SIM_GetIRQCount(IRQ_NO_DMA2_STREAM0), (unsigned long) SIM_GetIRQCount(IRQ_NO_I2C1_EV));
+
+	//4. Same ISR timing report as on target (host time - ISRs that busy-wait include the simulated peripherals)
+	printf("\n");
+	PROF_Dump(NULL);
+
+	//5. Every burst also left one reading for the main loop (not run here) - nothing lost while it fits in the ring
+	uint32_t Bursts = SIM_GetIRQCount(IRQ_NO_DMA2_STREAM0);
+	uint32_t Expect = ( Bursts < SampleRing.Capacity ) ? Bursts : SampleRing.Capacity;
+
+	printf("sample ring: %d waiting   %d high water   %lu overflows\n", RING_GetCount(&SampleRing), SampleRing.HighWater, (unsigned long) SampleRing.Overflows);
+
+	if( ( RING_GetCount(&SampleRing) != Expect ) || ( SampleRing.Overflows != ( Bursts - Expect ) ) )
+	{
+		printf("  expected %lu waiting and %lu overflows\n", (unsigned long) Expect, (unsigned long) ( Bursts - Expect ));
+		Errors++;
+	}
+
+	//6. Log channel - a line comes out of USART3 intact, a write bigger than the free space is dropped whole
+	uint32_t TxStart = SIM_USARTGetTxCount(USART3);
+	uint32_t DroppedStart = ConsoleLog.Dropped;
+
+	USART_LOG_Write(&ConsoleLog, (const uint8_t *) LogLine, sizeof(LogLine) - 1);
+	USART_LOG_Write(&ConsoleLog, LogOversize, sizeof(LogOversize));
+
+	SimDrainLog(&ConsoleLog);
+
+	printf("log: %lu bytes on USART3   %d high water   %lu dropped\n", (unsigned long) ( SIM_USARTGetTxCount(USART3) - TxStart ),
+			ConsoleLog.HighWater, (unsigned long) ( ConsoleLog.Dropped - DroppedStart ));
+
+	if( ( SIM_USARTGetTxCount(USART3) - TxStart ) != ( sizeof(LogLine) - 1 ) || ( ( ConsoleLog.Dropped - DroppedStart ) != sizeof(LogOversize) ) )
+	{
+		printf("  expected %lu bytes sent and %lu dropped\n", (unsigned long) ( sizeof(LogLine) - 1 ), (unsigned long) sizeof(LogOversize));
+		Errors++;
+	}
+	else
+	{
+		for(uint32_t i = 0; i < ( sizeof(LogLine) - 1 ); i++)
+		{
+			if( SIM_USARTGetTxByte(USART3, TxStart + i) != (uint8_t) LogLine[i] )
+			{
+				printf("  log byte %lu is 0x%02X, expected 0x%02X\n", (unsigned long) i, SIM_USARTGetTxByte(USART3, TxStart + i), (uint8_t) LogLine[i]);
+				Errors++;
+				break;
+			}
+		}
+	}
+
+	//7. Telemetry - what the main loop would send for every waiting reading, decoded back from the USART6 bytes
+	uint8_t SampleCopy[SampleRing.ItemSize];
+	uint32_t Sent = 0;
+	uint32_t TlmStart = SIM_USARTGetTxCount(USART6);
+
+	while( RING_Get(&SampleRing, SampleCopy) == RING_OK )
+	{
+		SendSampleTelemetry(SampleCopy);
+		Sent++;
+	}
+
+	SimDrainLog(&TelemetryLog);
+
+	uint32_t TlmLen = SIM_USARTGetTxCount(USART6) - TlmStart;
+	uint8_t Frame[TLM_MAX_FRAME_LEN];
+	uint16_t FrameLen = 0;
+	uint32_t Decoded = 0;
+	FILE *pCapture = ( argc > 1 ) ? fopen(argv[1], "wb") : NULL;
+
+	for(uint32_t i = 0; i < TlmLen; i++)
+	{
+		uint8_t Byte = SIM_USARTGetTxByte(USART6, TlmStart + i);
+		TLM_Frame_t Decoded_Frame;
+
+		if( pCapture )
+		{
+			fputc(Byte, pCapture);
+		}
+
+		if( Byte != 0x00 )
+		{
+			if( FrameLen < sizeof(Frame) )
+			{
+				Frame[FrameLen++] = Byte;
+			}
+
+			continue;
+		}
+
+		if( ( TLM_DecodeFrame(Frame, FrameLen, &Decoded_Frame) != TLM_OK ) || ( Decoded_Frame.Type != WQ_TLM_RECORD_SAMPLE ) ||
+			( Decoded_Frame.Sequence != Decoded ) || ( Decoded_Frame.PayloadLen != sizeof(WQ_TLM_Sample_t) ) )
+		{
+			printf("  telemetry frame %lu does not decode\n", (unsigned long) Decoded);
+			Errors++;
+		}
+		else
+		{
+			WQ_TLM_Sample_t Record;
+
+			memcpy(&Record, Decoded_Frame.Payload, sizeof(Record));
+
+			if( ( Record.TDSppm != Expected.TDSppm ) || ( Record.TurbidityTenths != Expected.TurbidityTenths ) ||
+				( ( Record.Flags & WQ_TLM_FLAG_TEMP_VALID ) && ( Record.TemperatureCentiDeg != SIM_OW_CENTIDEG_25C ) ) )
+			{
+				printf("  telemetry frame %lu: TDS %u turbidity %u flags 0x%02X\n", (unsigned long) Decoded, Record.TDSppm, Record.TurbidityTenths, Record.Flags);
+				Errors++;
+			}
+		}
+
+		Decoded++;
+		FrameLen = 0;
+	}
+
+	if( pCapture )
+	{
+		fclose(pCapture);
+	}
+
+	printf("telemetry: %lu records sent   %lu bytes on USART6   %lu decoded\n", (unsigned long) Sent, (unsigned long) TlmLen, (unsigned long) Decoded);
+
+	if( ( Decoded != Sent ) || ( Sent == 0 ) )
+	{
+		Errors++;
+	}
+
+	//8. Clock change - back to the 16MHz HSI, every initialized driver re-derives its settings through its clock callback
+	RCC_Config_t HSIConfig;
+
+	memset(&HSIConfig, 0, sizeof(HSIConfig));
+	HSIConfig.RCC_ClkSource = RCC_CLK_SRC_HSI;
+	HSIConfig.RCC_AHBPrescaler = RCC_AHB_DIV_1;
+	HSIConfig.RCC_APB1Prescaler = RCC_APB_DIV_1;
+	HSIConfig.RCC_APB2Prescaler = RCC_APB_DIV_1;
+	HSIConfig.RCC_FlashART = ENABLE;
+
+	RCC_ClockConfig(&HSIConfig);
+
+	uint32_t Arr = TIM2->ARR;
+
+	printf("clock change: PCLK1 %lu   USART3 BRR 0x%lX   USART6 BRR 0x%lX   I2C1 FREQ %lu   TIM2 ARR %lu   TIM5 PSC %lu\n",
+			(unsigned long) RCC_GetPCLK1Val(), (unsigned long) USART3->BRR, (unsigned long) USART6->BRR, (unsigned long) ( I2C1->CR2 & 0x3F ),
+			(unsigned long) Arr, (unsigned long) TIM5->PSC);
+
+	if( ( RCC_GetPCLK1Val() != RCC_HSI_FREQ ) || ( USART3->BRR != SIM_HSI_USART3_BRR ) || ( USART6->BRR != SIM_HSI_USART6_BRR ) ||
+		( ( I2C1->CR2 & 0x3F ) != ( RCC_HSI_FREQ / 1000000U ) ) || ( Arr < SIM_HSI_TIM2_ARR - 1 ) || ( Arr > SIM_HSI_TIM2_ARR + 1 ) ||
+		( TIM2->PSC != 0 ) || ( TIM5->PSC != ( RCC_HSI_FREQ / 1000000U ) - 1 ) || ( ( FLASH->ACR & 0x7 ) != 0 ) )
+	{
+		printf("  clock dependent settings not updated\n");
+		Errors++;
+	}
+
+	//9. Integer period API - pre-scaler on a 16-bit timer, out of range periods, and a blocking delay
+	TIM_Period_t Tim3Period, Tim3Delay, Tim3Bad;
+	uint8_t Status = TIM2_5_ComputePeriod(TIM3, SIM_TIM3_PERIOD_MS, TIM_UNIT_MS, &Tim3Period);
+	uint8_t ShortStatus = TIM2_5_ComputePeriod(TIM3, SIM_TIM3_TOO_SHORT_NS, TIM_UNIT_NS, &Tim3Bad);
+	uint8_t LongStatus = TIM2_5_ComputePeriod(TIM3, SIM_TIM3_TOO_LONG_MS, TIM_UNIT_MS, &Tim3Bad);
+
+	TIM2_5_SetDelayInit(TIM3);
+	TIM2_5_ComputePeriod(TIM3, SIM_TIM3_DELAY_US, TIM_UNIT_US, &Tim3Delay);
+
+	uint64_t DelayStart = SIM_GetTimeUsecs();
+	TIM2_5_DelayPeriod(TIM3, &Tim3Delay);
+	uint64_t DelayUsecs = SIM_GetTimeUsecs() - DelayStart;
+
+	printf("timer periods: TIM3 %ums PSC %u ARR %lu   %uns/%ums %s/%s   %uus delay took %luus\n", SIM_TIM3_PERIOD_MS,
+			Tim3Period.PSC, (unsigned long) Tim3Period.ARR, SIM_TIM3_TOO_SHORT_NS, SIM_TIM3_TOO_LONG_MS,
+			( ShortStatus == TIM_ERROR_RANGE ) ? "rejected" : "accepted", ( LongStatus == TIM_ERROR_RANGE ) ? "rejected" : "accepted",
+			SIM_TIM3_DELAY_US, (unsigned long) DelayUsecs);
+
+	if( ( Status != TIM_OK ) || ( Tim3Period.PSC != SIM_TIM3_PSC ) || ( Tim3Period.ARR != SIM_TIM3_ARR ) ||
+		( ShortStatus != TIM_ERROR_RANGE ) || ( LongStatus != TIM_ERROR_RANGE ) || ( DelayUsecs < SIM_TIM3_DELAY_US ) || ( DelayUsecs > SIM_TIM3_DELAY_US + 2 ) )
+	{
+		printf("  integer periods wrong\n");
+		Errors++;
+	}
+
+	//10. Software timers on TIM5 channel 2 (next to the 1-wire engine) - one-shot, periodic, cancelled, several levels out
+	SWT_Timer_t OneShot, Periodic, Cancelled, Far;
+	SimTimerLog_t OneShotLog, PeriodicLog, CancelledLog, FarLog;
+
+	memset(&OneShot, 0, sizeof(OneShot));
+	memset(&Periodic, 0, sizeof(Periodic));
+	memset(&Cancelled, 0, sizeof(Cancelled));
+	memset(&Far, 0, sizeof(Far));
+	memset(&OneShotLog, 0, sizeof(OneShotLog));
+	memset(&PeriodicLog, 0, sizeof(PeriodicLog));
+	memset(&CancelledLog, 0, sizeof(CancelledLog));
+	memset(&FarLog, 0, sizeof(FarLog));
+
+	PeriodicLog.Limit = SIM_SWT_PERIODIC_RUNS;
+	PeriodicLog.pTimer = &Periodic;
+
+	uint32_t SwtStart = SWT_GetTime(&SoftTimers);
+	uint32_t Cascades = SoftTimers.Cascades;
+
+	SWT_Start(&SoftTimers, &OneShot, SIM_SWT_ONESHOT_TICKS, 0, SimTimerCallback, &OneShotLog);
+	SWT_Start(&SoftTimers, &Periodic, SIM_SWT_PERIOD_TICKS, SIM_SWT_PERIOD_TICKS, SimTimerCallback, &PeriodicLog);
+	SWT_Start(&SoftTimers, &Cancelled, SIM_SWT_ONESHOT_TICKS / 2, 0, SimTimerCallback, &CancelledLog);
+	SWT_Start(&SoftTimers, &Far, SIM_SWT_FAR_TICKS, 0, SimTimerCallback, &FarLog);
+
+	uint8_t CancelStatus = SWT_Cancel(&SoftTimers, &Cancelled);
+	uint8_t RangeStatus = SWT_Start(&SoftTimers, &Cancelled, 0, 0, SimTimerCallback, &CancelledLog);
+
+	SIM_RunUsecs(SIM_SWT_FAR_TICKS + SIM_SWT_ONESHOT_TICKS);
+
+	printf("software timers: one-shot %lu   periodic %lu   cancelled %lu   far %lu   %lu fired   %lu cascades   %lu max ticks late\n",
+			(unsigned long) OneShotLog.Count, (unsigned long) PeriodicLog.Count, (unsigned long) CancelledLog.Count,
+			(unsigned long) FarLog.Count, (unsigned long) SoftTimers.Fired, (unsigned long) ( SoftTimers.Cascades - Cascades ),
+			(unsigned long) SoftTimers.MaxLateness);
+
+	if( ( OneShotLog.Count != 1 ) || SimTimerLate(&OneShotLog, SwtStart + SIM_SWT_ONESHOT_TICKS) ||
+		( PeriodicLog.Count != SIM_SWT_PERIODIC_RUNS ) || SimTimerLate(&PeriodicLog, SwtStart + SIM_SWT_PERIODIC_RUNS * SIM_SWT_PERIOD_TICKS) ||
+		( CancelledLog.Count != 0 ) || ( CancelStatus != SWT_OK ) || ( RangeStatus != SWT_ERROR_RANGE ) ||
+		( FarLog.Count != 1 ) || SimTimerLate(&FarLog, SwtStart + SIM_SWT_FAR_TICKS) || ( SoftTimers.Cascades == Cascades ) ||
+		( SoftTimers.MaxLateness > SIM_SWT_MAX_LATE_TICKS ) || !HeartbeatTimer.Active )
+	{
+		printf("  software timers wrong\n");
+		Errors++;
+	}
+
+	//11. Idle main loop - back at 168MHz, STOP between readings. Readings must keep their period on both the time base and the simulated time
+	RCC_ClockConfig(&RunClockConfig);
+
+	while( RING_Get(&SampleRing, SampleCopy) == RING_OK )
+		;
+
+	uint64_t IdleStart = SIM_GetTimeUsecs();
+	uint64_t StopStart = PWR_GetStateUsecs(&PowerManager, PWR_STATE_STOP);
+	uint32_t StopEntries = PowerManager.Entries[PWR_STATE_STOP];
+	uint32_t Heartbeats = SoftTimers.Fired;
+	uint32_t IdleStamps[SIM_IDLE_SAMPLES];
+	uint64_t IdleTimes[SIM_IDLE_SAMPLES];
+	uint32_t IdleSamples = 0;
+	uint32_t MaxJitter = 0;
+
+	while( ( IdleSamples < SIM_IDLE_SAMPLES ) && ( ( SIM_GetTimeUsecs() - IdleStart ) < SIM_MAX_USECS ) )
+	{
+		uint32_t primask;
+
+		if( RING_Get(&SampleRing, SampleCopy) == RING_OK )
+		{
+			memcpy(&IdleStamps[IdleSamples], SampleCopy, sizeof(uint32_t));		//WQ_Sample_t starts with its timestamp
+			IdleTimes[IdleSamples++] = SIM_GetTimeUsecs();
+			SendSampleTelemetry(SampleCopy);
+			continue;
+		}
+
+		CRITICAL_SECTION_ENTER(primask);
+
+		if( RING_GetCount(&SampleRing) == 0 )
+		{
+			PWR_Idle(&PowerManager);
+		}
+
+		CRITICAL_SECTION_EXIT(primask);
+
+		SIM_Step();																//Interrupts taken when PRIMASK is cleared
+	}
+
+	for(uint32_t i = 1; i < IdleSamples; i++)
+	{
+		int64_t StampErr = (int64_t) ( IdleStamps[i] - IdleStamps[i - 1] ) - SIM_SAMPLE_PERIOD_USECS;
+		int64_t TimeErr = (int64_t) ( IdleTimes[i] - IdleTimes[i - 1] ) - SIM_SAMPLE_PERIOD_USECS;
+
+		StampErr = ( StampErr < 0 ) ? -StampErr : StampErr;
+		TimeErr = ( TimeErr < 0 ) ? -TimeErr : TimeErr;
+		MaxJitter = ( StampErr > MaxJitter ) ? StampErr : MaxJitter;
+		MaxJitter = ( TimeErr > MaxJitter ) ? TimeErr : MaxJitter;
+	}
+
+	uint64_t IdleUsecs = SIM_GetTimeUsecs() - IdleStart;
+	uint64_t StopUsecs = PWR_GetStateUsecs(&PowerManager, PWR_STATE_STOP) - StopStart;
+	int64_t LSIError = ( ( (int64_t) PowerManager.LSIFreq - SIM_LSI_FREQ ) * 1000000 ) / SIM_LSI_FREQ;
+
+	printf("power: %lu readings in %lums   %lums in STOP (%lu entries, %lu vetoed, %lu late)   %luus max period error   LSI %luHz (%ldppm)\n",
+			(unsigned long) IdleSamples, (unsigned long) ( IdleUsecs / 1000 ), (unsigned long) ( StopUsecs / 1000 ),
+			(unsigned long) ( PowerManager.Entries[PWR_STATE_STOP] - StopEntries ), (unsigned long) PowerManager.StopVetoes,
+			(unsigned long) PowerManager.LateWakeups, (unsigned long) MaxJitter, (unsigned long) PowerManager.LSIFreq, (long) LSIError);
+
+	if( ( IdleSamples != SIM_IDLE_SAMPLES ) || ( MaxJitter > SIM_IDLE_MAX_JITTER_USECS ) || ( ( StopUsecs * 100 ) < ( IdleUsecs * SIM_IDLE_MIN_STOP_PERCENT ) ) ||
+		( PowerManager.Entries[PWR_STATE_STOP] == StopEntries ) || PowerManager.LateWakeups || ( RCC_GetSysClkVal() != SIM_SYSCLK_FREQ ) ||
+		( ( RCC->CFGR & 0xC ) != 0x8 ) || ( LSIError > SIM_LSI_MAX_ERROR_PPM ) || ( LSIError < -SIM_LSI_MAX_ERROR_PPM ) || ( SoftTimers.Fired == Heartbeats ) )
+	{
+		printf("  idle loop wrong\n");
+		Errors++;
+	}
+
+	//12. Dual ADC burst - from the TIM2 trigger (first ADC_CDR word moved) to the re-armed stream, TDS and turbidity paired
+	uint16_t BurstWords = DMA_GetCurrDataCounter(&ADC1DMAHandle);
+	uint64_t BurstStart, BurstUsecs;
+	uint32_t BadPairs = 0;
+
+	while( ( DMA_GetCurrDataCounter(&ADC1DMAHandle) == BurstWords ) && ( SIM_GetTimeUsecs() < ( IdleStart + 2 * SIM_MAX_USECS ) ) )
+	{
+		SIM_Step();
+	}
+
+	BurstStart = SIM_GetTimeUsecs();
+
+	while( ( DMA_GetCurrDataCounter(&ADC1DMAHandle) != BurstWords ) && ( SIM_GetTimeUsecs() < ( IdleStart + 2 * SIM_MAX_USECS ) ) )
+	{
+		SIM_Step();
+	}
+
+	//First word is moved one conversion after the trigger
+	BurstUsecs = SIM_GetTimeUsecs() - BurstStart + ( SIM_ADC_BURST_MIN_USECS / SIM_ADC_PAIRS );
+
+	for(uint32_t i = 0; i < SIM_ADC_PAIRS; i++)
+	{
+		if( ( BufferADCValues[2 * i] != SIM_TDS_COUNTS ) || ( BufferADCValues[( 2 * i ) + 1] != SIM_TURBIDITY_COUNTS ) )
+		{
+			BadPairs++;
+		}
+	}
+
+	printf("dual ADC: %u words per burst   %luus burst   %lu bad pairs   CCR 0x%05lX\n", BurstWords, (unsigned long) BurstUsecs,
+			(unsigned long) BadPairs, (unsigned long) ADCCOMMON->CCR);
+
+	if( ( BurstWords != SIM_ADC_PAIRS ) || ( BurstUsecs < SIM_ADC_BURST_MIN_USECS ) || ( BurstUsecs > SIM_ADC_BURST_MAX_USECS ) || BadPairs ||
+		( ( ADCCOMMON->CCR & 0x1F ) != ADC_MULTI_DUAL_REG_SIMULT ) )
+	{
+		printf("  dual ADC burst wrong\n");
+		Errors++;
+	}
+
+	//13. 1-wire bus model - probes found and read, then a corrupted byte (retried), zeros cut short (CRC error) and no presence
+	const int16_t ProbeRaw[SIM_OW_PROBES] = { SIM_OW_RAW_NEGATIVE, SIM_OW_RAW_25C };
+	uint8_t ProbesOK = ( DS18B20_GetNumOfDevices() == SIM_OW_PROBES );
+	uint8_t ReadOK, RetryOK, ShortZeroRead, NoPresenceRead, RecoverOK;
+	uint32_t Retries, NoPresence;
+	uint32_t ConvertTs = 0;
+
+	TIM2_5_IRQInterruptConfig(IRQ_NO_TIM2, DISABLE);							//No more readings started by the application
+	SimProbeWait();
+
+	//Search, configuration and pipelined reads of the application so far
+	const SIM_OWStats_t *pOWStats = SIM_OneWireGetStats();
+	uint32_t AppViolations = pOWStats->ResetViolations + pOWStats->LowViolations + pOWStats->SlotViolations;
+	uint32_t AppTransactions = pOWStats->Transactions;
+
+	SIM_OneWireClearStats();
+
+	uint32_t LogStart = SIM_OneWireGetTransactionCount();
+
+	SIM_OneWireSetTemperature(0, SIM_OW_RAW_NEGATIVE);
+	ReadOK = SimProbeRead();
+
+	for(uint8_t p = 0; ProbesOK && ( p < SIM_OW_PROBES ); p++)
+	{
+		uint8_t d = SimProbeModelIndex(p);
+
+		ProbesOK = ( ( d < SIM_OW_PROBES ) && ( DS18B20_ConvertTempRaw(&BufferProbeTemperatures[2 * p]) == ProbeRaw[d] ) );
+	}
+
+	ReadOK = ( ReadOK && ProbesOK && ( TemperatureRaw == ProbeRaw[SimProbeModelIndex(0)] ) );
+
+	Retries = DS18B20_GetCRCRetries();
+	SIM_OneWireInjectFault(0, SIM_OW_FAULT_BIT_ERROR, 1);
+	RetryOK = ( SimProbeRead() && ( DS18B20_GetCRCRetries() > Retries ) );
+
+	SIM_OneWireInjectFault(0, SIM_OW_FAULT_SHORT_ZERO, SIM_OW_MANY_FAULTS);
+	SIM_OneWireInjectFault(1, SIM_OW_FAULT_SHORT_ZERO, SIM_OW_MANY_FAULTS);
+	ShortZeroRead = SimProbeRead();
+	SIM_OneWireInjectFault(0, SIM_OW_FAULT_SHORT_ZERO, 0);
+	SIM_OneWireInjectFault(1, SIM_OW_FAULT_SHORT_ZERO, 0);
+
+	NoPresence = SIM_OneWireGetStats()->NoPresence;
+	SIM_OneWireInjectFault(0, SIM_OW_FAULT_NO_PRESENCE, SIM_OW_MANY_FAULTS);
+	SIM_OneWireInjectFault(1, SIM_OW_FAULT_NO_PRESENCE, SIM_OW_MANY_FAULTS);
+	NoPresenceRead = SimProbeRead();
+	SIM_OneWireInjectFault(0, SIM_OW_FAULT_NO_PRESENCE, 0);
+	SIM_OneWireInjectFault(1, SIM_OW_FAULT_NO_PRESENCE, 0);
+	SIM_RunUsecs(SIM_OW_MIN_RSTH_USECS);										//The job ended 70us into the master Rx phase - let it run out
+
+	RecoverOK = ( SimProbeRead() && ( TemperatureRaw == ProbeRaw[SimProbeModelIndex(0)] ) );
+
+	//Every Convert T (SKIP_ROM, CONVERT_T) is in the transaction log
+	for(uint32_t i = LogStart; i < SIM_OneWireGetTransactionCount(); i++)
+	{
+		const SIM_OWTransaction_t *pTransaction = SIM_OneWireGetTransaction(i);
+
+		if( pTransaction && ( pTransaction->Command[0] == MASTER_COMMAND_SKIP_ROM ) && ( pTransaction->Command[1] == MASTER_COMMAND_CONVERT_T ) )
+		{
+			ConvertTs++;
+		}
+	}
+
+	uint64_t OWUsecs = SIM_GetTimeUsecs() - pOWStats->StartUsecs;
+
+	printf("1-wire: %u probes   %.3f/%.3f°C   retry %s   short zeros %s   no presence %s (%lu resets)   recovered %s   %lu faults injected\n",
+			DS18B20_GetNumOfDevices(), DS18B20_ConvertTempRaw(&BufferProbeTemperatures[0]) / 16.0f, DS18B20_ConvertTempRaw(&BufferProbeTemperatures[2]) / 16.0f,
+			RetryOK ? "read" : "failed", ShortZeroRead ? "read" : "rejected", NoPresenceRead ? "read" : "rejected",
+			(unsigned long) ( pOWStats->NoPresence - NoPresence ), RecoverOK ? "yes" : "no", (unsigned long) pOWStats->FaultsInjected);
+	printf("1-wire bus: %lu application transactions   %lu timing violations\n", (unsigned long) AppTransactions, (unsigned long) AppViolations);
+	printf("1-wire bus: %lu transactions (%lu Convert T)   %lu slots   latency min/avg/max %lu/%lu/%luus   %.2f%% utilization   %lu/%lu/%lu reset/low/slot timing violations\n",
+			(unsigned long) pOWStats->Transactions, (unsigned long) ConvertTs, (unsigned long) pOWStats->Slots, (unsigned long) pOWStats->MinUsecs,
+			(unsigned long) ( pOWStats->Transactions ? ( pOWStats->BusyUsecs / pOWStats->Transactions ) : 0 ), (unsigned long) pOWStats->MaxUsecs,
+			OWUsecs ? ( pOWStats->BusyUsecs * 100.0 ) / OWUsecs : 0.0, (unsigned long) pOWStats->ResetViolations,
+			(unsigned long) pOWStats->LowViolations, (unsigned long) pOWStats->SlotViolations);
+
+	if( !ReadOK || !RetryOK || ShortZeroRead || NoPresenceRead || ( pOWStats->NoPresence == NoPresence ) || !RecoverOK || ( ConvertTs != 5 ) ||
+		pOWStats->ResetViolations || pOWStats->LowViolations || pOWStats->SlotViolations || AppViolations || ( AppTransactions == 0 ) )
+	{
+		printf("  1-wire bus model wrong\n");
+		Errors++;
+	}
+
+	//14. DS18B20 alarm search and configuration - one probe in alarm, then none (completes, no error), 9-bit, recall and save to E2
+	uint8_t AlarmProbe = 0xFF;
+	uint32_t OneAlarm, NoAlarm, SearchErrors = OneWireSearchErrors;
+	uint32_t ConvTime9, ConvTimeRecalled, ConvTimeSaved;
+	float LSBWeight9;
+	int8_t RecalledHigh, RecalledLow, SavedHigh, SavedLow;
+	uint8_t Read9OK;
+
+	for(uint8_t p = 0; p < SIM_OW_PROBES; p++)
+	{
+		if( SimProbeModelIndex(p) == 0 )
+		{
+			AlarmProbe = p;
+		}
+	}
+
+	//Model device 0 converted below the low threshold on the last read - only it takes part. The application then rewrites the configuration
+	DS18B20_MasterSearchROMIT(MASTER_COMMAND_ALARM_SEARCH);
+	SimProbeWait();
+	OneAlarm = DS18B20_GetAlarmDevices();
+	SimProbeWait();
+
+	SIM_OneWireSetTemperature(0, SIM_OW_RAW_25C);
+	SimProbeRead();
+	DS18B20_MasterSearchROMIT(MASTER_COMMAND_ALARM_SEARCH);
+	SimProbeWait();
+	NoAlarm = DS18B20_GetAlarmDevices();
+	SimProbeWait();
+
+	//9-bit - 93.75ms conversions, 0.5°C LSB and the 3 undefined low bits of the reading
+	DS18B20_MasterWriteConfigIT(DS18B20_ALL_DEVICES, SIM_OW_ALARM_HIGH_C, SIM_OW_ALARM_LOW_C, DS18B20_RESOLUTION_9_BIT, 0);
+	SimProbeWait();
+	ConvTime9 = DS18B20_GetConvTimeUsecs();
+	LSBWeight9 = DS18B20_GetLSBWeight(0);
+
+	SIM_OneWireSetTemperature(0, SIM_OW_RAW_NEGATIVE);
+	Read9OK = ( SimProbeRead() && ( AlarmProbe < SIM_OW_PROBES ) &&
+				( ( DS18B20_ConvertTempRaw(&BufferProbeTemperatures[2 * AlarmProbe]) & ~0x7 ) == ( SIM_OW_RAW_NEGATIVE & ~0x7 ) ) );
+
+	//Nothing saved yet - the power-on E2 comes back (75/70°C, 12-bit)
+	DS18B20_MasterRecallConfigIT(DS18B20_ALL_DEVICES);
+	SimProbeWait();
+	ConvTimeRecalled = DS18B20_GetConvTimeUsecs();
+	DS18B20_GetAlarmThresholds(0, &RecalledHigh, &RecalledLow);
+
+	//Application configuration saved, then recalled
+	DS18B20_MasterWriteConfigIT(DS18B20_ALL_DEVICES, SIM_OW_ALARM_HIGH_C, SIM_OW_ALARM_LOW_C, DS18B20_RESOLUTION_12_BIT, 1);
+	SimProbeWait();
+	DS18B20_MasterRecallConfigIT(DS18B20_ALL_DEVICES);
+	SimProbeWait();
+	ConvTimeSaved = DS18B20_GetConvTimeUsecs();
+	DS18B20_GetAlarmThresholds(0, &SavedHigh, &SavedLow);
+
+	printf("DS18B20 config: alarm search 0x%lX/0x%lX (%lu errors)   9-bit %luus %.4f°C %s   recalled %d/%d°C %luus   saved %d/%d°C %luus\n",
+			(unsigned long) OneAlarm, (unsigned long) NoAlarm, (unsigned long) ( OneWireSearchErrors - SearchErrors ), (unsigned long) ConvTime9,
+			LSBWeight9, Read9OK ? "read" : "failed", RecalledHigh, RecalledLow, (unsigned long) ConvTimeRecalled, SavedHigh, SavedLow,
+			(unsigned long) ConvTimeSaved);
+
+	if( ( AlarmProbe >= SIM_OW_PROBES ) || ( OneAlarm != ( 1UL << AlarmProbe ) ) || NoAlarm || ( OneWireSearchErrors != SearchErrors ) ||
+		( ConvTime9 != DS18B20_CONV_TIME_RES_USECS(DS18B20_RESOLUTION_9_BIT) ) || ( LSBWeight9 != 0.5f ) || !Read9OK ||
+		( RecalledHigh != SIM_OW_POWER_ON_HIGH_C ) || ( RecalledLow != SIM_OW_POWER_ON_LOW_C ) || ( ConvTimeRecalled != DS18B20_CONV_TIME_USECS ) ||
+		( SavedHigh != SIM_OW_ALARM_HIGH_C ) || ( SavedLow != SIM_OW_ALARM_LOW_C ) || ( ConvTimeSaved != DS18B20_CONV_TIME_USECS ) ||
+		( DS18B20_GetState() != DS18B20_READY ) || pOWStats->ResetViolations || pOWStats->LowViolations || pOWStats->SlotViolations )
+	{
+		printf("  DS18B20 alarm search / configuration wrong\n");
+		Errors++;
+	}
+
+	//15. NVIC - disabling an IRQ above 31 (ICER1) clears its enable bit and leaves the others of the register alone
+	DMA_IRQInterruptConfig(IRQ_NO_DMA2_STREAM0, DISABLE);
+	SIM_Step();
+
+	printf("NVIC: ISER1 0x%08lX after DMA2 stream 0 (IRQ %d) disabled\n", (unsigned long) *NVIC_ISER1, IRQ_NO_DMA2_STREAM0);
+
+	if( ( *NVIC_ISER1 & ( 1 << ( IRQ_NO_DMA2_STREAM0 % 32 ) ) ) || !( *NVIC_ISER1 & ( 1 << ( IRQ_NO_TIM5 % 32 ) ) ) )
+	{
+		printf("  IRQ disable wrong\n");
+		Errors++;
+	}
+
+	if( Checked < SIM_FRAMES_TO_CHECK )
+	{
+		printf("FAIL: only %lu of %d frames sent\n", (unsigned long) Checked, SIM_FRAMES_TO_CHECK);
+		return EXIT_FAILURE;
+	}
+
+	if( Errors )
+	{
+		printf("FAIL: %d mismatches\n", Errors);
+		return EXIT_FAILURE;
+	}
+
+	printf("PASS\n");
+
+	return EXIT_SUCCESS;
+}